@@ -140,6 +140,9 @@ macro(write_configtable)
   string(APPEND out "Emulation FdNetDevice         : ")
   check_on_or_off("${ENABLE_EMU}" "${ENABLE_EMUNETDEV}")
 
+  string(APPEND out "Event memory pool             : ")
+  check_on_or_off("${NS3_EVENT_POOL}" "${NS3_EVENT_POOL}")
+
   string(APPEND out "Examples                      : ")
   check_on_or_off("${ENABLE_EXAMPLES}" "${ENABLE_EXAMPLES}")
 
@@ -158,6 +161,9 @@ macro(write_configtable)
   string(APPEND out "MPI Support                   : ")
   check_on_or_off("${NS3_MPI}" "${MPI_FOUND}")
 
+  string(APPEND out "Multithreaded Simulation      : ")
+  check_on_or_off("${NS3_MTP}" "${ENABLE_MTP}")
+
   string(APPEND out "ns-3 Click Integration        : ")
   check_on_or_off("ON" "${NS3_CLICK}")
 
@@ -167,6 +173,9 @@ macro(write_configtable)
   string(APPEND out "Netmap emulation FdNetDevice  : ")
   check_on_or_off("${ENABLE_EMU}" "${ENABLE_NETMAP_EMU}")
 
+  string(APPEND out "Packet memory pool            : ")
+  check_on_or_off("${NS3_PACKET_POOL}" "${NS3_PACKET_POOL}")
+
   string(APPEND out "PyViz visualizer              : ")
   check_on_or_off("${NS3_VISUALIZER}" "${ENABLE_VISUALIZER}")
 
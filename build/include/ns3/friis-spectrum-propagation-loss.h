@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/friis-spectrum-propagation-loss.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/internet/helper/rip-helper.h"
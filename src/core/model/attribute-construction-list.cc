@@ -53,6 +53,7 @@ AttributeConstructionList::Add(std::string name,
             break;
         }
     }
+    m_compiled.reset();
     // store the new value.
     Item attr;
     attr.checker = checker;
@@ -90,4 +91,25 @@ AttributeConstructionList::End() const
     return m_list.end();
 }
 
+bool
+AttributeConstructionList::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_list.empty();
+}
+
+std::shared_ptr<const AttributeConstructionList::Compiled>
+AttributeConstructionList::GetCompiled() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_compiled;
+}
+
+void
+AttributeConstructionList::SetCompiled(std::shared_ptr<const Compiled> compiled) const
+{
+    NS_LOG_FUNCTION(this);
+    m_compiled = compiled;
+}
+
 } // namespace ns3
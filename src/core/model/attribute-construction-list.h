@@ -22,6 +22,8 @@
 #include "attribute.h"
 
 #include <list>
+#include <memory>
+#include <vector>
 
 /**
  * \file
@@ -53,6 +55,34 @@ class AttributeConstructionList
     /** Iterator type. */
     typedef std::list<struct Item>::const_iterator CIterator;
 
+    /** An Attribute resolved for the construction of the objects of a TypeId */
+    struct Setting
+    {
+        /** The accessor of the Attribute. */
+        Ptr<const AttributeAccessor> accessor;
+        /** The checker of the Attribute. */
+        Ptr<const AttributeChecker> checker;
+        /** The value to set. */
+        Ptr<const AttributeValue> value;
+        /** \c true if the value is checked at each construction. */
+        bool check;
+    };
+
+    /**
+     * The Attributes of a TypeId, with the values of this list, the
+     * environment and the initial values, resolved by ObjectBase for the
+     * construction of its objects.
+     */
+    struct Compiled
+    {
+        /** The uid of the TypeId. */
+        uint16_t uid;
+        /** The generation of the attributes, from TypeId::GetAttributeGeneration(). */
+        uint64_t generation;
+        /** The Attributes to set, in order. */
+        std::vector<Setting> settings;
+    };
+
     /** Constructor */
     AttributeConstructionList();
 
@@ -78,10 +108,27 @@ class AttributeConstructionList
     CIterator Begin() const;
     /** \returns The end of the list (iterator to one past the last). */
     CIterator End() const;
+    /** \returns \c true if the list has no Attribute. */
+    bool IsEmpty() const;
+
+    /**
+     * Get the Attributes resolved with this list, if any.
+     *
+     * \returns The Attributes resolved with this list, or null.
+     */
+    std::shared_ptr<const Compiled> GetCompiled() const;
+    /**
+     * Keep the Attributes resolved with this list, until the list changes.
+     *
+     * \param [in] compiled The Attributes resolved with this list.
+     */
+    void SetCompiled(std::shared_ptr<const Compiled> compiled) const;
 
   private:
     /** The list of Items */
     std::list<struct Item> m_list;
+    /** The Attributes resolved with this list. */
+    mutable std::shared_ptr<const Compiled> m_compiled;
 };
 
 } // namespace ns3
@@ -414,4 +414,28 @@ CalendarScheduler::Resize(uint32_t newSize)
     DoResize(newSize, newWidth);
 }
 
+void
+CalendarScheduler::RemoveCancelled(std::vector<Event>& removed)
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t bucket = 0; bucket < m_nBuckets; bucket++)
+    {
+        Bucket::iterator i = m_buckets[bucket].begin();
+        while (i != m_buckets[bucket].end())
+        {
+            if (i->impl->IsCancelled())
+            {
+                removed.push_back(*i);
+                i = m_buckets[bucket].erase(i);
+                m_qSize--;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+    ResizeDown();
+}
+
 } // namespace ns3
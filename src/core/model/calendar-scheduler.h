@@ -66,6 +66,7 @@ class EventImpl;
  * PeekNext()   | ~Constant       | Search buckets
  * Remove()     | ~Constant       | Search within bucket; possible resize
  * RemoveNext() | ~Constant       | Search buckets; possible resize
+ * RemoveCancelled() | Linear      | Filter the buckets; possible resize
  *
  * \par Memory Complexity
  *
@@ -110,6 +111,7 @@ class CalendarScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
 
   private:
     /** Double the number of buckets if necessary. */
@@ -29,6 +29,8 @@
 
 #include <functional>
 #include <memory>
+#include <tuple>
+#include <type_traits>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -72,6 +74,41 @@ namespace ns3
  * or not we really want to use it.
  */
 
+class CallbackBase;
+
+/**
+ * \ingroup callbackimpl
+ * A component of a callback, i.e., the callable object or a bound
+ * argument, as seen by the equality test of the callbacks.
+ */
+struct CallbackComponent
+{
+    const std::type_info* type; //!< The type of the component.
+    const void* value;          //!< The address of the component.
+    /**
+     * The equality test of two components of this type, or \c nullptr
+     * if the type cannot be compared: then components are only equal
+     * to themselves.
+     */
+    bool (*isEqual)(const void* a, const void* b);
+
+    /**
+     * Equality test
+     *
+     * \param [in] other The other component
+     * \return \c true if the components have the same type, and are
+     *         the same object or compare equal
+     */
+    bool IsEqual(const CallbackComponent& other) const
+    {
+        return *type == *other.type &&
+               (value == other.value || (isEqual != nullptr && isEqual(value, other.value)));
+    }
+};
+
+/// Vector of callback components
+typedef std::vector<CallbackComponent> CallbackComponentVector;
+
 /**
  * \ingroup callbackimpl
  * Abstract base class for CallbackImpl
@@ -97,6 +134,13 @@ class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
      * \return The object type as a string.
      */
     virtual std::string GetTypeid() const = 0;
+    /**
+     * Append the components of this callback, i.e., the original
+     * callable object followed by all the bound arguments.
+     *
+     * \param [in,out] components The vector of components.
+     */
+    virtual void GetComponents(CallbackComponentVector& components) const = 0;
 
   protected:
     /**
@@ -126,119 +170,40 @@ class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
         }
         return typeName;
     }
-};
-
-/**
- * \ingroup callbackimpl
- * Abstract base class for CallbackComponent.
- * Provides equality test.
- */
-class CallbackComponentBase
-{
-  public:
-    /** Virtual destructor */
-    virtual ~CallbackComponentBase()
-    {
-    }
 
     /**
-     * Equality test
+     * Describe a component of a callback.
      *
-     * \param [in] other CallbackComponent Ptr
-     * \return \c true if we are equal
+     * \tparam T \explicit The type of the component.
+     * \tparam isComparable \explicit Whether the values of type \pname{T}
+     *         can be compared with each other
+     * \param [in] t The component
+     * \return The component description
      */
-    virtual bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const = 0;
-};
-
-/**
- * \ingroup callbackimpl
- * Stores a component of a callback, i.e., the callable object
- * or a bound argument. The purpose of this class is to test
- * the equality of the components of two callbacks.
- *
- * \tparam T The type of the callback component.
- * \tparam isComparable whether this callback component can be compared to others of the same type
- */
-template <typename T, bool isComparable = true>
-class CallbackComponent : public CallbackComponentBase
-{
-  public:
-    /**
-     * Constructor
-     *
-     * \param [in] t The value of the callback component
-     */
-    CallbackComponent(const T& t)
-        : m_comp(t)
+    template <typename T, bool isComparable = true>
+    static CallbackComponent MakeComponent(const T& t)
     {
-    }
-
-    /**
-     * Equality test between the values of two components
-     *
-     * \param [in] other CallbackComponentBase Ptr
-     * \return \c true if we are equal
-     */
-    bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const override
-    {
-        auto p = std::dynamic_pointer_cast<const CallbackComponent<T>>(other);
-
-        // other must have the same type and value as ours
-        if (p == nullptr || p->m_comp != m_comp)
+        CallbackComponent component{&typeid(T), &t, nullptr};
+        if constexpr (isComparable)
         {
-            return false;
+            component.isEqual = [](const void* a, const void* b) {
+                return !(*static_cast<const T*>(a) != *static_cast<const T*>(b));
+            };
         }
-
-        return true;
-    }
-
-  private:
-    T m_comp; //!< the value of the callback component
-};
-
-/**
- * \ingroup callbackimpl
- * Partial specialization of class CallbackComponent with isComparable equal
- * to false. This is required to handle callable objects (such as lambdas and
- * objects returned by std::function and std::bind) that do not provide the
- * equality operator. Given that these objects cannot be compared and the only
- * purpose of the class CallbackComponent is to compare values, no object is
- * stored in this specialized class.
- *
- * \tparam T The type of the callback component.
- */
-template <typename T>
-class CallbackComponent<T, false> : public CallbackComponentBase
-{
-  public:
-    /**
-     * Constructor
-     *
-     * \param [in] t The value of the callback component
-     */
-    CallbackComponent(const T& t)
-    {
-    }
-
-    /**
-     * Equality test between functions
-     *
-     * \param [in] other CallbackParam Ptr
-     * \return \c true if we are equal
-     */
-    bool IsEqual(std::shared_ptr<const CallbackComponentBase> other) const override
-    {
-        return false;
+        return component;
     }
 };
 
-/// Vector of callback components
-typedef std::vector<std::shared_ptr<CallbackComponentBase>> CallbackComponentVector;
-
 /**
  * \ingroup callbackimpl
  * CallbackImpl class with varying numbers of argument types
  *
+ * The callable object and the bound arguments are stored by the
+ * derived CallbackTargetImpl, in the same allocation as the reference
+ * count.  Invoking the callback does not go through a virtual
+ * function, but through a single function pointer set by the derived
+ * class, which calls the target directly.
+ *
  * \tparam R \explicit The return type of the Callback.
  * \tparam UArgs \explicit The types of any arguments to the Callback.
  */
@@ -246,36 +211,6 @@ template <typename R, typename... UArgs>
 class CallbackImpl : public CallbackImplBase
 {
   public:
-    /**
-     * Constructor.
-     *
-     * \param func the callable object
-     * \param components the callback components (callable object and bound arguments)
-     */
-    CallbackImpl(std::function<R(UArgs...)> func, const CallbackComponentVector& components)
-        : m_func(func),
-          m_components(components)
-    {
-    }
-
-    /**
-     * Get the stored function.
-     * \return A const reference to the stored function.
-     */
-    const std::function<R(UArgs...)>& GetFunction() const
-    {
-        return m_func;
-    }
-
-    /**
-     * Get the vector of callback components.
-     * \return A const reference to the vector of callback components.
-     */
-    const CallbackComponentVector& GetComponents() const
-    {
-        return m_components;
-    }
-
     /**
      * Function call operator.
      *
@@ -284,7 +219,7 @@ class CallbackImpl : public CallbackImplBase
      */
     R operator()(UArgs... uargs) const
     {
-        return m_func(uargs...);
+        return m_invoke(this, std::forward<UArgs>(uargs)...);
     }
 
     bool IsEqual(Ptr<const CallbackImplBase> other) const override
@@ -296,26 +231,27 @@ class CallbackImpl : public CallbackImplBase
         {
             return false;
         }
-
-        // if the two callback implementations are made of a distinct number of
-        // components, they are different
-        if (m_components.size() != otherDerived->GetComponents().size())
+        if (otherDerived == this)
         {
-            return false;
+            return true;
         }
 
-        // the two functions are equal if they compare equal or the shared pointers
-        // point to the same locations
-        if (!m_components.at(0)->IsEqual(otherDerived->GetComponents().at(0)) &&
-            m_components.at(0) != otherDerived->GetComponents().at(0))
+        CallbackComponentVector components;
+        CallbackComponentVector otherComponents;
+        GetComponents(components);
+        otherDerived->GetComponents(otherComponents);
+
+        // if the two callback implementations are made of a distinct number of
+        // components, they are different
+        if (components.size() != otherComponents.size())
         {
             return false;
         }
 
-        // check if the remaining components are equal one by one
-        for (std::size_t i = 1; i < m_components.size(); i++)
+        // check if the components are equal one by one
+        for (std::size_t i = 0; i < components.size(); i++)
         {
-            if (!m_components.at(i)->IsEqual(otherDerived->GetComponents().at(i)))
+            if (!components[i].IsEqual(otherComponents[i]))
             {
                 return false;
             }
@@ -348,12 +284,119 @@ class CallbackImpl : public CallbackImplBase
         return id;
     }
 
+  protected:
+    /** The type of the function which invokes the target of the callback. */
+    typedef R (*Invoker)(const CallbackImpl<R, UArgs...>* impl, UArgs... uargs);
+
+    /**
+     * Constructor.
+     *
+     * \param [in] invoke The function which invokes the target
+     */
+    CallbackImpl(Invoker invoke)
+        : m_invoke(invoke)
+    {
+    }
+
+  private:
+    /// Invokes the target of this callback
+    Invoker m_invoke;
+};
+
+/**
+ * \ingroup callbackimpl
+ * CallbackImpl storing a callable object and the values of the
+ * arguments bound to it.
+ *
+ * \tparam Signature \explicit The signature of the Callback, \c R(UArgs...).
+ * \tparam T \explicit The type of the callable object, which may be a
+ *         Callback whose first arguments are bound.
+ * \tparam BArgs \explicit The types of the bound arguments.
+ */
+template <typename Signature, typename T, typename... BArgs>
+class CallbackTargetImpl;
+
+/**
+ * \ingroup callbackimpl
+ * Partial specialization of CallbackTargetImpl which splits the
+ * signature into its return and argument types.
+ *
+ * \tparam R \explicit The return type of the Callback.
+ * \tparam UArgs \explicit The types of any arguments to the Callback.
+ * \tparam T \explicit The type of the callable object.
+ * \tparam BArgs \explicit The types of the bound arguments.
+ */
+template <typename R, typename... UArgs, typename T, typename... BArgs>
+class CallbackTargetImpl<R(UArgs...), T, BArgs...> : public CallbackImpl<R, UArgs...>
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \tparam F \deduced The type of the callable object argument
+     * \tparam BoundArgs \deduced The types of the bound argument values
+     * \param [in] func The callable object
+     * \param [in] bargs The values of the bound arguments
+     */
+    template <typename F, typename... BoundArgs>
+    CallbackTargetImpl(F&& func, BoundArgs&&... bargs)
+        : CallbackImpl<R, UArgs...>(&CallbackTargetImpl::Invoke),
+          m_func(std::forward<F>(func)),
+          m_bargs(std::forward<BoundArgs>(bargs)...)
+    {
+    }
+
+    void GetComponents(CallbackComponentVector& components) const override
+    {
+        if constexpr (std::is_base_of_v<CallbackBase, T>)
+        {
+            // A bound callback has the components of the original one
+            m_func.GetImpl()->GetComponents(components);
+        }
+        else
+        {
+            // The original function is comparable if it is a function pointer or
+            // a pointer to a member function or a pointer to a member data.
+            constexpr bool isComp =
+                std::is_function_v<std::remove_pointer_t<T>> || std::is_member_pointer_v<T>;
+            components.push_back(CallbackImplBase::MakeComponent<T, isComp>(m_func));
+        }
+        std::apply(
+            [&components](const BArgs&... bargs) {
+                (components.push_back(CallbackImplBase::MakeComponent<BArgs>(bargs)), ...);
+            },
+            m_bargs);
+    }
+
   private:
-    /// Stores the callable object associated with this callback (as a lambda)
-    std::function<R(UArgs...)> m_func;
+    /**
+     * Invoke the callable object with the bound and the actual arguments.
+     *
+     * \param [in] impl This callback
+     * \param [in] uargs The arguments to the Callback
+     * \return Callback value
+     */
+    static R Invoke(const CallbackImpl<R, UArgs...>* impl, UArgs... uargs)
+    {
+        auto self = static_cast<const CallbackTargetImpl*>(impl);
+        return std::apply(
+            [self, &uargs...](BArgs&... bargs) -> R {
+                if constexpr (std::is_void_v<R>)
+                {
+                    std::invoke(self->m_func, bargs..., std::forward<UArgs>(uargs)...);
+                }
+                else
+                {
+                    return std::invoke(self->m_func, bargs..., std::forward<UArgs>(uargs)...);
+                }
+            },
+            self->m_bargs);
+    }
 
-    /// Stores the original callable object and the bound arguments, if any
-    std::vector<std::shared_ptr<CallbackComponentBase>> m_components;
+    /// The callable object, which may keep a state across invocations
+    mutable T m_func;
+    /// The values of the bound arguments
+    mutable std::tuple<BArgs...> m_bargs;
 };
 
 /**
@@ -469,16 +512,10 @@ class Callback : public CallbackBase
     template <typename... BArgs>
     Callback(const Callback<R, BArgs..., UArgs...>& cb, BArgs... bargs)
     {
-        auto f = cb.DoPeekImpl()->GetFunction();
-
-        CallbackComponentVector components(cb.DoPeekImpl()->GetComponents());
-        components.insert(components.end(), {std::make_shared<CallbackComponent<BArgs>>(bargs)...});
-
-        m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        m_impl =
+            Create<CallbackTargetImpl<R(UArgs...), Callback<R, BArgs..., UArgs...>, BArgs...>>(
+                cb,
+                std::move(bargs)...);
     }
 
     /**
@@ -498,22 +535,8 @@ class Callback : public CallbackBase
               typename... BArgs>
     Callback(T func, BArgs... bargs)
     {
-        // store the function in a std::function object
-        std::function<R(BArgs..., UArgs...)> f(func);
-
-        // The original function is comparable if it is a function pointer or
-        // a pointer to a member function or a pointer to a member data.
-        constexpr bool isComp =
-            std::is_function_v<std::remove_pointer_t<T>> || std::is_member_pointer_v<T>;
-
-        CallbackComponentVector components({std::make_shared<CallbackComponent<T, isComp>>(func),
-                                            std::make_shared<CallbackComponent<BArgs>>(bargs)...});
-
-        m_impl = Create<CallbackImpl<R, UArgs...>>(
-            [f, bargs...](auto&&... uargs) -> R {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        m_impl = Create<CallbackTargetImpl<R(UArgs...), T, BArgs...>>(std::move(func),
+                                                                       std::move(bargs)...);
     }
 
   private:
@@ -533,17 +556,10 @@ class Callback : public CallbackBase
     {
         Callback<R, std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...> cb;
 
-        const auto f = DoPeekImpl()->GetFunction();
-
-        CallbackComponentVector components(DoPeekImpl()->GetComponents());
-        components.insert(components.end(),
-                          {std::make_shared<CallbackComponent<BoundArgs>>(bargs)...});
-
-        cb.m_impl = Create<std::remove_pointer_t<decltype(cb.DoPeekImpl())>>(
-            [f, bargs...](auto&&... uargs) mutable {
-                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
-            },
-            components);
+        cb.m_impl = Create<CallbackTargetImpl<
+            R(std::tuple_element_t<sizeof...(bargs) + INDEX, std::tuple<UArgs...>>...),
+            Callback<R, UArgs...>,
+            std::decay_t<BoundArgs>...>>(*this, std::forward<BoundArgs>(bargs)...);
 
         return cb;
     }
@@ -588,7 +604,7 @@ class Callback : public CallbackBase
      */
     R operator()(UArgs... uargs) const
     {
-        return (*(DoPeekImpl()))(uargs...);
+        return (*(DoPeekImpl()))(std::forward<UArgs>(uargs)...);
     }
 
     /**
@@ -752,6 +768,21 @@ MakeNullCallback()
     return Callback<R, Args...>();
 }
 
+/**
+ * \ingroup callbackimpl
+ * Declare the type of a Callback whose first arguments are bound,
+ * for use in unevaluated contexts only.
+ *
+ * \tparam N \explicit The number of bound arguments.
+ * \tparam R \explicit Return type of the callback.
+ * \tparam Args \explicit Type list of all the arguments of the function.
+ * \tparam INDEX \deduced The indices of the arguments left unbound.
+ * \return The Callback type, taking the arguments left unbound
+ */
+template <std::size_t N, typename R, typename... Args, std::size_t... INDEX>
+Callback<R, std::tuple_element_t<N + INDEX, std::tuple<Args...>>...> BoundCallbackType(
+    std::index_sequence<INDEX...>);
+
 /**
  * \ingroup makeboundcallback
  * @{
@@ -767,7 +798,9 @@ template <typename R, typename... Args, typename... BArgs>
 auto
 MakeBoundCallback(R (*fnPtr)(Args...), BArgs&&... bargs)
 {
-    return Callback<R, Args...>(fnPtr).Bind(std::forward<BArgs>(bargs)...);
+    using BoundCallback = decltype(BoundCallbackType<sizeof...(BArgs), R, Args...>(
+        std::make_index_sequence<sizeof...(Args) - sizeof...(BArgs)>{}));
+    return BoundCallback(fnPtr, std::forward<BArgs>(bargs)...);
 }
 
 /**
@@ -788,14 +821,18 @@ template <typename T, typename OBJ, typename R, typename... Args, typename... BA
 auto
 MakeCallback(R (T::*memPtr)(Args...), OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    using BoundCallback = decltype(BoundCallbackType<sizeof...(BArgs), R, Args...>(
+        std::make_index_sequence<sizeof...(Args) - sizeof...(BArgs)>{}));
+    return BoundCallback(memPtr, objPtr, bargs...);
 }
 
 template <typename T, typename OBJ, typename R, typename... Args, typename... BArgs>
 auto
 MakeCallback(R (T::*memPtr)(Args...) const, OBJ objPtr, BArgs... bargs)
 {
-    return Callback<R, Args...>(memPtr, objPtr).Bind(bargs...);
+    using BoundCallback = decltype(BoundCallbackType<sizeof...(BArgs), R, Args...>(
+        std::make_index_sequence<sizeof...(Args) - sizeof...(BArgs)>{}));
+    return BoundCallback(memPtr, objPtr, bargs...);
 }
 
 /**@}*/
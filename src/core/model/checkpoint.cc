@@ -0,0 +1,556 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "checkpoint.h"
+
+#include "command-line.h"
+#include "fatal-error.h"
+#include "log-binary.h"
+#include "log.h"
+#include "parameter-sweep.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulator-impl.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifndef __WIN32__
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Checkpoint");
+
+namespace
+{
+
+/** The path of the socket of the checkpoint, from \c --checkpoint. */
+std::string g_path;
+/** The time of the checkpoint, from \c --checkpointAt. */
+Time g_at;
+/** Whether to stop the simulation after the checkpoint, from \c --checkpointStop. */
+bool g_stop = false;
+/** The idle time of the checkpoint process, in seconds, from \c --checkpointIdle. */
+uint32_t g_idle = 0;
+
+/** Whether the checkpoint of the options is saved, or scheduled. */
+bool g_started = false;
+/** Whether the process is a restored copy of a checkpoint. */
+bool g_restored = false;
+
+/** The request to restore a checkpoint. */
+const std::string RESTORE = "restore";
+/** The request to stop a checkpoint process. */
+const std::string STOP = "stop";
+/** The number of file descriptors passed with a request to restore. */
+const int FDS = 3;
+
+/** Save the checkpoint of the options, and stop the simulation if requested. */
+void
+SaveOptions()
+{
+    Checkpoint::Save(g_path, g_idle);
+    if (g_stop && !Checkpoint::IsRestored())
+    {
+        Simulator::Stop();
+    }
+}
+
+#ifndef __WIN32__
+
+/**
+ * Get the address of a checkpoint socket.
+ * \param [in] path The path of the socket.
+ * \returns The address.
+ */
+sockaddr_un
+GetAddress(const std::string& path)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    NS_ABORT_MSG_IF(path.empty() || path.size() >= sizeof(address.sun_path),
+                    "Invalid checkpoint path \"" << path << "\": it must have 1 to "
+                                                 << sizeof(address.sun_path) - 1
+                                                 << " characters");
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+/**
+ * Write data to a socket.
+ * \param [in] fd The socket.
+ * \param [in] data The data.
+ * \param [in] size The size of the data.
+ * \returns \c true if all the data was written.
+ */
+bool
+WriteAll(int fd, const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+/**
+ * Send a request to a checkpoint process.
+ * \param [in] path The path of the socket of the checkpoint.
+ * \param [in] request The request.
+ * \param [in] fds Whether to pass the standard input, output and error.
+ * \returns The connected socket, to read the reply.
+ */
+int
+SendRequest(const std::string& path, const std::string& request, bool fds)
+{
+    sockaddr_un address = GetAddress(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    NS_ABORT_MSG_IF(fd < 0, "Can't create a socket: " << std::strerror(errno));
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        NS_FATAL_ERROR("No checkpoint at " << path << ": " << std::strerror(errno));
+    }
+
+    // The first byte carries the file descriptors
+    iovec iov{const_cast<char*>(request.data()), 1};
+    char control[CMSG_SPACE(sizeof(int) * FDS)] = {};
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    if (fds)
+    {
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * FDS);
+        int standard[FDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+        std::memcpy(CMSG_DATA(header), standard, sizeof(standard));
+    }
+    if (sendmsg(fd, &message, MSG_NOSIGNAL) != 1 ||
+        !WriteAll(fd, request.data() + 1, request.size() - 1))
+    {
+        NS_FATAL_ERROR("Can't send the request to the checkpoint at " << path << ": "
+                                                                       << std::strerror(errno));
+    }
+    shutdown(fd, SHUT_WR);
+    return fd;
+}
+
+/**
+ * Receive a request.
+ * \param [in] fd The connected socket.
+ * \param [out] fds The file descriptors passed with the request, or -1.
+ * \returns The lines of the request.
+ */
+std::vector<std::string>
+ReceiveRequest(int fd, int* fds)
+{
+    std::fill(fds, fds + FDS, -1);
+    char first;
+    iovec iov{&first, 1};
+    char control[CMSG_SPACE(sizeof(int) * FDS)] = {};
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(fd, &message, 0) != 1)
+    {
+        return {};
+    }
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (header != nullptr && header->cmsg_level == SOL_SOCKET &&
+        header->cmsg_type == SCM_RIGHTS && header->cmsg_len == CMSG_LEN(sizeof(int) * FDS))
+    {
+        std::memcpy(fds, CMSG_DATA(header), sizeof(int) * FDS);
+    }
+
+    std::string text(1, first);
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        text.append(buffer, size);
+    }
+    std::vector<std::string> lines;
+    std::istringstream is(text);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+/**
+ * Close file descriptors.
+ * \param [in] fds The file descriptors, or -1.
+ */
+void
+CloseAll(const int* fds)
+{
+    for (int i = 0; i < FDS; ++i)
+    {
+        if (fds[i] >= 0)
+        {
+            close(fds[i]);
+        }
+    }
+}
+
+/**
+ * Continue the simulation in a restored copy.
+ * \param [in] fds The standard input, output and error of the copy.
+ * \param [in] directory The working directory of the copy.
+ * \param [in] overrides The overrides of the copy.
+ */
+void
+SetUpRestored(const int* fds,
+              const std::string& directory,
+              const std::vector<std::string>& overrides)
+{
+    g_restored = true;
+    for (int i = 0; i < FDS; ++i)
+    {
+        dup2(fds[i], i);
+    }
+    CloseAll(fds);
+    if (chdir(directory.c_str()) != 0)
+    {
+        NS_FATAL_ERROR("Can't change to the directory " << directory << ": "
+                                                        << std::strerror(errno));
+    }
+    uint32_t seed = RngSeedManager::GetSeed();
+    uint64_t run = RngSeedManager::GetRun();
+    ParameterSweep::Apply(overrides);
+    if (RngSeedManager::GetSeed() != seed || RngSeedManager::GetRun() != run)
+    {
+        RandomVariableStream::ReseedAll();
+    }
+}
+
+/**
+ * Serve the requests of a checkpoint until it is stopped or idle.
+ *
+ * The function returns in the restored copies only.
+ * \param [in] listener The listening socket.
+ * \param [in] path The path of the socket.
+ * \param [in] idle The idle time, in seconds, or 0.
+ */
+void
+Serve(int listener, const std::string& path, uint32_t idle)
+{
+    // The intermediate processes which wait for the copies are reaped
+    std::signal(SIGCHLD, SIG_IGN);
+    while (true)
+    {
+        pollfd pfd{listener, POLLIN, 0};
+        int ready = poll(&pfd, 1, (idle == 0) ? -1 : static_cast<int>(idle) * 1000);
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ready <= 0)
+        {
+            unlink(path.c_str());
+            _exit(0);
+        }
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection < 0)
+        {
+            continue;
+        }
+        int fds[FDS];
+        std::vector<std::string> lines = ReceiveRequest(connection, fds);
+        if (!lines.empty() && lines[0] == STOP)
+        {
+            unlink(path.c_str());
+            int status = 0;
+            WriteAll(connection, reinterpret_cast<char*>(&status), sizeof(status));
+            _exit(0);
+        }
+        if (lines.size() < 2 || lines[0] != RESTORE || fds[0] < 0 || fork() != 0)
+        {
+            // Invalid request, or the server, which goes on
+            CloseAll(fds);
+            close(connection);
+            continue;
+        }
+
+        // The intermediate process, which waits for the copy
+        std::signal(SIGCHLD, SIG_DFL);
+        close(listener);
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(connection);
+            std::vector<std::string> overrides(lines.begin() + 2, lines.end());
+            SetUpRestored(fds, lines[1], overrides);
+            return;
+        }
+        CloseAll(fds);
+        int status = 127;
+        int waited = 0;
+        if (pid > 0 && waitpid(pid, &waited, 0) == pid)
+        {
+            status = WIFEXITED(waited) ? WEXITSTATUS(waited) : 128 + WTERMSIG(waited);
+        }
+        WriteAll(connection, reinterpret_cast<char*>(&status), sizeof(status));
+        _exit(0);
+    }
+}
+
+/**
+ * Get the number of threads of the process.
+ * \returns The number of threads, or 1 if it is unknown.
+ */
+uint32_t
+GetThreadCount()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 8, "Threads:") == 0)
+        {
+            return std::stoul(line.substr(8));
+        }
+    }
+    return 1;
+}
+
+#endif // __WIN32__
+
+} // unnamed namespace
+
+void
+Checkpoint::Enable(CommandLine& cmd)
+{
+    NS_LOG_FUNCTION(&cmd);
+    cmd.AddValue("checkpoint", "The path of the socket of a checkpoint to save", g_path);
+    cmd.AddValue("checkpointAt",
+                 "The simulation time of the checkpoint, 0 for the start of the run",
+                 g_at);
+    cmd.AddValue("checkpointStop", "Stop the simulation after the checkpoint is saved", g_stop);
+    cmd.AddValue("checkpointIdle",
+                 "The seconds without requests after which the checkpoint process exits, "
+                 "0 for never",
+                 g_idle);
+}
+
+void
+Checkpoint::Start()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_started || g_path.empty())
+    {
+        return;
+    }
+    g_started = true;
+    if (g_at > Simulator::Now())
+    {
+        Simulator::Schedule(g_at - Simulator::Now(), &SaveOptions);
+    }
+    else
+    {
+        SaveOptions();
+    }
+}
+
+std::vector<std::string>
+Checkpoint::GetUnsupported()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    std::vector<std::string> unsupported;
+#ifdef __WIN32__
+    unsupported.emplace_back("Windows, which has no fork()");
+#else
+    std::string impl = Simulator::GetImplementation()->GetInstanceTypeId().GetName();
+    if (impl != "ns3::DefaultSimulatorImpl")
+    {
+        unsupported.push_back("the simulator implementation " + impl +
+                              ", rather than the single-threaded ns3::DefaultSimulatorImpl");
+    }
+    if (LogIsBinaryEnabled())
+    {
+        unsupported.emplace_back("the writer thread of the binary log; call LogDisableBinary()");
+    }
+    uint32_t threads = GetThreadCount() - (LogIsBinaryEnabled() ? 1 : 0);
+    if (threads > 1)
+    {
+        unsupported.push_back(std::to_string(threads - 1) +
+                              " threads besides the simulation, such as those of emulation "
+                              "or tap devices");
+    }
+#endif
+    return unsupported;
+}
+
+void
+Checkpoint::Save(const std::string& path, uint32_t idle)
+{
+    NS_LOG_FUNCTION(path << idle);
+    std::vector<std::string> unsupported = GetUnsupported();
+    if (!unsupported.empty())
+    {
+        std::ostringstream oss;
+        for (const auto& item : unsupported)
+        {
+            oss << "\n  - " << item;
+        }
+        NS_FATAL_ERROR("Can't save a checkpoint at " << path << ", the process has" << oss.str());
+    }
+#ifndef __WIN32__
+    sockaddr_un address = GetAddress(path);
+    unlink(path.c_str());
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 ||
+        bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, SOMAXCONN) != 0)
+    {
+        NS_FATAL_ERROR("Can't listen on the checkpoint socket " << path << ": "
+                                                                 << std::strerror(errno));
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        NS_FATAL_ERROR("Can't fork the checkpoint process: " << std::strerror(errno));
+    }
+    if (pid > 0)
+    {
+        close(listener);
+        // The checkpoint process detaches, and the intermediate process exits
+        waitpid(pid, nullptr, 0);
+        NS_LOG_LOGIC("Saved the checkpoint at " << path << " at " << Simulator::Now());
+        return;
+    }
+
+    // Detach from the session and the outputs of the process, which may be
+    // pipes waiting for their end, and from its parent
+    setsid();
+    int null = open("/dev/null", O_RDWR);
+    if (null >= 0)
+    {
+        dup2(null, STDIN_FILENO);
+        dup2(null, STDOUT_FILENO);
+        dup2(null, STDERR_FILENO);
+        close(null);
+    }
+    if (fork() != 0)
+    {
+        _exit(0);
+    }
+    Serve(listener, path, idle);
+#endif // __WIN32__
+}
+
+bool
+Checkpoint::IsRestored()
+{
+    return g_restored;
+}
+
+int
+Checkpoint::Restore(const std::string& path, const std::vector<std::string>& overrides)
+{
+    NS_LOG_FUNCTION(path);
+#ifdef __WIN32__
+    NS_FATAL_ERROR("Checkpoints are not supported on Windows");
+    return 1;
+#else
+    char directory[4096];
+    NS_ABORT_MSG_IF(getcwd(directory, sizeof(directory)) == nullptr,
+                    "Can't get the working directory: " << std::strerror(errno));
+    std::string request = RESTORE + "\n" + directory + "\n";
+    for (const auto& item : overrides)
+    {
+        NS_ABORT_MSG_IF(item.find('=') == std::string::npos || item.find('\n') != std::string::npos,
+                        "Invalid override \"" << item << "\", expected name=value");
+        request += item + "\n";
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    int fd = SendRequest(path, request, true);
+    int status = 0;
+    ssize_t size = 0;
+    do
+    {
+        size = read(fd, &status, sizeof(status));
+    } while (size < 0 && errno == EINTR);
+    close(fd);
+    NS_ABORT_MSG_IF(size != sizeof(status),
+                    "The checkpoint at " << path << " didn't return the status of the restore");
+    return status;
+#endif // __WIN32__
+}
+
+void
+Checkpoint::Stop(const std::string& path)
+{
+    NS_LOG_FUNCTION(path);
+#ifdef __WIN32__
+    NS_FATAL_ERROR("Checkpoints are not supported on Windows");
+#else
+    int fd = SendRequest(path, STOP + "\n", false);
+    int status = 0;
+    while (read(fd, &status, sizeof(status)) < 0 && errno == EINTR)
+    {
+    }
+    close(fd);
+#endif // __WIN32__
+}
+
+} // namespace ns3
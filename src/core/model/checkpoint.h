@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3
+{
+
+class CommandLine;
+
+/**
+ * \ingroup core
+ * \brief Keep the state of a simulation at a point in time, and continue
+ * it later from that point in other processes.
+ *
+ * The pending events of a simulation hold arbitrary callbacks, and its
+ * objects arbitrary protocol state, which can't be written to a file in
+ * general.  A checkpoint keeps them instead in a dormant copy of the
+ * process: Save() forks a checkpoint process, which holds the whole state
+ * of the simulation, including the event queue and the positions of the
+ * random number streams, and listens on a Unix socket.  Each Restore()
+ * from another process forks the checkpoint process again, and the copy
+ * continues the simulation from the checkpoint with the standard input,
+ * output and error and the working directory of the restoring process,
+ * which gets its exit status.  The copies share the memory of the
+ * checkpoint copy-on-write, so restoring takes about the time of a fork.
+ *
+ * A script gains the checkpoint options with a single line before
+ * parsing its command line:
+ *
+ * \code
+ *   CommandLine cmd(__FILE__);
+ *   Checkpoint::Enable(cmd);
+ *   cmd.Parse(argc, argv);
+ * \endcode
+ *
+ * The options are
+ *
+ * - \c --checkpoint: the path of the socket of the checkpoint.
+ * - \c --checkpointAt: the simulation time of the checkpoint; by default,
+ *   the checkpoint is saved when Simulator::Run() starts.
+ * - \c --checkpointStop: stop the simulation after the checkpoint is saved,
+ *   rather than continue it.
+ * - \c --checkpointIdle: the number of seconds without requests after which
+ *   the checkpoint process exits, or 0 to keep it until Stop().
+ *
+ * and the \c restore-checkpoint utility restores a checkpoint, with
+ * overrides, or stops it:
+ *
+ * \code
+ *   $ ./my-script --checkpoint=warm.sock --checkpointAt=60s --checkpointStop
+ *   $ restore-checkpoint warm.sock RngRun=2 > run-2.txt
+ *   $ restore-checkpoint warm.sock RngRun=3 > run-3.txt
+ *   $ restore-checkpoint --stop warm.sock
+ * \endcode
+ *
+ * The overrides are applied as those of a ParameterSweep; when they change
+ * the seed or the run number, the random variable streams are restarted
+ * with them by RandomVariableStream::ReseedAll(), otherwise the simulation
+ * continues exactly as the process which saved the checkpoint.
+ *
+ * The checkpoint holds any model, but not the threads of the process,
+ * which fork() doesn't copy: the checkpoint is refused, with the list of
+ * the unsupported state from GetUnsupported(), with a multithreaded
+ * simulator implementation, a binary log, or other threads, such as those
+ * of the emulation and tap devices.  The files opened before the
+ * checkpoint are shared by the restored simulations, and the checkpoint
+ * doesn't outlive the machine.  Checkpoints are not supported on Windows.
+ */
+class Checkpoint
+{
+  public:
+    /**
+     * Add the checkpoint options to a command line.
+     *
+     * \param [in,out] cmd The command line.
+     */
+    static void Enable(CommandLine& cmd);
+
+    /**
+     * Save the checkpoint now, or schedule it at the time given by
+     * \c --checkpointAt, if \c --checkpoint is given.
+     *
+     * Called by Simulator::Run().
+     */
+    static void Start();
+
+    /**
+     * Save a checkpoint of the simulation.
+     *
+     * The function returns in the process, which continues the simulation,
+     * and in the restored copies, where IsRestored() is \c true.
+     *
+     * \param [in] path The path of the socket of the checkpoint.
+     * \param [in] idle The number of seconds without requests after which
+     *             the checkpoint process exits, or 0 to keep it until Stop().
+     */
+    static void Save(const std::string& path, uint32_t idle = 0);
+
+    /**
+     * Check if the process is a restored copy of a checkpoint.
+     *
+     * \returns \c true in the restored copies.
+     */
+    static bool IsRestored();
+
+    /**
+     * Get the state of the process which a checkpoint can't hold.
+     *
+     * \returns The descriptions of the unsupported state, which are empty
+     *          if a checkpoint can be saved.
+     */
+    static std::vector<std::string> GetUnsupported();
+
+    /**
+     * Continue the simulation of a checkpoint in a copy of the checkpoint
+     * process, and wait for its end.
+     *
+     * \param [in] path The path of the socket of the checkpoint.
+     * \param [in] overrides The \c name=value overrides of the copy.
+     * \returns The exit status of the copy, or 128 plus the number of the
+     *          signal which ended it.
+     */
+    static int Restore(const std::string& path, const std::vector<std::string>& overrides);
+
+    /**
+     * Stop a checkpoint process.
+     *
+     * The restored copies still running continue.
+     *
+     * \param [in] path The path of the socket of the checkpoint.
+     */
+    static void Stop(const std::string& path);
+
+}; // class Checkpoint
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
@@ -26,6 +26,8 @@
 #include "pointer.h"
 #include "singleton.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -197,10 +199,15 @@ MatchContainer::DisconnectWithoutContext(std::string name, const CallbackBase& c
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is decoded once, into a list of ranges of indexes.
  */
 class ArrayMatcher
 {
   public:
+    /** A range of indexes, with both bounds included. */
+    typedef std::pair<uint32_t, uint32_t> Range;
+
     /**
      * Construct from a Config path specification.
      *
@@ -214,8 +221,24 @@ class ArrayMatcher
      * \returns \c true if the index matches the Config Path.
      */
     bool Matches(std::size_t i) const;
+    /**
+     * \returns \c true if every index matches the Config Path.
+     */
+    bool MatchesAll() const;
+    /**
+     * Get the ranges of the indexes which match the Config Path.
+     *
+     * \returns The ranges, sorted and disjoint.
+     */
+    const std::vector<Range>& GetRanges() const;
 
   private:
+    /**
+     * Decode a Config path specification into ranges.
+     *
+     * \param [in] element The Config path specification.
+     */
+    void Parse(std::string element);
     /**
      * Convert a string to an \c uint32_t.
      *
@@ -226,77 +249,111 @@ class ArrayMatcher
     bool StringToUint32(std::string str, uint32_t* value) const;
     /** The Config path element. */
     std::string m_element;
+    /** Whether the element matches every index. */
+    bool m_all;
+    /** The ranges of matching indexes. */
+    std::vector<Range> m_ranges;
 
 }; // class ArrayMatcher
 
 ArrayMatcher::ArrayMatcher(std::string element)
-    : m_element(element)
+    : m_element(element),
+      m_all(false)
 {
     NS_LOG_FUNCTION(this << element);
+    Parse(element);
+    std::sort(m_ranges.begin(), m_ranges.end());
+    // merge the overlapping ranges
+    std::vector<Range> ranges;
+    for (const auto& range : m_ranges)
+    {
+        if (!ranges.empty() && range.first <= ranges.back().second)
+        {
+            ranges.back().second = std::max(ranges.back().second, range.second);
+        }
+        else
+        {
+            ranges.push_back(range);
+        }
+    }
+    m_ranges.swap(ranges);
 }
 
-bool
-ArrayMatcher::Matches(std::size_t i) const
+void
+ArrayMatcher::Parse(std::string element)
 {
-    NS_LOG_FUNCTION(this << i);
-    if (m_element == "*")
+    NS_LOG_FUNCTION(this << element);
+    if (element == "*")
     {
-        NS_LOG_DEBUG("Array " << i << " matches *");
-        return true;
+        m_all = true;
+        return;
     }
     std::string::size_type tmp;
-    tmp = m_element.find('|');
+    tmp = element.find('|');
     if (tmp != std::string::npos)
     {
-        std::string left = m_element.substr(0, tmp - 0);
-        std::string right = m_element.substr(tmp + 1, m_element.size() - (tmp + 1));
-        ArrayMatcher matcher = ArrayMatcher(left);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << left);
-            return true;
-        }
-        matcher = ArrayMatcher(right);
-        if (matcher.Matches(i))
-        {
-            NS_LOG_DEBUG("Array " << i << " matches " << right);
-            return true;
-        }
-        NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
-        return false;
+        std::string left = element.substr(0, tmp - 0);
+        std::string right = element.substr(tmp + 1, element.size() - (tmp + 1));
+        Parse(left);
+        Parse(right);
+        return;
     }
-    std::string::size_type leftBracket = m_element.find('[');
-    std::string::size_type rightBracket = m_element.find(']');
-    std::string::size_type dash = m_element.find('-');
-    if (leftBracket == 0 && rightBracket == m_element.size() - 1 && dash > leftBracket &&
+    std::string::size_type leftBracket = element.find('[');
+    std::string::size_type rightBracket = element.find(']');
+    std::string::size_type dash = element.find('-');
+    if (leftBracket == 0 && rightBracket == element.size() - 1 && dash > leftBracket &&
         dash < rightBracket)
     {
-        std::string lowerBound = m_element.substr(leftBracket + 1, dash - (leftBracket + 1));
-        std::string upperBound = m_element.substr(dash + 1, rightBracket - (dash + 1));
+        std::string lowerBound = element.substr(leftBracket + 1, dash - (leftBracket + 1));
+        std::string upperBound = element.substr(dash + 1, rightBracket - (dash + 1));
         uint32_t min;
         uint32_t max;
-        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && i >= min &&
-            i <= max)
+        if (StringToUint32(lowerBound, &min) && StringToUint32(upperBound, &max) && min <= max)
         {
-            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
-            return true;
-        }
-        else
-        {
-            NS_LOG_DEBUG("Array " << i << " does not " << m_element);
-            return false;
+            m_ranges.emplace_back(min, max);
         }
+        return;
     }
     uint32_t value;
-    if (StringToUint32(m_element, &value) && i == value)
+    if (StringToUint32(element, &value))
+    {
+        m_ranges.emplace_back(value, value);
+    }
+}
+
+bool
+ArrayMatcher::Matches(std::size_t i) const
+{
+    NS_LOG_FUNCTION(this << i);
+    if (m_all)
     {
-        NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+        NS_LOG_DEBUG("Array " << i << " matches *");
         return true;
     }
+    for (const auto& range : m_ranges)
+    {
+        if (i >= range.first && i <= range.second)
+        {
+            NS_LOG_DEBUG("Array " << i << " matches " << m_element);
+            return true;
+        }
+    }
     NS_LOG_DEBUG("Array " << i << " does not match " << m_element);
     return false;
 }
 
+bool
+ArrayMatcher::MatchesAll() const
+{
+    return m_all;
+}
+
+const std::vector<ArrayMatcher::Range>&
+ArrayMatcher::GetRanges() const
+{
+    return m_ranges;
+}
+
 bool
 ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
 {
@@ -307,6 +364,205 @@ ArrayMatcher::StringToUint32(std::string str, uint32_t* value) const
     return !iss.bad() && !iss.fail();
 }
 
+/**
+ * \ingroup config-impl
+ * A parsed segment of a Config path.
+ */
+struct Path::Segment
+{
+    /**
+     * Parse a segment.
+     *
+     * \param [in] segment The text of the segment.
+     */
+    Segment(std::string segment);
+
+    /** The text of the segment. */
+    std::string item;
+    /** Whether the segment starts the "/Names" namespace. */
+    bool names;
+    /** Whether the segment is a GetObject, <tt>$TypeId</tt>. */
+    bool getObject;
+    /** Whether \c tid has been found, for a GetObject segment. */
+    bool tidFound;
+    /** The TypeId of a GetObject segment. */
+    TypeId tid;
+    /** The segment, as an array specification. */
+    ArrayMatcher matcher;
+};
+
+Path::Segment::Segment(std::string segment)
+    : item(segment),
+      names(segment.compare(0, 5, "Names") == 0),
+      getObject(segment.find('$') == 0),
+      tidFound(false),
+      matcher(segment)
+{
+    if (getObject)
+    {
+        tidFound = TypeId::LookupByNameFailSafe(item.substr(1, item.size() - 1), &tid);
+    }
+}
+
+Path::Path(std::string path)
+    : m_path(path),
+      m_segments(Parse(path)),
+      m_hasLeaf(false)
+{
+    NS_LOG_FUNCTION(this << path);
+    std::string::size_type slash = path.find_last_of('/');
+    if (slash != std::string::npos)
+    {
+        m_hasLeaf = true;
+        m_parentPath = path.substr(0, slash);
+        m_parentSegments = Parse(m_parentPath);
+        m_leaf = path.substr(slash + 1, path.size() - (slash + 1));
+    }
+}
+
+Path::Path(const Path& other) = default;
+
+Path&
+Path::operator=(const Path& other) = default;
+
+Path::~Path() = default;
+
+std::string
+Path::GetString() const
+{
+    return m_path;
+}
+
+std::vector<Path::Segment>
+Path::Parse(std::string path)
+{
+    NS_LOG_FUNCTION(path);
+
+    // ensure that we start and end with a '/'
+    std::string::size_type tmp = path.find('/');
+    if (tmp != 0)
+    {
+        // no slash at start
+        path = "/" + path;
+    }
+    tmp = path.find_last_of('/');
+    if (tmp != (path.size() - 1))
+    {
+        // no slash at end
+        path = path + "/";
+    }
+
+    std::vector<Segment> segments;
+    std::string::size_type start = 1;
+    std::string::size_type next;
+    while ((next = path.find('/', start)) != std::string::npos)
+    {
+        segments.emplace_back(path.substr(start, next - start));
+        start = next + 1;
+    }
+    return segments;
+}
+
+/**
+ * \ingroup config-impl
+ * An attribute through which a Config path segment leads to other objects.
+ */
+struct PathAttribute
+{
+    /** The attribute name. */
+    std::string name;
+    /** Whether the attribute is an ObjectPtrContainer, or else a Pointer. */
+    bool container;
+    /** Whether the attribute can be read through \c accessor. */
+    bool gettable;
+    /** The accessor of the attribute. */
+    Ptr<const AttributeAccessor> accessor;
+    /** The accessor as container accessor, if it is one. */
+    const ObjectPtrContainerAccessor* containerAccessor;
+};
+
+/**
+ * \ingroup config-impl
+ * Index of the attributes which Config path segments match, by TypeId
+ * and segment.
+ *
+ * Resolving a segment on an object walks the attributes of its TypeId
+ * and of its parents; the index does it once per TypeId and segment,
+ * rather than once per object.
+ */
+class AttributeIndex
+{
+  public:
+    /**
+     * Get the Pointer and ObjectPtrContainer attributes which a segment
+     * matches on the objects of a TypeId.
+     *
+     * \param [in] tid The TypeId of the object.
+     * \param [in] item The segment: an attribute name, or \c *.
+     * \returns The attributes, from the TypeId to its parents.
+     */
+    const std::vector<PathAttribute>& Lookup(TypeId tid, const std::string& item);
+
+  private:
+    /** The attributes, by TypeId uid and segment. */
+    std::map<std::pair<uint16_t, std::string>, std::vector<PathAttribute>> m_attributes;
+};
+
+const std::vector<PathAttribute>&
+AttributeIndex::Lookup(TypeId tid, const std::string& item)
+{
+    NS_LOG_FUNCTION(this << tid << item);
+    auto key = std::make_pair(tid.GetUid(), item);
+    auto found = m_attributes.find(key);
+    if (found != m_attributes.end())
+    {
+        return found->second;
+    }
+
+    std::vector<PathAttribute>& attributes = m_attributes[key];
+    TypeId current;
+    TypeId next = tid;
+    do
+    {
+        current = next;
+        for (uint32_t i = 0; i < current.GetAttributeN(); i++)
+        {
+            struct TypeId::AttributeInformation info = current.GetAttribute(i);
+            if (info.name != item && item != "*")
+            {
+                continue;
+            }
+            PathAttribute attribute;
+            attribute.name = info.name;
+            if (dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) != nullptr)
+            {
+                attribute.container = false;
+            }
+            else if (dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker)) !=
+                     nullptr)
+            {
+                attribute.container = true;
+            }
+            else
+            {
+                // this could be anything else and we don't know what to do with it.
+                // So, we just ignore it.
+                continue;
+            }
+            // The attribute is read by name, as ObjectBase::GetAttribute would
+            struct TypeId::AttributeInformation named;
+            tid.LookupAttributeByName(info.name, &named);
+            attribute.accessor = named.accessor;
+            attribute.gettable = (named.flags & TypeId::ATTR_GET) && named.accessor->HasGetter();
+            attribute.containerAccessor =
+                dynamic_cast<const ObjectPtrContainerAccessor*>(PeekPointer(named.accessor));
+            attributes.push_back(attribute);
+        }
+        next = current.GetParent();
+    } while (next != current);
+    return attributes;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -315,11 +571,12 @@ class Resolver
 {
   public:
     /**
-     * Construct from a base Config path.
+     * Construct from the segments of a Config path.
      *
-     * \param [in] path The Config path.
+     * \param [in] segments The segments of the Config path.
+     * \param [in,out] index The index of the attributes of the segments.
      */
-    Resolver(std::string path);
+    Resolver(const std::vector<Path::Segment>& segments, AttributeIndex& index);
     /** Destructor. */
     virtual ~Resolver();
 
@@ -333,23 +590,38 @@ class Resolver
     void Resolve(Ptr<Object> root);
 
   private:
-    /** Ensure the Config path starts and ends with a '/'. */
-    void Canonicalize();
     /**
      * Parse the next element in the Config path.
      *
-     * \param [in] path The remaining portion of the Config path.
+     * \param [in] segment The index of the next segment of the Config path.
      * \param [in] root The object corresponding to the current position
      *                  in the Config path.
      */
-    void DoResolve(std::string path, Ptr<Object> root);
+    void DoResolve(std::size_t segment, Ptr<Object> root);
     /**
      * Parse an index on the Config path.
      *
-     * \param [in] path The remaining Config path.
-     * \param [in,out] vector The resulting list of matching objects.
+     * \param [in] segment The index of the next segment of the Config path.
+     * \param [in] attribute The container attribute.
+     * \param [in] root The object which holds the container.
      */
-    void DoArrayResolve(std::string path, const ObjectPtrContainerValue& vector);
+    void DoArrayResolve(std::size_t segment,
+                        const PathAttribute& attribute,
+                        Ptr<Object> root);
+    /**
+     * Parse an index on the Config path, fetching only the matching
+     * objects of the container.
+     *
+     * \param [in] segment The index of the next segment of the Config path.
+     * \param [in] accessor The accessor of the container.
+     * \param [in] root The object which holds the container.
+     * \returns \c false if the positions of the objects in the container
+     *          are not their indexes, so that the matching objects could
+     *          not be fetched directly.
+     */
+    bool DoDirectArrayResolve(std::size_t segment,
+                              const ObjectPtrContainerAccessor* accessor,
+                              Ptr<Object> root);
     /**
      * Handle one object found on the path.
      *
@@ -372,16 +644,24 @@ class Resolver
 
     /** Current list of path tokens. */
     std::vector<std::string> m_workStack;
-    /** The Config path. */
-    std::string m_path;
+    /** The segments of the Config path. */
+    const std::vector<Path::Segment>& m_segments;
+    /** The index of the attributes of the segments. */
+    AttributeIndex& m_index;
+    /**
+     * The last attributes looked up in the index for each segment,
+     * with the uid of their TypeId.
+     */
+    std::vector<std::pair<uint16_t, const std::vector<PathAttribute>*>> m_lastAttributes;
 
 }; // class Resolver
 
-Resolver::Resolver(std::string path)
-    : m_path(path)
+Resolver::Resolver(const std::vector<Path::Segment>& segments, AttributeIndex& index)
+    : m_segments(segments),
+      m_index(index),
+      m_lastAttributes(segments.size(), {0, nullptr})
 {
-    NS_LOG_FUNCTION(this << path);
-    Canonicalize();
+    NS_LOG_FUNCTION(this << &segments << &index);
 }
 
 Resolver::~Resolver()
@@ -389,32 +669,12 @@ Resolver::~Resolver()
     NS_LOG_FUNCTION(this);
 }
 
-void
-Resolver::Canonicalize()
-{
-    NS_LOG_FUNCTION(this);
-
-    // ensure that we start and end with a '/'
-    std::string::size_type tmp = m_path.find('/');
-    if (tmp != 0)
-    {
-        // no slash at start
-        m_path = "/" + m_path;
-    }
-    tmp = m_path.find_last_of('/');
-    if (tmp != (m_path.size() - 1))
-    {
-        // no slash at end
-        m_path = m_path + "/";
-    }
-}
-
 void
 Resolver::Resolve(Ptr<Object> root)
 {
     NS_LOG_FUNCTION(this << root);
 
-    DoResolve(m_path, root);
+    DoResolve(0, root);
 }
 
 std::string
@@ -441,13 +701,11 @@ Resolver::DoResolveOne(Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve(std::string path, Ptr<Object> root)
+Resolver::DoResolve(std::size_t segment, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << root);
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
+    NS_LOG_FUNCTION(this << segment << root);
 
-    if (next == std::string::npos)
+    if (segment == m_segments.size())
     {
         //
         // If root is zero, we're beginning to see if we can use the object name
@@ -463,8 +721,8 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
         }
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
+    const Path::Segment& current = m_segments[segment];
+    const std::string& item = current.item;
 
     //
     // If root is zero, we're beginning to see if we can use the object name
@@ -473,16 +731,12 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     // the root of the "/Names" namespace, so we just ignore it and move on to
     // the next segment.
     //
-    if (!root)
+    if (!root && current.names)
     {
-        std::string::size_type offset = path.find("/Names");
-        if (offset == 0)
-        {
-            m_workStack.push_back(item);
-            DoResolve(pathLeft, root);
-            m_workStack.pop_back();
-            return;
-        }
+        m_workStack.push_back(item);
+        DoResolve(segment + 1, root);
+        m_workStack.pop_back();
+        return;
     }
 
     //
@@ -496,7 +750,7 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         NS_LOG_DEBUG("Name system resolved item = " << item << " to " << namedObject);
         m_workStack.push_back(item);
-        DoResolve(pathLeft, namedObject);
+        DoResolve(segment + 1, namedObject);
         m_workStack.pop_back();
         return;
     }
@@ -512,85 +766,75 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
     {
         return;
     }
-    std::string::size_type dollarPos = item.find('$');
-    if (dollarPos == 0)
+    if (current.getObject)
     {
         // This is a call to GetObject
-        std::string tidString = item.substr(1, item.size() - 1);
-        NS_LOG_DEBUG("GetObject=" << tidString << " on path=" << GetResolvedPath());
-        TypeId tid = TypeId::LookupByName(tidString);
+        NS_LOG_DEBUG("GetObject=" << item << " on path=" << GetResolvedPath());
+        TypeId tid = current.tid;
+        if (!current.tidFound)
+        {
+            // Let TypeId::LookupByName raise the error
+            tid = TypeId::LookupByName(item.substr(1, item.size() - 1));
+        }
         Ptr<Object> object = root->GetObject<Object>(tid);
         if (!object)
         {
-            NS_LOG_DEBUG("GetObject (" << tidString << ") failed on path=" << GetResolvedPath());
+            NS_LOG_DEBUG("GetObject (" << item << ") failed on path=" << GetResolvedPath());
             return;
         }
         m_workStack.push_back(item);
-        DoResolve(pathLeft, object);
+        DoResolve(segment + 1, object);
         m_workStack.pop_back();
     }
     else
     {
         // this is a normal attribute.
-        TypeId tid;
-        TypeId nextTid = root->GetInstanceTypeId();
+        TypeId tid = root->GetInstanceTypeId();
+        auto& last = m_lastAttributes[segment];
+        if (last.second == nullptr || last.first != tid.GetUid())
+        {
+            last.first = tid.GetUid();
+            last.second = &m_index.Lookup(tid, item);
+        }
+        const std::vector<PathAttribute>& attributes = *last.second;
         bool foundMatch = false;
 
-        do
+        for (const auto& attribute : attributes)
         {
-            tid = nextTid;
-
-            for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+            if (!attribute.container)
             {
-                struct TypeId::AttributeInformation info;
-                info = tid.GetAttribute(i);
-                if (info.name != item && item != "*")
+                NS_LOG_DEBUG("GetAttribute(ptr)=" << attribute.name
+                                                  << " on path=" << GetResolvedPath());
+                PointerValue pValue;
+                if (!attribute.gettable || !attribute.accessor->Get(PeekPointer(root), pValue))
                 {
-                    continue;
+                    // Let ObjectBase::GetAttribute raise any errors
+                    root->GetAttribute(attribute.name, pValue);
                 }
-                // attempt to cast to a pointer checker.
-                const PointerChecker* pChecker =
-                    dynamic_cast<const PointerChecker*>(PeekPointer(info.checker));
-                if (pChecker != nullptr)
+                Ptr<Object> object = pValue.Get<Object>();
+                if (!object)
                 {
-                    NS_LOG_DEBUG("GetAttribute(ptr)=" << info.name
-                                                      << " on path=" << GetResolvedPath());
-                    PointerValue pValue;
-                    root->GetAttribute(info.name, pValue);
-                    Ptr<Object> object = pValue.Get<Object>();
-                    if (!object)
-                    {
-                        NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
-                                                                << GetResolvedPath()
-                                                                << "\""
-                                                                   " but is null.");
-                        continue;
-                    }
-                    foundMatch = true;
-                    m_workStack.push_back(info.name);
-                    DoResolve(pathLeft, object);
-                    m_workStack.pop_back();
-                }
-                // attempt to cast to an object vector.
-                const ObjectPtrContainerChecker* vectorChecker =
-                    dynamic_cast<const ObjectPtrContainerChecker*>(PeekPointer(info.checker));
-                if (vectorChecker != nullptr)
-                {
-                    NS_LOG_DEBUG("GetAttribute(vector)=" << info.name << " on path="
-                                                         << GetResolvedPath() << pathLeft);
-                    foundMatch = true;
-                    ObjectPtrContainerValue vector;
-                    root->GetAttribute(info.name, vector);
-                    m_workStack.push_back(info.name);
-                    DoArrayResolve(pathLeft, vector);
-                    m_workStack.pop_back();
+                    NS_LOG_ERROR("Requested object name=\"" << item << "\" exists on path=\""
+                                                            << GetResolvedPath()
+                                                            << "\""
+                                                               " but is null.");
+                    continue;
                 }
-                // this could be anything else and we don't know what to do with it.
-                // So, we just ignore it.
+                foundMatch = true;
+                m_workStack.push_back(attribute.name);
+                DoResolve(segment + 1, object);
+                m_workStack.pop_back();
             }
-
-            nextTid = tid.GetParent();
-        } while (nextTid != tid);
+            else
+            {
+                NS_LOG_DEBUG("GetAttribute(vector)=" << attribute.name
+                                                     << " on path=" << GetResolvedPath());
+                foundMatch = true;
+                m_workStack.push_back(attribute.name);
+                DoArrayResolve(segment + 1, attribute, root);
+                m_workStack.pop_back();
+            }
+        }
 
         if (!foundMatch)
         {
@@ -602,34 +846,96 @@ Resolver::DoResolve(std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve(std::string path, const ObjectPtrContainerValue& container)
+Resolver::DoArrayResolve(std::size_t segment, const PathAttribute& attribute, Ptr<Object> root)
 {
-    NS_LOG_FUNCTION(this << path << &container);
-    NS_ASSERT(!path.empty());
-    NS_ASSERT((path.find('/')) == 0);
-    std::string::size_type next = path.find('/', 1);
-    if (next == std::string::npos)
+    NS_LOG_FUNCTION(this << segment << attribute.name << root);
+    if (segment == m_segments.size())
     {
         return;
     }
-    std::string item = path.substr(1, next - 1);
-    std::string pathLeft = path.substr(next, path.size() - next);
 
-    ArrayMatcher matcher = ArrayMatcher(item);
+    if (attribute.gettable && attribute.containerAccessor != nullptr &&
+        DoDirectArrayResolve(segment, attribute.containerAccessor, root))
+    {
+        return;
+    }
+
+    ObjectPtrContainerValue container;
+    root->GetAttribute(attribute.name, container);
+    const ArrayMatcher& matcher = m_segments[segment].matcher;
     ObjectPtrContainerValue::Iterator it;
     for (it = container.Begin(); it != container.End(); ++it)
     {
         if (matcher.Matches((*it).first))
         {
-            std::ostringstream oss;
-            oss << (*it).first;
-            m_workStack.push_back(oss.str());
-            DoResolve(pathLeft, (*it).second);
+            m_workStack.push_back(std::to_string((*it).first));
+            DoResolve(segment + 1, (*it).second);
             m_workStack.pop_back();
         }
     }
 }
 
+bool
+Resolver::DoDirectArrayResolve(std::size_t segment,
+                               const ObjectPtrContainerAccessor* accessor,
+                               Ptr<Object> root)
+{
+    NS_LOG_FUNCTION(this << segment << accessor << root);
+    std::size_t n;
+    if (!accessor->GetN(PeekPointer(root), &n))
+    {
+        return false;
+    }
+
+    // Fetch the matching objects first, so that we can fall back to a
+    // copy of the whole container before resolving anything
+    const ArrayMatcher& matcher = m_segments[segment].matcher;
+    std::vector<Ptr<Object>> objects;
+    std::vector<std::size_t> indexes;
+    auto fetch = [&](std::size_t i) {
+        std::size_t index;
+        Ptr<Object> object = accessor->GetItem(PeekPointer(root), i, &index);
+        if (index != i)
+        {
+            return false;
+        }
+        objects.push_back(object);
+        indexes.push_back(i);
+        return true;
+    };
+    if (matcher.MatchesAll())
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            if (!fetch(i))
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        for (const auto& range : matcher.GetRanges())
+        {
+            for (std::size_t i = range.first; i <= range.second && i < n; i++)
+            {
+                if (!fetch(i))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < objects.size(); i++)
+    {
+        m_workStack.push_back(std::to_string(indexes[i]));
+        DoResolve(segment + 1, objects[i]);
+        m_workStack.pop_back();
+    }
+    return true;
+}
+
 /**
  * \ingroup config-impl
  * Config system implementation class.
@@ -639,20 +945,20 @@ class ConfigImpl : public Singleton<ConfigImpl>
   public:
     // Keep Set and SetFailSafe since their errors are triggered
     // by the underlying ObjectBase functions.
-    /** \copydoc ns3::Config::Set() */
-    void Set(std::string path, const AttributeValue& value);
-    /** \copydoc ns3::Config::SetFailSafe() */
-    bool SetFailSafe(std::string path, const AttributeValue& value);
-    /** \copydoc ns3::Config::ConnectWithoutContextFailSafe() */
-    bool ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::ConnectFailSafe() */
-    bool ConnectFailSafe(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::DisconnectWithoutContext() */
-    void DisconnectWithoutContext(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::Disconnect() */
-    void Disconnect(std::string path, const CallbackBase& cb);
-    /** \copydoc ns3::Config::LookupMatches() */
-    MatchContainer LookupMatches(std::string path);
+    /** \copydoc ns3::Config::Set(const Path&,const AttributeValue&) */
+    void Set(const Path& path, const AttributeValue& value);
+    /** \copydoc ns3::Config::SetFailSafe(const Path&,const AttributeValue&) */
+    bool SetFailSafe(const Path& path, const AttributeValue& value);
+    /** \copydoc ns3::Config::ConnectWithoutContextFailSafe(const Path&,const CallbackBase&) */
+    bool ConnectWithoutContextFailSafe(const Path& path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::ConnectFailSafe(const Path&,const CallbackBase&) */
+    bool ConnectFailSafe(const Path& path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::DisconnectWithoutContext(const Path&,const CallbackBase&) */
+    void DisconnectWithoutContext(const Path& path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::Disconnect(const Path&,const CallbackBase&) */
+    void Disconnect(const Path& path, const CallbackBase& cb);
+    /** \copydoc ns3::Config::LookupMatches(const Path&) */
+    MatchContainer LookupMatches(const Path& path);
 
     /** \copydoc ns3::Config::RegisterRootNamespaceObject() */
     void RegisterRootNamespaceObject(Ptr<Object> obj);
@@ -666,128 +972,127 @@ class ConfigImpl : public Singleton<ConfigImpl>
 
   private:
     /**
-     * Break a Config path into the leading path and the last leaf token.
+     * Find the objects designated by the leading part of a Config path,
+     * up to the final slash.
+     *
+     * \param [in] path The Config path.
+     * \returns A container which contains all the matching objects.
+     */
+    MatchContainer LookupParentMatches(const Path& path);
+    /**
+     * Find the objects designated by a list of Config path segments.
+     *
+     * \param [in] segments The segments of the Config path.
      * \param [in] path The Config path.
-     * \param [in,out] root The leading part of the \pname{path},
-     *   up to the final slash.
-     * \param [in,out] leaf The trailing part of the \pname{path}.
+     * \returns A container which contains all the matching objects.
      */
-    void ParsePath(std::string path, std::string* root, std::string* leaf) const;
+    MatchContainer DoLookupMatches(const std::vector<Path::Segment>& segments, std::string path);
 
     /** Container type to hold the root Config path tokens. */
     typedef std::vector<Ptr<Object>> Roots;
 
     /** The list of Config path roots. */
     Roots m_roots;
+    /** The index of the attributes of the Config path segments. */
+    AttributeIndex m_index;
 
 }; // class ConfigImpl
 
-void
-ConfigImpl::ParsePath(std::string path, std::string* root, std::string* leaf) const
+MatchContainer
+ConfigImpl::LookupParentMatches(const Path& path)
 {
-    NS_LOG_FUNCTION(this << path << root << leaf);
-
-    std::string::size_type slash = path.find_last_of('/');
-    NS_ASSERT(slash != std::string::npos);
-    *root = path.substr(0, slash);
-    *leaf = path.substr(slash + 1, path.size() - (slash + 1));
-    NS_LOG_FUNCTION(path << *root << *leaf);
+    NS_LOG_FUNCTION(this << path.GetString());
+    NS_ASSERT(path.m_hasLeaf);
+    return DoLookupMatches(path.m_parentSegments, path.m_parentPath);
 }
 
 void
-ConfigImpl::Set(std::string path, const AttributeValue& value)
+ConfigImpl::Set(const Path& path, const AttributeValue& value)
 {
-    NS_LOG_FUNCTION(this << path << &value);
+    NS_LOG_FUNCTION(this << path.GetString() << &value);
 
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    container.Set(leaf, value);
+    MatchContainer container = LookupParentMatches(path);
+    container.Set(path.m_leaf, value);
 }
 
 bool
-ConfigImpl::SetFailSafe(std::string path, const AttributeValue& value)
+ConfigImpl::SetFailSafe(const Path& path, const AttributeValue& value)
 {
-    NS_LOG_FUNCTION(this << path << &value);
+    NS_LOG_FUNCTION(this << path.GetString() << &value);
 
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.SetFailSafe(leaf, value);
+    MatchContainer container = LookupParentMatches(path);
+    return container.SetFailSafe(path.m_leaf, value);
 }
 
 bool
-ConfigImpl::ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb)
+ConfigImpl::ConnectWithoutContextFailSafe(const Path& path, const CallbackBase& cb)
 {
-    NS_LOG_FUNCTION(this << path << &cb);
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.ConnectWithoutContextFailSafe(leaf, cb);
+    NS_LOG_FUNCTION(this << path.GetString() << &cb);
+    MatchContainer container = LookupParentMatches(path);
+    return container.ConnectWithoutContextFailSafe(path.m_leaf, cb);
 }
 
 void
-ConfigImpl::DisconnectWithoutContext(std::string path, const CallbackBase& cb)
+ConfigImpl::DisconnectWithoutContext(const Path& path, const CallbackBase& cb)
 {
-    NS_LOG_FUNCTION(this << path << &cb);
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
+    NS_LOG_FUNCTION(this << path.GetString() << &cb);
+    MatchContainer container = LookupParentMatches(path);
     if (container.GetN() == 0)
     {
+        const std::string& root = path.m_parentPath;
         std::size_t lastFwdSlash = root.rfind('/');
         NS_LOG_WARN("Failed to disconnect "
-                    << leaf << ", the Requested object name = " << root.substr(lastFwdSlash + 1)
-                    << " does not exits on path " << root.substr(0, lastFwdSlash));
+                    << path.m_leaf << ", the Requested object name = "
+                    << root.substr(lastFwdSlash + 1) << " does not exits on path "
+                    << root.substr(0, lastFwdSlash));
     }
-    container.DisconnectWithoutContext(leaf, cb);
+    container.DisconnectWithoutContext(path.m_leaf, cb);
 }
 
 bool
-ConfigImpl::ConnectFailSafe(std::string path, const CallbackBase& cb)
+ConfigImpl::ConnectFailSafe(const Path& path, const CallbackBase& cb)
 {
-    NS_LOG_FUNCTION(this << path << &cb);
+    NS_LOG_FUNCTION(this << path.GetString() << &cb);
 
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
-    return container.ConnectFailSafe(leaf, cb);
+    MatchContainer container = LookupParentMatches(path);
+    return container.ConnectFailSafe(path.m_leaf, cb);
 }
 
 void
-ConfigImpl::Disconnect(std::string path, const CallbackBase& cb)
+ConfigImpl::Disconnect(const Path& path, const CallbackBase& cb)
 {
-    NS_LOG_FUNCTION(this << path << &cb);
+    NS_LOG_FUNCTION(this << path.GetString() << &cb);
 
-    std::string root;
-    std::string leaf;
-    ParsePath(path, &root, &leaf);
-    MatchContainer container = LookupMatches(root);
+    MatchContainer container = LookupParentMatches(path);
     if (container.GetN() == 0)
     {
+        const std::string& root = path.m_parentPath;
         std::size_t lastFwdSlash = root.rfind('/');
         NS_LOG_WARN("Failed to disconnect "
-                    << leaf << ", the Requested object name = " << root.substr(lastFwdSlash + 1)
-                    << " does not exits on path " << root.substr(0, lastFwdSlash));
+                    << path.m_leaf << ", the Requested object name = "
+                    << root.substr(lastFwdSlash + 1) << " does not exits on path "
+                    << root.substr(0, lastFwdSlash));
     }
-    container.Disconnect(leaf, cb);
+    container.Disconnect(path.m_leaf, cb);
 }
 
 MatchContainer
-ConfigImpl::LookupMatches(std::string path)
+ConfigImpl::LookupMatches(const Path& path)
 {
-    NS_LOG_FUNCTION(this << path);
+    NS_LOG_FUNCTION(this << path.GetString());
+    return DoLookupMatches(path.m_segments, path.m_path);
+}
+
+MatchContainer
+ConfigImpl::DoLookupMatches(const std::vector<Path::Segment>& segments, std::string path)
+{
+    NS_LOG_FUNCTION(this << &segments << path);
 
     class LookupMatchesResolver : public Resolver
     {
       public:
-        LookupMatchesResolver(std::string path)
-            : Resolver(path)
+        LookupMatchesResolver(const std::vector<Path::Segment>& segments, AttributeIndex& index)
+            : Resolver(segments, index)
         {
         }
 
@@ -799,7 +1104,7 @@ ConfigImpl::LookupMatches(std::string path)
 
         std::vector<Ptr<Object>> m_objects;
         std::vector<std::string> m_contexts;
-    } resolver = LookupMatchesResolver(path);
+    } resolver = LookupMatchesResolver(segments, m_index);
 
     for (Roots::const_iterator i = m_roots.begin(); i != m_roots.end(); i++)
     {
@@ -877,14 +1182,14 @@ void
 Set(std::string path, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(path << &value);
-    ConfigImpl::Get()->Set(path, value);
+    ConfigImpl::Get()->Set(Path(path), value);
 }
 
 bool
 SetFailSafe(std::string path, const AttributeValue& value)
 {
     NS_LOG_FUNCTION(path << &value);
-    return ConfigImpl::Get()->SetFailSafe(path, value);
+    return ConfigImpl::Get()->SetFailSafe(Path(path), value);
 }
 
 void
@@ -961,14 +1266,14 @@ bool
 ConnectWithoutContextFailSafe(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(path << &cb);
-    return ConfigImpl::Get()->ConnectWithoutContextFailSafe(path, cb);
+    return ConfigImpl::Get()->ConnectWithoutContextFailSafe(Path(path), cb);
 }
 
 void
 DisconnectWithoutContext(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(path << &cb);
-    ConfigImpl::Get()->DisconnectWithoutContext(path, cb);
+    ConfigImpl::Get()->DisconnectWithoutContext(Path(path), cb);
 }
 
 void
@@ -985,23 +1290,92 @@ bool
 ConnectFailSafe(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(path << &cb);
-    return ConfigImpl::Get()->ConnectFailSafe(path, cb);
+    return ConfigImpl::Get()->ConnectFailSafe(Path(path), cb);
 }
 
 void
 Disconnect(std::string path, const CallbackBase& cb)
 {
     NS_LOG_FUNCTION(path << &cb);
-    ConfigImpl::Get()->Disconnect(path, cb);
+    ConfigImpl::Get()->Disconnect(Path(path), cb);
 }
 
 MatchContainer
 LookupMatches(std::string path)
 {
     NS_LOG_FUNCTION(path);
+    return ConfigImpl::Get()->LookupMatches(Path(path));
+}
+
+MatchContainer
+LookupMatches(const Path& path)
+{
+    NS_LOG_FUNCTION(path.GetString());
     return ConfigImpl::Get()->LookupMatches(path);
 }
 
+void
+Set(const Path& path, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(path.GetString() << &value);
+    ConfigImpl::Get()->Set(path, value);
+}
+
+bool
+SetFailSafe(const Path& path, const AttributeValue& value)
+{
+    NS_LOG_FUNCTION(path.GetString() << &value);
+    return ConfigImpl::Get()->SetFailSafe(path, value);
+}
+
+void
+ConnectWithoutContext(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    if (!ConnectWithoutContextFailSafe(path, cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << path.GetString());
+    }
+}
+
+bool
+ConnectWithoutContextFailSafe(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    return ConfigImpl::Get()->ConnectWithoutContextFailSafe(path, cb);
+}
+
+void
+DisconnectWithoutContext(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    ConfigImpl::Get()->DisconnectWithoutContext(path, cb);
+}
+
+void
+Connect(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    if (!ConnectFailSafe(path, cb))
+    {
+        NS_FATAL_ERROR("Could not connect callback to " << path.GetString());
+    }
+}
+
+bool
+ConnectFailSafe(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    return ConfigImpl::Get()->ConnectFailSafe(path, cb);
+}
+
+void
+Disconnect(const Path& path, const CallbackBase& cb)
+{
+    NS_LOG_FUNCTION(path.GetString() << &cb);
+    ConfigImpl::Get()->Disconnect(path, cb);
+}
+
 void
 RegisterRootNamespaceObject(Ptr<Object> obj)
 {
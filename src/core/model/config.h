@@ -57,6 +57,91 @@ namespace Config
  */
 void Reset();
 
+/**
+ * \ingroup config
+ * A Config path, parsed once to be resolved any number of times.
+ *
+ * The functions which take a path as a string parse it on each call.
+ * A Path keeps the parsed segments, with the array specifications of
+ * the segments, such as <tt>[0-3]|7</tt>, and the TypeIds of the
+ * <tt>$TypeId</tt> segments already decoded, so that a path which is
+ * used repeatedly, or on many objects, is parsed only once.
+ *
+ * Like the string paths of Config::Set() and Config::Connect(), a Path
+ * designates an attribute or a trace source: its last segment is the
+ * name of the attribute or trace source, and the leading segments
+ * designate the objects.  Config::LookupMatches() resolves instead all
+ * the segments to objects.
+ *
+ * To connect several trace sources of the same objects with a single
+ * resolution of the path, look up the objects once and connect each
+ * trace source through the resulting MatchContainer:
+ * \code
+ *   Config::Path path("/NodeList/[0-99]/DeviceList/0/$ns3::WifiNetDevice/Phy");
+ *   Config::MatchContainer phys = Config::LookupMatches(path);
+ *   phys.ConnectWithoutContext("PhyTxBegin", MakeCallback(&TxBegin));
+ *   phys.ConnectWithoutContext("PhyRxEnd", MakeCallback(&RxEnd));
+ * \endcode
+ */
+class Path
+{
+  public:
+    /**
+     * Parse a Config path.
+     *
+     * \param [in] path The Config path.
+     */
+    explicit Path(std::string path);
+    /**
+     * Copy constructor.
+     *
+     * \param [in] other The Path to copy.
+     */
+    Path(const Path& other);
+    /**
+     * Assignment operator.
+     *
+     * \param [in] other The Path to copy.
+     * \returns This Path.
+     */
+    Path& operator=(const Path& other);
+    /** Destructor. */
+    ~Path();
+
+    /**
+     * \returns The Config path, as given to the constructor.
+     */
+    std::string GetString() const;
+
+  private:
+    friend class ConfigImpl;
+    friend class Resolver;
+
+    /** A parsed segment of the path, between two slashes. */
+    struct Segment;
+
+    /**
+     * Parse a Config path into its segments.
+     *
+     * \param [in] path The Config path.
+     * \returns The segments.
+     */
+    static std::vector<Segment> Parse(std::string path);
+
+    /** The Config path. */
+    std::string m_path;
+    /** The segments of the path, to resolve it to objects. */
+    std::vector<Segment> m_segments;
+    /** \c true if the path has a leading part and a leaf. */
+    bool m_hasLeaf;
+    /** The leading part of the path, up to the last slash. */
+    std::string m_parentPath;
+    /** The segments of the leading part of the path. */
+    std::vector<Segment> m_parentSegments;
+    /** The trailing part of the path, after the last slash. */
+    std::string m_leaf;
+};
+
 /**
  * \ingroup config
  * \param [in] path A path to match attributes.
@@ -361,6 +446,74 @@ class MatchContainer
  */
 MatchContainer LookupMatches(std::string path);
 
+/**
+ * \ingroup config
+ * \param [in] path The path to perform a match against
+ * \returns A container which contains all the objects which match the input
+ *          path.
+ */
+MatchContainer LookupMatches(const Path& path);
+
+/**
+ * \ingroup config
+ * \param [in] path A path to match attributes.
+ * \param [in] value The value to set in all matching attributes.
+ * \sa Set(std::string,const AttributeValue&)
+ */
+void Set(const Path& path, const AttributeValue& value);
+/**
+ * \ingroup config
+ * \param [in] path A path to match attributes.
+ * \param [in] value The value to set in all matching attributes.
+ * \returns \c true if any matching attributes could be set.
+ * \sa SetFailSafe(std::string,const AttributeValue&)
+ */
+bool SetFailSafe(const Path& path, const AttributeValue& value);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \sa ConnectWithoutContext(std::string,const CallbackBase&)
+ */
+void ConnectWithoutContext(const Path& path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \returns \c true if any trace sources could be connected.
+ * \sa ConnectWithoutContextFailSafe(std::string,const CallbackBase&)
+ */
+bool ConnectWithoutContextFailSafe(const Path& path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to disconnect from the matching trace sources.
+ * \sa DisconnectWithoutContext(std::string,const CallbackBase&)
+ */
+void DisconnectWithoutContext(const Path& path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \sa Connect(std::string,const CallbackBase&)
+ */
+void Connect(const Path& path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to connect to the matching trace sources.
+ * \returns \c true if any trace sources could be connected.
+ * \sa ConnectFailSafe(std::string,const CallbackBase&)
+ */
+bool ConnectFailSafe(const Path& path, const CallbackBase& cb);
+/**
+ * \ingroup config
+ * \param [in] path A path to match trace sources.
+ * \param [in] cb The callback to disconnect from the matching trace sources.
+ * \sa Disconnect(std::string,const CallbackBase&)
+ */
+void Disconnect(const Path& path, const CallbackBase& cb);
+
 /**
  * \ingroup config
  * \param [in] obj A new root object
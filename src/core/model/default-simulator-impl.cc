@@ -19,12 +19,23 @@
 
 #include "default-simulator-impl.h"
 
+#include "abort.h"
 #include "assert.h"
+#include "double.h"
 #include "log.h"
+#include "nstime.h"
 #include "scheduler.h"
 #include "simulator.h"
+#include "string.h"
+#include "system-path.h"
+#include "uinteger.h"
 
+#include <algorithm>
 #include <cmath>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
 
 /**
  * \file
@@ -48,11 +59,75 @@ DefaultSimulatorImpl::GetTypeId()
     static TypeId tid = TypeId("ns3::DefaultSimulatorImpl")
                             .SetParent<SimulatorImpl>()
                             .SetGroupName("Core")
-                            .AddConstructor<DefaultSimulatorImpl>();
+                            .AddConstructor<DefaultSimulatorImpl>()
+                            .AddAttribute("MinDrainBatch",
+                                          "The minimum number of events from other threads "
+                                          "moved into the event queue after each event",
+                                          UintegerValue(16),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_minDrainBatch),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("MaxDrainBatch",
+                                          "The maximum number of events from other threads "
+                                          "moved into the event queue after each event",
+                                          UintegerValue(1024),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_maxDrainBatch),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("CompactionThreshold",
+                                          "The fraction of cancelled events in the event queue "
+                                          "above which they are removed; 1 disables the removal",
+                                          DoubleValue(0.5),
+                                          MakeDoubleAccessor(
+                                              &DefaultSimulatorImpl::m_compactionThreshold),
+                                          MakeDoubleChecker<double>(0, 1))
+                            .AddAttribute("CompactionMinEvents",
+                                          "The minimum number of cancelled events in the event "
+                                          "queue before they are removed",
+                                          UintegerValue(1024),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_compactionMinEvents),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("ProfilingPeriod",
+                                          "The average number of events per event timed by the "
+                                          "profiler; 0 disables the profiler",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_profilingPeriod),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("ProfilingFile",
+                                          "The file to which the profile of the events is "
+                                          "written in JSON; empty for none",
+                                          StringValue(""),
+                                          MakeStringAccessor(
+                                              &DefaultSimulatorImpl::m_profilingFile),
+                                          MakeStringChecker())
+                            .AddAttribute("StatsFile",
+                                          "The file to which the live counters of the "
+                                          "simulation are exported; empty for none",
+                                          StringValue(""),
+                                          MakeStringAccessor(&DefaultSimulatorImpl::m_statsFile),
+                                          MakeStringChecker())
+                            .AddAttribute("StatsPeriod",
+                                          "The average number of events per event sampled for "
+                                          "the live counters",
+                                          UintegerValue(1024),
+                                          MakeUintegerAccessor(
+                                              &DefaultSimulatorImpl::m_statsPeriod),
+                                          MakeUintegerChecker<uint32_t>(1))
+                            .AddAttribute("StatsInterval",
+                                          "The wall clock time between two updates of the live "
+                                          "counters",
+                                          TimeValue(Seconds(1)),
+                                          MakeTimeAccessor(
+                                              &DefaultSimulatorImpl::m_statsInterval),
+                                          MakeTimeChecker(Time(0)));
     return tid;
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY),
+      m_eventsOverflowing(false)
 {
     NS_LOG_FUNCTION(this);
     m_stop = false;
@@ -61,8 +136,15 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentTs = 0;
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
+    m_cancelledEvents = 0;
+    m_compactionThreshold = 1;
+    m_compactionMinEvents = 1;
+    m_profilingPeriod = 0;
+    m_statsPeriod = 1;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    m_drainBatch = 1;
+    m_minDrainBatch = 1;
+    m_maxDrainBatch = 1;
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -75,12 +157,21 @@ void
 DefaultSimulatorImpl::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    ProcessEventsWithContext();
+    ProcessEventsWithContext(true);
 
-    while (!m_events->IsEmpty())
+    if (Simulator::IsBulkTeardown())
     {
-        Scheduler::Event next = m_events->RemoveNext();
-        next.impl->Unref();
+        // The pending events, and the objects they hold, are left to the
+        // end of the process with the scheduler
+        m_events->Ref();
+    }
+    else
+    {
+        while (!m_events->IsEmpty())
+        {
+            Scheduler::Event next = m_events->RemoveNext();
+            next.impl->Unref();
+        }
     }
     m_events = nullptr;
     SimulatorImpl::DoDispose();
@@ -100,6 +191,20 @@ DefaultSimulatorImpl::Destroy()
             ev->Invoke();
         }
     }
+
+    if (m_profiler)
+    {
+        m_profiler->Print(std::clog);
+        if (!m_profilingFile.empty())
+        {
+            std::ofstream os(m_profilingFile);
+            NS_ABORT_MSG_UNLESS(os.is_open(), "Cannot open the profile file " << m_profilingFile);
+            std::string model = SystemPath::Split(m_profilingFile).back();
+            m_profiler->WriteJson(os, model.substr(0, model.rfind('.')));
+        }
+        m_profiler.reset();
+    }
+    m_stats.reset();
 }
 
 void
@@ -141,7 +246,22 @@ DefaultSimulatorImpl::ProcessOneEvent()
     m_currentTs = next.key.m_ts;
     m_currentContext = next.key.m_context;
     m_currentUid = next.key.m_uid;
-    next.impl->Invoke();
+    if (next.impl->IsCancelled() && m_cancelledEvents > 0)
+    {
+        m_cancelledEvents--;
+    }
+    if (m_stats && m_stats->Sample(next.impl))
+    {
+        UpdateStats(true);
+    }
+    if (m_profiler)
+    {
+        m_profiler->Invoke(next.impl, m_currentContext);
+    }
+    else
+    {
+        next.impl->Invoke();
+    }
     next.impl->Unref();
 
     ProcessEventsWithContext();
@@ -154,32 +274,58 @@ DefaultSimulatorImpl::IsFinished() const
 }
 
 void
-DefaultSimulatorImpl::ProcessEventsWithContext()
+DefaultSimulatorImpl::InsertEventWithContext(const EventWithContext& event)
 {
-    if (m_eventsWithContextEmpty)
+    Scheduler::Event ev;
+    ev.impl = event.event;
+    ev.key.m_ts = m_currentTs + event.timestamp;
+    ev.key.m_context = event.context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
+void
+DefaultSimulatorImpl::ProcessEventsWithContext(bool drainAll)
+{
+    if (m_eventsWithContext.IsEmpty() && !m_eventsOverflowing.load(std::memory_order_acquire))
     {
         return;
     }
 
-    // swap queues
-    EventsWithContext eventsWithContext;
+    uint32_t budget = drainAll ? std::numeric_limits<uint32_t>::max() : m_drainBatch;
+    uint32_t count = 0;
+    EventWithContext event;
+    while (count < budget && m_eventsWithContext.Pop(event))
     {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        InsertEventWithContext(event);
+        count++;
     }
-    while (!eventsWithContext.empty())
+    if (!m_eventsWithContext.IsEmpty())
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
-        Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
-        ev.key.m_uid = m_uid;
-        m_uid++;
-        m_unscheduledEvents++;
-        m_events->Insert(ev);
+        // A backlog builds up: move more events next time.  The
+        // overflow list holds newer events, so it must wait.
+        m_drainBatch = std::min(2 * m_drainBatch, m_maxDrainBatch);
+        return;
+    }
+    if (count < m_drainBatch / 2)
+    {
+        m_drainBatch = std::max(m_drainBatch / 2, m_minDrainBatch);
+    }
+
+    if (m_eventsOverflowing.load(std::memory_order_acquire))
+    {
+        EventsWithContext eventsWithContext;
+        {
+            std::unique_lock lock{m_eventsOverflowMutex};
+            m_eventsOverflow.swap(eventsWithContext);
+            m_eventsOverflowing.store(false, std::memory_order_relaxed);
+        }
+        for (const auto& eventWithContext : eventsWithContext)
+        {
+            InsertEventWithContext(eventWithContext);
+        }
     }
 }
 
@@ -189,17 +335,54 @@ DefaultSimulatorImpl::Run()
     NS_LOG_FUNCTION(this);
     // Set the current threadId as the main threadId
     m_mainThreadId = std::this_thread::get_id();
-    ProcessEventsWithContext();
+    m_drainBatch = std::min(m_minDrainBatch, m_maxDrainBatch);
+    if (m_profilingPeriod > 0 && !m_profiler)
+    {
+        m_profiler = std::make_unique<EventProfiler>(m_profilingPeriod);
+    }
+    if (!m_statsFile.empty() && !m_stats)
+    {
+        m_stats = std::make_unique<SimulatorStats>(m_statsFile, m_statsPeriod, m_statsInterval);
+    }
+    ProcessEventsWithContext(true);
     m_stop = false;
+    if (m_stats)
+    {
+        UpdateStats(true);
+    }
 
-    while (!m_events->IsEmpty() && !m_stop)
+    while (!m_stop)
     {
+        if (m_events->IsEmpty())
+        {
+            // Do not leave behind the events still queued by other threads
+            ProcessEventsWithContext(true);
+            if (m_events->IsEmpty())
+            {
+                break;
+            }
+        }
         ProcessOneEvent();
     }
 
     // If the simulator stopped naturally by lack of events, make a
     // consistency test to check that we didn't lose any events along the way.
     NS_ASSERT(!m_events->IsEmpty() || m_unscheduledEvents == 0);
+
+    if (m_stats)
+    {
+        UpdateStats(false);
+    }
+}
+
+void
+DefaultSimulatorImpl::UpdateStats(bool running)
+{
+    m_stats->Update(TimeStep(m_currentTs),
+                    m_eventCount,
+                    m_unscheduledEvents,
+                    m_cancelledEvents,
+                    running);
 }
 
 void
@@ -264,10 +447,11 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
+        if (m_eventsOverflowing.load(std::memory_order_acquire) || !m_eventsWithContext.Push(ev))
         {
-            std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
+            std::unique_lock lock{m_eventsOverflowMutex};
+            m_eventsOverflow.push_back(ev);
+            m_eventsOverflowing.store(true, std::memory_order_release);
         }
     }
 }
@@ -352,7 +536,30 @@ DefaultSimulatorImpl::Cancel(const EventId& id)
     if (!IsExpired(id))
     {
         id.PeekEventImpl()->Cancel();
+        if (id.GetUid() != EventId::UID::DESTROY)
+        {
+            m_cancelledEvents++;
+            if (m_cancelledEvents >= m_compactionMinEvents &&
+                m_cancelledEvents > m_compactionThreshold * m_unscheduledEvents)
+            {
+                Compact();
+            }
+        }
+    }
+}
+
+void
+DefaultSimulatorImpl::Compact()
+{
+    NS_LOG_FUNCTION(this << m_cancelledEvents << m_unscheduledEvents);
+    std::vector<Scheduler::Event> removed;
+    m_events->RemoveCancelled(removed);
+    for (const auto& ev : removed)
+    {
+        ev.impl->Unref();
     }
+    m_unscheduledEvents -= removed.size();
+    m_cancelledEvents = 0;
 }
 
 bool
@@ -405,4 +612,16 @@ DefaultSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+DefaultSimulatorImpl::GetLiveEventCount() const
+{
+    return m_unscheduledEvents - m_cancelledEvents;
+}
+
+uint64_t
+DefaultSimulatorImpl::GetCancelledEventCount() const
+{
+    return m_cancelledEvents;
+}
+
 } // namespace ns3
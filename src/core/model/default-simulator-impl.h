@@ -20,10 +20,16 @@
 #ifndef DEFAULT_SIMULATOR_IMPL_H
 #define DEFAULT_SIMULATOR_IMPL_H
 
+#include "event-profiler.h"
+#include "mpsc-queue.h"
 #include "simulator-impl.h"
+#include "simulator-stats.h"
 
+#include <atomic>
 #include <list>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 
 /**
@@ -42,6 +48,31 @@ class Scheduler;
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * The events scheduled with a context from a thread other than the
+ * main simulation thread, typically by the reader threads of the
+ * emulation devices, are pushed to a bounded lock-free queue.  Only
+ * when this queue is full do the producers fall back to a list
+ * protected by a mutex.  The main thread moves these events into the
+ * scheduler after each event, at most \c MaxDrainBatch at a time: the
+ * number of events moved per iteration doubles while a backlog
+ * remains, and halves back towards \c MinDrainBatch when the queue is
+ * drained easily.
+ *
+ * Simulator::Cancel() leaves the cancelled events in the scheduler.
+ * When they make up more than \c CompactionThreshold of the event
+ * queue, and there are at least \c CompactionMinEvents of them, the
+ * queue is compacted with Scheduler::RemoveCancelled().
+ *
+ * When \c ProfilingPeriod is not zero, the events are invoked through
+ * an EventProfiler, which times one event in \c ProfilingPeriod; its
+ * report is printed to std::clog at Destroy(), and written in JSON to
+ * \c ProfilingFile if set.
+ *
+ * When \c StatsFile is set, the live counters of the simulation are
+ * exported to that file by a SimulatorStats, which samples one event in
+ * \c StatsPeriod and updates the file every \c StatsInterval of wall
+ * clock time, and at the start and the end of Run().
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -77,14 +108,29 @@ class DefaultSimulatorImpl : public SimulatorImpl
     uint32_t GetSystemId() const override;
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
+    uint64_t GetLiveEventCount() const override;
+    uint64_t GetCancelledEventCount() const override;
 
   private:
     void DoDispose() override;
 
     /** Process the next event. */
     void ProcessOneEvent();
-    /** Move events from a different context into the main event queue. */
-    void ProcessEventsWithContext();
+    /** Remove the cancelled events from the event queue. */
+    void Compact();
+    /**
+     * Update the live counters.
+     *
+     * \param [in] running Whether Run() runs.
+     */
+    void UpdateStats(bool running);
+    /**
+     * Move events from a different context into the main event queue.
+     *
+     * \param [in] drainAll Whether to move all the pending events,
+     *             regardless of the current batch size.
+     */
+    void ProcessEventsWithContext(bool drainAll = false);
 
     /** Wrap an event with its execution context. */
     struct EventWithContext
@@ -96,17 +142,35 @@ class DefaultSimulatorImpl : public SimulatorImpl
         /** The event implementation. */
         EventImpl* event;
     };
+    /**
+     * Insert an event from a different context in the main event queue.
+     *
+     * \param [in] event The event.
+     */
+    void InsertEventWithContext(const EventWithContext& event);
+
+    /** Capacity of the queue of events from a different context. */
+    static constexpr std::size_t EVENTS_WITH_CONTEXT_CAPACITY = 4096;
+    /** The queue of events from a different context. */
+    MpscQueue<EventWithContext> m_eventsWithContext;
     /** Container type for the events from a different context. */
     typedef std::list<struct EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
+    /** The events from a different context which did not fit in the queue. */
+    EventsWithContext m_eventsOverflow;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * Flag \c true if events are held in \c m_eventsOverflow; while it
+     * is set, the producers keep using the list, so that the events of
+     * each thread remain in order.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
-    std::mutex m_eventsWithContextMutex;
+    std::atomic<bool> m_eventsOverflowing;
+    /** Mutex to control access to the overflow list. */
+    std::mutex m_eventsOverflowMutex;
+    /** Current maximum number of events moved per iteration. */
+    uint32_t m_drainBatch;
+    /** Lower bound of the number of events moved per iteration. */
+    uint32_t m_minDrainBatch;
+    /** Upper bound of the number of events moved per iteration. */
+    uint32_t m_maxDrainBatch;
 
     /** Container type for the events to run at Simulator::Destroy() */
     typedef std::list<EventId> DestroyEvents;
@@ -132,6 +196,31 @@ class DefaultSimulatorImpl : public SimulatorImpl
      *  not counting the Destroy events; this is used for validation
      */
     int m_unscheduledEvents;
+    /** Number of cancelled events still in the event queue. */
+    uint64_t m_cancelledEvents;
+    /**
+     * Fraction of cancelled events in the event queue above which the
+     * queue is compacted.
+     */
+    double m_compactionThreshold;
+    /** Minimum number of cancelled events before the queue is compacted. */
+    uint32_t m_compactionMinEvents;
+
+    /** Average number of events per timed event; 0 disables the profiler. */
+    uint32_t m_profilingPeriod;
+    /** The file of the JSON profile, if any. */
+    std::string m_profilingFile;
+    /** The profiler of the events, if enabled. */
+    std::unique_ptr<EventProfiler> m_profiler;
+
+    /** The file of the live counters, if any. */
+    std::string m_statsFile;
+    /** Average number of events per event sampled for the live counters. */
+    uint32_t m_statsPeriod;
+    /** Wall clock time between two updates of the live counters. */
+    Time m_statsInterval;
+    /** The exporter of the live counters, if enabled. */
+    std::unique_ptr<SimulatorStats> m_stats;
 
     /** Main execution thread. */
     std::thread::id m_mainThreadId;
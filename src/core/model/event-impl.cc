@@ -21,6 +21,8 @@
 
 #include "log.h"
 
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +34,150 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+#ifdef NS3_EVENT_POOL
+namespace
+{
+
+/** Granularity of the size classes of the event pool, in bytes. */
+constexpr std::size_t POOL_GRANULARITY = 16;
+/** Number of size classes; larger events are not pooled. */
+constexpr std::size_t POOL_CLASSES = 16;
+/** Maximum number of free blocks kept per size class. */
+constexpr uint32_t POOL_MAX_FREE = 4096;
+
+/** A free block of the pool. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block of the same size class.
+};
+
+/**
+ * The event memory pool.
+ *
+ * The pool is trivially destructible, so that events released during
+ * the destruction of static objects can still safely reach it; the
+ * free blocks are released by EventPoolDestructor.
+ */
+struct EventPool
+{
+    FreeBlock* freeList[POOL_CLASSES]; //!< Free blocks, per size class.
+    uint32_t length[POOL_CLASSES];     //!< Number of free blocks, per size class.
+    bool registered;                   //!< Whether the destructor is registered.
+    bool destroyed;                    //!< Whether the free blocks were released.
+    EventImpl::PoolStats stats;        //!< Usage statistics.
+};
+
+/** Release the free blocks of the pool at exit. */
+struct EventPoolDestructor
+{
+    ~EventPoolDestructor();
+};
+
+// Events may be scheduled from other threads, with
+// Simulator::ScheduleWithContext(), even without NS3_MTP.
+thread_local EventPool g_eventPool;
+thread_local EventPoolDestructor g_eventPoolDestructor;
+
+/** Whether the memory of the events is recycled. */
+bool g_eventPoolEnabled = true;
+
+EventPoolDestructor::~EventPoolDestructor()
+{
+    for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+    {
+        while (g_eventPool.freeList[i] != nullptr)
+        {
+            FreeBlock* block = g_eventPool.freeList[i];
+            g_eventPool.freeList[i] = block->next;
+            ::operator delete(block);
+        }
+        g_eventPool.length[i] = 0;
+    }
+    g_eventPool.destroyed = true;
+}
+
+/**
+ * Get the size class of an event.
+ *
+ * \param [in] size The size of the event.
+ * \returns The size class; POOL_CLASSES if the event is not pooled.
+ */
+inline std::size_t
+GetSizeClass(std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+    return sizeClass < POOL_CLASSES ? sizeClass : POOL_CLASSES;
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    EventPool& pool = g_eventPool;
+    pool.stats.allocations++;
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass == POOL_CLASSES)
+    {
+        return ::operator new(size);
+    }
+    FreeBlock* block = pool.freeList[sizeClass];
+    if (block != nullptr && g_eventPoolEnabled)
+    {
+        pool.freeList[sizeClass] = block->next;
+        pool.length[sizeClass]--;
+        pool.stats.hits++;
+        return block;
+    }
+    if (!pool.registered)
+    {
+        // The destructor of a thread_local object is only registered
+        // when the object is first used by the thread.
+        (void)&g_eventPoolDestructor;
+        pool.registered = true;
+    }
+    // The whole size class is allocated so that the block can be reused
+    // by any event of the class, even if the pool is enabled later on.
+    return ::operator new((sizeClass + 1) * POOL_GRANULARITY);
+}
+
+void
+EventImpl::operator delete(void* ptr, std::size_t size)
+{
+    EventPool& pool = g_eventPool;
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass == POOL_CLASSES || !g_eventPoolEnabled || !pool.registered ||
+        pool.destroyed || pool.length[sizeClass] >= POOL_MAX_FREE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = pool.freeList[sizeClass];
+    pool.freeList[sizeClass] = block;
+    pool.length[sizeClass]++;
+}
+#endif /* NS3_EVENT_POOL */
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats()
+{
+#ifdef NS3_EVENT_POOL
+    return g_eventPool.stats;
+#else
+    return PoolStats{0, 0};
+#endif
+}
+
+void
+EventImpl::SetPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+#ifdef NS3_EVENT_POOL
+    g_eventPoolEnabled = enabled;
+#endif
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
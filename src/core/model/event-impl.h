@@ -21,6 +21,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -41,6 +42,11 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * When ns-3 is built with the \c NS3_EVENT_POOL option (the default),
+ * the memory of the events is recycled: the blocks released when the
+ * reference count of an event drops to zero are kept in free lists,
+ * one per size class, and reused by the next events of a similar size.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +73,55 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /** Usage statistics of the event memory pool. */
+    struct PoolStats
+    {
+        uint64_t allocations; //!< Number of events allocated.
+        uint64_t hits;        //!< Number of events allocated from a free list.
+    };
+
+    /**
+     * Get the usage statistics of the event memory pool.
+     *
+     * Each thread has its own pool, and the statistics are those of the
+     * calling thread.
+     *
+     * \returns The statistics; all zero if ns-3 is built without the
+     * \c NS3_EVENT_POOL option.
+     */
+    static PoolStats GetPoolStats();
+    /**
+     * Enable or disable the recycling of the memory of the events.
+     *
+     * This is intended for benchmarks; the setting is shared by all the
+     * threads and should be changed while no event is being scheduled.
+     * It has no effect if ns-3 is built without the \c NS3_EVENT_POOL
+     * option.
+     *
+     * \param [in] enabled Whether to recycle the memory of the events.
+     */
+    static void SetPoolEnabled(bool enabled);
+
+#ifdef NS3_EVENT_POOL
+    /**
+     * Allocate the memory of an event, from the pool if possible.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory block.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event to the pool.
+     *
+     * The destructor being virtual, \p size is the size of the most
+     * derived event class.
+     *
+     * \param [in] ptr The memory block.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* ptr, std::size_t size);
+#endif /* NS3_EVENT_POOL */
+
   protected:
     /**
      * Implementation for Invoke().
@@ -0,0 +1,306 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "event-profiler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime> // time_t, time()
+#include <iomanip>
+#include <ios>
+
+#if (__GNUC__ >= 3)
+#include <cstdlib>
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3
+{
+
+namespace
+{
+
+/**
+ * \ingroup simulator
+ * Write a string as a JSON string literal.
+ *
+ * \param [in,out] os The output stream.
+ * \param [in] s The string.
+ */
+void
+WriteJsonString(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            os << '\\';
+        }
+        os << c;
+    }
+    os << '"';
+}
+
+} // unnamed namespace
+
+std::string
+EventProfiler::GetEventTypeName(const std::type_info& type)
+{
+    std::string name = type.name();
+#if (__GNUC__ >= 3)
+    int status;
+    char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        name = demangled;
+    }
+    std::free(demangled);
+#endif
+
+    const std::string prefix = "ns3::MakeEvent<";
+    if (name.compare(0, prefix.size(), prefix) != 0)
+    {
+        return name;
+    }
+    int depth = 1;
+    for (std::size_t i = prefix.size(); i < name.size(); ++i)
+    {
+        if (name[i] == '<')
+        {
+            depth++;
+        }
+        else if (name[i] == '>' && --depth == 0)
+        {
+            return name.substr(prefix.size(), i - prefix.size());
+        }
+    }
+    return name;
+}
+
+std::size_t
+EventProfiler::KeyHash::operator()(const Key& key) const
+{
+    return std::hash<const void*>()(key.type) ^ (std::size_t(key.context) * 0x9e3779b97f4a7c15);
+}
+
+EventProfiler::EventProfiler(uint32_t period)
+    : m_lastKey{nullptr, 0},
+      m_lastStats(nullptr),
+      m_period(period),
+      m_random(0x2545f4914f6cdd1d),
+      m_count(0)
+{
+    NS_ASSERT_MSG(period > 0, "The sampling period must be positive");
+    m_gap = NextGap();
+}
+
+uint32_t
+EventProfiler::NextGap()
+{
+    if (m_period == 1)
+    {
+        return 1;
+    }
+    // xorshift64, which does not draw from the random streams of the
+    // models and so leaves the simulation unchanged
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 7;
+    m_random ^= m_random << 17;
+    // Uniform in [1, 2 * period - 1], with a mean of period
+    return 1 + m_random % (2 * uint64_t(m_period) - 1);
+}
+
+void
+EventProfiler::Invoke(EventImpl* event, uint32_t context)
+{
+    if (event->IsCancelled())
+    {
+        return;
+    }
+
+    Key key{&typeid(*event), context};
+    if (m_lastStats == nullptr || !(key == m_lastKey))
+    {
+        // The nodes of the map are stable, so the pointer stays valid
+        m_lastStats = &m_stats[key];
+        m_lastKey = key;
+    }
+    Stats* stats = m_lastStats;
+    stats->count++;
+    m_count++;
+
+    if (--m_gap > 0)
+    {
+        event->Invoke();
+        return;
+    }
+    m_gap = NextGap();
+
+    auto begin = std::chrono::steady_clock::now();
+    event->Invoke();
+    auto end = std::chrono::steady_clock::now();
+    uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+    stats->samples++;
+    stats->sampled += duration;
+    stats->maximum = std::max(stats->maximum, duration);
+    std::size_t bucket = 0;
+    while (bucket < HISTOGRAM_BUCKETS - 1 && (duration >> (bucket + 1)) > 0)
+    {
+        bucket++;
+    }
+    stats->histogram[bucket]++;
+}
+
+std::vector<EventProfiler::Record>
+EventProfiler::GetRecords() const
+{
+    std::vector<Record> records;
+    records.reserve(m_stats.size());
+    for (const auto& [key, stats] : m_stats)
+    {
+        Record record;
+        record.type = GetEventTypeName(*key.type);
+        record.context = key.context;
+        record.count = stats.count;
+        record.samples = stats.samples;
+        record.sampled = stats.sampled;
+        record.maximum = stats.maximum;
+        record.estimate = 0;
+        if (stats.samples > 0)
+        {
+            record.estimate = static_cast<uint64_t>(static_cast<double>(stats.sampled) *
+                                                    stats.count / stats.samples);
+        }
+        record.histogram = stats.histogram;
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        if (a.estimate != b.estimate)
+        {
+            return a.estimate > b.estimate;
+        }
+        if (a.count != b.count)
+        {
+            return a.count > b.count;
+        }
+        if (a.type != b.type)
+        {
+            return a.type < b.type;
+        }
+        return a.context < b.context;
+    });
+    return records;
+}
+
+uint64_t
+EventProfiler::GetEventCount() const
+{
+    return m_count;
+}
+
+void
+EventProfiler::Print(std::ostream& os) const
+{
+    std::vector<Record> records = GetRecords();
+    uint64_t total = 0;
+    for (const auto& record : records)
+    {
+        total += record.estimate;
+    }
+
+    std::ios::fmtflags flags(os.flags());
+    os << "Event profile: " << m_count << " events, 1 in " << m_period << " timed, "
+       << std::fixed << std::setprecision(3) << total * 1e-9 << " s estimated" << std::endl;
+    os << std::setw(10) << "Time (s)" << std::setw(8) << "Share" << std::setw(12) << "Events"
+       << std::setw(12) << "Mean (us)" << std::setw(12) << "Max (us)" << std::setw(9)
+       << "Context"
+       << "  Type" << std::endl;
+    for (const auto& record : records)
+    {
+        double mean = record.samples > 0 ? 1e-3 * record.sampled / record.samples : 0;
+        os << std::setw(10) << std::setprecision(3) << record.estimate * 1e-9 << std::setw(7)
+           << std::setprecision(1) << (total > 0 ? 100.0 * record.estimate / total : 0) << "%"
+           << std::setw(12) << record.count << std::setw(12) << std::setprecision(3) << mean
+           << std::setw(12) << record.maximum * 1e-3 << std::setw(9);
+        if (record.context == Simulator::NO_CONTEXT)
+        {
+            os << "-";
+        }
+        else
+        {
+            os << record.context;
+        }
+        os << "  " << record.type << std::endl;
+    }
+    os.flags(flags);
+}
+
+void
+EventProfiler::WriteJson(std::ostream& os, const std::string& modelName) const
+{
+    time_t current_time;
+    time(&current_time);
+    const char* date = ctime(&current_time);
+    std::string capture_date(date, 24); // discard trailing newline from ctime
+
+    os << "{" << std::endl;
+    os << " \"simulator_name\" : \"ns-3\"," << std::endl;
+    os << " \"model_name\" : ";
+    WriteJsonString(os, modelName);
+    os << "," << std::endl;
+    os << " \"capture_date\" : \"" << capture_date << "\"," << std::endl;
+    os << " \"sampling_period\" : " << m_period << "," << std::endl;
+    os << " \"event_count\" : " << m_count << "," << std::endl;
+    os << " \"event_types\" : [";
+
+    char separator = ' ';
+    for (const auto& record : GetRecords())
+    {
+        os << separator << std::endl;
+        separator = ',';
+        // Force to signed so we can show NoContext as '-1'
+        int32_t context =
+            (record.context != Simulator::NO_CONTEXT) ? (int32_t)record.context : -1;
+        os << "  {\"type\" : ";
+        WriteJsonString(os, record.type);
+        os << ", \"context\" : " << context << ", \"count\" : " << record.count
+           << ", \"samples\" : " << record.samples << ", \"sampled_ns\" : " << record.sampled
+           << ", \"maximum_ns\" : " << record.maximum << ", \"estimate_ns\" : " << record.estimate
+           << ", \"histogram\" : [";
+        for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            os << (i > 0 ? "," : "") << record.histogram[i];
+        }
+        os << "]}";
+    }
+    os << std::endl;
+    os << " ]" << std::endl;
+    os << "}" << std::endl;
+}
+
+} // namespace ns3
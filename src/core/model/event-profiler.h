@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <array>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3
+{
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Wall clock profile of the events, by event type and context.
+ *
+ * The simulator invokes its events through Invoke(), which counts
+ * every event and measures the wall clock time of a sample of them.
+ * The events are keyed by the dynamic type of their EventImpl, which
+ * MakeEvent() derives from the type of the function or of the member
+ * function and object invoked, and by their context, normally the id
+ * of the node which runs them.
+ *
+ * Reading the clock costs about as much as a small event, so only one
+ * event in \c period, on average, is timed; the gap between two timed
+ * events is drawn at random so that periodic event patterns do not
+ * bias the sample.  The total time of each record is estimated from
+ * its sampled events.  Each record also keeps a histogram of the
+ * sampled durations, in buckets of powers of two nanoseconds.
+ *
+ * The DefaultSimulatorImpl uses an EventProfiler when its
+ * \c ProfilingPeriod attribute is not zero, and emits the report with
+ * Print() and WriteJson() at Simulator::Destroy().
+ */
+class EventProfiler
+{
+  public:
+    /** The number of buckets of the duration histograms. */
+    static constexpr std::size_t HISTOGRAM_BUCKETS = 32;
+
+    /** The profile of one event type in one context. */
+    struct Record
+    {
+        std::string type;  //!< The demangled event type.
+        uint32_t context;  //!< The event context.
+        uint64_t count;    //!< The number of events run.
+        uint64_t samples;  //!< The number of events timed.
+        uint64_t sampled;  //!< The total time of the events timed, in ns.
+        uint64_t maximum;  //!< The longest time of the events timed, in ns.
+        uint64_t estimate; //!< The estimated time of all the events, in ns.
+        /**
+         * The number of events timed by duration: bucket \c i counts
+         * the durations in [2^i, 2^(i+1)) ns, and the last bucket
+         * also the longer ones.
+         */
+        std::array<uint64_t, HISTOGRAM_BUCKETS> histogram;
+    };
+
+    /**
+     * Constructor.
+     *
+     * \param [in] period The average number of events per timed
+     *             event; 1 times every event.
+     */
+    explicit EventProfiler(uint32_t period);
+
+    /**
+     * Invoke an event and account for it.
+     *
+     * \param [in] event The event.
+     * \param [in] context The context of the event.
+     */
+    void Invoke(EventImpl* event, uint32_t context);
+
+    /**
+     * Get the records, by decreasing estimated time.
+     *
+     * \returns The records.
+     */
+    std::vector<Record> GetRecords() const;
+
+    /**
+     * \returns The number of events invoked.
+     */
+    uint64_t GetEventCount() const;
+
+    /**
+     * Print a table of the records, by decreasing estimated time.
+     *
+     * \param [in,out] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * Write the records in JSON, in the style of DesMetrics.
+     *
+     * \param [in,out] os The output stream.
+     * \param [in] modelName The name of the simulation program.
+     */
+    void WriteJson(std::ostream& os, const std::string& modelName) const;
+
+    /**
+     * Get the readable name of an event type.
+     *
+     * The events built by MakeEvent() are local classes of its
+     * instantiations, so only the template arguments of MakeEvent(), which
+     * give the function invoked and the types of its arguments, are kept.
+     *
+     * \param [in] type The dynamic type of the event.
+     * \returns The name of the event type.
+     */
+    static std::string GetEventTypeName(const std::type_info& type);
+
+  private:
+    /** The key of a record. */
+    struct Key
+    {
+        const std::type_info* type; //!< The dynamic type of the event.
+        uint32_t context;           //!< The event context.
+
+        /**
+         * Equality operator.
+         * \param [in] other The other key.
+         * \returns \c true if the keys are equal.
+         */
+        bool operator==(const Key& other) const
+        {
+            return type == other.type && context == other.context;
+        }
+    };
+
+    /** Hash function of the keys. */
+    struct KeyHash
+    {
+        /**
+         * Hash a key.
+         * \param [in] key The key.
+         * \returns The hash.
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /** The statistics of a record, without its key. */
+    struct Stats
+    {
+        uint64_t count{0};                                   //!< Events run.
+        uint64_t samples{0};                                 //!< Events timed.
+        uint64_t sampled{0};                                 //!< Time timed, in ns.
+        uint64_t maximum{0};                                 //!< Longest time, in ns.
+        std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{}; //!< Histogram.
+    };
+
+    /**
+     * \returns The number of events to run before the next timed event.
+     */
+    uint32_t NextGap();
+
+    /** The statistics by key. */
+    std::unordered_map<Key, Stats, KeyHash> m_stats;
+    Key m_lastKey;      //!< The key of the last event.
+    Stats* m_lastStats; //!< The statistics of the last event.
+    uint32_t m_period;  //!< The average number of events per timed event.
+    uint32_t m_gap;     //!< Events left before the next timed event.
+    uint64_t m_random;  //!< The state of the gap generator.
+    uint64_t m_count;   //!< The number of events invoked.
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -63,7 +63,8 @@ sigaction(int sig, struct sigaction* action, struct sigaction* old)
  * \file
  * \ingroup fatalimpl
  * \brief ns3::FatalImpl::RegisterStream(), ns3::FatalImpl::UnregisterStream(),
- * and ns3::FatalImpl::FlushStreams() implementations;
+ * ns3::FatalImpl::FlushStreams() and ns3::FatalImpl::FlushRegisteredStreams()
+ * implementations;
  * see Implementation note!
  *
  * \note Implementation.
@@ -187,6 +188,7 @@ void
 FlushStreams()
 {
     NS_LOG_FUNCTION_NOARGS();
+    LogFlushBinary();
     std::list<std::ostream*>** pl = PeekStreamList();
     if (*pl == nullptr)
     {
@@ -227,6 +229,25 @@ FlushStreams()
     *pl = nullptr;
 }
 
+void
+FlushRegisteredStreams()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    LogFlushBinary();
+    std::list<std::ostream*>** pl = PeekStreamList();
+    if (*pl != nullptr)
+    {
+        for (std::ostream* s : **pl)
+        {
+            s->flush();
+        }
+    }
+    std::fflush(nullptr);
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+}
+
 } // namespace FatalImpl
 
 } // namespace ns3
@@ -26,7 +26,8 @@
  * \file
  * \ingroup fatalimpl
  * ns3::FatalImpl::RegisterStream(), ns3::FatalImpl::UnregisterStream(),
- * and ns3::FatalImpl::FlushStreams() declarations.
+ * ns3::FatalImpl::FlushStreams() and ns3::FatalImpl::FlushRegisteredStreams()
+ * declarations.
  */
 
 /**
@@ -94,6 +95,17 @@ void UnregisterStream(std::ostream* stream);
  */
 void FlushStreams();
 
+/**
+ * \ingroup fatalimpl
+ *
+ * \brief Flush all currently registered streams, which stay registered.
+ *
+ * Unlike FlushStreams(), this function is safe in a normal run: it is
+ * called by Simulator::Destroy() and at exit in a bulk teardown, which
+ * leaves the objects holding the streams to the end of the process.
+ */
+void FlushRegisteredStreams();
+
 } // namespace FatalImpl
 } // namespace ns3
 
@@ -62,6 +62,7 @@ namespace ns3
  * PeekNext()   | Constant        | Heap kept sorted
  * Remove()     | Logarithmic     | Search, heapify
  * RemoveNext() | Logarithmic     | Heapify
+ * RemoveCancelled() | Linear      | Filter, rebuild the heap
  *
  * \par Memory Complexity
  *
@@ -90,6 +91,7 @@ class HeapScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
 
   private:
     /** Event list type:  vector of Events, managed as a heap. */
@@ -171,8 +173,12 @@ class HeapScheduler : public Scheduler
      * \param [in] b The second item.
      */
     inline void Exch(std::size_t a, std::size_t b);
-    /** Percolate a newly inserted Last item to its proper position. */
-    void BottomUp();
+    /**
+     * Percolate an item up the heap to its proper position.
+     *
+     * \param [in] start Starting entry, e.g. the newly inserted Last item.
+     */
+    void BottomUp(std::size_t start);
     /**
      * Percolate a deletion bubble down the heap.
      *
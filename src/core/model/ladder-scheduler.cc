@@ -0,0 +1,342 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+#include "uinteger.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::LadderScheduler")
+            .SetParent<Scheduler>()
+            .SetGroupName("Core")
+            .AddConstructor<LadderScheduler>()
+            .AddAttribute("Threshold",
+                          "The maximum number of events sorted at once; larger buckets "
+                          "are spread over a new rung",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&LadderScheduler::m_threshold),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxRungs",
+                          "The maximum number of rungs of the ladder",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&LadderScheduler::m_maxRungs),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(std::numeric_limits<uint64_t>::max()),
+      m_topMax(0),
+      m_topStart(0),
+      m_nRungs(0),
+      m_size(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::Rung::GetCurrentStart() const
+{
+    return start + current * width;
+}
+
+uint32_t
+LadderScheduler::Rung::GetBucket(uint64_t ts) const
+{
+    NS_ASSERT(ts >= start);
+    uint32_t bucket = (ts - start) / width;
+    NS_ASSERT(bucket < nBuckets);
+    return bucket;
+}
+
+void
+LadderScheduler::SpawnRung(Bucket& events, uint64_t start, uint64_t end)
+{
+    NS_LOG_FUNCTION(this << events.size() << start << end);
+    NS_ASSERT(end > start);
+
+    uint64_t range = end - start;
+    uint64_t nBuckets = std::max<uint64_t>(1, std::min<uint64_t>(events.size(), range));
+    uint64_t width = (range - 1) / nBuckets + 1;
+    nBuckets = (range - 1) / width + 1;
+
+    if (m_rungs.size() == m_nRungs)
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs];
+    if (rung.buckets.size() < nBuckets)
+    {
+        rung.buckets.resize(nBuckets);
+    }
+    rung.nBuckets = nBuckets;
+    rung.start = start;
+    rung.width = width;
+    rung.current = 0;
+    rung.count = events.size();
+    for (const Scheduler::Event& ev : events)
+    {
+        rung.buckets[rung.GetBucket(ev.key.m_ts)].push_back(ev);
+    }
+    events.clear();
+    m_nRungs++;
+}
+
+void
+LadderScheduler::DoInsert(const Scheduler::Event& ev)
+{
+    uint64_t ts = ev.key.m_ts;
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+        return;
+    }
+    for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        if (ts >= rung.GetCurrentStart())
+        {
+            rung.buckets[rung.GetBucket(ts)].push_back(ev);
+            rung.count++;
+            return;
+        }
+    }
+
+    m_bottom.insert(
+        std::upper_bound(m_bottom.begin(), m_bottom.end(), ev, std::greater<Scheduler::Event>()),
+        ev);
+    if (m_bottom.size() > m_threshold && m_nRungs < m_maxRungs &&
+        m_bottom.front().key.m_ts != m_bottom.back().key.m_ts)
+    {
+        // Too many events end up being sorted: spread them over a new
+        // rung, below the current bucket of the lowest rung.
+        uint64_t end = m_nRungs > 0 ? m_rungs[m_nRungs - 1].GetCurrentStart() : m_topStart;
+        SpawnRung(m_bottom, m_bottom.back().key.m_ts, end);
+    }
+}
+
+void
+LadderScheduler::Refill()
+{
+    while (m_bottom.empty() && m_size > 0)
+    {
+        if (m_nRungs == 0)
+        {
+            NS_ASSERT(!m_top.empty());
+            if (m_top.size() <= m_threshold || m_topMin == m_topMax)
+            {
+                m_bottom.swap(m_top);
+                std::sort(m_bottom.begin(), m_bottom.end(), std::greater<Scheduler::Event>());
+                m_topStart = m_topMax + 1;
+            }
+            else
+            {
+                SpawnRung(m_top, m_topMin, m_topMax + 1);
+                const Rung& rung = m_rungs[0];
+                m_topStart = rung.start + rung.nBuckets * rung.width;
+            }
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+        while (rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        NS_ASSERT(rung.current < rung.nBuckets);
+        Bucket& bucket = rung.buckets[rung.current];
+        uint64_t start = rung.GetCurrentStart();
+        rung.count -= bucket.size();
+        rung.current++;
+        if (bucket.size() > m_threshold && m_nRungs < m_maxRungs && rung.width > 1)
+        {
+            SpawnRung(bucket, start, start + rung.width);
+        }
+        else
+        {
+            m_bottom.swap(bucket);
+            std::sort(m_bottom.begin(), m_bottom.end(), std::greater<Scheduler::Event>());
+        }
+    }
+}
+
+void
+LadderScheduler::Insert(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    m_size++;
+    DoInsert(ev);
+    Refill();
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_size == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_bottom.empty());
+    return m_bottom.back();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_bottom.empty());
+    Scheduler::Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    m_size--;
+    Refill();
+    NS_LOG_DEBUG("remove " << ev.key.m_ts << ", " << ev.key.m_uid << ", " << ev.key.m_context
+                           << ", " << ev.impl);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Scheduler::Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+
+    // The tier holding an event is found with the same rules as in
+    // DoInsert(): the events moved down the ladder always stay below
+    // the current bucket of the rungs above.
+    uint64_t ts = ev.key.m_ts;
+    Bucket* bucket = &m_bottom;
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_nRungs; ++i)
+        {
+            Rung& rung = m_rungs[i];
+            if (ts >= rung.GetCurrentStart())
+            {
+                bucket = &rung.buckets[rung.GetBucket(ts)];
+                rung.count--;
+                break;
+            }
+        }
+    }
+
+    if (bucket == &m_bottom)
+    {
+        auto it = std::lower_bound(m_bottom.begin(),
+                                   m_bottom.end(),
+                                   ev,
+                                   std::greater<Scheduler::Event>());
+        NS_ASSERT(it != m_bottom.end() && it->key == ev.key);
+        m_bottom.erase(it);
+    }
+    else
+    {
+        auto it = std::find(bucket->begin(), bucket->end(), ev);
+        NS_ASSERT(it != bucket->end());
+        *it = bucket->back();
+        bucket->pop_back();
+    }
+    m_size--;
+    Refill();
+}
+
+void
+LadderScheduler::RemoveCancelled(std::vector<Scheduler::Event>& removed)
+{
+    NS_LOG_FUNCTION(this);
+    auto isCancelled = [](const Scheduler::Event& ev) { return ev.impl->IsCancelled(); };
+    std::size_t before = removed.size();
+
+    // Filter an unsorted bucket
+    auto filter = [&removed, &isCancelled](Bucket& bucket) {
+        auto it = std::partition(bucket.begin(), bucket.end(), std::not_fn(isCancelled));
+        removed.insert(removed.end(), it, bucket.end());
+        std::size_t count = bucket.end() - it;
+        bucket.erase(it, bucket.end());
+        return count;
+    };
+
+    filter(m_top);
+    m_topMin = std::numeric_limits<uint64_t>::max();
+    m_topMax = 0;
+    for (const Scheduler::Event& ev : m_top)
+    {
+        m_topMin = std::min(m_topMin, ev.key.m_ts);
+        m_topMax = std::max(m_topMax, ev.key.m_ts);
+    }
+    for (uint32_t i = 0; i < m_nRungs; ++i)
+    {
+        Rung& rung = m_rungs[i];
+        for (uint32_t bucket = rung.current; bucket < rung.nBuckets; ++bucket)
+        {
+            rung.count -= filter(rung.buckets[bucket]);
+        }
+    }
+    // Bottom must stay sorted
+    auto it = std::stable_partition(m_bottom.begin(), m_bottom.end(), std::not_fn(isCancelled));
+    removed.insert(removed.end(), it, m_bottom.end());
+    m_bottom.erase(it, m_bottom.end());
+
+    m_size -= removed.size() - before;
+    Refill();
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue published in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and
+ * Ian Li-Jin Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are stored in three tiers:
+ *   - \c Top, an unsorted vector which receives the events far in the
+ *     future;
+ *   - the \c Ladder, a stack of rungs; each rung is an array of unsorted
+ *     buckets of uniform width, and each lower rung refines a single
+ *     bucket of the rung above;
+ *   - \c Bottom, a short sorted vector holding the next events to run.
+ *
+ * When \c Bottom is empty, the first non-empty bucket of the lowest rung
+ * is either sorted into \c Bottom or, if it holds more than
+ * \c Threshold events, spread over a new rung.  When the ladder is
+ * empty, \c Top is spread over a new first rung.  Contrary to the
+ * calendar queue, there is thus no global resize: each event is moved
+ * a bounded number of times, and only a small number of events is ever
+ * sorted.
+ *
+ * The buckets are \c std::vector, whose storage is reused from one
+ * rung to the next.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time  | Reason
+ * :----------- | :--------------- | :-----
+ * Insert()     | Constant         | Append to a bucket; sorted insertion in \c Bottom
+ * IsEmpty()    | Constant         | Explicit queue size
+ * PeekNext()   | Constant         | Last item of \c Bottom
+ * Remove()     | Linear in bucket | Search within the bucket
+ * RemoveNext() | ~Constant        | Possible transfer of a bucket to \c Bottom
+ * RemoveCancelled() | Linear       | Filter the tiers
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                            | Reason
+ * :-------- | :-------------------------------- | :-----
+ * Overhead  | 3 x `sizeof (*)` per bucket       | `std::vector`
+ * Per Event | 0                                 | Events stored in `std::vector`
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
+
+  private:
+    /** Bucket type: an unsorted vector of Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        /** The buckets; only the first \c nBuckets are in use. */
+        std::vector<Bucket> buckets;
+        /** Number of buckets in use. */
+        uint32_t nBuckets;
+        /** Timestamp of the start of the first bucket. */
+        uint64_t start;
+        /** Width of the buckets, in dimensionless time units. */
+        uint64_t width;
+        /** Index of the first bucket which may hold events. */
+        uint32_t current;
+        /** Number of events in the rung. */
+        uint32_t count;
+
+        /**
+         * Get the start of the current bucket, below which the events
+         * do not belong to this rung.
+         *
+         * \returns The start of the current bucket.
+         */
+        uint64_t GetCurrentStart() const;
+        /**
+         * Get the bucket holding a timestamp.
+         *
+         * \param [in] ts The event timestamp.
+         * \returns The bucket index.
+         */
+        uint32_t GetBucket(uint64_t ts) const;
+    };
+
+    /**
+     * Spread events over a new rung of the ladder.
+     *
+     * \param [in,out] events The events to move; cleared on return.
+     * \param [in] start The start of the range covered by the rung.
+     * \param [in] end The end of the range covered by the rung.
+     */
+    void SpawnRung(Bucket& events, uint64_t start, uint64_t end);
+    /**
+     * Insert an event in the ladder or in \c Bottom.
+     *
+     * \param [in] ev The event to insert.
+     */
+    void DoInsert(const Scheduler::Event& ev);
+    /** Move the next events to \c Bottom if it is empty. */
+    void Refill();
+
+    /** The unsorted events far in the future. */
+    Bucket m_top;
+    /** The smallest timestamp in \c Top. */
+    uint64_t m_topMin;
+    /** The largest timestamp in \c Top. */
+    uint64_t m_topMax;
+    /** The events with a timestamp greater than or equal are in \c Top. */
+    uint64_t m_topStart;
+    /**
+     * The rungs; only the first \c m_nRungs are in use.  A deque keeps
+     * the buckets in place while a new rung is appended.
+     */
+    std::deque<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** The next events, sorted in decreasing order. */
+    Bucket m_bottom;
+    /** Number of events in queue. */
+    uint32_t m_size;
+    /** Maximum number of events sorted at once. */
+    uint32_t m_threshold;
+    /** Maximum number of rungs. */
+    uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
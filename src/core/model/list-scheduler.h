@@ -53,6 +53,7 @@ class EventImpl;
  * PeekNext()   | Constant        | `std::list::front()`
  * Remove()     | Linear          | Linear search in `std::list`
  * RemoveNext() | Constant        | `std::list::pop_front()`
+ * RemoveCancelled() | Linear      | Filter the list
  *
  * \par Memory Complexity
  *
@@ -82,6 +83,7 @@ class ListScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
 
   private:
     /** Event list type: a simple list of Events. */
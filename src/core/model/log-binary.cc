@@ -0,0 +1,964 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "log-binary.h"
+
+#include "abort.h"
+#include "environment-variable.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "nstime.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogBinaryRecord and the binary log sink implementation.
+ */
+
+namespace ns3
+{
+
+namespace
+{
+
+/** The magic string at the start of a binary log file. */
+const char MAGIC[8] = {'n', 's', '3', 'b', 'l', 'o', 'g', '\n'};
+/** The version of the format of the binary log files. */
+const uint32_t VERSION = 1;
+/** The byte order mark, written in the byte order of the file. */
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/** The types of the records of a binary log file. */
+enum RecordType : uint8_t
+{
+    RECORD_SITE = 0,    //!< The definition of a site.
+    RECORD_MESSAGE = 1, //!< A log message.
+};
+
+/** The prefixes of a message record. */
+enum Prefix : uint8_t
+{
+    PREFIX_TIME = 0x1,  //!< Print the simulation time.
+    PREFIX_NODE = 0x2,  //!< Print the context.
+    PREFIX_FUNC = 0x4,  //!< Print the component and function.
+    PREFIX_LEVEL = 0x8, //!< Print the log level.
+};
+
+/**
+ * The size of the buffer of each thread, a power of two.  A record
+ * which does not fit in it is written directly to the file.
+ */
+constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+/** A site of a logging macro. */
+struct Site
+{
+    std::string component;      //!< The name of the log component.
+    LogBinaryRecord::Kind kind; //!< The kind of logging macro.
+    int32_t level;              //!< The log level.
+    std::string function;       //!< The name of the function.
+    std::string file;           //!< The name of the source file.
+    uint32_t line;              //!< The line in the source file.
+};
+
+/** The sites registered by the logging macros. */
+struct SiteRegistry
+{
+    std::mutex mutex;        //!< Protects the sites.
+    std::vector<Site> sites; //!< The sites, by id.
+};
+
+/**
+ * Get the site registry.
+ *
+ * The registry is never deleted, so that the sink can write the
+ * sites while the static objects are destroyed at exit.
+ *
+ * \returns The site registry.
+ */
+SiteRegistry&
+GetSiteRegistry()
+{
+    static SiteRegistry* registry = new SiteRegistry;
+    return *registry;
+}
+
+/**
+ * Append the raw bytes of a value to a string.
+ * \tparam T \deduced The type of the value.
+ * \param [in,out] s The string.
+ * \param [in] value The value.
+ */
+template <typename T>
+void
+Append(std::string& s, const T& value)
+{
+    s.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * Append a string, preceded by its size, to a string.
+ * \param [in,out] s The string.
+ * \param [in] value The string to append.
+ */
+void
+AppendString(std::string& s, const std::string& value)
+{
+    Append(s, static_cast<uint32_t>(value.size()));
+    s.append(value);
+}
+
+/** Reader of the values of a record. */
+class RecordReader
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] data The record, without its size.
+     */
+    RecordReader(const std::string& data)
+        : m_data(data),
+          m_offset(0)
+    {
+    }
+
+    /**
+     * Read a value.
+     * \tparam T \explicit The type of the value.
+     * \returns The value.
+     */
+    template <typename T>
+    T Get()
+    {
+        NS_ABORT_MSG_IF(m_offset + sizeof(T) > m_data.size(), "Corrupt binary log record");
+        T value;
+        std::memcpy(&value, m_data.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    /**
+     * Read a string, preceded by its size.
+     * \returns The string.
+     */
+    std::string GetString()
+    {
+        auto size = Get<uint32_t>();
+        NS_ABORT_MSG_IF(m_offset + size > m_data.size(), "Corrupt binary log record");
+        std::string value = m_data.substr(m_offset, size);
+        m_offset += size;
+        return value;
+    }
+
+    /** \returns \c true if the whole record has been read. */
+    bool AtEnd() const
+    {
+        return m_offset == m_data.size();
+    }
+
+  private:
+    const std::string& m_data; //!< The record.
+    std::size_t m_offset;      //!< The offset of the next value.
+};
+
+/**
+ * Print a simulation time as DefaultTimePrinter() does.
+ * \param [in,out] os The output stream.
+ * \param [in] time The time, in units of the resolution.
+ * \param [in] resolution The Time::Unit of the resolution.
+ */
+void
+PrintTime(std::ostream& os, int64_t time, uint8_t resolution)
+{
+    if (Time::GetResolution() != resolution)
+    {
+        Time::SetResolution(static_cast<Time::Unit>(resolution));
+    }
+    std::ios_base::fmtflags ff = os.flags();
+    std::streamsize oldPrecision = os.precision();
+    os << std::fixed;
+    switch (resolution)
+    {
+    case Time::US:
+        os << std::setprecision(6);
+        break;
+    case Time::NS:
+        os << std::setprecision(9);
+        break;
+    case Time::PS:
+        os << std::setprecision(12);
+        break;
+    case Time::FS:
+        os << std::setprecision(15);
+        break;
+    default:
+        os << std::setprecision(5);
+    }
+    os << TimeStep(time).As(Time::S);
+    os << std::setprecision(oldPrecision);
+    os.flags(ff);
+}
+
+/**
+ * Print the values of a message record.
+ * \param [in,out] os The output stream.
+ * \param [in,out] reader The reader of the record.
+ * \param [in] parameters Whether the values are function parameters,
+ *             separated by commas, whose strings are quoted.
+ */
+void
+PrintValues(std::ostream& os, RecordReader& reader, bool parameters)
+{
+    bool first = true;
+    while (!reader.AtEnd())
+    {
+        if (parameters && !first)
+        {
+            os << ", ";
+        }
+        first = false;
+        auto tag = static_cast<LogBinaryRecord::Tag>(reader.Get<uint8_t>());
+        switch (tag)
+        {
+        case LogBinaryRecord::TAG_TEXT:
+            os << reader.GetString();
+            break;
+        case LogBinaryRecord::TAG_STRING:
+            if (parameters)
+            {
+                os << "\"" << reader.GetString() << "\"";
+            }
+            else
+            {
+                os << reader.GetString();
+            }
+            break;
+        case LogBinaryRecord::TAG_BOOL:
+            os << static_cast<bool>(reader.Get<uint8_t>());
+            break;
+        case LogBinaryRecord::TAG_CHAR:
+            os << reader.Get<char>();
+            break;
+        case LogBinaryRecord::TAG_INT:
+            os << reader.Get<int64_t>();
+            break;
+        case LogBinaryRecord::TAG_UINT:
+            os << reader.Get<uint64_t>();
+            break;
+        case LogBinaryRecord::TAG_DOUBLE:
+            os << reader.Get<double>();
+            break;
+        case LogBinaryRecord::TAG_POINTER:
+            os << reinterpret_cast<const void*>(static_cast<uintptr_t>(reader.Get<uint64_t>()));
+            break;
+        default:
+            NS_FATAL_ERROR("Corrupt binary log record: unknown tag " << +tag);
+        }
+    }
+}
+
+} // unnamed namespace
+
+class LogBinarySink;
+
+/** The buffer of the binary records of a thread. */
+struct LogBinaryRecord::Buffer
+{
+    /**
+     * Constructor.
+     * \param [in] s The sink which drains the buffer.
+     */
+    Buffer(LogBinarySink* s)
+        : ring(BUFFER_SIZE),
+          head(0),
+          tail(0),
+          depth(0),
+          sink(s)
+    {
+    }
+
+    /** A record being built. */
+    struct Scratch
+    {
+        std::string record;           //!< The record.
+        std::ostringstream formatter; //!< The formatter of the record.
+        bool formatterUsed{false};    //!< Whether the record used the formatter.
+    };
+
+    std::vector<char> ring;     //!< The committed records.
+    std::atomic<uint64_t> head; //!< The bytes committed, by the thread.
+    std::atomic<uint64_t> tail; //!< The bytes drained, by the writer.
+    /**
+     * The records being built.  The arguments of a record may log
+     * themselves, so each nesting level has its own record.
+     */
+    std::deque<Scratch> scratch;
+    std::size_t depth;   //!< The number of records being built.
+    LogBinarySink* sink; //!< The sink.
+};
+
+/**
+ * \ingroup logging
+ * The binary log sink: the buffers of the threads and the thread which
+ * writes them to the file.
+ */
+class LogBinarySink
+{
+  public:
+    /** The type of the buffers. */
+    using Buffer = LogBinaryRecord::Buffer;
+
+    /**
+     * Open the file and start the writer.
+     * \param [in] filename The name of the file.
+     */
+    LogBinarySink(const std::string& filename);
+    /** Write the pending records, stop the writer and close the file. */
+    ~LogBinarySink();
+
+    /**
+     * Get the buffer of the calling thread.
+     * \returns The buffer, or \c nullptr if the binary sink is not enabled.
+     */
+    static Buffer* GetBuffer();
+
+    /**
+     * Commit a record to a buffer.
+     * \param [in,out] buffer The buffer.
+     * \param [in] record The record.
+     */
+    void Commit(Buffer* buffer, const std::string& record);
+
+    /** Write the records committed so far to the file. */
+    void Flush();
+
+  private:
+    /** The body of the writer thread. */
+    void Run();
+    /**
+     * Write the records committed to the buffers to the file.
+     * \param [in] buffers The buffers.
+     * \returns \c true if some records were written.
+     */
+    bool Drain(const std::vector<Buffer*>& buffers);
+    /** Write the sites registered since the last call; needs m_fileMutex. */
+    void WriteSites();
+
+    std::ofstream m_file;    //!< The binary log file.
+    std::mutex m_fileMutex;  //!< Protects m_file and m_sitesWritten.
+    std::size_t m_sitesWritten; //!< The number of sites written.
+
+    std::mutex m_mutex; //!< Protects the following members.
+    std::condition_variable m_wake;    //!< Wakes up the writer.
+    std::condition_variable m_flushed; //!< Signals the completion of the flushes.
+    std::vector<std::unique_ptr<Buffer>> m_buffers; //!< The buffers of the threads.
+    bool m_running;                                 //!< Whether the writer should run.
+    uint64_t m_flushRequests;                       //!< The number of flushes requested.
+    uint64_t m_flushDone;                           //!< The number of flushes done.
+
+    uint64_t m_generation; //!< Identifies this sink in the buffers of the threads.
+    std::thread m_writer;  //!< The writer thread.
+
+    static thread_local uint64_t t_generation; //!< The generation of the buffer of the thread.
+    static thread_local Buffer* t_buffer;      //!< The buffer of the thread.
+};
+
+namespace
+{
+
+/** The binary log sink, if enabled. */
+std::atomic<LogBinarySink*> g_sink{nullptr};
+/** Serializes LogEnableBinary() and LogDisableBinary(). */
+std::mutex g_sinkMutex;
+/** The number of sinks created. */
+std::atomic<uint64_t> g_generation{0};
+
+} // unnamed namespace
+
+thread_local uint64_t LogBinarySink::t_generation = 0;
+thread_local LogBinarySink::Buffer* LogBinarySink::t_buffer = nullptr;
+
+LogBinarySink::LogBinarySink(const std::string& filename)
+    : m_file(filename, std::ios::binary | std::ios::trunc),
+      m_sitesWritten(0),
+      m_running(true),
+      m_flushRequests(0),
+      m_flushDone(0),
+      m_generation(++g_generation)
+{
+    if (!m_file.is_open())
+    {
+        NS_FATAL_ERROR("Can't open binary log file " << filename);
+    }
+    std::string header(MAGIC, sizeof(MAGIC));
+    Append(header, VERSION);
+    Append(header, BYTE_ORDER_MARK);
+    m_file.write(header.data(), header.size());
+    m_writer = std::thread(&LogBinarySink::Run, this);
+}
+
+LogBinarySink::~LogBinarySink()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_one();
+    m_writer.join();
+    m_file.close();
+}
+
+LogBinarySink::Buffer*
+LogBinarySink::GetBuffer()
+{
+    LogBinarySink* sink = g_sink.load(std::memory_order_acquire);
+    if (sink == nullptr)
+    {
+        return nullptr;
+    }
+    if (t_generation != sink->m_generation)
+    {
+        auto buffer = std::make_unique<Buffer>(sink);
+        t_buffer = buffer.get();
+        t_generation = sink->m_generation;
+        std::lock_guard<std::mutex> lock(sink->m_mutex);
+        sink->m_buffers.push_back(std::move(buffer));
+    }
+    return t_buffer;
+}
+
+void
+LogBinarySink::Commit(Buffer* buffer, const std::string& record)
+{
+    std::size_t size = record.size();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+
+    if (size > BUFFER_SIZE)
+    {
+        // Write the earlier records of the thread first
+        while (buffer->tail.load(std::memory_order_acquire) != head)
+        {
+            m_wake.notify_one();
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> lock(m_fileMutex);
+        WriteSites();
+        m_file.write(record.data(), size);
+        return;
+    }
+
+    uint64_t tail = buffer->tail.load(std::memory_order_acquire);
+    while (head + size - tail > BUFFER_SIZE)
+    {
+        // The buffer is full: wait for the writer
+        m_wake.notify_one();
+        std::this_thread::yield();
+        tail = buffer->tail.load(std::memory_order_acquire);
+    }
+    std::size_t offset = head & (BUFFER_SIZE - 1);
+    std::size_t first = std::min(size, BUFFER_SIZE - offset);
+    std::memcpy(buffer->ring.data() + offset, record.data(), first);
+    std::memcpy(buffer->ring.data(), record.data() + first, size - first);
+    buffer->head.store(head + size, std::memory_order_release);
+
+    if (head + size - tail > BUFFER_SIZE / 2)
+    {
+        m_wake.notify_one();
+    }
+}
+
+void
+LogBinarySink::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t request = ++m_flushRequests;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [this, request]() { return m_flushDone >= request; });
+}
+
+void
+LogBinarySink::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        bool running = m_running;
+        uint64_t flushRequests = m_flushRequests;
+        std::vector<Buffer*> buffers;
+        buffers.reserve(m_buffers.size());
+        for (const auto& buffer : m_buffers)
+        {
+            buffers.push_back(buffer.get());
+        }
+        lock.unlock();
+
+        bool written = Drain(buffers);
+        if (flushRequests != m_flushDone || !running)
+        {
+            std::lock_guard<std::mutex> fileLock(m_fileMutex);
+            m_file.flush();
+        }
+
+        lock.lock();
+        if (flushRequests != m_flushDone)
+        {
+            m_flushDone = flushRequests;
+            m_flushed.notify_all();
+        }
+        if (!running)
+        {
+            break;
+        }
+        // Poll more often while the records flow; a thread whose buffer
+        // fills up wakes the writer up anyway
+        m_wake.wait_for(lock, std::chrono::milliseconds(written ? 1 : 10));
+    }
+}
+
+bool
+LogBinarySink::Drain(const std::vector<Buffer*>& buffers)
+{
+    // Read the heads before the sites, so that the sites of the records
+    // drained below are written
+    std::vector<uint64_t> heads;
+    heads.reserve(buffers.size());
+    for (auto buffer : buffers)
+    {
+        heads.push_back(buffer->head.load(std::memory_order_acquire));
+    }
+
+    bool written = false;
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    WriteSites();
+    for (std::size_t i = 0; i < buffers.size(); ++i)
+    {
+        Buffer* buffer = buffers[i];
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        std::size_t size = heads[i] - tail;
+        if (size == 0)
+        {
+            continue;
+        }
+        std::size_t offset = tail & (BUFFER_SIZE - 1);
+        std::size_t first = std::min(size, BUFFER_SIZE - offset);
+        m_file.write(buffer->ring.data() + offset, first);
+        m_file.write(buffer->ring.data(), size - first);
+        buffer->tail.store(heads[i], std::memory_order_release);
+        written = true;
+    }
+    return written;
+}
+
+void
+LogBinarySink::WriteSites()
+{
+    SiteRegistry& registry = GetSiteRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::string record;
+    for (; m_sitesWritten < registry.sites.size(); ++m_sitesWritten)
+    {
+        const Site& site = registry.sites[m_sitesWritten];
+        record.clear();
+        Append(record, uint32_t(0));
+        Append(record, uint8_t(RECORD_SITE));
+        Append(record, uint8_t(site.kind));
+        Append(record, uint16_t(0));
+        Append(record, static_cast<uint32_t>(m_sitesWritten));
+        Append(record, site.level);
+        Append(record, site.line);
+        AppendString(record, site.component);
+        AppendString(record, site.function);
+        AppendString(record, site.file);
+        auto size = static_cast<uint32_t>(record.size());
+        std::memcpy(&record[0], &size, sizeof(size));
+        m_file.write(record.data(), record.size());
+    }
+}
+
+/* static */
+uint32_t
+LogBinaryRecord::RegisterSite(const LogComponent& component,
+                              Kind kind,
+                              int32_t level,
+                              const char* function,
+                              const char* file,
+                              int line)
+{
+    SiteRegistry& registry = GetSiteRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.sites.push_back(
+        {component.Name(), kind, level, function, file, static_cast<uint32_t>(line)});
+    return static_cast<uint32_t>(registry.sites.size() - 1);
+}
+
+LogBinaryRecord::LogBinaryRecord(const LogComponent& component, uint32_t site)
+    : m_plain(true),
+      m_data(nullptr),
+      m_buffer(LogBinarySink::GetBuffer()),
+      m_depth(0)
+{
+    if (m_buffer == nullptr)
+    {
+        return;
+    }
+
+    uint8_t prefixes = 0;
+    uint8_t resolution = 0;
+    uint32_t context = Simulator::NO_CONTEXT;
+    int64_t time = 0;
+    if (component.IsEnabled(LOG_PREFIX_TIME) && LogGetTimePrinter() != nullptr)
+    {
+        prefixes |= PREFIX_TIME;
+        resolution = static_cast<uint8_t>(Time::GetResolution());
+        time = Simulator::Now().GetTimeStep();
+    }
+    if (component.IsEnabled(LOG_PREFIX_NODE) && LogGetNodePrinter() != nullptr)
+    {
+        prefixes |= PREFIX_NODE;
+        context = Simulator::GetContext();
+    }
+    if (component.IsEnabled(LOG_PREFIX_FUNC))
+    {
+        prefixes |= PREFIX_FUNC;
+    }
+    if (component.IsEnabled(LOG_PREFIX_LEVEL))
+    {
+        prefixes |= PREFIX_LEVEL;
+    }
+
+    m_depth = m_buffer->depth++;
+    if (m_depth == m_buffer->scratch.size())
+    {
+        m_buffer->scratch.emplace_back();
+    }
+    Buffer::Scratch& scratch = m_buffer->scratch[m_depth];
+    m_data = &scratch.record;
+    m_data->clear();
+    Append(*m_data, uint32_t(0));
+    Append(*m_data, uint8_t(RECORD_MESSAGE));
+    Append(*m_data, prefixes);
+    Append(*m_data, resolution);
+    Append(*m_data, uint8_t(0));
+    Append(*m_data, site);
+    Append(*m_data, context);
+    Append(*m_data, time);
+
+    if (scratch.formatterUsed)
+    {
+        std::ostringstream& formatter = scratch.formatter;
+        formatter.clear();
+        formatter.flags(std::ios_base::dec | std::ios_base::skipws);
+        formatter.precision(6);
+        formatter.width(0);
+        formatter.fill(' ');
+        scratch.formatterUsed = false;
+    }
+}
+
+LogBinaryRecord::~LogBinaryRecord()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+    auto size = static_cast<uint32_t>(m_data->size());
+    std::memcpy(&(*m_data)[0], &size, sizeof(size));
+    m_buffer->sink->Commit(m_buffer, *m_data);
+    m_buffer->depth--;
+}
+
+std::ostream&
+LogBinaryRecord::Formatter()
+{
+    if (m_data == nullptr)
+    {
+        // The sink was disabled by another thread: discard the values
+        static std::ostream discard(nullptr);
+        return discard;
+    }
+    Buffer::Scratch& scratch = m_buffer->scratch[m_depth];
+    scratch.formatterUsed = true;
+    return scratch.formatter;
+}
+
+void
+LogBinaryRecord::PutFormatted()
+{
+    if (m_data == nullptr)
+    {
+        return;
+    }
+    std::ostringstream& formatter = m_buffer->scratch[m_depth].formatter;
+    std::string text = formatter.str();
+    PutString(TAG_TEXT, text.data(), text.size());
+    formatter.str("");
+    m_plain = formatter.flags() == (std::ios_base::dec | std::ios_base::skipws) &&
+              formatter.precision() == 6 && formatter.width() == 0;
+}
+
+LogBinaryMessage&
+LogBinaryMessage::operator<<(const std::string& value)
+{
+    if (m_plain)
+    {
+        PutString(TAG_STRING, value.data(), value.size());
+        return *this;
+    }
+    Formatter() << value;
+    PutFormatted();
+    return *this;
+}
+
+LogBinaryMessage&
+LogBinaryMessage::operator<<(const char* value)
+{
+    if (m_plain && value != nullptr)
+    {
+        PutString(TAG_STRING, value, std::strlen(value));
+        return *this;
+    }
+    Formatter() << value;
+    PutFormatted();
+    return *this;
+}
+
+LogBinaryMessage&
+LogBinaryMessage::operator<<(std::ostream& (*manipulator)(std::ostream&))
+{
+    Formatter() << manipulator;
+    PutFormatted();
+    return *this;
+}
+
+LogBinaryMessage&
+LogBinaryMessage::operator<<(std::ios_base& (*manipulator)(std::ios_base&))
+{
+    Formatter() << manipulator;
+    PutFormatted();
+    return *this;
+}
+
+LogBinaryMessage&
+LogBinaryMessage::operator<<(std::ios& (*manipulator)(std::ios&))
+{
+    Formatter() << manipulator;
+    PutFormatted();
+    return *this;
+}
+
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const std::string& param)
+{
+    PutString(TAG_STRING, param.data(), param.size());
+    return *this;
+}
+
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const char* param)
+{
+    (*this) << std::string(param);
+    return *this;
+}
+
+void
+LogEnableBinary(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    delete g_sink.exchange(nullptr);
+    g_sink.store(new LogBinarySink(filename), std::memory_order_release);
+}
+
+void
+LogDisableBinary()
+{
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    delete g_sink.exchange(nullptr);
+}
+
+bool
+LogIsBinaryEnabled()
+{
+    return g_sink.load(std::memory_order_relaxed) != nullptr;
+}
+
+void
+LogFlushBinary()
+{
+    std::lock_guard<std::mutex> lock(g_sinkMutex);
+    LogBinarySink* sink = g_sink.load(std::memory_order_acquire);
+    if (sink != nullptr)
+    {
+        sink->Flush();
+    }
+}
+
+void
+LogDecodeBinary(std::istream& is, std::ostream& os)
+{
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    uint32_t byteOrderMark = 0;
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(&version), sizeof(version));
+    is.read(reinterpret_cast<char*>(&byteOrderMark), sizeof(byteOrderMark));
+    NS_ABORT_MSG_UNLESS(is && std::equal(magic, magic + sizeof(magic), MAGIC),
+                        "Not an ns-3 binary log file");
+    NS_ABORT_MSG_UNLESS(version == VERSION, "Unsupported binary log file version " << version);
+    NS_ABORT_MSG_UNLESS(byteOrderMark == BYTE_ORDER_MARK,
+                        "The binary log file was written with another byte order");
+
+    std::vector<Site> sites;
+    std::vector<bool> defined;
+    std::string data;
+    uint32_t size;
+    while (is.read(reinterpret_cast<char*>(&size), sizeof(size)))
+    {
+        NS_ABORT_MSG_IF(size <= sizeof(size), "Corrupt binary log record");
+        data.resize(size - sizeof(size));
+        if (!is.read(&data[0], data.size()))
+        {
+            // Truncated by a crash
+            break;
+        }
+        RecordReader reader(data);
+        auto type = reader.Get<uint8_t>();
+        if (type == RECORD_SITE)
+        {
+            Site site;
+            site.kind = static_cast<LogBinaryRecord::Kind>(reader.Get<uint8_t>());
+            reader.Get<uint16_t>();
+            auto id = reader.Get<uint32_t>();
+            site.level = reader.Get<int32_t>();
+            site.line = reader.Get<uint32_t>();
+            site.component = reader.GetString();
+            site.function = reader.GetString();
+            site.file = reader.GetString();
+            if (id >= sites.size())
+            {
+                sites.resize(id + 1);
+                defined.resize(id + 1);
+            }
+            sites[id] = site;
+            defined[id] = true;
+            continue;
+        }
+        NS_ABORT_MSG_UNLESS(type == RECORD_MESSAGE,
+                            "Corrupt binary log file: unknown record type " << +type);
+
+        auto prefixes = reader.Get<uint8_t>();
+        auto resolution = reader.Get<uint8_t>();
+        reader.Get<uint8_t>();
+        auto id = reader.Get<uint32_t>();
+        auto context = reader.Get<uint32_t>();
+        auto time = reader.Get<int64_t>();
+        NS_ABORT_MSG_UNLESS(id < sites.size() && defined[id],
+                            "Corrupt binary log file: undefined site " << id);
+        const Site& site = sites[id];
+
+        if (prefixes & PREFIX_TIME)
+        {
+            PrintTime(os, time, resolution);
+            os << " ";
+        }
+        if (prefixes & PREFIX_NODE)
+        {
+            if (context == Simulator::NO_CONTEXT)
+            {
+                os << "-1";
+            }
+            else
+            {
+                os << context;
+            }
+            os << " ";
+        }
+        switch (site.kind)
+        {
+        case LogBinaryRecord::MESSAGE:
+            if (prefixes & PREFIX_FUNC)
+            {
+                os << site.component << ":" << site.function << "(): ";
+            }
+            if (prefixes & PREFIX_LEVEL)
+            {
+                os << "[" << LogComponent::GetLevelLabel(static_cast<LogLevel>(site.level))
+                   << "] ";
+            }
+            PrintValues(os, reader, false);
+            break;
+        case LogBinaryRecord::FUNCTION:
+            os << site.component << ":" << site.function << "(";
+            PrintValues(os, reader, true);
+            os << ")";
+            break;
+        case LogBinaryRecord::FUNCTION_NOARGS:
+            os << site.component << ":" << site.function << "()";
+            break;
+        default:
+            NS_FATAL_ERROR("Corrupt binary log file: unknown site kind " << +site.kind);
+        }
+        os << "\n";
+    }
+}
+
+/**
+ * \ingroup logging
+ * Handler of the \c NS_LOG_BINARY environment variable, which enables
+ * the binary sink before \c main(), and writes the pending records and
+ * closes the binary file at exit.
+ *
+ * This is private to the logging implementation.
+ */
+class LogBinaryEnvironment
+{
+  public:
+    /** Constructor, enables the binary sink if requested. */
+    LogBinaryEnvironment()
+    {
+        auto [found, value] = EnvironmentVariable::Get("NS_LOG_BINARY");
+        if (found && !value.empty())
+        {
+            LogEnableBinary(value);
+        }
+    }
+
+    /** Destructor, disables the binary sink. */
+    ~LogBinaryEnvironment()
+    {
+        LogDisableBinary();
+    }
+};
+
+/**
+ * Invoke handler for \c NS_LOG_BINARY.
+ * This is private to the logging implementation.
+ */
+static LogBinaryEnvironment g_logBinaryEnvironment;
+
+} // namespace ns3
@@ -0,0 +1,549 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NS3_LOG_BINARY_H
+#define NS3_LOG_BINARY_H
+
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogBinaryRecord declaration, and the functions which select the
+ * binary log sink.
+ */
+
+namespace ns3
+{
+
+class LogComponent;
+
+/**
+ * \ingroup logging
+ * \name Binary logging
+ *
+ * The log messages are normally formatted on \c std::clog as they are
+ * emitted.  The binary sink records instead, for each message, the
+ * site of the logging macro, the simulation time and context, and the
+ * raw values of the arguments, in a buffer of the emitting thread.  A
+ * background thread writes the buffers to a file, which
+ * LogDecodeBinary() and the \c decode-binary-log utility render as
+ * the text which \c std::clog would have shown.
+ *
+ * The binary sink is selected by LogEnableBinary(), or by the
+ * \c NS_LOG_BINARY environment variable, which gives the name of the
+ * file:
+ * \code
+ *   $ NS_LOG="*=level_all|prefix_all" NS_LOG_BINARY=run.nslog ./ns3 run ...
+ *   $ ./build/utils/ns3-dev-decode-binary-log run.nslog
+ * \endcode
+ *
+ * The records of a thread keep their order in the file; the records of
+ * different threads are interleaved in blocks.  The time and node
+ * prefixes are rendered as DefaultTimePrinter() and DefaultNodePrinter()
+ * print them, and the file-local NS_LOG_APPEND_CONTEXT is not recorded.
+ * NS_LOG_UNCOND() always writes on \c std::clog.
+ */
+/** @{ */
+
+/**
+ * Write the log messages to a binary file instead of \c std::clog.
+ *
+ * A binary file already being written is closed first.
+ *
+ * \param [in] filename The name of the file.
+ */
+void LogEnableBinary(const std::string& filename);
+
+/**
+ * Write the pending binary log messages, close the binary file and
+ * write the log messages to \c std::clog again.
+ *
+ * This must not be called while other threads emit log messages.
+ */
+void LogDisableBinary();
+
+/**
+ * Check if the log messages are written to a binary file.
+ *
+ * \returns \c true if the binary sink is selected.
+ */
+bool LogIsBinaryEnabled();
+
+/**
+ * Write the binary log messages emitted so far to the file.
+ *
+ * This is called by FatalImpl::FlushStreams(), so that the messages
+ * which precede a fatal error are not lost.
+ */
+void LogFlushBinary();
+
+/**
+ * Render a binary log file as text.
+ *
+ * A record truncated by the end of the file, as when the program
+ * crashed, ends the rendering.
+ *
+ * \param [in,out] is The binary log file.
+ * \param [in,out] os The output stream of the text.
+ */
+void LogDecodeBinary(std::istream& is, std::ostream& os);
+
+/** @} */
+
+/**
+ * \ingroup logging
+ * Output streamer for a std::pair, declared here so that log messages
+ * can stream pairs to a LogBinaryRecord.  Defined in pair.h.
+ * \tparam A \deduced Type of the `pair.first`.
+ * \tparam B \deduced Type of the `pair.second`.
+ * \param [in,out] os The output stream.
+ * \param [in] p The pair.
+ * \returns The output stream.
+ */
+template <class A, class B>
+std::ostream& operator<<(std::ostream& os, const std::pair<A, B>& p);
+
+/**
+ * \ingroup logging
+ * Output streamer for a std::tuple, declared here so that log messages
+ * can stream tuples to a LogBinaryRecord.  Defined in tuple.h.
+ * \tparam Args \deduced Tuple arguments.
+ * \param [in,out] os The output stream.
+ * \param [in] t The tuple.
+ * \returns The output stream.
+ */
+template <class... Args>
+std::ostream& operator<<(std::ostream& os, const std::tuple<Args...>& t);
+
+/**
+ * \ingroup logging
+ * Check if a type has an output streamer other than the members of
+ * \c std::ostream, such as one for the pointers to a class.
+ * \tparam T \explicit The type.
+ */
+template <typename T, typename = void>
+struct LogBinaryHasStreamer : std::false_type
+{
+};
+
+/**
+ * \ingroup logging
+ * Specialization for the types which have an output streamer.
+ * \tparam T \explicit The type.
+ */
+template <typename T>
+struct LogBinaryHasStreamer<
+    T,
+    std::void_t<decltype(operator<<(std::declval<std::ostream&>(), std::declval<const T&>()))>>
+    : std::true_type
+{
+};
+
+/**
+ * \ingroup logging
+ * A log message being recorded by the binary sink.
+ *
+ * The logging macros build a temporary record, stream the arguments
+ * into it and commit it to the buffer of the thread when it is
+ * destroyed.  The arithmetic values, the strings and the pointers are
+ * stored raw, while the other values, and all the values which follow
+ * a stream manipulator, are formatted as they would be on \c std::clog.
+ *
+ * The records are built by the subclasses LogBinaryMessage and
+ * LogBinaryParameters, which follow the formatting of \c std::clog and
+ * of ParameterLogger respectively.
+ */
+class LogBinaryRecord
+{
+  public:
+    /** The kind of logging macro of a site. */
+    enum Kind : uint8_t
+    {
+        MESSAGE = 0,         //!< NS_LOG() and the per-level macros.
+        FUNCTION = 1,        //!< NS_LOG_FUNCTION().
+        FUNCTION_NOARGS = 2, //!< NS_LOG_FUNCTION_NOARGS().
+    };
+
+    /** The tag of each value of a record. */
+    enum Tag : uint8_t
+    {
+        TAG_TEXT = 0,    //!< Formatted text: uint32_t size and characters.
+        TAG_STRING = 1,  //!< A string: uint32_t size and characters.
+        TAG_BOOL = 2,    //!< A bool, as uint8_t.
+        TAG_CHAR = 3,    //!< A character.
+        TAG_INT = 4,     //!< A signed integer, as int64_t.
+        TAG_UINT = 5,    //!< An unsigned integer, as uint64_t.
+        TAG_DOUBLE = 6,  //!< A floating point number, as double.
+        TAG_POINTER = 7, //!< A pointer, as uint64_t.
+    };
+
+    /**
+     * Register a site of a logging macro.
+     *
+     * The logging macros register their site once, in a static local
+     * variable, the first time they emit a binary record.
+     *
+     * \param [in] component The log component of the site.
+     * \param [in] kind The kind of logging macro.
+     * \param [in] level The log level of the site.
+     * \param [in] function The name of the function.
+     * \param [in] file The name of the source file.
+     * \param [in] line The line in the source file.
+     * \returns The id of the site.
+     */
+    static uint32_t RegisterSite(const LogComponent& component,
+                                 Kind kind,
+                                 int32_t level,
+                                 const char* function,
+                                 const char* file,
+                                 int line);
+
+    /**
+     * Start a record.
+     *
+     * \param [in] component The log component, which gives the prefixes.
+     * \param [in] site The id of the site.
+     */
+    LogBinaryRecord(const LogComponent& component, uint32_t site);
+    /** Commit the record to the buffer of the thread. */
+    ~LogBinaryRecord();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    LogBinaryRecord(const LogBinaryRecord&) = delete;
+    LogBinaryRecord& operator=(const LogBinaryRecord&) = delete;
+
+  protected:
+    /**
+     * Append a value.
+     *
+     * \param [in] tag The tag of the value.
+     * \param [in] value The raw value.
+     * \param [in] size The size of the raw value.
+     */
+    void Put(Tag tag, const void* value, std::size_t size)
+    {
+        if (m_data != nullptr)
+        {
+            m_data->push_back(static_cast<char>(tag));
+            m_data->append(static_cast<const char*>(value), size);
+        }
+    }
+
+    /**
+     * Append a string.
+     *
+     * \param [in] tag TAG_TEXT or TAG_STRING.
+     * \param [in] s The characters.
+     * \param [in] size The number of characters.
+     */
+    void PutString(Tag tag, const char* s, std::size_t size)
+    {
+        uint32_t size32 = static_cast<uint32_t>(size);
+        Put(tag, &size32, sizeof(size32));
+        if (m_data != nullptr)
+        {
+            m_data->append(s, size);
+        }
+    }
+
+    /**
+     * Append an integer.
+     * \tparam T \deduced The integer type.
+     * \param [in] value The value.
+     */
+    template <typename T>
+    void PutInteger(T value)
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            int64_t raw = value;
+            Put(TAG_INT, &raw, sizeof(raw));
+        }
+        else
+        {
+            uint64_t raw = value;
+            Put(TAG_UINT, &raw, sizeof(raw));
+        }
+    }
+
+    /**
+     * Append a pointer.
+     * \param [in] value The pointer.
+     */
+    void PutPointer(const void* value)
+    {
+        uint64_t raw = reinterpret_cast<uintptr_t>(value);
+        Put(TAG_POINTER, &raw, sizeof(raw));
+    }
+
+    /**
+     * Get the stream which formats the values which are not stored raw.
+     *
+     * The stream keeps its state, as set by the manipulators, until the
+     * end of the record.  Call PutFormatted() after writing to it.
+     *
+     * \returns The formatting stream.
+     */
+    std::ostream& Formatter();
+
+    /** Append the text written to the Formatter() as a TAG_TEXT. */
+    void PutFormatted();
+
+    /**
+     * Check if a type is stored raw.
+     * \tparam T \explicit The type.
+     */
+    template <typename T>
+    static constexpr bool IS_RAW =
+        std::is_same_v<T, bool> || std::is_same_v<T, float> || std::is_same_v<T, double> ||
+        (std::is_integral_v<T> && sizeof(T) <= sizeof(int64_t)) ||
+        (std::is_pointer_v<T> && !std::is_function_v<std::remove_pointer_t<T>> &&
+         !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char> &&
+         !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, signed char> &&
+         !std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, unsigned char> &&
+         !LogBinaryHasStreamer<T>::value);
+
+    /**
+     * Append a value of a type which IS_RAW.
+     * \tparam T \deduced The type.
+     * \param [in] value The value.
+     * \param [in] charAsNumber Whether \c signed \c char and \c unsigned
+     *             \c char are numbers rather than characters.
+     */
+    template <typename T>
+    void PutRaw(T value, bool charAsNumber)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+        {
+            uint8_t raw = value;
+            Put(TAG_BOOL, &raw, sizeof(raw));
+        }
+        else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+        {
+            double raw = value;
+            Put(TAG_DOUBLE, &raw, sizeof(raw));
+        }
+        else if constexpr (std::is_same_v<T, char>)
+        {
+            Put(TAG_CHAR, &value, sizeof(value));
+        }
+        else if constexpr (std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>)
+        {
+            if (charAsNumber)
+            {
+                PutInteger(value);
+            }
+            else
+            {
+                Put(TAG_CHAR, &value, sizeof(value));
+            }
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            PutInteger(value);
+        }
+        else
+        {
+            PutPointer(value);
+        }
+    }
+
+    /**
+     * Whether the Formatter() is in its initial state, so that the raw
+     * values are rendered as they would be formatted.
+     */
+    bool m_plain;
+
+  private:
+    friend class LogBinarySink;
+    struct Buffer;
+
+    std::string* m_data; //!< The record being built, or null without a sink.
+    Buffer* m_buffer;    //!< The buffer of the thread.
+    std::size_t m_depth; //!< The nesting level of the record in the buffer.
+};
+
+/**
+ * \ingroup logging
+ * A binary record of NS_LOG(), whose arguments are streamed as they
+ * would be on \c std::clog.
+ */
+class LogBinaryMessage : public LogBinaryRecord
+{
+  public:
+    using LogBinaryRecord::LogBinaryRecord;
+
+    /**
+     * Stream a value.
+     *
+     * The value is forwarded to the Formatter() as it is to \c std::clog,
+     * so that the output streamers which take a non-const reference
+     * apply.
+     *
+     * \tparam T \deduced The type of the value.
+     * \param [in] value The value.
+     * \returns This record, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryMessage& operator<<(T&& value);
+
+    /**
+     * Stream a string.
+     * \param [in] value The string.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryMessage& operator<<(const std::string& value);
+
+    /**
+     * Stream a C-string.
+     * \param [in] value The C-string.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryMessage& operator<<(const char* value);
+
+    /**
+     * Apply a manipulator, such as \c std::endl.
+     * \param [in] manipulator The manipulator.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryMessage& operator<<(std::ostream& (*manipulator)(std::ostream&));
+
+    /**
+     * Apply a manipulator, such as \c std::hex.
+     * \param [in] manipulator The manipulator.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryMessage& operator<<(std::ios_base& (*manipulator)(std::ios_base&));
+
+    /**
+     * Apply a manipulator of \c std::ios.
+     * \param [in] manipulator The manipulator.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryMessage& operator<<(std::ios& (*manipulator)(std::ios&));
+};
+
+/**
+ * \ingroup logging
+ * A binary record of NS_LOG_FUNCTION(), whose arguments are streamed as
+ * they would be to a ParameterLogger.
+ */
+class LogBinaryParameters : public LogBinaryRecord
+{
+  public:
+    using LogBinaryRecord::LogBinaryRecord;
+
+    /**
+     * Stream a function parameter.
+     * \tparam T \deduced The type of the parameter.
+     * \param [in] param The parameter.
+     * \returns This record, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryParameters& operator<<(const T& param);
+
+    /**
+     * Stream each element of a vector as a parameter.
+     * \tparam T \deduced The type of the elements.
+     * \param [in] vector The parameters.
+     * \returns This record, so it's chainable.
+     */
+    template <typename T>
+    LogBinaryParameters& operator<<(const std::vector<T>& vector);
+
+    /**
+     * Stream a string parameter, which is quoted.
+     * \param [in] param The string.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryParameters& operator<<(const std::string& param);
+
+    /**
+     * Stream a C-string parameter, which is quoted.
+     * \param [in] param The C-string.
+     * \returns This record, so it's chainable.
+     */
+    LogBinaryParameters& operator<<(const char* param);
+};
+
+/*************************************************************************
+ *  Implementation of the templates declared above.
+ *************************************************************************/
+
+template <typename T>
+LogBinaryMessage&
+LogBinaryMessage::operator<<(T&& value)
+{
+    using U = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (std::is_same_v<U, std::string>)
+    {
+        return *this << static_cast<const std::string&>(value);
+    }
+    else
+    {
+        if constexpr (IS_RAW<U>)
+        {
+            if (m_plain)
+            {
+                PutRaw<U>(value, false);
+                return *this;
+            }
+        }
+        Formatter() << std::forward<T>(value);
+        PutFormatted();
+        return *this;
+    }
+}
+
+template <typename T>
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const T& param)
+{
+    if constexpr (IS_RAW<T>)
+    {
+        PutRaw(param, true);
+    }
+    else
+    {
+        Formatter() << param;
+        PutFormatted();
+    }
+    return *this;
+}
+
+template <typename T>
+LogBinaryParameters&
+LogBinaryParameters::operator<<(const std::vector<T>& vector)
+{
+    for (const auto& i : vector)
+    {
+        *this << i;
+    }
+    return *this;
+}
+
+} // namespace ns3
+
+#endif /* NS3_LOG_BINARY_H */
@@ -120,6 +120,22 @@
         std::clog << "[" << g_log.GetLevelLabel(level) << "] ";                                    \
     }
 
+/**
+ * \ingroup logging
+ * Start a binary record of a log message, registering the site of the
+ * logging macro the first time.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ *
+ * \param [in] type The LogBinaryRecord subclass.
+ * \param [in] kind The LogBinaryRecord::Kind of the logging macro.
+ * \param [in] level The log level.
+ */
+#define NS_LOG_BINARY_RECORD(type, kind, level)                                                    \
+    static const uint32_t ns3LogBinarySite =                                                       \
+        ns3::LogBinaryRecord::RegisterSite(g_log, kind, level, __FUNCTION__, __FILE__, __LINE__);  \
+    type(g_log, ns3LogBinarySite)
+
 #ifndef NS_LOG_APPEND_CONTEXT
 /**
  * \ingroup logging
@@ -184,6 +200,12 @@
     {                                                                                              \
         if (g_log.IsEnabled(level))                                                                \
         {                                                                                          \
+            if (ns3::LogIsBinaryEnabled())                                                         \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::LogBinaryMessage, ns3::LogBinaryRecord::MESSAGE, level)  \
+                    << msg;                                                                        \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
@@ -207,6 +229,13 @@
     {                                                                                              \
         if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
         {                                                                                          \
+            if (ns3::LogIsBinaryEnabled())                                                         \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::LogBinaryRecord,                                         \
+                                     ns3::LogBinaryRecord::FUNCTION_NOARGS,                        \
+                                     ns3::LOG_FUNCTION);                                           \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
@@ -241,6 +270,14 @@
     {                                                                                              \
         if (g_log.IsEnabled(ns3::LOG_FUNCTION))                                                    \
         {                                                                                          \
+            if (ns3::LogIsBinaryEnabled())                                                         \
+            {                                                                                      \
+                NS_LOG_BINARY_RECORD(ns3::LogBinaryParameters,                                     \
+                                     ns3::LogBinaryRecord::FUNCTION,                               \
+                                     ns3::LOG_FUNCTION)                                            \
+                    << parameters;                                                                 \
+                break;                                                                             \
+            }                                                                                      \
             NS_LOG_APPEND_TIME_PREFIX;                                                             \
             NS_LOG_APPEND_NODE_PREFIX;                                                             \
             NS_LOG_APPEND_CONTEXT;                                                                 \
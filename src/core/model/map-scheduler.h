@@ -51,6 +51,7 @@ namespace ns3
  * PeekNext()   | Constant        | `std::map::begin()`
  * Remove()     | Logarithmic     | `std::map::find()`
  * RemoveNext() | Constant        | `std::map::begin()`
+ * RemoveCancelled() | Linear      | Filter the map
  *
  * \par Memory Complexity
  *
@@ -80,6 +81,7 @@ class MapScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
 
   private:
     /** Event list type: a Map from EventKey to EventImpl. */
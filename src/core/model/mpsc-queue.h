@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "assert.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup system
+ * \brief A bounded lock-free multiple producer, single consumer queue.
+ *
+ * This is the bounded queue of Dmitry Vyukov: each cell of a circular
+ * buffer carries a sequence number, which tells the producers whether
+ * the cell is free and the consumer whether it holds an item.  The
+ * producers reserve a cell with a single compare-and-swap on the
+ * enqueue position; the consumer owns the dequeue position, and no
+ * atomic read-modify-write is needed to remove an item.
+ *
+ * Push() may be called concurrently from any thread, and fails rather
+ * than blocking when the queue is full.  Pop() and IsEmpty() must only
+ * be called from a single consumer thread.  The items pushed by a
+ * given thread are popped in the order in which they were pushed.
+ *
+ * \tparam T \explicit The type of the items, which must be copyable.
+ */
+template <typename T>
+class MpscQueue
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] capacity The maximum number of items in the queue,
+     *             rounded up to a power of two.
+     */
+    explicit MpscQueue(std::size_t capacity);
+
+    /**
+     * Add an item to the queue.
+     *
+     * \param [in] item The item to add.
+     * \returns \c false if the queue is full.
+     */
+    bool Push(const T& item);
+    /**
+     * Remove the oldest item of the queue.
+     *
+     * \param [out] item The item removed.
+     * \returns \c false if the queue is empty.
+     */
+    bool Pop(T& item);
+    /**
+     * \returns \c true if no item is ready to be popped.
+     */
+    bool IsEmpty() const;
+    /**
+     * \returns The maximum number of items in the queue.
+     */
+    std::size_t GetCapacity() const;
+
+  private:
+    /** A cell of the circular buffer. */
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence; //!< Position at which the cell is next used.
+        T item;                            //!< The item.
+    };
+
+    /** Size of a cache line, to avoid false sharing between positions. */
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> m_buffer; //!< The circular buffer.
+    std::size_t m_mask;               //!< Capacity minus one.
+    /** Position of the next item to push, shared by the producers. */
+    alignas(CACHE_LINE) std::atomic<std::size_t> m_enqueuePos;
+    /** Position of the next item to pop, owned by the consumer. */
+    alignas(CACHE_LINE) std::size_t m_dequeuePos;
+};
+
+} // namespace ns3
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3
+{
+
+template <typename T>
+MpscQueue<T>::MpscQueue(std::size_t capacity)
+    : m_enqueuePos(0),
+      m_dequeuePos(0)
+{
+    NS_ASSERT_MSG(capacity > 0, "The capacity must be positive");
+    std::size_t size = 1;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+    m_buffer.reset(new Cell[size]);
+    m_mask = size - 1;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Push(const T& item)
+{
+    Cell* cell;
+    std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        cell = &m_buffer[pos & m_mask];
+        std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            // The cell is free: try to reserve it
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The cell still holds the item pushed one lap earlier
+            return false;
+        }
+        else
+        {
+            // Another producer reserved the cell
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->item = item;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop(T& item)
+{
+    Cell* cell = &m_buffer[m_dequeuePos & m_mask];
+    std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    if (sequence != m_dequeuePos + 1)
+    {
+        return false;
+    }
+    item = cell->item;
+    cell->sequence.store(m_dequeuePos + m_mask + 1, std::memory_order_release);
+    m_dequeuePos++;
+    return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty() const
+{
+    const Cell* cell = &m_buffer[m_dequeuePos & m_mask];
+    return cell->sequence.load(std::memory_order_acquire) != m_dequeuePos + 1;
+}
+
+template <typename T>
+std::size_t
+MpscQueue<T>::GetCapacity() const
+{
+    return m_mask + 1;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
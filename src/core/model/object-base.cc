@@ -22,11 +22,15 @@
 #include "attribute-construction-list.h"
 #include "environment-variable.h"
 #include "log.h"
+#include "pointer.h"
 #include "string.h"
 #include "trace-source-accessor.h"
 
 #include "ns3/core-config.h"
 
+#include <memory>
+#include <vector>
+
 /**
  * \file
  * \ingroup object
@@ -77,12 +81,30 @@ ObjectBase::NotifyConstructionCompleted()
     NS_LOG_FUNCTION(this);
 }
 
-void
-ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
+/**
+ * Resolve the attributes of a TypeId for the construction of its objects.
+ *
+ * Each attribute settable at construction takes its value from the
+ * AttributeConstructionList, the NS_ATTRIBUTE_DEFAULT environment variable
+ * or its initial value, in this order.  The value is checked, and converted
+ * from a string, once for all the objects, except the strings of a
+ * PointerValue, which create a new object at each conversion.
+ *
+ * \relates ns3::ObjectBase
+ *
+ * \param [in] instanceTid The TypeId of the objects.
+ * \param [in] attributes The attribute values of the construction.
+ * \returns The attributes to set, in the order of the TypeId and its parents.
+ */
+static std::shared_ptr<const AttributeConstructionList::Compiled>
+CompileAttributes(TypeId instanceTid, const AttributeConstructionList& attributes)
 {
+    NS_LOG_FUNCTION(instanceTid.GetName() << &attributes);
+    auto compiled = std::make_shared<AttributeConstructionList::Compiled>();
+    compiled->uid = instanceTid.GetUid();
+    compiled->generation = TypeId::GetAttributeGeneration();
     // loop over the inheritance tree back to the Object base class.
-    NS_LOG_FUNCTION(this << &attributes);
-    TypeId tid = GetInstanceTypeId();
+    TypeId tid = instanceTid;
     do // Do this tid and all parents
     {
         // loop over all attributes in object type
@@ -132,52 +154,96 @@ ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
                 }
             }
 
-            bool initial{false};
             if (!value)
             {
                 // This is guaranteed to exist
                 NS_LOG_DEBUG("falling back to initial value from tid");
                 value = info.initialValue;
                 where = "initial value";
-                initial = true;
             }
 
-            // We have a matching attribute value, if only from the initialValue
-            if (DoSet(info.accessor, info.checker, *value) || initial)
+            AttributeConstructionList::Setting setting;
+            setting.accessor = info.accessor;
+            setting.checker = info.checker;
+            setting.check = !info.checker->Check(*value) &&
+                            dynamic_cast<const PointerChecker*>(PeekPointer(info.checker)) &&
+                            dynamic_cast<const StringValue*>(PeekPointer(value));
+            if (setting.check)
             {
-                // Setting from initial value may fail, e.g. setting
-                // ObjectVectorValue from ""
-                // That's ok, so we still report success since construction is complete
-                NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
-                                            << where);
+                setting.value = value;
             }
             else
+            {
+                setting.value = info.checker->CreateValidValue(*value);
+            }
+            if (!setting.value)
             {
                 /*
-                  One would think this is an error...
-
-                  but there are cases where `attributes.Find(info.checker)`
-                  returns a non-null value which still fails the `DoSet()` call.
-                  For example, `value` is sometimes a real `PointerValue`
-                  containing 0 as the pointed-to address.  Since value
-                  is not null (it just contains null) the initial
-                  value is not used, the DoSet fails, and we end up
-                  here.
-
-                  If we were adventurous we might try to fix this deep
-                  below DoSet, but there be dragons.
-                */
-                /*
-                NS_ASSERT_MSG(false,
-                              "Failed to set attribute '" << info.name << "' from '"
-                                                          << value->SerializeToString(info.checker)
-                                                          << "'");
+                  Setting an invalid value would fail at each construction,
+                  which is not an error: setting from the initial value may
+                  fail, e.g. setting ObjectVectorValue from "", and a value
+                  from the AttributeConstructionList may fail too, e.g. a
+                  PointerValue containing 0 as the pointed-to address.
                 */
+                NS_LOG_DEBUG("skipping \"" << tid.GetName() << "::" << info.name
+                                            << "\", invalid value from " << where);
+                continue;
             }
-
+            compiled->settings.push_back(setting);
+            NS_LOG_DEBUG("construct \"" << tid.GetName() << "::" << info.name << "\" from "
+                                        << where);
         } // for i attributes
         tid = tid.GetParent();
     } while (tid != ObjectBase::GetTypeId());
+    return compiled;
+}
+
+void
+ObjectBase::ConstructSelf(const AttributeConstructionList& attributes)
+{
+    NS_LOG_FUNCTION(this << &attributes);
+    TypeId tid = GetInstanceTypeId();
+    uint64_t generation = TypeId::GetAttributeGeneration();
+    std::shared_ptr<const AttributeConstructionList::Compiled> compiled;
+    if (attributes.IsEmpty())
+    {
+        // The attributes of the objects created without attribute values,
+        // as by CreateObject, are resolved once per TypeId and thread.
+        thread_local std::vector<std::shared_ptr<const AttributeConstructionList::Compiled>>
+            byUid;
+        if (byUid.size() <= tid.GetUid())
+        {
+            byUid.resize(tid.GetUid() + 1);
+        }
+        compiled = byUid[tid.GetUid()];
+        if (!compiled || compiled->generation != generation)
+        {
+            compiled = CompileAttributes(tid, attributes);
+            byUid[tid.GetUid()] = compiled;
+        }
+    }
+    else
+    {
+        // The attributes of the objects created from the same list, as by
+        // an ObjectFactory, are resolved once per list.
+        compiled = attributes.GetCompiled();
+        if (!compiled || compiled->uid != tid.GetUid() || compiled->generation != generation)
+        {
+            compiled = CompileAttributes(tid, attributes);
+            attributes.SetCompiled(compiled);
+        }
+    }
+    for (const auto& setting : compiled->settings)
+    {
+        if (setting.check)
+        {
+            DoSet(setting.accessor, setting.checker, *setting.value);
+        }
+        else
+        {
+            setting.accessor->Set(this, *setting.value);
+        }
+    }
     NotifyConstructionCompleted();
 }
 
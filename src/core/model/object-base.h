@@ -314,6 +314,11 @@ class ObjectBase
      * you should make sure that you invoke this method from
      * your most-derived constructor.
      *
+     * The attributes are resolved, from \pname{attributes}, the
+     * environment and their initial values, once per TypeId and
+     * AttributeConstructionList, and again when their initial values
+     * change (see TypeId::GetAttributeGeneration()).
+     *
      * \param [in] attributes The attribute values used to initialize
      *        the member variables of this object's instance.
      */
@@ -26,6 +26,7 @@
 #include "object-factory.h"
 #include "string.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
@@ -96,11 +97,9 @@ Object::Object()
     : m_tid(Object::GetTypeId()),
       m_disposed(false),
       m_initialized(false),
-      m_aggregates((struct Aggregates*)std::malloc(sizeof(struct Aggregates))),
-      m_getObjectCount(0)
+      m_aggregates(AllocateAggregates(1))
 {
     NS_LOG_FUNCTION(this);
-    m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
 
@@ -118,13 +117,15 @@ Object::~Object()
                          &m_aggregates->buffer[i + 1],
                          sizeof(Object*) * (m_aggregates->n - (i + 1)));
             m_aggregates->n--;
+            // the cached indexes are now stale
+            ClearCache(m_aggregates);
         }
     }
     // finally, if all objects have been removed from the list,
     // delete the aggregate list
     if (m_aggregates->n == 0)
     {
-        std::free(m_aggregates);
+        FreeAggregates(m_aggregates);
     }
     m_aggregates = nullptr;
 }
@@ -133,10 +134,8 @@ Object::Object(const Object& o)
     : m_tid(o.m_tid),
       m_disposed(false),
       m_initialized(false),
-      m_aggregates((struct Aggregates*)std::malloc(sizeof(struct Aggregates))),
-      m_getObjectCount(0)
+      m_aggregates(AllocateAggregates(1))
 {
-    m_aggregates->n = 1;
     m_aggregates->buffer[0] = this;
 }
 
@@ -151,13 +150,36 @@ Ptr<Object>
 Object::DoGetObject(TypeId tid) const
 {
     NS_LOG_FUNCTION(this << tid);
+    return Ptr<Object>(DoPeekObject(tid));
+}
+
+Object*
+Object::DoPeekObject(TypeId tid) const
+{
     NS_ASSERT(CheckLoose());
 
-    uint32_t n = m_aggregates->n;
+    struct Aggregates* aggregates = m_aggregates;
+    uint16_t uid = tid.GetUid();
+    if (uid < aggregates->cacheSize)
+    {
+        uint8_t entry = aggregates->cache[uid];
+        if (entry >= CACHE_INDEX)
+        {
+            return aggregates->buffer[entry - CACHE_INDEX];
+        }
+        if (entry == CACHE_ABSENT)
+        {
+            return nullptr;
+        }
+    }
+
+    uint32_t n = aggregates->n;
     TypeId objectTid = Object::GetTypeId();
-    for (uint32_t i = 0; i < n; i++)
+    Object* found = nullptr;
+    uint32_t i;
+    for (i = 0; i < n; i++)
     {
-        Object* current = m_aggregates->buffer[i];
+        Object* current = aggregates->buffer[i];
         TypeId cur = current->GetInstanceTypeId();
         while (cur != tid && cur != objectTid)
         {
@@ -165,21 +187,29 @@ Object::DoGetObject(TypeId tid) const
         }
         if (cur == tid)
         {
-            // This is an attempt to 'cache' the result of this lookup.
-            // the idea is that if we perform a lookup for a TypeId on this object,
-            // we are likely to perform the same lookup later so, we make sure
-            // that the aggregate array is sorted by the number of accesses
-            // to each object.
-
-            // first, increment the access count
-            current->m_getObjectCount++;
-            // then, update the sort
-            UpdateSortedArray(m_aggregates, i);
-            // finally, return the match
-            return const_cast<Object*>(current);
+            found = current;
+            break;
         }
     }
-    return nullptr;
+    if (n == 1 || (found != nullptr && i >= 256u - CACHE_INDEX))
+    {
+        // Not worth caching, or out of the range of the cache
+        return found;
+    }
+
+    if (uid >= aggregates->cacheSize)
+    {
+        // Make room for all the TypeIds registered so far, so that
+        // the cache is seldom grown
+        uint32_t size = std::max<uint32_t>(uid + 1, TypeId::GetRegisteredN());
+        aggregates->cache = (uint8_t*)std::realloc(aggregates->cache, size);
+        std::memset(&aggregates->cache[aggregates->cacheSize],
+                    CACHE_UNKNOWN,
+                    size - aggregates->cacheSize);
+        aggregates->cacheSize = size;
+    }
+    aggregates->cache[uid] = (found != nullptr) ? CACHE_INDEX + i : CACHE_ABSENT;
+    return found;
 }
 
 void
@@ -188,10 +218,9 @@ Object::Initialize()
     /**
      * Note: the code here is a bit tricky because we need to protect ourselves from
      * modifications in the aggregate array while DoInitialize is called. The user's
-     * implementation of the DoInitialize method could call GetObject (which could
-     * reorder the array) and it could call AggregateObject which would add an
-     * object at the end of the array. To be safe, we restart iteration over the
-     * array whenever we call some user code, just in case.
+     * implementation of the DoInitialize method could call AggregateObject which
+     * would add an object at the end of the array. To be safe, we restart iteration
+     * over the array whenever we call some user code, just in case.
      */
     NS_LOG_FUNCTION(this);
 restart:
@@ -221,8 +250,8 @@ Object::Dispose()
     /**
      * Note: the code here is a bit tricky because we need to protect ourselves from
      * modifications in the aggregate array while DoDispose is called. The user's
-     * DoDispose implementation could call GetObject (which could reorder the array)
-     * and it could call AggregateObject which would add an object at the end of the array.
+     * DoDispose implementation could call AggregateObject which would add an object
+     * at the end of the array.
      * So, to be safe, we restart the iteration over the array whenever we call some
      * user code.
      */
@@ -241,18 +270,30 @@ restart:
     }
 }
 
+struct Object::Aggregates*
+Object::AllocateAggregates(uint32_t n)
+{
+    struct Aggregates* aggregates =
+        (struct Aggregates*)std::malloc(sizeof(struct Aggregates) + (n - 1) * sizeof(Object*));
+    aggregates->n = n;
+    aggregates->cacheSize = 0;
+    aggregates->cache = nullptr;
+    return aggregates;
+}
+
 void
-Object::UpdateSortedArray(struct Aggregates* aggregates, uint32_t j) const
+Object::FreeAggregates(struct Aggregates* aggregates)
 {
-    NS_LOG_FUNCTION(this << aggregates << j);
-    while (j > 0 &&
-           aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j - 1]->m_getObjectCount)
-    {
-        Object* tmp = aggregates->buffer[j - 1];
-        aggregates->buffer[j - 1] = aggregates->buffer[j];
-        aggregates->buffer[j] = tmp;
-        j--;
-    }
+    std::free(aggregates->cache);
+    std::free(aggregates);
+}
+
+void
+Object::ClearCache(struct Aggregates* aggregates)
+{
+    std::free(aggregates->cache);
+    aggregates->cache = nullptr;
+    aggregates->cacheSize = 0;
 }
 
 void
@@ -267,9 +308,7 @@ Object::AggregateObject(Ptr<Object> o)
     Object* other = PeekPointer(o);
     // first create the new aggregate buffer.
     uint32_t total = m_aggregates->n + other->m_aggregates->n;
-    struct Aggregates* aggregates =
-        (struct Aggregates*)std::malloc(sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
-    aggregates->n = total;
+    struct Aggregates* aggregates = AllocateAggregates(total);
 
     // copy our buffer to the new buffer
     std::memcpy(&aggregates->buffer[0],
@@ -287,7 +326,6 @@ Object::AggregateObject(Ptr<Object> o)
                            "Multiple aggregation of objects of type "
                            << other->GetInstanceTypeId() << " on objects of type " << typeId);
         }
-        UpdateSortedArray(aggregates, m_aggregates->n + i);
     }
 
     // keep track of the old aggregate buffers for the iteration
@@ -319,9 +357,10 @@ Object::AggregateObject(Ptr<Object> o)
         current->NotifyNewAggregate();
     }
 
-    // Now that we are done with them, we can free our old aggregate buffers
-    std::free(a);
-    std::free(b);
+    // Now that we are done with them, we can free our old aggregate buffers,
+    // along with the lookups cached in them
+    FreeAggregates(a);
+    FreeAggregates(b);
 }
 
 /**
@@ -342,15 +342,60 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * chunk of memory than the struct to allow space for a larger
      * variable sized buffer whose size is indicated by the element
      * \c n
+     *
+     * The results of DoGetObject() are cached in \c cache, indexed by
+     * the uid of the TypeId looked up, so that a lookup, including a
+     * match of a parent TypeId, costs a single load once the TypeId
+     * has been looked up in the aggregate.  The cache is allocated on
+     * the first lookup in an aggregate of more than one Object, and is
+     * grown as TypeIds with larger uids are looked up; it is dropped
+     * whenever the aggregate changes.  It takes one byte per TypeId, so
+     * the matches beyond the first 253 Objects of an aggregate are not
+     * cached.
      */
     struct Aggregates
     {
         /** The number of entries in \c buffer. */
         uint32_t n;
+        /** The number of entries in \c cache. */
+        uint32_t cacheSize;
+        /**
+         * The lookup results, by TypeId uid: one of the CacheEntry
+         * values, or CACHE_INDEX plus the index in \c buffer of the match.
+         */
+        uint8_t* cache;
         /** The array of Objects. */
         Object* buffer[1];
     };
 
+    /** The special entries of Aggregates::cache. */
+    enum CacheEntry : uint8_t
+    {
+        CACHE_UNKNOWN = 0, //!< The TypeId has not been looked up.
+        CACHE_ABSENT = 1,  //!< No Object of the aggregate matches the TypeId.
+        CACHE_INDEX = 2    //!< The offset of the indexes in the buffer.
+    };
+
+    /**
+     * Allocate a list of aggregates.
+     *
+     * \param [in] n The number of Objects in the list.
+     * \return The list, with an empty cache.
+     */
+    static struct Aggregates* AllocateAggregates(uint32_t n);
+    /**
+     * Free a list of aggregates and its cache.
+     *
+     * \param [in] aggregates The list of aggregated Objects.
+     */
+    static void FreeAggregates(struct Aggregates* aggregates);
+    /**
+     * Drop the cached lookups of a list of aggregates.
+     *
+     * \param [in,out] aggregates The list of aggregated Objects.
+     */
+    static void ClearCache(struct Aggregates* aggregates);
+
     /**
      * Find an Object of TypeId tid in the aggregates of this Object.
      *
@@ -358,6 +403,14 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * \return The matching Object, if it is found
      */
     Ptr<Object> DoGetObject(TypeId tid) const;
+    /**
+     * Find an Object of TypeId tid in the aggregates of this Object,
+     * without taking a reference to it.
+     *
+     * \param [in] tid The TypeId we're looking for
+     * \return The matching Object, if it is found, or \c nullptr
+     */
+    Object* DoPeekObject(TypeId tid) const;
     /**
      * Verify that this Object is still live, by checking it's reference count.
      * \return \c true if the reference count is non zero.
@@ -398,13 +451,6 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      */
     void Construct(const AttributeConstructionList& attributes);
 
-    /**
-     * Keep the list of aggregates in most-recently-used order
-     *
-     * \param [in,out] aggregates The list of aggregated Objects.
-     * \param [in] i The most recently used entry in the list.
-     */
-    void UpdateSortedArray(struct Aggregates* aggregates, uint32_t i) const;
     /**
      * Attempt to delete this Object.
      *
@@ -436,14 +482,6 @@ class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
      * so the size of the array is indirectly a reference count.
      */
     struct Aggregates* m_aggregates;
-    /**
-     * The number of times the Object was accessed with a
-     * call to GetObject().
-     *
-     * This integer is used to implement a heuristic to sort
-     * the array of aggregates in most-frequently accessed order.
-     */
-    uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -470,20 +508,14 @@ template <typename T>
 Ptr<T>
 Object::GetObject() const
 {
-    // This is an optimization: if the cast works (which is likely),
-    // things will be pretty fast.
-    T* result = dynamic_cast<T*>(m_aggregates->buffer[0]);
-    if (result != nullptr)
-    {
-        return Ptr<T>(result);
-    }
-    // if the cast does not work, we try to do a full type check.
-    Ptr<Object> found = DoGetObject(T::GetTypeId());
-    if (found)
+    Object* found = DoPeekObject(T::GetTypeId());
+    if (found != nullptr)
     {
-        return Ptr<T>(static_cast<T*>(PeekPointer(found)));
+        return Ptr<T>(static_cast<T*>(found));
     }
-    return nullptr;
+    // The TypeId of the Object may not match its class, if the class
+    // does not register its own TypeId, so we also try a cast.
+    return Ptr<T>(dynamic_cast<T*>(m_aggregates->buffer[0]));
 }
 
 /**
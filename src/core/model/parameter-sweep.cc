@@ -0,0 +1,435 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "parameter-sweep.h"
+
+#include "command-line.h"
+#include "config.h"
+#include "fatal-error.h"
+#include "log-binary.h"
+#include "log.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "simulator-impl.h"
+#include "simulator.h"
+#include "string.h"
+#include "system-path.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#ifndef __WIN32__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParameterSweep implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ParameterSweep");
+
+namespace
+{
+
+/** The file of the variants, from \c --sweepFile. */
+std::string g_file;
+/** The number of runs of each variant, from \c --sweepRuns. */
+uint32_t g_runs = 1;
+/** The time of the fork, from \c --sweepAt. */
+Time g_at;
+/** The directory of the outputs, from \c --sweepDir. */
+std::string g_dir = "sweep";
+/** The maximum number of children running at a time, from \c --sweepJobs. */
+uint32_t g_jobs = 0;
+
+/** Whether the children are forked, or being forked. */
+bool g_forked = false;
+/** Whether the process is a child. */
+bool g_child = false;
+/** The index of the child. */
+uint32_t g_index = 0;
+/** The overrides of the child. */
+std::vector<std::string> g_overrides;
+
+/** The name of the file of the binary log of a child. */
+const std::string BINARY_LOG = "log.bin";
+/** The name of the summary of the sweep. */
+const std::string SUMMARY = "summary.tsv";
+
+/**
+ * Join overrides.
+ * \param [in] overrides The overrides.
+ * \returns The overrides, separated by spaces.
+ */
+std::string
+Join(const std::vector<std::string>& overrides)
+{
+    std::string joined;
+    for (const auto& item : overrides)
+    {
+        joined += (joined.empty() ? "" : " ") + item;
+    }
+    return joined;
+}
+
+#ifndef __WIN32__
+
+/**
+ * Read the variants.
+ * \returns The overrides of each variant.
+ */
+std::vector<std::vector<std::string>>
+ReadVariants()
+{
+    std::vector<std::vector<std::string>> variants;
+    if (g_file.empty())
+    {
+        variants.emplace_back();
+        return variants;
+    }
+    std::ifstream is(g_file);
+    if (!is.is_open())
+    {
+        NS_FATAL_ERROR("Can't open the sweep file " << g_file);
+    }
+    std::string line;
+    while (std::getline(is, line))
+    {
+        std::vector<std::string> overrides = ParameterSweep::ParseVariant(line);
+        if (!overrides.empty())
+        {
+            variants.push_back(overrides);
+        }
+    }
+    if (variants.empty())
+    {
+        NS_FATAL_ERROR("No variant in the sweep file " << g_file);
+    }
+    return variants;
+}
+
+/**
+ * Redirect a standard stream of the process to a file.
+ * \param [in] fd The file descriptor of the stream.
+ * \param [in] filename The name of the file.
+ */
+void
+Redirect(int fd, const std::string& filename)
+{
+    int file = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0 || dup2(file, fd) < 0)
+    {
+        NS_FATAL_ERROR("Can't redirect to " << filename << ": " << std::strerror(errno));
+    }
+    close(file);
+}
+
+/**
+ * Set up the process as a child of the sweep, then return to the
+ * simulation.
+ * \param [in] index The index of the child.
+ * \param [in] run The run number of the child.
+ * \param [in] overrides The overrides of the child.
+ * \param [in] binaryLog Whether to write a binary log.
+ */
+void
+SetUpChild(uint32_t index,
+           uint64_t run,
+           const std::vector<std::string>& overrides,
+           bool binaryLog)
+{
+    g_child = true;
+    g_index = index;
+    g_overrides = overrides;
+
+    std::string dir = SystemPath::Append(g_dir, std::to_string(index));
+    SystemPath::MakeDirectories(dir);
+    Redirect(STDOUT_FILENO, SystemPath::Append(dir, "stdout"));
+    Redirect(STDERR_FILENO, SystemPath::Append(dir, "stderr"));
+    if (chdir(dir.c_str()) != 0)
+    {
+        NS_FATAL_ERROR("Can't change to the directory " << dir << ": " << std::strerror(errno));
+    }
+    if (binaryLog)
+    {
+        LogEnableBinary(BINARY_LOG);
+    }
+
+    RngSeedManager::SetRun(run);
+    ParameterSweep::Apply(overrides);
+    RandomVariableStream::ReseedAll();
+}
+
+/**
+ * Describe the exit status of a child.
+ * \param [in] status The status returned by \c waitpid().
+ * \returns The description of the status.
+ */
+std::string
+DescribeStatus(int status)
+{
+    if (WIFEXITED(status))
+    {
+        return "exit " + std::to_string(WEXITSTATUS(status));
+    }
+    if (WIFSIGNALED(status))
+    {
+        return "signal " + std::to_string(WTERMSIG(status));
+    }
+    return "unknown";
+}
+
+#endif // __WIN32__
+
+} // unnamed namespace
+
+void
+ParameterSweep::Enable(CommandLine& cmd)
+{
+    NS_LOG_FUNCTION(&cmd);
+    cmd.AddValue("sweepFile",
+                 "The file of the variants of a sweep, one per line of name=value overrides",
+                 g_file);
+    cmd.AddValue("sweepRuns", "The number of runs of each variant of a sweep", g_runs);
+    cmd.AddValue("sweepAt",
+                 "The simulation time of the fork of a sweep, 0 for the start of the run",
+                 g_at);
+    cmd.AddValue("sweepDir", "The directory of the outputs of a sweep", g_dir);
+    cmd.AddValue("sweepJobs",
+                 "The maximum number of children of a sweep running at a time, "
+                 "0 for the number of CPUs",
+                 g_jobs);
+}
+
+bool
+ParameterSweep::IsRequested()
+{
+    return !g_file.empty() || g_runs > 1;
+}
+
+void
+ParameterSweep::Start()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_forked || !IsRequested())
+    {
+        return;
+    }
+    if (g_at > Simulator::Now())
+    {
+        Simulator::Schedule(g_at - Simulator::Now(), &ParameterSweep::Fork);
+    }
+    else
+    {
+        Fork();
+    }
+}
+
+void
+ParameterSweep::Fork()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    if (g_forked || !IsRequested())
+    {
+        return;
+    }
+    g_forked = true;
+#ifdef __WIN32__
+    NS_FATAL_ERROR("ParameterSweep is not supported on Windows");
+#else
+    std::string impl = Simulator::GetImplementation()->GetInstanceTypeId().GetName();
+    NS_ABORT_MSG_IF(impl != "ns3::DefaultSimulatorImpl",
+                    "ParameterSweep forks the process, which needs the single-threaded "
+                    "ns3::DefaultSimulatorImpl, not "
+                    << impl);
+    NS_ABORT_MSG_IF(g_runs == 0, "--sweepRuns must be at least 1");
+
+    std::vector<std::vector<std::string>> variants = ReadVariants();
+    uint32_t children = variants.size() * g_runs;
+    uint32_t jobs = g_jobs;
+    if (jobs == 0)
+    {
+        jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+    uint64_t baseRun = RngSeedManager::GetRun();
+    SystemPath::MakeDirectories(g_dir);
+
+    // The binary log writer is a thread, which the children would not have
+    bool binaryLog = LogIsBinaryEnabled();
+    if (binaryLog)
+    {
+        LogDisableBinary();
+    }
+    std::cout.flush();
+    std::cerr.flush();
+    std::clog.flush();
+    std::fflush(nullptr);
+
+    using Clock = std::chrono::steady_clock;
+    struct Child
+    {
+        uint32_t index;
+        uint64_t run;
+        Clock::time_point start;
+        std::string status;
+        double seconds;
+    };
+
+    std::vector<Child> results(children);
+    std::map<pid_t, uint32_t> running;
+    uint32_t next = 0;
+    uint32_t failures = 0;
+    while (next < children || !running.empty())
+    {
+        if (next < children && running.size() < jobs)
+        {
+            uint32_t index = next++;
+            uint64_t run = baseRun + index % g_runs;
+            results[index] = {index, run, Clock::now(), "", 0};
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                NS_FATAL_ERROR("Can't fork the child " << index << ": " << std::strerror(errno));
+            }
+            if (pid == 0)
+            {
+                SetUpChild(index, run, variants[index / g_runs], binaryLog);
+                return;
+            }
+            NS_LOG_LOGIC("Forked the child " << index << " as " << pid);
+            running[pid] = index;
+            continue;
+        }
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0)
+        {
+            NS_FATAL_ERROR("Can't wait for the children: " << std::strerror(errno));
+        }
+        auto it = running.find(pid);
+        if (it == running.end())
+        {
+            continue;
+        }
+        Child& child = results[it->second];
+        running.erase(it);
+        child.status = DescribeStatus(status);
+        child.seconds = std::chrono::duration<double>(Clock::now() - child.start).count();
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            failures++;
+        }
+    }
+
+    std::string summary = SystemPath::Append(g_dir, SUMMARY);
+    std::ofstream os(summary);
+    if (!os.is_open())
+    {
+        NS_FATAL_ERROR("Can't write the sweep summary " << summary);
+    }
+    os << "index\trun\tstatus\tseconds\toverrides\n";
+    for (const auto& child : results)
+    {
+        os << child.index << "\t" << child.run << "\t" << child.status << "\t" << child.seconds
+           << "\t" << Join(variants[child.index / g_runs]) << "\n";
+    }
+    os.close();
+    std::cout << "Sweep: " << children - failures << " of " << children
+              << " runs succeeded, summary in " << summary << std::endl;
+    std::exit(failures == 0 ? 0 : 1);
+#endif // __WIN32__
+}
+
+bool
+ParameterSweep::IsChild()
+{
+    return g_child;
+}
+
+uint32_t
+ParameterSweep::GetIndex()
+{
+    return g_index;
+}
+
+std::vector<std::string>
+ParameterSweep::GetOverrides()
+{
+    return g_overrides;
+}
+
+std::vector<std::string>
+ParameterSweep::ParseVariant(const std::string& line)
+{
+    NS_LOG_FUNCTION(line);
+    std::istringstream is(line.substr(0, line.find('#')));
+    std::vector<std::string> overrides;
+    std::string item;
+    while (is >> item)
+    {
+        std::size_t equal = item.find('=');
+        NS_ABORT_MSG_IF(equal == 0 || equal == std::string::npos,
+                        "Invalid override \"" << item << "\" in the sweep variant \"" << line
+                                              << "\", expected name=value");
+        overrides.push_back(item);
+    }
+    return overrides;
+}
+
+void
+ParameterSweep::Apply(const std::vector<std::string>& overrides)
+{
+    NS_LOG_FUNCTION(Join(overrides));
+    for (const auto& item : overrides)
+    {
+        std::size_t equal = item.find('=');
+        NS_ABORT_MSG_IF(equal == 0 || equal == std::string::npos,
+                        "Invalid override \"" << item << "\", expected name=value");
+        std::string name = item.substr(0, equal);
+        StringValue value(item.substr(equal + 1));
+        if (name[0] == '/')
+        {
+            Config::Set(name, value);
+        }
+        else if (name.find("::") != std::string::npos)
+        {
+            Config::SetDefault(name, value);
+        }
+        else
+        {
+            Config::SetGlobal(name, value);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::ParameterSweep declaration.
+ */
+
+namespace ns3
+{
+
+class CommandLine;
+
+/**
+ * \ingroup core
+ * \brief Run the variants of a scenario in child processes which share
+ * the setup of the scenario.
+ *
+ * A sweep builds the scenario once, then forks a child process for each
+ * variant and run.  The children share the memory of the setup
+ * copy-on-write; each applies its overrides, sets its run number and
+ * runs the simulation to completion, while the parent waits for them
+ * and writes a summary.  A script gains the sweep options with a single
+ * line before parsing its command line:
+ *
+ * \code
+ *   CommandLine cmd(__FILE__);
+ *   ParameterSweep::Enable(cmd);
+ *   cmd.Parse(argc, argv);
+ * \endcode
+ *
+ * The options are
+ *
+ * - \c --sweepFile: a file of variants, one per line, each a list of
+ *   \c name=value overrides separated by white space.  A name which
+ *   starts with \c / is a Config::Set() path, applied to the objects of
+ *   the scenario; a name with \c :: is a Config::SetDefault() attribute,
+ *   applied to the objects created after the fork; any other name is a
+ *   Config::SetGlobal() global value, such as \c RngRun.  The text after
+ *   a \c # is a comment.
+ * - \c --sweepRuns: the number of runs of each variant.  The run \c r of
+ *   every variant uses the run number of the scenario plus \c r, so the
+ *   variants are compared with common random numbers.
+ * - \c --sweepAt: the simulation time of the fork; by default, the fork
+ *   happens when Simulator::Run() starts, after the setup.
+ * - \c --sweepDir: the directory of the outputs.
+ * - \c --sweepJobs: the maximum number of children running at a time.
+ *
+ * A sweep is requested by \c --sweepFile or by more than one run.  The
+ * child \c i works in the directory \c <sweepDir>/<i>, where its standard
+ * output and error are written to the files \c stdout and \c stderr, and
+ * where the relative paths of the files it opens resolve, and a binary
+ * log enabled by LogEnableBinary() is written to \c log.bin.  The parent
+ * writes the index, run number, exit status, duration and overrides of
+ * each child to \c <sweepDir>/summary.tsv, then exits with status 0 if
+ * all the children succeeded, and 1 otherwise.
+ *
+ * The children share the files opened before the fork, such as trace
+ * files enabled during the setup: open the outputs of each run after the
+ * fork.  The random variable streams alive at the fork are restarted with
+ * the run number of each child by RandomVariableStream::ReseedAll(), and
+ * the values of the command line of the script keep those of the setup.
+ *
+ * The fork requires a single-threaded process: it is only supported with
+ * ns3::DefaultSimulatorImpl, and not on Windows.
+ */
+class ParameterSweep
+{
+  public:
+    /**
+     * Add the sweep options to a command line.
+     *
+     * \param [in,out] cmd The command line.
+     */
+    static void Enable(CommandLine& cmd);
+
+    /**
+     * Check if a sweep is requested.
+     *
+     * \returns \c true if the options request a sweep.
+     */
+    static bool IsRequested();
+
+    /**
+     * Fork the children of the sweep now, if a sweep is requested and the
+     * children are not forked yet.
+     *
+     * The function returns in the children, and in the process when no
+     * sweep is requested; the parent waits for the children and exits.
+     * Call this to fork at a point of the setup, rather than when
+     * Simulator::Run() starts or at the time given by \c --sweepAt.
+     */
+    static void Fork();
+
+    /**
+     * Fork the children now, or schedule the fork at the time given by
+     * \c --sweepAt.
+     *
+     * Called by Simulator::Run().
+     */
+    static void Start();
+
+    /**
+     * Check if the process is a child of a sweep.
+     *
+     * \returns \c true in the children.
+     */
+    static bool IsChild();
+
+    /**
+     * Get the index of the child.
+     *
+     * \returns The index of the child, from 0, or 0 outside the children.
+     */
+    static uint32_t GetIndex();
+
+    /**
+     * Get the overrides of the child.
+     *
+     * \returns The \c name=value overrides of the variant of the child.
+     */
+    static std::vector<std::string> GetOverrides();
+
+    /**
+     * Parse a variant.
+     *
+     * \param [in] line A line of the file of variants.
+     * \returns The \c name=value overrides of the line, which are empty
+     *          for a blank line or a comment.
+     */
+    static std::vector<std::string> ParseVariant(const std::string& line);
+
+    /**
+     * Apply overrides.
+     *
+     * \param [in] overrides The \c name=value overrides.
+     */
+    static void Apply(const std::vector<std::string>& overrides);
+
+}; // class ParameterSweep
+
+} // namespace ns3
+
+#endif /* PARAMETER_SWEEP_H */
@@ -25,6 +25,7 @@
 #include "log.h"
 #include "scheduler.h"
 
+#include <algorithm>
 #include <string>
 
 /**
@@ -106,6 +107,17 @@ PriorityQueueScheduler::EventPriorityQueue::remove(const Scheduler::Event& ev)
     }
 }
 
+void
+PriorityQueueScheduler::EventPriorityQueue::removeCancelled(std::vector<Scheduler::Event>& removed)
+{
+    auto it = std::partition(this->c.begin(), this->c.end(), [](const Scheduler::Event& ev) {
+        return !ev.impl->IsCancelled();
+    });
+    removed.insert(removed.end(), it, this->c.end());
+    this->c.erase(it, this->c.end());
+    std::make_heap(this->c.begin(), this->c.end(), this->comp);
+}
+
 void
 PriorityQueueScheduler::Remove(const Scheduler::Event& ev)
 {
@@ -113,4 +125,11 @@ PriorityQueueScheduler::Remove(const Scheduler::Event& ev)
     m_queue.remove(ev);
 }
 
+void
+PriorityQueueScheduler::RemoveCancelled(std::vector<Scheduler::Event>& removed)
+{
+    NS_LOG_FUNCTION(this);
+    m_queue.removeCancelled(removed);
+}
+
 } // namespace ns3
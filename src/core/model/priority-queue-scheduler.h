@@ -53,6 +53,7 @@ namespace ns3
  * PeekNext()   | Constant         | `std::vector::front()`
  * Remove()     | Linear           | `std::find()` and `std::make_heap()`
  * RemoveNext() | Logarithmic      | `std::pop_heap()`
+ * RemoveCancelled() | Linear       | Filter, `std::make_heap()`
  *
  * \par Memory Complexity
  *
@@ -82,6 +83,7 @@ class PriorityQueueScheduler : public Scheduler
     Scheduler::Event PeekNext() const override;
     Scheduler::Event RemoveNext() override;
     void Remove(const Scheduler::Event& ev) override;
+    void RemoveCancelled(std::vector<Scheduler::Event>& removed) override;
 
   private:
     /**
@@ -98,6 +100,10 @@ class PriorityQueueScheduler : public Scheduler
          * \returns \c true if the event was found, false otherwise.
          */
         bool remove(const Scheduler::Event& ev);
+        /**
+         * \copydoc PriorityQueueScheduler::RemoveCancelled()
+         */
+        void removeCancelled(std::vector<Scheduler::Event>& removed);
 
     }; // class EventPriorityQueue
 
@@ -27,6 +27,7 @@
 #include "assert.h"
 #include "boolean.h"
 #include "double.h"
+#include "enum.h"
 #include "integer.h"
 #include "log.h"
 #include "pointer.h"
@@ -35,8 +36,12 @@
 #include "string.h"
 
 #include <algorithm> // upper_bound
+#include <array>
 #include <cmath>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <sstream>
 
 /**
  * \file
@@ -49,6 +54,321 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("RandomVariableStream");
 
+namespace
+{
+
+/** The number of uniform randoms drawn at a time for the batches of integers. */
+const std::size_t BATCH_SIZE = 64;
+
+/**
+ * The uniform randoms of successive calls to RngStream::RandU01(),
+ * or their antithetic values.
+ */
+class ScalarUniforms
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] rng The stream of the uniform randoms.
+     * \param [in] antithetic Whether to return the antithetic values.
+     */
+    ScalarUniforms(RngStream* rng, bool antithetic)
+        : m_rng(rng),
+          m_antithetic(antithetic)
+    {
+    }
+
+    /**
+     * Draw the next uniform random.
+     * \returns The uniform random.
+     */
+    double operator()()
+    {
+        double u = m_rng->RandU01();
+        return m_antithetic ? (1 - u) : u;
+    }
+
+  private:
+    RngStream* m_rng;  //!< The stream of the uniform randoms.
+    bool m_antithetic; //!< Whether to return the antithetic values.
+};
+
+/**
+ * The uniform randoms of a batch of values, the same as the successive
+ * calls to RngStream::RandU01() for each value.
+ *
+ * The uniform randoms are drawn in place, behind the values.  A value
+ * may consume several uniforms, or a rejected value consume uniforms
+ * without producing a value, so the uniforms of the remaining values
+ * are drawn when they run out: each value needs at least one uniform,
+ * so no uniform is drawn ahead of the successive calls.
+ */
+class BatchUniforms
+{
+  public:
+    /**
+     * Constructor.
+     * \param [in] rng The stream of the uniform randoms.
+     * \param [in] antithetic Whether to return the antithetic values.
+     * \param [out] values The values.
+     * \param [in] count The number of values.
+     */
+    BatchUniforms(RngStream* rng, bool antithetic, double* values, std::size_t count)
+        : m_rng(rng),
+          m_antithetic(antithetic),
+          m_values(values),
+          m_count(count),
+          m_next(0),
+          m_uniform(0),
+          m_drawn(0)
+    {
+    }
+
+    /**
+     * Draw the next uniform random.
+     * \returns The uniform random.
+     */
+    double operator()()
+    {
+        if (m_uniform == m_drawn)
+        {
+            m_rng->RandU01(m_values + m_next, m_count - m_next);
+            m_uniform = m_next;
+            m_drawn = m_count;
+        }
+        double u = m_values[m_uniform++];
+        return m_antithetic ? (1 - u) : u;
+    }
+
+    /**
+     * Store the next value.
+     * \param [in] value The value.
+     */
+    void Put(double value)
+    {
+        m_values[m_next++] = value;
+    }
+
+    /**
+     * Check whether all the values are stored.
+     * \returns \c true if all the values are stored.
+     */
+    bool IsFull() const
+    {
+        return m_next == m_count;
+    }
+
+  private:
+    RngStream* m_rng;      //!< The stream of the uniform randoms.
+    bool m_antithetic;     //!< Whether to return the antithetic values.
+    double* m_values;      //!< The values, then the uniform randoms.
+    std::size_t m_count;   //!< The number of values.
+    std::size_t m_next;    //!< The index of the next value.
+    std::size_t m_uniform; //!< The index of the next uniform random.
+    std::size_t m_drawn;   //!< The end of the uniform randoms.
+};
+
+/**
+ * The layers of the ziggurat of a decreasing density on \f$[0, \infty)\f$.
+ *
+ * The layers are rectangles of equal area \f$v\f$ under the unnormalized
+ * density, with \f$f(0) = 1\f$.  The base layer 0 extends to the virtual
+ * width \f$x_0 = v / f(r)\f$, to hold the tail beyond \f$r\f$.  The layer
+ * \f$i\f$ spans \f$[0, x_i)\f$, and the points of \f$[0, x_{i+1})\f$ are
+ * under the density.  See G. Marsaglia, W. W. Tsang, "The Ziggurat Method
+ * for Generating Random Variables", Journal of Statistical Software 5(8),
+ * 2000, and J. A. Doornik, "An Improved Ziggurat Method to Generate
+ * Normal Random Samples", 2005.
+ *
+ * \tparam N \explicit The number of layers.
+ */
+template <std::size_t N>
+struct Ziggurat
+{
+    /**
+     * Build the layers.
+     * \param [in] r The start of the tail.
+     * \param [in] v The area of each layer.
+     * \param [in] density The unnormalized density.
+     * \param [in] inverse The inverse of the density.
+     */
+    Ziggurat(double r, double v, double (*density)(double), double (*inverse)(double))
+    {
+        x[0] = v / density(r);
+        x[1] = r;
+        for (std::size_t i = 1; i < N - 1; ++i)
+        {
+            x[i + 1] = inverse(v / x[i] + density(x[i]));
+        }
+        x[N] = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            ratio[i] = x[i + 1] / x[i];
+        }
+    }
+
+    std::array<double, N + 1> x; //!< The widths of the layers.
+    std::array<double, N> ratio; //!< The fractions of the layers under the density.
+};
+
+/**
+ * The unnormalized normal density.
+ * \param [in] x The point.
+ * \returns The density.
+ */
+double
+NormalDensity(double x)
+{
+    return std::exp(-0.5 * x * x);
+}
+
+/**
+ * The inverse of NormalDensity() on \f$[0, \infty)\f$.
+ * \param [in] y The density.
+ * \returns The point.
+ */
+double
+NormalInverse(double y)
+{
+    return std::sqrt(-2 * std::log(y));
+}
+
+/**
+ * The unnormalized exponential density.
+ * \param [in] x The point.
+ * \returns The density.
+ */
+double
+ExponentialDensity(double x)
+{
+    return std::exp(-x);
+}
+
+/**
+ * The inverse of ExponentialDensity().
+ * \param [in] y The density.
+ * \returns The point.
+ */
+double
+ExponentialInverse(double y)
+{
+    return -std::log(y);
+}
+
+/** The number of layers of the normal ziggurat. */
+const std::size_t NORMAL_LAYERS = 128;
+/** The start of the tail of the normal ziggurat. */
+const double NORMAL_R = 3.442619855899;
+/** The area of the layers of the normal ziggurat. */
+const double NORMAL_V = 9.91256303526217e-3;
+
+/** The number of layers of the exponential ziggurat. */
+const std::size_t EXPONENTIAL_LAYERS = 256;
+/** The start of the tail of the exponential ziggurat. */
+const double EXPONENTIAL_R = 7.697117470131487;
+/** The area of the layers of the exponential ziggurat. */
+const double EXPONENTIAL_V = 3.949659822581572e-3;
+
+/**
+ * Draw a standard normal random value with the ziggurat method.
+ *
+ * The top bits of a uniform random select the layer, and the other
+ * bits a signed point in it, so a value usually consumes a single
+ * uniform random.
+ *
+ * \tparam Uniforms \deduced The source of the uniform randoms.
+ * \param [in,out] uniforms The source of the uniform randoms.
+ * \returns The normal random value.
+ */
+template <typename Uniforms>
+double
+ZigguratNormal(Uniforms& uniforms)
+{
+    static const Ziggurat<NORMAL_LAYERS> zig(NORMAL_R, NORMAL_V, NormalDensity, NormalInverse);
+    while (true)
+    {
+        double v = uniforms() * NORMAL_LAYERS;
+        auto i = static_cast<std::size_t>(v);
+        double u = 2 * (v - i) - 1;
+        if (std::fabs(u) < zig.ratio[i])
+        {
+            return u * zig.x[i];
+        }
+        if (i == 0)
+        {
+            // The tail beyond r, by Marsaglia's method
+            double x;
+            double y;
+            do
+            {
+                x = -std::log(uniforms()) / NORMAL_R;
+                y = -std::log(uniforms());
+            } while (y + y < x * x);
+            return (u < 0) ? -(NORMAL_R + x) : (NORMAL_R + x);
+        }
+        // The wedge above the density: compare the density at x with a
+        // uniform point between the densities at the layer edges.
+        double x = u * zig.x[i];
+        double f0 = std::exp(-0.5 * (zig.x[i] * zig.x[i] - x * x));
+        double f1 = std::exp(-0.5 * (zig.x[i + 1] * zig.x[i + 1] - x * x));
+        if (f1 + uniforms() * (f0 - f1) < 1.0)
+        {
+            return x;
+        }
+    }
+}
+
+/**
+ * Draw a standard exponential random value with the ziggurat method.
+ *
+ * \tparam Uniforms \deduced The source of the uniform randoms.
+ * \param [in,out] uniforms The source of the uniform randoms.
+ * \returns The exponential random value.
+ */
+template <typename Uniforms>
+double
+ZigguratExponential(Uniforms& uniforms)
+{
+    static const Ziggurat<EXPONENTIAL_LAYERS> zig(EXPONENTIAL_R,
+                                                  EXPONENTIAL_V,
+                                                  ExponentialDensity,
+                                                  ExponentialInverse);
+    while (true)
+    {
+        double v = uniforms() * EXPONENTIAL_LAYERS;
+        auto i = static_cast<std::size_t>(v);
+        double u = v - i;
+        if (u < zig.ratio[i])
+        {
+            return u * zig.x[i];
+        }
+        if (i == 0)
+        {
+            // The tail beyond r is an exponential shifted by r
+            return EXPONENTIAL_R - std::log(uniforms());
+        }
+        double x = u * zig.x[i];
+        double f0 = std::exp(x - zig.x[i]);
+        double f1 = std::exp(x - zig.x[i + 1]);
+        if (f1 + uniforms() * (f0 - f1) < 1.0)
+        {
+            return x;
+        }
+    }
+}
+
+} // unnamed namespace
+
+namespace
+{
+
+/** Protects the list of the random variable streams alive. */
+std::mutex g_streamsMutex;
+/** The first of the random variable streams alive. */
+RandomVariableStream* g_streams = nullptr;
+
+} // unnamed namespace
+
 NS_OBJECT_ENSURE_REGISTERED(RandomVariableStream);
 
 TypeId
@@ -77,17 +397,67 @@ RandomVariableStream::GetTypeId()
 }
 
 RandomVariableStream::RandomVariableStream()
-    : m_rng(nullptr)
+    : m_rng(nullptr),
+      m_streamIndex(0),
+      m_prevStream(nullptr)
 {
     NS_LOG_FUNCTION(this);
+    std::lock_guard<std::mutex> lock(g_streamsMutex);
+    m_nextStream = g_streams;
+    if (m_nextStream != nullptr)
+    {
+        m_nextStream->m_prevStream = this;
+    }
+    g_streams = this;
 }
 
 RandomVariableStream::~RandomVariableStream()
 {
     NS_LOG_FUNCTION(this);
+    {
+        std::lock_guard<std::mutex> lock(g_streamsMutex);
+        if (m_prevStream != nullptr)
+        {
+            m_prevStream->m_nextStream = m_nextStream;
+        }
+        else
+        {
+            g_streams = m_nextStream;
+        }
+        if (m_nextStream != nullptr)
+        {
+            m_nextStream->m_prevStream = m_prevStream;
+        }
+    }
     delete m_rng;
 }
 
+void
+RandomVariableStream::ReseedAll()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    std::lock_guard<std::mutex> lock(g_streamsMutex);
+    for (RandomVariableStream* rv = g_streams; rv != nullptr; rv = rv->m_nextStream)
+    {
+        if (rv->m_rng == nullptr)
+        {
+            continue;
+        }
+        delete rv->m_rng;
+        rv->m_rng = new RngStream(RngSeedManager::GetSeed(),
+                                  rv->m_streamIndex,
+                                  RngSeedManager::GetRun(),
+                                  RngSeedManager::GetEngine());
+        rv->DoReseed();
+    }
+}
+
+void
+RandomVariableStream::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+}
+
 void
 RandomVariableStream::SetAntithetic(bool isAntithetic)
 {
@@ -109,6 +479,26 @@ RandomVariableStream::GetInteger()
     return static_cast<uint32_t>(GetValue());
 }
 
+void
+RandomVariableStream::GetValues(double* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        values[i] = GetValue();
+    }
+}
+
+void
+RandomVariableStream::GetIntegers(uint32_t* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        values[i] = GetInteger();
+    }
+}
+
 void
 RandomVariableStream::SetStream(int64_t stream)
 {
@@ -122,16 +512,19 @@ RandomVariableStream::SetStream(int64_t stream)
         // number assignment.
         uint64_t nextStream = RngSeedManager::GetNextStreamIndex();
         NS_ASSERT(nextStream <= ((1ULL) << 63));
-        m_rng = new RngStream(RngSeedManager::GetSeed(), nextStream, RngSeedManager::GetRun());
+        m_streamIndex = nextStream;
     }
     else
     {
         // The last 2^63 streams are reserved for deterministic stream
         // number assignment.
         uint64_t base = ((1ULL) << 63);
-        uint64_t target = base + stream;
-        m_rng = new RngStream(RngSeedManager::GetSeed(), target, RngSeedManager::GetRun());
+        m_streamIndex = base + stream;
     }
+    m_rng = new RngStream(RngSeedManager::GetSeed(),
+                          m_streamIndex,
+                          RngSeedManager::GetRun(),
+                          RngSeedManager::GetEngine());
     m_stream = stream;
 }
 
@@ -226,6 +619,50 @@ UniformRandomVariable::GetInteger()
     return static_cast<uint32_t>(GetValue(m_min, m_max + 1));
 }
 
+void
+UniformRandomVariable::GetValues(double* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    // The same arithmetic as GetValue(double,double)
+    Peek()->RandU01(values, count);
+    double min = m_min;
+    double max = m_max;
+    bool antithetic = IsAntithetic();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double v = min + values[i] * (max - min);
+        if (antithetic)
+        {
+            v = min + (max - v);
+        }
+        values[i] = v;
+    }
+}
+
+void
+UniformRandomVariable::GetIntegers(uint32_t* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    double batch[BATCH_SIZE];
+    double min = m_min;
+    double max = m_max + 1;
+    bool antithetic = IsAntithetic();
+    for (std::size_t done = 0; done < count; done += BATCH_SIZE)
+    {
+        std::size_t n = std::min(BATCH_SIZE, count - done);
+        Peek()->RandU01(batch, n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            double v = min + batch[i] * (max - min);
+            if (antithetic)
+            {
+                v = min + (max - v);
+            }
+            values[done + i] = static_cast<uint32_t>(v);
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
 TypeId
@@ -393,7 +830,16 @@ ExponentialRandomVariable::GetTypeId()
                           "The upper bound on the values returned by this RNG stream.",
                           DoubleValue(0.0),
                           MakeDoubleAccessor(&ExponentialRandomVariable::m_bound),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Algorithm",
+                          "The algorithm which draws the values: the logarithm of a uniform "
+                          "random, or the faster ziggurat method.",
+                          EnumValue(ExponentialRandomVariable::INVERSION),
+                          MakeEnumAccessor(&ExponentialRandomVariable::m_algorithm),
+                          MakeEnumChecker(ExponentialRandomVariable::INVERSION,
+                                          "Inversion",
+                                          ExponentialRandomVariable::ZIGGURAT,
+                                          "Ziggurat"));
     return tid;
 }
 
@@ -421,6 +867,18 @@ double
 ExponentialRandomVariable::GetValue(double mean, double bound)
 {
     NS_LOG_FUNCTION(this << mean << bound);
+    if (m_algorithm == ZIGGURAT)
+    {
+        ScalarUniforms uniforms(Peek(), IsAntithetic());
+        while (true)
+        {
+            double r = mean * ZigguratExponential(uniforms);
+            if (bound == 0 || r <= bound)
+            {
+                return r;
+            }
+        }
+    }
     while (1)
     {
         // Get a uniform random variable in [0,1].
@@ -455,6 +913,40 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(double* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    double mean = m_mean;
+    double bound = m_bound;
+    BatchUniforms uniforms(Peek(), IsAntithetic(), values, count);
+    while (!uniforms.IsFull())
+    {
+        double r = (m_algorithm == ZIGGURAT) ? mean * ZigguratExponential(uniforms)
+                                             : -mean * std::log(uniforms());
+        if (bound == 0 || r <= bound)
+        {
+            uniforms.Put(r);
+        }
+    }
+}
+
+void
+ExponentialRandomVariable::GetIntegers(uint32_t* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    double batch[BATCH_SIZE];
+    for (std::size_t done = 0; done < count; done += BATCH_SIZE)
+    {
+        std::size_t n = std::min(BATCH_SIZE, count - done);
+        GetValues(batch, n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            values[done + i] = static_cast<uint32_t>(batch[i]);
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
 TypeId
@@ -678,7 +1170,16 @@ NormalRandomVariable::GetTypeId()
                           "The bound on the values returned by this RNG stream.",
                           DoubleValue(INFINITE_VALUE),
                           MakeDoubleAccessor(&NormalRandomVariable::m_bound),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Algorithm",
+                          "The algorithm which draws the values: the polar Box-Muller method, "
+                          "or the faster ziggurat method.",
+                          EnumValue(NormalRandomVariable::POLAR),
+                          MakeEnumAccessor(&NormalRandomVariable::m_algorithm),
+                          MakeEnumChecker(NormalRandomVariable::POLAR,
+                                          "Polar",
+                                          NormalRandomVariable::ZIGGURAT,
+                                          "Ziggurat"));
     return tid;
 }
 
@@ -715,6 +1216,18 @@ double
 NormalRandomVariable::GetValue(double mean, double variance, double bound)
 {
     NS_LOG_FUNCTION(this << mean << variance << bound);
+    if (m_algorithm == ZIGGURAT)
+    {
+        ScalarUniforms uniforms(Peek(), IsAntithetic());
+        while (true)
+        {
+            double x = mean + ZigguratNormal(uniforms) * std::sqrt(variance);
+            if (std::fabs(x - mean) <= bound)
+            {
+                return x;
+            }
+        }
+    }
     if (m_nextValid)
     { // use previously generated
         m_nextValid = false;
@@ -776,6 +1289,36 @@ NormalRandomVariable::GetValue()
     return GetValue(m_mean, m_variance, m_bound);
 }
 
+void
+NormalRandomVariable::GetValues(double* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    if (m_algorithm != ZIGGURAT)
+    {
+        RandomVariableStream::GetValues(values, count);
+        return;
+    }
+    double mean = m_mean;
+    double sigma = std::sqrt(m_variance);
+    double bound = m_bound;
+    BatchUniforms uniforms(Peek(), IsAntithetic(), values, count);
+    while (!uniforms.IsFull())
+    {
+        double x = mean + ZigguratNormal(uniforms) * sigma;
+        if (std::fabs(x - mean) <= bound)
+        {
+            uniforms.Put(x);
+        }
+    }
+}
+
+void
+NormalRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
 TypeId
@@ -797,7 +1340,16 @@ LogNormalRandomVariable::GetTypeId()
                 "The sigma value for the log-normal distribution returned by this RNG stream.",
                 DoubleValue(1.0),
                 MakeDoubleAccessor(&LogNormalRandomVariable::m_sigma),
-                MakeDoubleChecker<double>());
+                MakeDoubleChecker<double>())
+            .AddAttribute("Algorithm",
+                          "The algorithm which draws the normal random values: the polar "
+                          "Box-Muller method, or the faster ziggurat method.",
+                          EnumValue(LogNormalRandomVariable::POLAR),
+                          MakeEnumAccessor(&LogNormalRandomVariable::m_algorithm),
+                          MakeEnumChecker(LogNormalRandomVariable::POLAR,
+                                          "Polar",
+                                          LogNormalRandomVariable::ZIGGURAT,
+                                          "Ziggurat"));
     return tid;
 }
 
@@ -852,6 +1404,12 @@ LogNormalRandomVariable::GetSigma() const
 double
 LogNormalRandomVariable::GetValue(double mu, double sigma)
 {
+    if (m_algorithm == ZIGGURAT)
+    {
+        NS_LOG_FUNCTION(this << mu << sigma);
+        ScalarUniforms uniforms(Peek(), IsAntithetic());
+        return std::exp(sigma * ZigguratNormal(uniforms) + mu);
+    }
     if (m_nextValid)
     { // use previously generated
         m_nextValid = false;
@@ -911,6 +1469,31 @@ LogNormalRandomVariable::GetValue()
     return GetValue(m_mu, m_sigma);
 }
 
+void
+LogNormalRandomVariable::GetValues(double* values, std::size_t count)
+{
+    NS_LOG_FUNCTION(this << values << count);
+    if (m_algorithm != ZIGGURAT)
+    {
+        RandomVariableStream::GetValues(values, count);
+        return;
+    }
+    double mu = m_mu;
+    double sigma = m_sigma;
+    BatchUniforms uniforms(Peek(), IsAntithetic(), values, count);
+    while (!uniforms.IsFull())
+    {
+        uniforms.Put(std::exp(sigma * ZigguratNormal(uniforms) + mu));
+    }
+}
+
+void
+LogNormalRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 NS_OBJECT_ENSURE_REGISTERED(GammaRandomVariable);
 
 TypeId
@@ -1032,6 +1615,13 @@ GammaRandomVariable::GetValue()
     return GetValue(m_alpha, m_beta);
 }
 
+void
+GammaRandomVariable::DoReseed()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextValid = false;
+}
+
 double
 GammaRandomVariable::GetNormalValue(double mean, double variance, double bound)
 {
@@ -1569,6 +2159,13 @@ EmpiricalRandomVariable::GetTypeId()
                           "default is to treat the CDF as a histogram and sample.",
                           BooleanValue(false),
                           MakeBooleanAccessor(&EmpiricalRandomVariable::m_interpolate),
+                          MakeBooleanChecker())
+            .AddAttribute("Alias",
+                          "In sampling mode, select the value with the alias method, "
+                          "in constant time, rather than by the inversion of the CDF.  "
+                          "The values have the same distribution but differ.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&EmpiricalRandomVariable::m_alias),
                           MakeBooleanChecker());
     return tid;
 }
@@ -1626,6 +2223,11 @@ EmpiricalRandomVariable::GetValue()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_alias && !m_interpolate)
+    {
+        return DoSampleAlias();
+    }
+
     double value;
     if (PreSample(value))
     {
@@ -1649,10 +2251,48 @@ EmpiricalRandomVariable::DoSampleCDF(double r)
 {
     NS_LOG_FUNCTION(this << r);
 
-    ValueCDF selector(0, r);
-    auto bound = std::upper_bound(m_emp.begin(), m_emp.end(), selector);
+    return m_emp[Search(r)].value;
+}
+
+std::size_t
+EmpiricalRandomVariable::Search(double r) const
+{
+    // The guide of the interval of r precedes or is the point, as in
+    // BuildTables(), and the expected number of points to skip is less
+    // than two: as many as the points of an interval of probability.
+    auto n = static_cast<double>(m_guide.size());
+    std::size_t i = m_guide[static_cast<std::size_t>(std::floor(r * n))];
+    while (!(r < m_emp[i].cdf))
+    {
+        ++i;
+    }
+    return i;
+}
+
+double
+EmpiricalRandomVariable::DoSampleAlias()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_validated)
+    {
+        Validate();
+    }
+
+    double r = Peek()->RandU01();
+    if (IsAntithetic())
+    {
+        r = (1 - r);
+    }
 
-    return bound->value;
+    // The integer part of r * n selects the column, the fraction its point
+    double x = r * m_aliasPoint.size();
+    auto column = std::min(static_cast<std::size_t>(x), m_aliasPoint.size() - 1);
+    if (x - column < m_aliasProbability[column])
+    {
+        return m_emp[column].value;
+    }
+    return m_emp[m_aliasPoint[column]].value;
 }
 
 double
@@ -1680,8 +2320,7 @@ EmpiricalRandomVariable::DoInterpolate(double r)
     // This code based (loosely) on code by Bruce Mah (Thanks Bruce!)
 
     // search
-    ValueCDF selector(0, r);
-    auto upper = std::upper_bound(m_emp.begin(), m_emp.end(), selector);
+    auto upper = m_emp.begin() + Search(r);
     auto lower = std::prev(upper, 1);
     if (upper == m_emp.begin())
     {
@@ -1705,6 +2344,44 @@ EmpiricalRandomVariable::CDF(double v, double c)
     // NOTE.   These MUST be inserted in non-decreasing order
     NS_LOG_FUNCTION(this << v << c);
     m_emp.emplace_back(v, c);
+    m_validated = false;
+}
+
+void
+EmpiricalRandomVariable::LoadCDF(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+    std::ifstream is(filename);
+    if (!is.is_open())
+    {
+        NS_FATAL_ERROR("Can't open the CDF file " << filename);
+    }
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(is, line))
+    {
+        lineNumber++;
+        std::istringstream iss(line.substr(0, line.find('#')));
+        double v;
+        double c;
+        if (!(iss >> v))
+        {
+            // Blank or comment line
+            continue;
+        }
+        std::string extra;
+        if (!(iss >> c) || (iss >> extra))
+        {
+            NS_FATAL_ERROR("Invalid CDF point at " << filename << ":" << lineNumber << ": "
+                                                   << line);
+        }
+        if (c < 0.0 || c > 1.0)
+        {
+            NS_FATAL_ERROR("Invalid CDF probability at " << filename << ":" << lineNumber
+                                                         << ": " << line);
+        }
+        CDF(v, c);
+    }
 }
 
 void
@@ -1731,7 +2408,67 @@ EmpiricalRandomVariable::Validate()
     {
         NS_FATAL_ERROR("CDF does not cover the whole distribution");
     }
+    BuildTables();
     m_validated = true;
 }
 
+void
+EmpiricalRandomVariable::BuildTables()
+{
+    NS_LOG_FUNCTION(this);
+    std::size_t n = m_emp.size();
+
+    // The guide of the interval j is the first point whose CDF, scaled as
+    // the selector in Search(), is at least j: the points before it have
+    // a CDF less than any selector of the interval, since the scaling is
+    // monotonic.  The last point, with a CDF of 1, ends every search.
+    m_guide.assign(n, 0);
+    std::size_t i = 0;
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        while (std::floor(m_emp[i].cdf * n) < j)
+        {
+            ++i;
+        }
+        m_guide[j] = i;
+    }
+
+    // Vose's alias method: the columns of the points which are less
+    // likely than 1 / n are filled with the more likely points.
+    m_aliasProbability.resize(n);
+    m_aliasPoint.resize(n);
+    std::vector<std::size_t> small;
+    std::vector<std::size_t> large;
+    double prior = 0;
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        m_aliasProbability[k] = (m_emp[k].cdf - prior) * n;
+        m_aliasPoint[k] = k;
+        prior = m_emp[k].cdf;
+        (m_aliasProbability[k] < 1 ? small : large).push_back(k);
+    }
+    while (!small.empty() && !large.empty())
+    {
+        std::size_t less = small.back();
+        small.pop_back();
+        std::size_t more = large.back();
+        m_aliasPoint[less] = more;
+        m_aliasProbability[more] -= 1 - m_aliasProbability[less];
+        if (m_aliasProbability[more] < 1)
+        {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // The rounding errors leave columns with a probability close to 1
+    for (auto k : small)
+    {
+        m_aliasProbability[k] = 1;
+    }
+    for (auto k : large)
+    {
+        m_aliasProbability[k] = 1;
+    }
+}
+
 } // namespace ns3
@@ -152,6 +152,39 @@ class RandomVariableStream : public Object
     // The base implementation returns `(uint32_t)GetValue()`
     virtual uint32_t GetInteger();
 
+    /**
+     * \brief Get the next random values drawn from the distribution.
+     *
+     * The values are those of \p count successive calls to GetValue().
+     * The base implementation calls GetValue(); the distributions which
+     * draw their uniform randoms in blocks override it.
+     *
+     * \param [out] values The random values.
+     * \param [in] count The number of values.
+     */
+    virtual void GetValues(double* values, std::size_t count);
+
+    /**
+     * \brief Get the next random integers drawn from the distribution.
+     *
+     * The integers are those of \p count successive calls to GetInteger().
+     *
+     * \param [out] values The random integers.
+     * \param [in] count The number of integers.
+     */
+    virtual void GetIntegers(uint32_t* values, std::size_t count);
+
+    /**
+     * \brief Restart all the random variable streams alive.
+     *
+     * The streams draw again from the start of their stream numbers, with
+     * the current seed, run number and engine of RngSeedManager, as if they
+     * had been created with them.  This lets a process which changes the
+     * run number after building a scenario, as the children of a
+     * ParameterSweep do, draw the values of that run.
+     */
+    static void ReseedAll();
+
   protected:
     /**
      * \brief Get the pointer to the underlying RngStream.
@@ -159,10 +192,26 @@ class RandomVariableStream : public Object
      */
     RngStream* Peek() const;
 
+    /**
+     * \brief Discard the values drawn ahead from the previous RngStream.
+     *
+     * Called by ReseedAll() after the RngStream is replaced.  The base
+     * implementation does nothing.
+     */
+    virtual void DoReseed();
+
   private:
     /** Pointer to the underlying RngStream. */
     RngStream* m_rng;
 
+    /** The index of the RngStream, allocated or derived from the stream number. */
+    uint64_t m_streamIndex;
+
+    /** The previous random variable stream alive, for ReseedAll(). */
+    RandomVariableStream* m_prevStream;
+    /** The next random variable stream alive, for ReseedAll(). */
+    RandomVariableStream* m_nextStream;
+
     /** Indicates if antithetic values should be generated by this RNG stream. */
     bool m_isAntithetic;
 
@@ -282,6 +331,10 @@ class UniformRandomVariable : public RandomVariableStream
      */
     uint32_t GetInteger() override;
 
+    // Inherited
+    void GetValues(double* values, std::size_t count) override;
+    void GetIntegers(uint32_t* values, std::size_t count) override;
+
   private:
     /** The lower bound on values that can be returned by this RNG stream. */
     double m_min;
@@ -547,10 +600,29 @@ class SequentialRandomVariable : public RandomVariableStream
  *   \f]
  *
  * where \f$u\f$ is a uniform random variable on [0,1).
+ *
+ * \par Ziggurat Algorithm
+ *
+ * With the \c Algorithm attribute set to ZIGGURAT, the values are drawn
+ * with the ziggurat method of Marsaglia and Tsang, in the double
+ * precision variant of Doornik, rather than by inversion.  The top 8
+ * bits of a uniform random select one of 256 layers of equal area under
+ * the density, and the other bits a point in the layer, which is
+ * accepted without any logarithm 99% of the time.  The values have the
+ * same distribution but are not the same as by inversion, and the
+ * antithetic values are not mirrored as above: \f$1 - u\f$ replaces each
+ * uniform random.
  */
 class ExponentialRandomVariable : public RandomVariableStream
 {
   public:
+    /** The algorithms which draw the values. */
+    enum Algorithm
+    {
+        INVERSION, //!< The logarithm of a uniform random.
+        ZIGGURAT   //!< The ziggurat method.
+    };
+
     /**
      * \brief Register this type.
      * \return The object TypeId.
@@ -591,6 +663,8 @@ class ExponentialRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    void GetValues(double* values, std::size_t count) override;
+    void GetIntegers(uint32_t* values, std::size_t count) override;
 
   private:
     /** The mean value of the unbounded exponential distribution. */
@@ -599,6 +673,9 @@ class ExponentialRandomVariable : public RandomVariableStream
     /** The upper bound on values that can be returned by this RNG stream. */
     double m_bound;
 
+    /** The algorithm which draws the values. */
+    Algorithm m_algorithm;
+
 }; // class ExponentialRandomVariable
 
 /**
@@ -963,6 +1040,18 @@ class WeibullRandomVariable : public RandomVariableStream
  *   \f}
  *
  * which now involves the distances \f$u_1\f$ and \f$u_2\f$ are from 1.
+ *
+ * \par Ziggurat Algorithm
+ *
+ * With the \c Algorithm attribute set to ZIGGURAT, the values are drawn
+ * with the ziggurat method of Marsaglia and Tsang, in the double
+ * precision variant of Doornik, rather than by the polar method.  The
+ * top 7 bits of a uniform random select one of 128 layers of equal area
+ * under the density, and the other bits a signed point in the layer,
+ * which is accepted without any logarithm or square root 99% of the
+ * time.  The values have the same distribution but are not the same as
+ * by the polar method, and the antithetic values are not mirrored as
+ * above: \f$1 - u\f$ replaces each uniform random.
  */
 class NormalRandomVariable : public RandomVariableStream
 {
@@ -970,6 +1059,13 @@ class NormalRandomVariable : public RandomVariableStream
     /** Large constant to bound the range. */
     static const double INFINITE_VALUE;
 
+    /** The algorithms which draw the values. */
+    enum Algorithm
+    {
+        POLAR,   //!< The polar Box-Muller method.
+        ZIGGURAT //!< The ziggurat method.
+    };
+
     /**
      * \brief Register this type.
      * \return The object TypeId.
@@ -1016,6 +1112,10 @@ class NormalRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    void GetValues(double* values, std::size_t count) override;
+
+  protected:
+    void DoReseed() override;
 
   private:
     /** The mean value for the normal distribution returned by this RNG stream. */
@@ -1035,6 +1135,9 @@ class NormalRandomVariable : public RandomVariableStream
     /** The algorithm produces two values at a time. Cache parameters for possible reuse.*/
     double m_y;
 
+    /** The algorithm which draws the values. */
+    Algorithm m_algorithm;
+
 }; // class NormalRandomVariable
 
 /**
@@ -1126,6 +1229,12 @@ class NormalRandomVariable : public RandomVariableStream
  *   \f}
  *
  * which now involves the distances \f$u_1\f$ and \f$u_2\f$ are from 1.
+ *
+ * \par Ziggurat Algorithm
+ *
+ * With the \c Algorithm attribute set to ZIGGURAT, the normal random
+ * value \f$v_1 y\f$ is drawn with the ziggurat method, as by
+ * NormalRandomVariable, rather than by the polar method.
  */
 class LogNormalRandomVariable : public RandomVariableStream
 {
@@ -1136,6 +1245,13 @@ class LogNormalRandomVariable : public RandomVariableStream
      */
     static TypeId GetTypeId();
 
+    /** The algorithms which draw the normal random values. */
+    enum Algorithm
+    {
+        POLAR,   //!< The polar Box-Muller method.
+        ZIGGURAT //!< The ziggurat method.
+    };
+
     /**
      * \brief Creates a log-normal distribution RNG with the default
      * values for mu and sigma.
@@ -1167,6 +1283,10 @@ class LogNormalRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    void GetValues(double* values, std::size_t count) override;
+
+  protected:
+    void DoReseed() override;
 
   private:
     /** The mu value for the log-normal distribution returned by this RNG stream. */
@@ -1184,6 +1304,9 @@ class LogNormalRandomVariable : public RandomVariableStream
     /** The algorithm produces two values at a time. Cache parameters for possible reuse.*/
     double m_normal;
 
+    /** The algorithm which draws the normal random values. */
+    Algorithm m_algorithm;
+
 }; // class LogNormalRandomVariable
 
 /**
@@ -1281,6 +1404,9 @@ class GammaRandomVariable : public RandomVariableStream
     double GetValue() override;
     using RandomVariableStream::GetInteger;
 
+  protected:
+    void DoReseed() override;
+
   private:
     /**
      * \brief Returns a random double from a normal distribution with the specified mean, variance,
@@ -1960,6 +2086,25 @@ class DeterministicRandomVariable : public RandomVariableStream
  *
  * See empirical-random-variable-example.cc for an example.
  *
+ * The points of a large CDF, from a file of measurements for example,
+ * can be loaded with LoadCDF().
+ *
+ * \par Performance
+ *
+ * A guide table, built with the validation of the CDF on the first draw,
+ * indexes the first point of each of \f$n\f$ equal intervals of
+ * probability, for a CDF of \f$n\f$ points.  The search of \f$u\f$
+ * starts from its interval, so its expected cost does not grow with the
+ * size of the CDF, for both modes, and the values are those of a search
+ * of the whole CDF.
+ *
+ * In sampling mode, the \c Alias Attribute selects Walker's alias method
+ * instead: \f$u\f$ selects one of \f$n\f$ equally likely columns,
+ * and its remaining bits whether to return the point of the column or
+ * its alias.  A draw always costs a single lookup, but the values differ
+ * from those of inverse transform sampling, although they have the same
+ * distribution.
+ *
  * \par Antithetic Values.
  *
  * If an instance of this RNG is configured to return antithetic values,
@@ -1992,6 +2137,18 @@ class EmpiricalRandomVariable : public RandomVariableStream
      */
     void CDF(double v, double c); // Value, prob <= Value
 
+    /**
+     * \brief Specifies the points of the empirical distribution from a file.
+     *
+     * Each line of the file holds a point, as the value and the CDF at the
+     * value, separated by white space, in the order of CDF().  The blank
+     * lines, and the text from a \c # to the end of a line, are ignored.
+     * It is a fatal error if the file can't be read or a line is not a point.
+     *
+     * \param [in] filename The name of the file.
+     */
+    void LoadCDF(const std::string& filename);
+
     // Inherited
     /**
      * \copydoc RandomVariableStream::GetValue()
@@ -2077,6 +2234,21 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * \returns The interpolated CDF at \pname{r}
      */
     double DoInterpolate(double r);
+    /**
+     * \brief Find the first point with a CDF greater than \p r, with the
+     * guide table.
+     *
+     * \param [in] r The CDF value, less than the CDF of the last point.
+     * \returns The index of the point.
+     */
+    std::size_t Search(double r) const;
+    /**
+     * \brief Sample the CDF as a histogram with the alias tables.
+     * \return The bin value.
+     */
+    double DoSampleAlias();
+    /** \brief Build the guide table and the alias tables of the CDF. */
+    void BuildTables();
 
     /**
      * \brief Comparison operator, for use by std::upper_bound
@@ -2095,6 +2267,17 @@ class EmpiricalRandomVariable : public RandomVariableStream
      * otherwise treat CDF as normal histogram.
      */
     bool m_interpolate;
+    /** If \c true GetValue will sample the histogram with the alias tables. */
+    bool m_alias;
+    /**
+     * The guide table: the index of the first point of each interval of
+     * probability, \f$[j/n, (j+1)/n)\f$, which may hold the search.
+     */
+    std::vector<std::size_t> m_guide;
+    /** The probability of each column of the alias tables to return its own point. */
+    std::vector<double> m_aliasProbability;
+    /** The point returned by each column of the alias tables, otherwise. */
+    std::vector<std::size_t> m_aliasPoint;
 
 }; // class EmpiricalRandomVariable
 
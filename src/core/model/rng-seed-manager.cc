@@ -20,6 +20,7 @@
 
 #include "attribute-helper.h"
 #include "config.h"
+#include "enum.h"
 #include "global-value.h"
 #include "log.h"
 #include "uinteger.h"
@@ -69,6 +70,22 @@ static ns3::GlobalValue g_rngRun("RngRun",
                                  "The substream index used for all streams",
                                  ns3::UintegerValue(1),
                                  ns3::MakeUintegerChecker<uint64_t>());
+/**
+ * \relates RngSeedManager
+ * \anchor GlobalValueRngEngine
+ * The random number generator engine of the streams created after it
+ * is set.  The engines give different numbers from the same seed, run
+ * and stream.
+ *
+ * This is accessible as "--RngEngine" from CommandLine.
+ */
+static ns3::GlobalValue g_rngEngine("RngEngine",
+                                    "The random number generator engine of all rng streams",
+                                    ns3::EnumValue(RngStream::MRG32K3A),
+                                    ns3::MakeEnumChecker(RngStream::MRG32K3A,
+                                                         "MRG32k3a",
+                                                         RngStream::PHILOX4X64,
+                                                         "Philox4x64"));
 
 uint32_t
 RngSeedManager::GetSeed()
@@ -103,6 +120,22 @@ RngSeedManager::GetRun()
     return run;
 }
 
+void
+RngSeedManager::SetEngine(RngStream::Engine engine)
+{
+    NS_LOG_FUNCTION(engine);
+    Config::SetGlobal("RngEngine", EnumValue(engine));
+}
+
+RngStream::Engine
+RngSeedManager::GetEngine()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    EnumValue value;
+    g_rngEngine.GetValue(value);
+    return static_cast<RngStream::Engine>(value.Get());
+}
+
 uint64_t
 RngSeedManager::GetNextStreamIndex()
 {
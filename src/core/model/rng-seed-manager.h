@@ -19,6 +19,8 @@
 #ifndef RNG_SEED_MANAGER_H
 #define RNG_SEED_MANAGER_H
 
+#include "rng-stream.h"
+
 #include <stdint.h>
 
 /**
@@ -99,6 +101,29 @@ class RngSeedManager
      */
     static uint64_t GetRun();
 
+    /**
+     * \brief Set the engine of the random number generator.
+     *
+     * The engine applies to the RandomVariableStream objects which
+     * get their stream after this call.  The default MRG32k3a jumps
+     * ahead in its sequence to start a stream; the counter-based
+     * Philox4x64 starts a stream in constant time, which matters for
+     * simulations with a very large number of streams.
+     *
+     * \code
+     *   RngSeedManager::SetEngine(RngStream::PHILOX4X64);
+     * \endcode
+     *
+     * \param [in] engine The engine.
+     */
+    static void SetEngine(RngStream::Engine engine);
+    /**
+     * \brief Get the engine of the random number generator.
+     * \returns The engine.
+     * \see SetEngine
+     */
+    static RngStream::Engine GetEngine();
+
     /**
      * Get the next automatically assigned stream index.
      * \returns The next stream index.
@@ -328,18 +328,210 @@ void PowerOfTwoMatrix (int n, Matrix a1p, Matrix a2p)
     }
 }
 
+
+/** Number of lanes of the batch generator. */
+const std::size_t LANES = 8;
+
+/** Smallest number of successive randoms computed by each lane, a power of 2. */
+const std::size_t MIN_BLOCK = 16;
+
+/** Number of steps of the lanes held before their randoms are stored. */
+const std::size_t TILE = 16;
+
+/** 2<sup>32</sup> MOD m1, since m1 = 2<sup>32</sup> - 209. */
+const uint64_t d1 = 209;
+
+/** 2<sup>32</sup> MOD m2, since m2 = 2<sup>32</sup> - 22853. */
+const uint64_t d2 = 22853;
+
+/**
+ * Partially reduce \c v MOD m, where m = 2<sup>32</sup> - d:
+ * the result is congruent to \c v, and less than
+ * (v / 2<sup>32</sup> + 1) * 2<sup>32</sup>.
+ *
+ * \param [in] v The value to reduce.
+ * \param [in] d The difference between 2<sup>32</sup> and m.
+ * \returns The reduced value.
+ */
+inline uint64_t FoldModM (uint64_t v, uint64_t d)
+{
+  return (v >> 32) * d + (v & 0xffffffff);
+}
+
+//-------------------------------------------------------------------------
+/**
+ * Compute the vector v = A*s MOD m, where m = 2<sup>32</sup> - d,
+ * with 64 bit integers.  Works also when v = s.
+ *
+ * The entries of \c A and \c s are less than m, so each product
+ * is folded below 2<sup>48</sup>, their sum is folded twice below
+ * 2<sup>32</sup> + 2<sup>17</sup>, and one subtraction of m completes
+ * the reduction.  This is much faster than MatVecModM().
+ *
+ * \param [in] A Matrix argument, 3x3.
+ * \param [in] s Three component input vector.
+ * \param [out] v Three component output vector.
+ * \param [in] d The difference between 2<sup>32</sup> and m.
+ */
+void IntMatVecModM (const Matrix A, const uint64_t s[3], uint64_t v[3],
+                    uint64_t d)
+{
+  uint64_t m = (uint64_t (1) << 32) - d;
+  uint64_t x[3];               // Necessary if v = s
+
+  for (int i = 0; i < 3; ++i)
+    {
+      x[i] = 0;
+      for (int j = 0; j < 3; ++j)
+        {
+          x[i] += FoldModM (static_cast<uint64_t> (A[i][j]) * s[j], d);
+        }
+      x[i] = FoldModM (FoldModM (x[i], d), d);
+      if (x[i] >= m)
+        {
+          x[i] -= m;
+        }
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+      v[i] = x[i];
+    }
+}
+
 } // namespace MRG32k3a
 
 // clang-format on
 
+/** Namespace for Philox4x64 implementation details. */
+namespace Philox4x64
+{
+
+/** First round multiplier. */
+const uint64_t M0 = 0xD2E7470EE14C6C93ULL;
+
+/** Second round multiplier. */
+const uint64_t M1 = 0xCA5A826395121157ULL;
+
+/** First key increment, the golden ratio. */
+const uint64_t W0 = 0x9E3779B97F4A7C15ULL;
+
+/** Second key increment, sqrt(3) - 1. */
+const uint64_t W1 = 0xBB67AE8584CAA73BULL;
+
+/** The number of rounds. */
+const int ROUNDS = 10;
+
+/**
+ * Compute the 128 bit product of two 64 bit integers.
+ *
+ * \param [in] a The first factor.
+ * \param [in] b The second factor.
+ * \param [out] hi The high 64 bits of the product.
+ * \param [out] lo The low 64 bits of the product.
+ */
+inline void
+MulHiLo(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo)
+{
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<uint64_t>(product >> 64);
+    lo = static_cast<uint64_t>(product);
+#else
+    uint64_t aLo = a & 0xffffffff;
+    uint64_t aHi = a >> 32;
+    uint64_t bLo = b & 0xffffffff;
+    uint64_t bHi = b >> 32;
+    uint64_t ll = aLo * bLo;
+    uint64_t lh = aLo * bHi;
+    uint64_t hl = aHi * bLo;
+    uint64_t hh = aHi * bHi;
+    uint64_t middle = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+    hi = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+    lo = (middle << 32) | (ll & 0xffffffff);
+#endif
+}
+
+/**
+ * Compute the block of random bits of a counter.
+ *
+ * \param [in] counter The counter.
+ * \param [in] key The key.
+ * \param [out] block The random bits.
+ */
+void
+Block(const uint64_t counter[4], const uint64_t key[2], uint64_t block[4])
+{
+    uint64_t x0 = counter[0];
+    uint64_t x1 = counter[1];
+    uint64_t x2 = counter[2];
+    uint64_t x3 = counter[3];
+    uint64_t k0 = key[0];
+    uint64_t k1 = key[1];
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        if (round > 0)
+        {
+            k0 += W0;
+            k1 += W1;
+        }
+        uint64_t hi0;
+        uint64_t lo0;
+        uint64_t hi1;
+        uint64_t lo1;
+        MulHiLo(M0, x0, hi0, lo0);
+        MulHiLo(M1, x2, hi1, lo1);
+        x0 = hi1 ^ x1 ^ k0;
+        x1 = lo1;
+        x2 = hi0 ^ x3 ^ k1;
+        x3 = lo0;
+    }
+    block[0] = x0;
+    block[1] = x1;
+    block[2] = x2;
+    block[3] = x3;
+}
+
+/**
+ * Convert random bits to a random in (0, 1), as MRG32k3a: the top 52
+ * bits, and half of the step, so that neither 0 nor 1 is returned.
+ *
+ * \param [in] bits The random bits.
+ * \returns The random.
+ */
+inline double
+ToU01(uint64_t bits)
+{
+    return (static_cast<double>(bits >> 12) + 0.5) * (1.0 / 4503599627370496.0);
+}
+
+} // namespace Philox4x64
+
 namespace ns3
 {
 
 using namespace MRG32k3a;
 
+double
+RngStream::PhiloxU01()
+{
+    if (m_next == 4)
+    {
+        uint64_t counter[4] = {m_counter[0], m_counter[1], 0, 0};
+        Philox4x64::Block(counter, m_key, m_block);
+        m_counter[0]++;
+        m_next = 0;
+    }
+    return Philox4x64::ToU01(m_block[m_next++]);
+}
+
 double
 RngStream::RandU01()
 {
+    if (m_engine == PHILOX4X64)
+    {
+        return PhiloxU01();
+    }
+
     int32_t k;
     double p1;
     double p2;
@@ -375,8 +567,121 @@ RngStream::RandU01()
     return u;
 }
 
-RngStream::RngStream(uint32_t seedNumber, uint64_t stream, uint64_t substream)
+void
+RngStream::RandU01(double* values, std::size_t count)
+{
+    if (m_engine == PHILOX4X64)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] = PhiloxU01();
+        }
+        return;
+    }
+
+    std::size_t done = 0;
+    while (count - done >= LANES * MIN_BLOCK)
+    {
+        // Each lane computes a block of successive randoms: the lanes start
+        // a power of 2 of steps apart, and the last lane ends where the
+        // stream continues.  The lanes run the steps of RandU01() side by
+        // side, so that the compiler can vectorize them.
+        int log2Block = 0;
+        while ((LANES << (log2Block + 1)) <= count - done)
+        {
+            ++log2Block;
+        }
+        std::size_t block = std::size_t(1) << log2Block;
+        Matrix a1p;
+        Matrix a2p;
+        PowerOfTwoMatrix(log2Block, a1p, a2p);
+
+        double x[3][LANES];
+        double y[3][LANES];
+        uint64_t s1[3];
+        uint64_t s2[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            s1[k] = static_cast<uint64_t>(m_currentState[k]);
+            s2[k] = static_cast<uint64_t>(m_currentState[k + 3]);
+        }
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+            if (lane > 0)
+            {
+                IntMatVecModM(a1p, s1, s1, d1);
+                IntMatVecModM(a2p, s2, s2, d2);
+            }
+            for (int k = 0; k < 3; ++k)
+            {
+                x[k][lane] = static_cast<double>(s1[k]);
+                y[k][lane] = static_cast<double>(s2[k]);
+            }
+        }
+
+        double tile[TILE][LANES];
+        for (std::size_t first = 0; first < block; first += TILE)
+        {
+            for (std::size_t t = 0; t < TILE; ++t)
+            {
+                for (std::size_t lane = 0; lane < LANES; ++lane)
+                {
+                    // The arithmetic of RandU01(), with the branches
+                    // replaced by selections of constants
+                    double p1 = a12 * x[1][lane] - a13n * x[0][lane];
+                    p1 -= static_cast<int32_t>(p1 / m1) * m1;
+                    p1 += (p1 < 0.0) ? m1 : 0.0;
+                    x[0][lane] = x[1][lane];
+                    x[1][lane] = x[2][lane];
+                    x[2][lane] = p1;
+
+                    double p2 = a21 * y[2][lane] - a23n * y[0][lane];
+                    p2 -= static_cast<int32_t>(p2 / m2) * m2;
+                    p2 += (p2 < 0.0) ? m2 : 0.0;
+                    y[0][lane] = y[1][lane];
+                    y[1][lane] = y[2][lane];
+                    y[2][lane] = p2;
+
+                    tile[t][lane] = (p1 - p2 + ((p1 > p2) ? 0.0 : m1)) * norm;
+                }
+            }
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                double* out = values + done + lane * block + first;
+                for (std::size_t t = 0; t < TILE; ++t)
+                {
+                    out[t] = tile[t][lane];
+                }
+            }
+        }
+
+        for (int k = 0; k < 3; ++k)
+        {
+            m_currentState[k] = x[k][LANES - 1];
+            m_currentState[k + 3] = y[k][LANES - 1];
+        }
+        done += LANES * block;
+    }
+
+    for (; done < count; ++done)
+    {
+        values[done] = RandU01();
+    }
+}
+
+RngStream::RngStream(uint32_t seedNumber, uint64_t stream, uint64_t substream, Engine engine)
+    : m_engine(engine),
+      m_currentState{0, 0, 0, 0, 0, 0},
+      m_key{stream, seedNumber},
+      m_counter{0, substream},
+      m_block{0, 0, 0, 0},
+      m_next(4)
 {
+    if (m_engine == PHILOX4X64)
+    {
+        // The stream and substream are part of the key and counter
+        return;
+    }
     if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
     {
         NS_FATAL_ERROR("invalid Seed " << seedNumber);
@@ -390,6 +695,11 @@ RngStream::RngStream(uint32_t seedNumber, uint64_t stream, uint64_t substream)
 }
 
 RngStream::RngStream(const RngStream& r)
+    : m_engine(r.m_engine),
+      m_key{r.m_key[0], r.m_key[1]},
+      m_counter{r.m_counter[0], r.m_counter[1]},
+      m_block{r.m_block[0], r.m_block[1], r.m_block[2], r.m_block[3]},
+      m_next(r.m_next)
 {
     for (int i = 0; i < 6; ++i)
     {
@@ -18,6 +18,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <cstddef>
 #include <stdint.h>
 #include <string>
 
@@ -45,18 +46,34 @@ namespace ns3
  * holds a static instance of this class.  The details of this
  * class are explained in:
  * http://www.iro.umontreal.ca/~lecuyer/myftp/papers/streams00.pdf
+ *
+ * The class can also run the counter-based generator Philox4x64-10,
+ * explained in:
+ * https://www.thesalmons.org/john/random123/papers/random123sc11.pdf
+ * Its random numbers are a block cipher of their position in the
+ * stream, keyed by the seed and the stream number, so that a stream and
+ * substream start in constant time, while MRG32k3a jumps ahead in its
+ * sequence.  The two engines give different numbers.
  */
 class RngStream
 {
   public:
+    /** The random number generator engines. */
+    enum Engine
+    {
+        MRG32K3A,  //!< The combined multiple-recursive generator MRG32k3a.
+        PHILOX4X64 //!< The counter-based generator Philox4x64-10.
+    };
+
     /**
      * Construct from explicit seed, stream and substream values.
      *
      * \param [in] seed The starting seed.
      * \param [in] stream The stream number.
      * \param [in] substream The sub-stream number.
+     * \param [in] engine The engine.
      */
-    RngStream(uint32_t seed, uint64_t stream, uint64_t substream);
+    RngStream(uint32_t seed, uint64_t stream, uint64_t substream, Engine engine = MRG32K3A);
     /**
      * Copy constructor.
      *
@@ -70,6 +87,19 @@ class RngStream
      * \returns The next random.
      */
     double RandU01();
+    /**
+     * Generate the next random numbers for this stream, as many
+     * successive calls to RandU01() would.
+     *
+     * Large batches are split in blocks of successive numbers, which
+     * are computed side by side from states obtained by jumping ahead in
+     * the stream, so that the steps vectorize.  The arithmetic is the same
+     * as RandU01(), so are the numbers.
+     *
+     * \param [out] values The randoms, uniformly distributed between 0 and 1.
+     * \param [in] count The number of randoms.
+     */
+    void RandU01(double* values, std::size_t count);
 
   private:
     /**
@@ -81,8 +111,26 @@ class RngStream
      */
     void AdvanceNthBy(uint64_t nth, int by, double state[6]);
 
-    /** The RNG state vector. */
+    /**
+     * Generate the next random number of the Philox4x64 engine.
+     * \returns The next random.
+     */
+    double PhiloxU01();
+
+    /** The engine. */
+    Engine m_engine;
+
+    /** The RNG state vector of MRG32k3a. */
     double m_currentState[6];
+
+    /** The key of Philox4x64: the stream and the seed. */
+    uint64_t m_key[2];
+    /** The counter of the next block of Philox4x64: its index and the substream. */
+    uint64_t m_counter[2];
+    /** The current block of Philox4x64. */
+    uint64_t m_block[4];
+    /** The index of the next random in the current block. */
+    uint32_t m_next;
 };
 
 } // namespace ns3
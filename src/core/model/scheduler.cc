@@ -20,6 +20,7 @@
 #include "scheduler.h"
 
 #include "assert.h"
+#include "event-impl.h"
 #include "log.h"
 
 /**
@@ -47,4 +48,27 @@ Scheduler::GetTypeId()
     return tid;
 }
 
+void
+Scheduler::RemoveCancelled(std::vector<Event>& removed)
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Event> live;
+    while (!IsEmpty())
+    {
+        Event ev = RemoveNext();
+        if (ev.impl->IsCancelled())
+        {
+            removed.push_back(ev);
+        }
+        else
+        {
+            live.push_back(ev);
+        }
+    }
+    for (const auto& ev : live)
+    {
+        Insert(ev);
+    }
+}
+
 } // namespace ns3
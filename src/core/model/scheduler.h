@@ -23,6 +23,7 @@
 #include "object.h"
 
 #include <stdint.h>
+#include <vector>
 
 /**
  * \file
@@ -226,6 +227,20 @@ class Scheduler : public Object
      * \param [in] ev The event to remove
      */
     virtual void Remove(const Event& ev) = 0;
+    /**
+     * Remove all the cancelled events from the event list.
+     *
+     * The default implementation empties the event list and inserts
+     * back the events which are not cancelled.  Subclasses which do
+     * not accept the insertion of events earlier than the last event
+     * removed must override it; others may override it with a more
+     * efficient version.
+     *
+     * \param [out] removed The cancelled events are appended to this
+     *             vector, in no particular order.  As for Remove(),
+     *             the caller is responsible for unreferencing them.
+     */
+    virtual void RemoveCancelled(std::vector<Event>& removed);
 };
 
 /**
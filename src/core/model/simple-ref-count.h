@@ -27,6 +27,10 @@
 #include <limits>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup ptr
@@ -75,6 +79,10 @@ class Empty
  *      to the object it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * When ns-3 is built with multithreaded simulation support (NS3_MTP),
+ * the counter is atomic so that references can be taken and released
+ * concurrently by the threads of the MultithreadedSimulatorImpl.
  */
 template <typename T, typename PARENT = Empty, typename DELETER = DefaultDeleter<T>>
 class SimpleRefCount : public PARENT
@@ -114,7 +122,11 @@ class SimpleRefCount : public PARENT
     inline void Ref() const
     {
         NS_ASSERT(m_count < std::numeric_limits<uint32_t>::max());
+#ifdef NS3_MTP
+        m_count.fetch_add(1, std::memory_order_relaxed);
+#else
         m_count++;
+#endif
     }
 
     /**
@@ -125,8 +137,12 @@ class SimpleRefCount : public PARENT
      */
     inline void Unref() const
     {
+#ifdef NS3_MTP
+        if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+#else
         m_count--;
         if (m_count == 0)
+#endif
         {
             DELETER::Delete(static_cast<T*>(const_cast<SimpleRefCount*>(this)));
         }
@@ -151,7 +167,11 @@ class SimpleRefCount : public PARENT
      * Note we make this mutable so that the const methods can still
      * change it.
      */
+#ifdef NS3_MTP
+    mutable std::atomic<uint32_t> m_count;
+#else
     mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
@@ -100,6 +100,18 @@ class SimulatorImpl : public Object
     virtual uint32_t GetContext() const = 0;
     /** \copydoc Simulator::GetEventCount */
     virtual uint64_t GetEventCount() const = 0;
+    /**
+     * \copydoc Simulator::GetLiveEventCount
+     *
+     * The default implementation does not track the events.
+     */
+    virtual uint64_t GetLiveEventCount() const;
+    /**
+     * \copydoc Simulator::GetCancelledEventCount
+     *
+     * The default implementation does not track the events.
+     */
+    virtual uint64_t GetCancelledEventCount() const;
 
     /**
      * Hook called before processing each event.
@@ -0,0 +1,390 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "simulator-stats.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "event-profiler.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "type-id.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <thread>
+
+#ifndef __WIN32__
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorStats implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SimulatorStats");
+
+namespace
+{
+
+/** The magic string at the start of a segment. */
+const char MAGIC[8] = {'N', 'S', '3', 'S', 'T', 'A', 'T', 'S'};
+
+/** The prefix of the names of the event counts by module. */
+const std::string EVENTS_PREFIX = "events/";
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "The sequence lock is shared between processes");
+
+/**
+ * \ingroup simulator
+ * Get the gauges.
+ * \returns The gauges, by name.
+ */
+std::vector<std::pair<std::string, Callback<uint64_t>>>&
+GetGauges()
+{
+    static std::vector<std::pair<std::string, Callback<uint64_t>>> gauges;
+    return gauges;
+}
+
+/**
+ * \ingroup simulator
+ * Get the module of an event type.
+ *
+ * The qualified names of the type of the event are tried in turn, each
+ * from the longest to its outermost scope, until one is a TypeId with a
+ * group name.
+ *
+ * \param [in] type The dynamic type of the event.
+ * \returns The group name of the TypeId, or \c "other".
+ */
+std::string
+GetModuleName(const std::type_info& type)
+{
+    std::string name = EventProfiler::GetEventTypeName(type);
+    std::size_t pos = name.find("ns3::");
+    while (pos != std::string::npos)
+    {
+        std::size_t end = pos;
+        while (end < name.size() &&
+               (std::isalnum(static_cast<unsigned char>(name[end])) || name[end] == '_' ||
+                name[end] == ':'))
+        {
+            end++;
+        }
+        std::string candidate = name.substr(pos, end - pos);
+        while (candidate.size() >= 2 && candidate.compare(candidate.size() - 2, 2, "::") == 0)
+        {
+            candidate.resize(candidate.size() - 2);
+        }
+        while (true)
+        {
+            TypeId tid;
+            if (TypeId::LookupByNameFailSafe(candidate, &tid) && !tid.GetGroupName().empty())
+            {
+                return tid.GetGroupName();
+            }
+            std::size_t scope = candidate.rfind("::");
+            if (scope == std::string::npos || scope <= 3)
+            {
+                break;
+            }
+            candidate.resize(scope);
+        }
+        pos = name.find("ns3::", end);
+    }
+    return "other";
+}
+
+/**
+ * \ingroup simulator
+ * Get the resident memory of the process.
+ * \returns The resident memory, in bytes, or 0 if unknown.
+ */
+uint64_t
+GetResidentMemory()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (statm >> size >> resident)
+    {
+        return resident * sysconf(_SC_PAGESIZE);
+    }
+#endif
+    return 0;
+}
+
+} // unnamed namespace
+
+SimulatorStats::SimulatorStats(const std::string& path, uint32_t period, Time interval)
+    : m_segment(nullptr),
+      m_period(period),
+      m_random(0x2545f4914f6cdd1d),
+      m_interval(std::chrono::nanoseconds(interval.GetNanoSeconds())),
+      m_start(Clock::now()),
+      m_last(m_start),
+      m_lastEvents(0)
+{
+    NS_LOG_FUNCTION(this << path << period << interval);
+    NS_ASSERT_MSG(period > 0, "The sampling period must be positive");
+    m_gap = period;
+#ifdef __WIN32__
+    NS_FATAL_ERROR("SimulatorStats is not supported on Windows");
+#else
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, sizeof(Segment)) != 0)
+    {
+        NS_FATAL_ERROR("Can't create the statistics file " << path << ": " << strerror(errno));
+    }
+    void* address = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        NS_FATAL_ERROR("Can't map the statistics file " << path << ": " << strerror(errno));
+    }
+    m_segment = new (address) Segment{};
+    std::memcpy(m_segment->magic, MAGIC, sizeof(MAGIC));
+    m_segment->version = VERSION;
+    m_segment->pid = getpid();
+#endif
+}
+
+SimulatorStats::~SimulatorStats()
+{
+    NS_LOG_FUNCTION(this);
+#ifndef __WIN32__
+    if (m_segment != nullptr)
+    {
+        munmap(m_segment, sizeof(Segment));
+    }
+#endif
+}
+
+bool
+SimulatorStats::DoSample(const EventImpl* event)
+{
+    auto it = m_modules.find(&typeid(*event));
+    if (it == m_modules.end())
+    {
+        std::size_t slot = GetSlot(EVENTS_PREFIX + GetModuleName(typeid(*event)));
+        it = m_modules.emplace(&typeid(*event), slot).first;
+    }
+    if (it->second < MAX_COUNTERS)
+    {
+        m_estimates[it->second] += m_period;
+    }
+
+    if (m_period == 1)
+    {
+        m_gap = 1;
+    }
+    else
+    {
+        // xorshift64, as the EventProfiler, uniform in [1, 2 * period - 1]
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        m_gap = 1 + m_random % (2 * uint64_t(m_period) - 1);
+    }
+    return Clock::now() - m_last >= m_interval;
+}
+
+std::size_t
+SimulatorStats::GetSlot(const std::string& name)
+{
+    for (std::size_t slot = 0; slot < m_names.size(); ++slot)
+    {
+        if (m_names[slot] == name)
+        {
+            return slot;
+        }
+    }
+    if (m_names.size() == MAX_COUNTERS)
+    {
+        NS_LOG_WARN("No counter left for " << name);
+        return MAX_COUNTERS;
+    }
+    m_names.push_back(name);
+    m_estimates.push_back(0);
+    return m_names.size() - 1;
+}
+
+void
+SimulatorStats::Update(Time now,
+                       uint64_t events,
+                       uint64_t scheduled,
+                       uint64_t cancelled,
+                       bool running)
+{
+    NS_LOG_FUNCTION(this << now << events << scheduled << cancelled << running);
+    if (m_segment == nullptr)
+    {
+        return;
+    }
+    Clock::time_point wall = Clock::now();
+    double seconds = std::chrono::duration<double>(wall - m_last).count();
+    double rate = seconds > 0 ? (events - m_lastEvents) / seconds : 0;
+
+    std::vector<std::pair<std::size_t, uint64_t>> gauges;
+    for (auto& [name, gauge] : GetGauges())
+    {
+        gauges.emplace_back(GetSlot(name), gauge());
+    }
+
+    // Odd while the counters are inconsistent
+    uint64_t sequence = m_segment->sequence.load(std::memory_order_relaxed);
+    m_segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_segment->running = running ? 1 : 0;
+    m_segment->simTime = now.GetNanoSeconds();
+    m_segment->wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+    m_segment->elapsed =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(wall - m_start).count();
+    m_segment->events = events;
+    m_segment->eventRate = rate;
+    m_segment->scheduled = scheduled;
+    m_segment->cancelled = cancelled;
+    m_segment->rss = GetResidentMemory();
+    for (std::size_t slot = 0; slot < m_names.size(); ++slot)
+    {
+        Counter& counter = m_segment->counter[slot];
+        std::strncpy(counter.name, m_names[slot].c_str(), NAME_SIZE - 1);
+        counter.value = m_estimates[slot];
+    }
+    for (const auto& [slot, value] : gauges)
+    {
+        if (slot < MAX_COUNTERS)
+        {
+            m_segment->counter[slot].value = value;
+        }
+    }
+    m_segment->counters = m_names.size();
+
+    m_segment->sequence.store(sequence + 2, std::memory_order_release);
+    m_last = wall;
+    m_lastEvents = events;
+}
+
+void
+SimulatorStats::AddGauge(const std::string& name, Callback<uint64_t> gauge)
+{
+    NS_LOG_FUNCTION(name);
+    NS_ASSERT_MSG(name.size() < NAME_SIZE, "The name of the gauge " << name << " is too long");
+    RemoveGauge(name);
+    GetGauges().emplace_back(name, gauge);
+}
+
+void
+SimulatorStats::RemoveGauge(const std::string& name)
+{
+    NS_LOG_FUNCTION(name);
+    auto& gauges = GetGauges();
+    for (auto it = gauges.begin(); it != gauges.end(); ++it)
+    {
+        if (it->first == name)
+        {
+            gauges.erase(it);
+            return;
+        }
+    }
+}
+
+bool
+SimulatorStats::Read(const std::string& path, Snapshot& snapshot)
+{
+    NS_LOG_FUNCTION(path);
+#ifdef __WIN32__
+    return false;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Segment)))
+    {
+        close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+        return false;
+    }
+    const auto segment = static_cast<const Segment*>(address);
+    if (std::memcmp(segment->magic, MAGIC, sizeof(MAGIC)) != 0 || segment->version != VERSION)
+    {
+        munmap(address, sizeof(Segment));
+        return false;
+    }
+
+    // A process killed during an update leaves the sequence odd
+    bool consistent = false;
+    for (uint32_t attempt = 0; attempt < 10000 && !consistent; ++attempt)
+    {
+        uint64_t sequence = segment->sequence.load(std::memory_order_acquire);
+        if (sequence % 2 == 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        snapshot.pid = segment->pid;
+        snapshot.running = segment->running != 0;
+        snapshot.simTime = NanoSeconds(segment->simTime);
+        snapshot.wallTime = segment->wallTime;
+        snapshot.elapsed = segment->elapsed * 1e-9;
+        snapshot.events = segment->events;
+        snapshot.eventRate = segment->eventRate;
+        snapshot.scheduled = segment->scheduled;
+        snapshot.cancelled = segment->cancelled;
+        snapshot.rss = segment->rss;
+        snapshot.counters.clear();
+        uint32_t counters = std::min<uint32_t>(segment->counters, MAX_COUNTERS);
+        for (uint32_t i = 0; i < counters; ++i)
+        {
+            const Counter& counter = segment->counter[i];
+            std::string name(counter.name, strnlen(counter.name, NAME_SIZE));
+            snapshot.counters.emplace_back(name, counter.value);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        consistent = segment->sequence.load(std::memory_order_relaxed) == sequence;
+    }
+    munmap(address, sizeof(Segment));
+    return consistent;
+#endif
+}
+
+} // namespace ns3
@@ -0,0 +1,230 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef SIMULATOR_STATS_H
+#define SIMULATOR_STATS_H
+
+#include "callback.h"
+#include "nstime.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulatorStats declaration.
+ */
+
+namespace ns3
+{
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Live counters of a running simulation, in a memory-mapped file.
+ *
+ * The DefaultSimulatorImpl exports its counters when its \c StatsFile
+ * attribute is set: the number of events run and their rate, the
+ * number of events in the event queue and of the cancelled ones among
+ * them, the simulation time, the resident memory of the process, the
+ * estimated number of events run by each module, and the gauges added
+ * with AddGauge(), such as the number of packets alive from the
+ * network module.  Other processes on the same host map the file and
+ * read the counters with Read(), as the \c read-simulator-stats utility
+ * does, without any call into the simulation.  A file under \c /dev/shm
+ * is a POSIX shared memory segment, which is never written to disk.
+ *
+ * The simulator counts down the events to one sampled event in \c
+ * StatsPeriod on average, which is charged to the module of its
+ * EventImpl: the group name of the first TypeId named in the type of
+ * the function invoked, as given by EventProfiler::GetEventTypeName().
+ * A sampled event also reads the wall clock, and the segment is updated
+ * when \c StatsInterval has elapsed since the last update, so that a
+ * plain event only costs a decrement.
+ *
+ * The segment is updated under a sequence lock: Read() retries until
+ * it copies the counters of a single update.
+ */
+class SimulatorStats
+{
+  public:
+    /** The version of the layout of the segment. */
+    static constexpr uint32_t VERSION = 1;
+    /** The maximum number of named counters. */
+    static constexpr std::size_t MAX_COUNTERS = 64;
+    /** The size of the names of the counters, with their final null. */
+    static constexpr std::size_t NAME_SIZE = 56;
+
+    /** A named counter of the segment. */
+    struct Counter
+    {
+        char name[NAME_SIZE]; //!< The null-terminated name.
+        uint64_t value;       //!< The value.
+    };
+
+    /** The layout of the segment. */
+    struct Segment
+    {
+        char magic[8];                  //!< "NS3STATS", without a final null.
+        uint32_t version;               //!< The layout version, VERSION.
+        uint32_t running;               //!< 1 while Simulator::Run() runs.
+        std::atomic<uint64_t> sequence; //!< The sequence lock, odd during an update.
+        int64_t pid;                    //!< The id of the process.
+        int64_t simTime;                //!< The simulation time, in ns.
+        int64_t wallTime;               //!< The time of the update, in ns since the epoch.
+        uint64_t elapsed;               //!< The wall clock time since the start, in ns.
+        uint64_t events;                //!< The number of events run.
+        double eventRate;               //!< The events per second since the last update.
+        uint64_t scheduled;             //!< The number of events in the event queue.
+        uint64_t cancelled;             //!< The number of cancelled events among them.
+        uint64_t rss;                   //!< The resident memory, in bytes.
+        uint32_t counters;              //!< The number of named counters used.
+        uint32_t reserved;              //!< Reserved, zero.
+        Counter counter[MAX_COUNTERS];  //!< The named counters.
+    };
+
+    /** A copy of the counters of one update of a segment. */
+    struct Snapshot
+    {
+        int64_t pid;        //!< The id of the process.
+        bool running;       //!< Whether Simulator::Run() runs.
+        Time simTime;       //!< The simulation time.
+        int64_t wallTime;   //!< The time of the update, in ns since the epoch.
+        double elapsed;     //!< The wall clock time since the start, in seconds.
+        uint64_t events;    //!< The number of events run.
+        double eventRate;   //!< The events per second since the last update.
+        uint64_t scheduled; //!< The number of events in the event queue.
+        uint64_t cancelled; //!< The number of cancelled events among them.
+        uint64_t rss;       //!< The resident memory, in bytes.
+        /** The named counters: the event counts by module and the gauges. */
+        std::vector<std::pair<std::string, uint64_t>> counters;
+    };
+
+    /**
+     * Create the segment.
+     *
+     * \param [in] path The path of the file of the segment.
+     * \param [in] period The average number of events per sampled event.
+     * \param [in] interval The wall clock time between two updates.
+     */
+    SimulatorStats(const std::string& path, uint32_t period, Time interval);
+
+    /** Unmap the segment, which keeps the counters of the last update. */
+    ~SimulatorStats();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    SimulatorStats(const SimulatorStats&) = delete;
+    SimulatorStats& operator=(const SimulatorStats&) = delete;
+
+    /**
+     * Account for an event about to run.
+     *
+     * \param [in] event The event.
+     * \returns \c true if the segment must be updated with Update().
+     */
+    inline bool Sample(const EventImpl* event)
+    {
+        if (--m_gap != 0)
+        {
+            return false;
+        }
+        return DoSample(event);
+    }
+
+    /**
+     * Update the segment.
+     *
+     * \param [in] now The simulation time.
+     * \param [in] events The number of events run.
+     * \param [in] scheduled The number of events in the event queue.
+     * \param [in] cancelled The number of cancelled events among them.
+     * \param [in] running Whether Simulator::Run() runs.
+     */
+    void Update(Time now, uint64_t events, uint64_t scheduled, uint64_t cancelled, bool running);
+
+    /**
+     * Add a gauge, read at each update of the segments.
+     *
+     * A gauge of the same name is replaced.
+     *
+     * \param [in] name The name of the counter of the gauge.
+     * \param [in] gauge The gauge.
+     */
+    static void AddGauge(const std::string& name, Callback<uint64_t> gauge);
+
+    /**
+     * Remove a gauge.
+     *
+     * \param [in] name The name of the counter of the gauge.
+     */
+    static void RemoveGauge(const std::string& name);
+
+    /**
+     * Read the counters of a segment.
+     *
+     * \param [in] path The path of the file of the segment.
+     * \param [out] snapshot The counters.
+     * \returns \c false if the file is not a segment of this version, or
+     *          if its process died during an update.
+     */
+    static bool Read(const std::string& path, Snapshot& snapshot);
+
+  private:
+    /**
+     * Account for a sampled event.
+     *
+     * \param [in] event The event.
+     * \returns \c true if the segment must be updated.
+     */
+    bool DoSample(const EventImpl* event);
+
+    /**
+     * Get the slot of a named counter, allocating it if needed.
+     *
+     * \param [in] name The name of the counter.
+     * \returns The index of the counter, or MAX_COUNTERS if they are all used.
+     */
+    std::size_t GetSlot(const std::string& name);
+
+    /** The clock of the updates. */
+    using Clock = std::chrono::steady_clock;
+
+    Segment* m_segment;                //!< The mapped segment.
+    std::vector<std::string> m_names;  //!< The names of the counters, by slot.
+    std::vector<uint64_t> m_estimates; //!< The estimated event counts, by slot.
+    /** The slot of the module of each event type sampled. */
+    std::unordered_map<const std::type_info*, std::size_t> m_modules;
+    uint32_t m_period;          //!< The average number of events per sample.
+    uint32_t m_gap;             //!< Events left before the next sample.
+    uint64_t m_random;          //!< The state of the gap generator.
+    Clock::duration m_interval; //!< The wall clock time between updates.
+    Clock::time_point m_start;  //!< The creation time.
+    Clock::time_point m_last;   //!< The time of the last update.
+    uint64_t m_lastEvents;      //!< The number of events at the last update.
+};
+
+} // namespace ns3
+
+#endif /* SIMULATOR_STATS_H */
@@ -19,12 +19,16 @@
 #include "simulator.h"
 
 #include "assert.h"
+#include "boolean.h"
+#include "checkpoint.h"
 #include "des-metrics.h"
 #include "event-impl.h"
+#include "fatal-impl.h"
 #include "global-value.h"
 #include "log.h"
 #include "map-scheduler.h"
 #include "object-factory.h"
+#include "parameter-sweep.h"
 #include "ptr.h"
 #include "scheduler.h"
 #include "simulator-impl.h"
@@ -33,6 +37,7 @@
 #include "ns3/core-config.h"
 
 #include <cmath>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -80,6 +85,20 @@ static GlobalValue g_schedTypeImpl =
                 TypeIdValue(MapScheduler::GetTypeId()),
                 MakeTypeIdChecker());
 
+/**
+ * \ingroup simulator
+ * \anchor GlobalValueBulkTeardown
+ * Whether Simulator::Destroy() leaves the nodes, the channels and the
+ * pending events to the end of the process; see Simulator::IsBulkTeardown().
+ */
+static GlobalValue g_bulkTeardown =
+    GlobalValue("BulkTeardown",
+                "Leave the nodes, the channels and the pending events to the end of the "
+                "process at Simulator::Destroy(), rather than dispose them, for scripts "
+                "which exit after Simulator::Destroy()",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
@@ -156,6 +175,26 @@ Simulator::Destroy()
     (*pimpl)->Destroy();
     (*pimpl)->Unref();
     *pimpl = nullptr;
+
+    if (IsBulkTeardown())
+    {
+        // The objects left alive still hold some of the output streams
+        FatalImpl::FlushRegisteredStreams();
+        static bool atExit = false;
+        if (!atExit)
+        {
+            std::atexit(&FatalImpl::FlushRegisteredStreams);
+            atExit = true;
+        }
+    }
+}
+
+bool
+Simulator::IsBulkTeardown()
+{
+    BooleanValue bulk;
+    g_bulkTeardown.GetValue(bulk);
+    return bulk.Get();
 }
 
 void
@@ -177,6 +216,8 @@ Simulator::Run()
 {
     NS_LOG_FUNCTION_NOARGS();
     Time::ClearMarkedTimes();
+    Checkpoint::Start();
+    ParameterSweep::Start();
     GetImpl()->Run();
 }
 
@@ -317,6 +358,18 @@ Simulator::GetEventCount()
     return GetImpl()->GetEventCount();
 }
 
+uint64_t
+Simulator::GetLiveEventCount()
+{
+    return GetImpl()->GetLiveEventCount();
+}
+
+uint64_t
+Simulator::GetCancelledEventCount()
+{
+    return GetImpl()->GetCancelledEventCount();
+}
+
 uint32_t
 Simulator::GetSystemId()
 {
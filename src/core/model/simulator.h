@@ -122,9 +122,32 @@ class Simulator
      * After this method has been invoked, it is actually possible
      * to restart a new simulation with a set of calls to Simulator::Run,
      * Simulator::Schedule and Simulator::ScheduleWithContext.
+     *
+     * With a bulk teardown, see IsBulkTeardown(), the output streams
+     * registered with FatalImpl::RegisterStream() are flushed after the
+     * destroy events, and again at the exit of the process.
      */
     static void Destroy();
 
+    /**
+     * Check if Destroy() makes a bulk teardown, from the \c BulkTeardown
+     * global value.
+     *
+     * A bulk teardown skips the disposal of the nodes and the channels,
+     * with their devices, protocols and applications, and the release of
+     * the events still pending: they are left to the end of the process,
+     * which frees their memory at once.  The outputs are still written:
+     * the streams of the trace files are flushed, and the objects which
+     * write their outputs when they are destroyed, such as the stats
+     * aggregators, write them with a destroy event in a bulk teardown.
+     *
+     * The objects left alive are never destroyed, so a bulk teardown is
+     * only for scripts which exit after Destroy().
+     *
+     * \returns \c true for a bulk teardown.
+     */
+    static bool IsBulkTeardown();
+
     /**
      * Check if the simulation should finish.
      *
@@ -145,6 +168,10 @@ class Simulator
      *   - The user called Simulator::Stop with a stop time and the
      *     expiration time of the next event to be processed
      *     is greater than or equal to the stop time.
+     *
+     * When a Checkpoint or a ParameterSweep is requested, the checkpoint
+     * is saved and the children of the sweep are forked first, or at their
+     * times.
      */
     static void Run();
 
@@ -208,6 +235,25 @@ class Simulator
      */
     static uint64_t GetEventCount();
 
+    /**
+     * Get the number of events waiting in the event queue which are
+     * not cancelled.
+     * \returns The number of live events, or 0 if the simulator
+     * implementation does not track it.
+     */
+    static uint64_t GetLiveEventCount();
+
+    /**
+     * Get the number of cancelled events still held in the event queue.
+     *
+     * Simulator::Cancel() only marks an event as cancelled: the event
+     * stays in the event queue until it reaches the head of the queue,
+     * or until the queue is compacted.
+     * \returns The number of cancelled events, or 0 if the simulator
+     * implementation does not track it.
+     */
+    static uint64_t GetCancelledEventCount();
+
     /**
      * @name Schedule events (in the same context) to run at a future time.
      */
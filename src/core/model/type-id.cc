@@ -23,9 +23,11 @@
 #include "singleton.h"
 #include "trace-source-accessor.h"
 
+#include <algorithm>
+#include <functional>
 #include <iomanip>
-#include <map>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -46,12 +48,151 @@ NS_LOG_COMPONENT_DEFINE("TypeId");
 // IidManager needs to be in ns3 namespace for NS_ASSERT and NS_LOG
 // to find g_log
 
+/**
+ * \ingroup object
+ * \brief Open addressing index of the attributes, or of the trace
+ * sources, of the type ids, by type id and name.
+ *
+ * \internal
+ * The index holds the position of each entry in the container of its
+ * type id, with the hash of its name.  A lookup probes the slots
+ * linearly from the slot of the type id and the hash, and compares the
+ * names of the candidates in the container.  The table is kept at most
+ * half full.
+ */
+class NameIndex
+{
+  public:
+    /** The result of Find() when the name is not found. */
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    /**
+     * Hash a name.
+     * \param [in] name The name.
+     * \returns The hash of the name, for all the type ids.
+     */
+    static std::size_t Hash(const std::string& name);
+    /**
+     * Add an entry.
+     * \param [in] uid The type id.
+     * \param [in] hash The hash of the name of the entry.
+     * \param [in] i The position of the entry in the container of the type id.
+     */
+    void Add(uint16_t uid, std::size_t hash, std::size_t i);
+    /**
+     * Find an entry of a type id, without its parents.
+     * \tparam Container \deduced The type of the container of the entries.
+     * \param [in] uid The type id.
+     * \param [in] hash The hash of the name.
+     * \param [in] name The name.
+     * \param [in] container The entries of the type id.
+     * \returns The position of the entry in the container, or NOT_FOUND.
+     */
+    template <typename Container>
+    std::size_t Find(uint16_t uid,
+                     std::size_t hash,
+                     const std::string& name,
+                     const Container& container) const;
+
+  private:
+    /**
+     * Get the first slot to probe.
+     * \param [in] uid The type id.
+     * \param [in] hash The hash of the name.
+     * \returns The first slot, before the mask of the table size.
+     */
+    static std::size_t Slot(uint16_t uid, std::size_t hash);
+
+    /** An entry of the table. */
+    struct Entry
+    {
+        /** The hash of the name. */
+        std::size_t hash;
+        /** The position of the entry in the container of the type id. */
+        std::size_t i;
+        /** The type id, or 0 for an empty slot. */
+        uint16_t uid;
+    };
+
+    /** The slots, a power of two of them. */
+    std::vector<Entry> m_slots;
+    /** The number of entries. */
+    std::size_t m_size{0};
+};
+
+std::size_t
+NameIndex::Hash(const std::string& name)
+{
+    return std::hash<std::string>()(name);
+}
+
+std::size_t
+NameIndex::Slot(uint16_t uid, std::size_t hash)
+{
+    uint64_t h = static_cast<uint64_t>(hash) ^ (uid * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 29;
+    return static_cast<std::size_t>(h);
+}
+
+void
+NameIndex::Add(uint16_t uid, std::size_t hash, std::size_t i)
+{
+    if (2 * (m_size + 1) > m_slots.size())
+    {
+        std::vector<Entry> slots(std::max<std::size_t>(256, 2 * m_slots.size()), Entry{0, 0, 0});
+        std::swap(slots, m_slots);
+        m_size = 0;
+        for (const auto& entry : slots)
+        {
+            if (entry.uid != 0)
+            {
+                Add(entry.uid, entry.hash, entry.i);
+            }
+        }
+    }
+    std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = Slot(uid, hash) & mask;
+    while (m_slots[slot].uid != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = Entry{hash, i, uid};
+    m_size++;
+}
+
+template <typename Container>
+std::size_t
+NameIndex::Find(uint16_t uid,
+                std::size_t hash,
+                const std::string& name,
+                const Container& container) const
+{
+    if (m_slots.empty())
+    {
+        return NOT_FOUND;
+    }
+    std::size_t mask = m_slots.size() - 1;
+    for (std::size_t slot = Slot(uid, hash) & mask;; slot = (slot + 1) & mask)
+    {
+        const Entry& entry = m_slots[slot];
+        if (entry.uid == 0)
+        {
+            return NOT_FOUND;
+        }
+        if (entry.uid == uid && entry.hash == hash && container[entry.i].name == name)
+        {
+            return entry.i;
+        }
+    }
+}
+
 /**
  * \ingroup object
  * \brief TypeId information manager
  *
  * Information records are stored in a vector.  Name and hash lookup
- * are performed by maps to the vector index.
+ * are performed by hash maps to the vector index.  The attributes and
+ * trace sources of each record are indexed by name in a NameIndex.
  *
  * \internal
  * <b>Hash Chaining</b>
@@ -269,6 +410,27 @@ class IidManager : public Singleton<IidManager>
      * \returns \c true if this TypeId should be hidden from the user.
      */
     bool MustHideFromDocumentation(uint16_t uid) const;
+    /**
+     * Get the generation of the attributes.
+     * \returns The number of changes to the attributes and their initial values.
+     */
+    uint64_t GetAttributeGeneration() const;
+    /**
+     * Find an attribute by name in a type id and its parents.
+     * \param [in] uid The id.
+     * \param [in] name The attribute name.
+     * \returns The attribute, or null if it is not found.
+     */
+    const struct TypeId::AttributeInformation* FindAttribute(uint16_t uid,
+                                                            const std::string& name) const;
+    /**
+     * Find a trace source by name in a type id and its parents.
+     * \param [in] uid The id.
+     * \param [in] name The trace source name.
+     * \returns The trace source, or null if it is not found.
+     */
+    const struct TypeId::TraceSourceInformation* FindTraceSource(uint16_t uid,
+                                                                const std::string& name) const;
 
   private:
     /**
@@ -334,15 +496,23 @@ class IidManager : public Singleton<IidManager>
     std::vector<struct IidInformation> m_information;
 
     /** Type of the by-name index. */
-    typedef std::map<std::string, uint16_t> namemap_t;
+    typedef std::unordered_map<std::string, uint16_t> namemap_t;
     /** The by-name index. */
     namemap_t m_namemap;
 
     /** Type of the by-hash index. */
-    typedef std::map<TypeId::hash_t, uint16_t> hashmap_t;
+    typedef std::unordered_map<TypeId::hash_t, uint16_t> hashmap_t;
     /** The by-hash index. */
     hashmap_t m_hashmap;
 
+    /** The index of the attributes by type id and name. */
+    NameIndex m_attributeIndex;
+    /** The index of the trace sources by type id and name. */
+    NameIndex m_traceSourceIndex;
+
+    /** The number of changes to the attributes and their initial values. */
+    uint64_t m_attributeGeneration{0};
+
     /** IidManager constants. */
     enum
     {
@@ -623,32 +793,32 @@ bool
 IidManager::HasAttribute(uint16_t uid, std::string name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    struct IidInformation* information = LookupInformation(uid);
+    bool found = FindAttribute(uid, name) != nullptr;
+    NS_LOG_LOGIC(IIDL << found);
+    return found;
+}
+
+const struct TypeId::AttributeInformation*
+IidManager::FindAttribute(uint16_t uid, const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    std::size_t hash = NameIndex::Hash(name);
     while (true)
     {
-        for (std::vector<struct TypeId::AttributeInformation>::const_iterator i =
-                 information->attributes.begin();
-             i != information->attributes.end();
-             ++i)
+        struct IidInformation* information = LookupInformation(uid);
+        std::size_t i = m_attributeIndex.Find(uid, hash, name, information->attributes);
+        if (i != NameIndex::NOT_FOUND)
         {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
+            return &information->attributes[i];
         }
-        struct IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
+        if (information->parent == uid || information->parent == 0)
         {
             // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
+            return nullptr;
         }
         // check parent
-        information = parent;
+        uid = information->parent;
     }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
 }
 
 void
@@ -687,6 +857,8 @@ IidManager::AddAttribute(uint16_t uid,
     info.supportLevel = supportLevel;
     info.supportMsg = supportMsg;
     information->attributes.push_back(info);
+    m_attributeIndex.Add(uid, NameIndex::Hash(name), information->attributes.size() - 1);
+    ++m_attributeGeneration;
     NS_LOG_LOGIC(IIDL << information->attributes.size() - 1);
 }
 
@@ -699,6 +871,14 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
     struct IidInformation* information = LookupInformation(uid);
     NS_ASSERT(i < information->attributes.size());
     information->attributes[i].initialValue = initialValue;
+    ++m_attributeGeneration;
+}
+
+uint64_t
+IidManager::GetAttributeGeneration() const
+{
+    NS_LOG_FUNCTION(IID);
+    return m_attributeGeneration;
 }
 
 std::size_t
@@ -725,32 +905,32 @@ bool
 IidManager::HasTraceSource(uint16_t uid, std::string name)
 {
     NS_LOG_FUNCTION(IID << uid << name);
-    struct IidInformation* information = LookupInformation(uid);
+    bool found = FindTraceSource(uid, name) != nullptr;
+    NS_LOG_LOGIC(IIDL << found);
+    return found;
+}
+
+const struct TypeId::TraceSourceInformation*
+IidManager::FindTraceSource(uint16_t uid, const std::string& name) const
+{
+    NS_LOG_FUNCTION(IID << uid << name);
+    std::size_t hash = NameIndex::Hash(name);
     while (true)
     {
-        for (std::vector<struct TypeId::TraceSourceInformation>::const_iterator i =
-                 information->traceSources.begin();
-             i != information->traceSources.end();
-             ++i)
+        struct IidInformation* information = LookupInformation(uid);
+        std::size_t i = m_traceSourceIndex.Find(uid, hash, name, information->traceSources);
+        if (i != NameIndex::NOT_FOUND)
         {
-            if (i->name == name)
-            {
-                NS_LOG_LOGIC(IIDL << true);
-                return true;
-            }
+            return &information->traceSources[i];
         }
-        struct IidInformation* parent = LookupInformation(information->parent);
-        if (parent == information)
+        if (information->parent == uid || information->parent == 0)
         {
             // top of inheritance tree
-            NS_LOG_LOGIC(IIDL << false);
-            return false;
+            return nullptr;
         }
         // check parent
-        information = parent;
+        uid = information->parent;
     }
-    NS_LOG_LOGIC(IIDL << false);
-    return false;
 }
 
 void
@@ -778,6 +958,7 @@ IidManager::AddTraceSource(uint16_t uid,
     source.supportLevel = supportLevel;
     source.supportMsg = supportMsg;
     information->traceSources.push_back(source);
+    m_traceSourceIndex.Add(uid, NameIndex::Hash(name), information->traceSources.size() - 1);
     NS_LOG_LOGIC(IIDL << information->traceSources.size() - 1);
 }
 
@@ -893,42 +1074,33 @@ TypeId::GetRegistered(uint16_t i)
     return TypeId(IidManager::Get()->GetRegistered(i));
 }
 
+uint64_t
+TypeId::GetAttributeGeneration()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    return IidManager::Get()->GetAttributeGeneration();
+}
+
 bool
 TypeId::LookupAttributeByName(std::string name, struct TypeId::AttributeInformation* info) const
 {
     NS_LOG_FUNCTION(this << name << info);
-    TypeId tid;
-    TypeId nextTid = *this;
-    do
+    const struct TypeId::AttributeInformation* tmp = IidManager::Get()->FindAttribute(m_tid, name);
+    if (tmp == nullptr)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetAttributeN(); i++)
-        {
-            struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "Attribute '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return true;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
-                                                 << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return false;
+        return false;
+    }
+    if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "Attribute '" << name << "' is deprecated: " << tmp->supportMsg << std::endl;
+    }
+    else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("Attribute '" << name << "' is obsolete, with no fallback: "
+                                     << tmp->supportMsg);
+    }
+    *info = *tmp;
+    return true;
 }
 
 TypeId
@@ -1159,50 +1331,61 @@ TypeId::HideFromDocumentation()
     return *this;
 }
 
+/**
+ * Find a trace source by name in a type id and its parents, and report
+ * its deprecation.
+ *
+ * \relates TypeId
+ *
+ * \param [in] uid The id.
+ * \param [in] name The trace source name.
+ * \returns The trace source, or null if it is not found.
+ */
+static const struct TypeId::TraceSourceInformation*
+FindSupportedTraceSource(uint16_t uid, const std::string& name)
+{
+    const struct TypeId::TraceSourceInformation* tmp =
+        IidManager::Get()->FindTraceSource(uid, name);
+    if (tmp == nullptr)
+    {
+        return nullptr;
+    }
+    if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+        std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp->supportMsg
+                  << std::endl;
+    }
+    else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+        NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
+                                       << tmp->supportMsg);
+    }
+    return tmp;
+}
+
 Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name, struct TraceSourceInformation* info) const
 {
     NS_LOG_FUNCTION(this << name);
-    TypeId tid;
-    TypeId nextTid = *this;
-    struct TypeId::TraceSourceInformation tmp;
-    do
+    const struct TypeId::TraceSourceInformation* tmp = FindSupportedTraceSource(m_tid, name);
+    if (tmp == nullptr)
     {
-        tid = nextTid;
-        for (std::size_t i = 0; i < tid.GetTraceSourceN(); i++)
-        {
-            tmp = tid.GetTraceSource(i);
-            if (tmp.name == name)
-            {
-                if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                    std::cerr << "TraceSource '" << name << "' is deprecated: " << tmp.supportMsg
-                              << std::endl;
-                    *info = tmp;
-                    return tmp.accessor;
-                }
-                else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                    NS_FATAL_ERROR("TraceSource '" << name << "' is obsolete, with no fallback: "
-                                                   << tmp.supportMsg);
-                }
-            }
-        }
-        nextTid = tid.GetParent();
-    } while (nextTid != tid);
-    return nullptr;
+        return nullptr;
+    }
+    *info = *tmp;
+    return tmp->accessor;
 }
 
 Ptr<const TraceSourceAccessor>
 TypeId::LookupTraceSourceByName(std::string name) const
 {
-    TraceSourceInformation info;
-    return LookupTraceSourceByName(name, &info);
+    NS_LOG_FUNCTION(this << name);
+    const struct TypeId::TraceSourceInformation* tmp = FindSupportedTraceSource(m_tid, name);
+    if (tmp == nullptr)
+    {
+        return nullptr;
+    }
+    return tmp->accessor;
 }
 
 uint16_t
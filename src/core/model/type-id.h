@@ -171,6 +171,17 @@ class TypeId
      * \returns The TypeId instance whose index is \c i.
      */
     static TypeId GetRegistered(uint16_t i);
+    /**
+     * Get the generation of the attributes of all the TypeIds.
+     *
+     * The generation changes whenever an attribute is added or the
+     * initial value of an attribute is changed, for instance by
+     * Config::SetDefault(), so that the attributes resolved for the
+     * construction of objects can be resolved again.
+     *
+     * \returns The generation of the attributes.
+     */
+    static uint64_t GetAttributeGeneration();
 
     /**
      * Constructor.
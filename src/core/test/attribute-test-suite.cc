@@ -1794,6 +1794,121 @@ PointerAttributeTestCase::DoRun()
                           "aotPtr and aotPtr2 are unique, but their Derived member is not");
 }
 
+/**
+ * \ingroup attribute-tests
+ *
+ * \brief Check that the attributes resolved once for the construction
+ * of many objects follow the changes of their values.
+ */
+class AttributeConstructionTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param description The TestCase description.
+     */
+    AttributeConstructionTestCase(std::string description);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Get the TestInt16 attribute of an object.
+     * \param object The object.
+     * \returns The value of the attribute.
+     */
+    static int64_t GetInt16(Ptr<AttributeObjectTest> object);
+    /**
+     * Get the TestRandom attribute of an object.
+     * \param object The object.
+     * \returns The random variable of the attribute.
+     */
+    static Ptr<RandomVariableStream> GetRandom(Ptr<AttributeObjectTest> object);
+};
+
+AttributeConstructionTestCase::AttributeConstructionTestCase(std::string description)
+    : TestCase(description)
+{
+}
+
+int64_t
+AttributeConstructionTestCase::GetInt16(Ptr<AttributeObjectTest> object)
+{
+    IntegerValue value;
+    object->GetAttribute("TestInt16", value);
+    return value.Get();
+}
+
+Ptr<RandomVariableStream>
+AttributeConstructionTestCase::GetRandom(Ptr<AttributeObjectTest> object)
+{
+    PointerValue value;
+    object->GetAttribute("TestRandom", value);
+    return value.Get<RandomVariableStream>();
+}
+
+void
+AttributeConstructionTestCase::DoRun()
+{
+    ObjectFactory factory("ns3::AttributeObjectTest", "TestUint8", StringValue("7"));
+    ObjectFactory copy = factory;
+    for (int i = 0; i < 2; ++i)
+    {
+        Ptr<AttributeObjectTest> created = CreateObject<AttributeObjectTest>();
+        NS_TEST_ASSERT_MSG_EQ(GetInt16(created), -2, "Wrong initial value " << i);
+        Ptr<AttributeObjectTest> made = factory.Create<AttributeObjectTest>();
+        NS_TEST_ASSERT_MSG_EQ(GetInt16(made), -2, "Wrong initial value from factory " << i);
+        UintegerValue uint8;
+        made->GetAttribute("TestUint8", uint8);
+        NS_TEST_ASSERT_MSG_EQ(uint8.Get(), 7, "Wrong value from factory string " << i);
+    }
+
+    // The new defaults apply to the objects created after them
+    Config::SetDefault("ns3::AttributeObjectTest::TestInt16", IntegerValue(5));
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(CreateObject<AttributeObjectTest>()), 5, "Default not applied");
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(factory.Create<AttributeObjectTest>()),
+                          5,
+                          "Default not applied by the factory");
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(copy.Create<AttributeObjectTest>()),
+                          5,
+                          "Default not applied by the copy of the factory");
+    Config::SetDefault("ns3::AttributeObjectTest::TestInt16", IntegerValue(-2));
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(CreateObject<AttributeObjectTest>()), -2, "Default not reset");
+
+    // The values set in the factory apply to the objects created after them
+    factory.Set("TestInt16", IntegerValue(3));
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(factory.Create<AttributeObjectTest>()), 3, "Value not set");
+    NS_TEST_ASSERT_MSG_EQ(GetInt16(copy.Create<AttributeObjectTest>()),
+                          -2,
+                          "Value set in the copy of the factory");
+
+    // A random variable described by a string is created for each object
+    Ptr<AttributeObjectTest> first = CreateObject<AttributeObjectTest>();
+    Ptr<AttributeObjectTest> second = CreateObject<AttributeObjectTest>();
+    NS_TEST_ASSERT_MSG_NE(GetRandom(first), nullptr, "No initial random variable");
+    NS_TEST_ASSERT_MSG_NE(GetRandom(first),
+                          GetRandom(second),
+                          "Initial random variable shared by two objects");
+    factory.Set("TestRandom", StringValue("ns3::UniformRandomVariable[Min=2|Max=3]"));
+    first = factory.Create<AttributeObjectTest>();
+    second = factory.Create<AttributeObjectTest>();
+    NS_TEST_ASSERT_MSG_NE(GetRandom(first),
+                          GetRandom(second),
+                          "Random variable from the factory shared by two objects");
+    double value = GetRandom(first)->GetValue();
+    NS_TEST_ASSERT_MSG_EQ((value >= 2 && value <= 3), true, "Wrong random variable");
+
+    // A random variable given as an object is shared, as it was
+    Ptr<RandomVariableStream> shared = CreateObject<ConstantRandomVariable>();
+    factory.Set("TestRandom", PointerValue(shared));
+    NS_TEST_ASSERT_MSG_EQ(GetRandom(factory.Create<AttributeObjectTest>()),
+                          shared,
+                          "Random variable from the factory not set");
+    NS_TEST_ASSERT_MSG_EQ(GetRandom(factory.Create<AttributeObjectTest>()),
+                          shared,
+                          "Random variable from the factory not shared");
+}
+
 /**
  * \ingroup attribute-tests
  *
@@ -1933,6 +2048,9 @@ AttributesTestSuite::AttributesTestSuite()
                 TestCase::QUICK);
     AddTestCase(new PointerAttributeTestCase("Check Attributes of type PointerValue"),
                 TestCase::QUICK);
+    AddTestCase(new AttributeConstructionTestCase(
+                    "Check the Attributes resolved for the construction of many objects"),
+                TestCase::QUICK);
     AddTestCase(new CallbackValueTestCase("Check Attributes of type CallbackValue"),
                 TestCase::QUICK);
     AddTestCase(new IntegerTraceSourceAttributeTestCase(
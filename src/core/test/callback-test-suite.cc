@@ -17,8 +17,10 @@
 
 #include "ns3/callback.h"
 #include "ns3/test.h"
+#include "ns3/traced-callback.h"
 
 #include <stdint.h>
+#include <string>
 
 using namespace ns3;
 
@@ -991,6 +993,104 @@ NullifyCallbackTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(target1.IsNull(), true, "Nullified Callback reports not IsNull()");
 }
 
+/**
+ * \ingroup callback-tests
+ *
+ * Test the storage of the targets and of the bound arguments.
+ */
+class CallbackStorageTestCase : public TestCase
+{
+  public:
+    CallbackStorageTestCase();
+
+    ~CallbackStorageTestCase() override
+    {
+    }
+
+    /**
+     * Callback target function, accumulating its argument.
+     *
+     * \param context the context
+     * \param value the value
+     */
+    void Trace(std::string context, int value)
+    {
+        m_context = context;
+        m_sum += value;
+    }
+
+  private:
+    void DoRun() override;
+
+    std::string m_context; //!< The last context received.
+    int m_sum;             //!< The sum of the values received.
+};
+
+CallbackStorageTestCase::CallbackStorageTestCase()
+    : TestCase("Check the storage of the targets and bound arguments"),
+      m_sum(0)
+{
+}
+
+/**
+ * Callback target function, returning the length of its argument.
+ *
+ * \param s the string
+ * \param offset a value added to the length
+ * \return the length of the string plus the offset
+ */
+static std::size_t
+CallbackStorageLength(std::string s, std::size_t offset)
+{
+    return s.size() + offset;
+}
+
+void
+CallbackStorageTestCase::DoRun()
+{
+    //
+    // The state of a functor is kept across calls, and shared by the copies
+    // of the callback.
+    //
+    Callback<int> counter([n = 0]() mutable { return ++n; });
+    NS_TEST_ASSERT_MSG_EQ(counter(), 1, "Functor state not kept");
+    Callback<int> copy = counter;
+    NS_TEST_ASSERT_MSG_EQ(copy(), 2, "Functor state not shared by copies");
+    NS_TEST_ASSERT_MSG_EQ(counter(), 3, "Functor state not shared by copies");
+
+    //
+    // Bound arguments larger than a pointer are stored by value.
+    //
+    Callback<std::size_t, std::size_t> length =
+        MakeBoundCallback(&CallbackStorageLength, std::string(100, 'x'));
+    NS_TEST_ASSERT_MSG_EQ(length(5), 105, "Bound string not stored");
+    Callback<std::size_t> bound = length.Bind(std::size_t(7));
+    NS_TEST_ASSERT_MSG_EQ(bound(), 107, "Bound string not stored");
+
+    //
+    // A member function callback with a bound argument compares equal
+    // whether the argument is bound by MakeCallback or by Bind.
+    //
+    Callback<void, int> a =
+        MakeCallback(&CallbackStorageTestCase::Trace, this, std::string("a"));
+    Callback<void, int> b =
+        Callback<void, std::string, int>(&CallbackStorageTestCase::Trace, this)
+            .Bind(std::string("a"));
+    NS_TEST_ASSERT_MSG_EQ(a.IsEqual(b), true, "Equality test failed");
+
+    //
+    // Disconnect a trace sink connected with a context.
+    //
+    TracedCallback<int> trace;
+    trace.Connect(MakeCallback(&CallbackStorageTestCase::Trace, this), "path");
+    trace(3);
+    NS_TEST_ASSERT_MSG_EQ(m_context, "path", "Wrong context");
+    NS_TEST_ASSERT_MSG_EQ(m_sum, 3, "Trace sink not called");
+    trace.Disconnect(MakeCallback(&CallbackStorageTestCase::Trace, this), "path");
+    trace(4);
+    NS_TEST_ASSERT_MSG_EQ(m_sum, 3, "Trace sink not disconnected");
+}
+
 /**
  * \ingroup callback-tests
  *
@@ -1197,6 +1297,7 @@ CallbackTestSuite::CallbackTestSuite()
     AddTestCase(new MakeBoundCallbackTestCase, TestCase::QUICK);
     AddTestCase(new CallbackEqualityTestCase, TestCase::QUICK);
     AddTestCase(new NullifyCallbackTestCase, TestCase::QUICK);
+    AddTestCase(new CallbackStorageTestCase, TestCase::QUICK);
     AddTestCase(new MakeCallbackTemplatesTestCase, TestCase::QUICK);
 }
 
@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/checkpoint.h"
+#include "ns3/log-binary.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup checkpoint-tests
+ * Checkpoint test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup checkpoint-tests Checkpoint test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup checkpoint-tests
+ * Check that the simulations restored from a checkpoint continue from it.
+ */
+class CheckpointRestoreTestCase : public TestCase
+{
+  public:
+    CheckpointRestoreTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Record a random value. */
+    void Record();
+
+    /**
+     * Read the values recorded by a restored simulation.
+     * \param [in] filename The file of the values.
+     * \returns The values.
+     */
+    std::vector<double> Read(const std::string& filename);
+
+    Ptr<UniformRandomVariable> m_random; //!< The random variable.
+    std::vector<double> m_values;        //!< The values recorded.
+};
+
+CheckpointRestoreTestCase::CheckpointRestoreTestCase()
+    : TestCase("Check the restore of a checkpoint")
+{
+}
+
+void
+CheckpointRestoreTestCase::Record()
+{
+    m_values.push_back(m_random->GetValue());
+}
+
+std::vector<double>
+CheckpointRestoreTestCase::Read(const std::string& filename)
+{
+    std::ifstream is(filename);
+    std::vector<double> values;
+    double value;
+    while (is >> value)
+    {
+        values.push_back(value);
+    }
+    return values;
+}
+
+void
+CheckpointRestoreTestCase::DoRun()
+{
+    std::string path = "/tmp/ns3-checkpoint-test-" + std::to_string(getpid()) + ".sock";
+    std::string filename = CreateTempDirFilename("checkpoint-restored.txt");
+
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetStream(1);
+    for (int i = 1; i <= 4; ++i)
+    {
+        Simulator::Schedule(Seconds(i), &CheckpointRestoreTestCase::Record, this);
+    }
+    // The checkpoint process exits after 30 s without requests if the test fails
+    Simulator::Schedule(Seconds(2.5), [path]() { Checkpoint::Save(path, 30); });
+    Simulator::Run();
+    if (Checkpoint::IsRestored())
+    {
+        std::ofstream os(filename);
+        os.precision(17);
+        for (auto value : m_values)
+        {
+            os << value << "\n";
+        }
+        os.close();
+        std::_Exit(0);
+    }
+    Simulator::Destroy();
+    NS_TEST_ASSERT_MSG_EQ(m_values.size(), 4, "Values of the simulation");
+
+    NS_TEST_ASSERT_MSG_EQ(Checkpoint::Restore(path, {}), 0, "Status of the restore");
+    std::vector<double> restored = Read(filename);
+    NS_TEST_ASSERT_MSG_EQ(restored.size(), 4, "Values of the restored simulation");
+    for (std::size_t i = 0; i < restored.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ_TOL(restored[i], m_values[i], 1e-15, "Restored value " << i);
+    }
+
+    // Another run restarts the streams at the checkpoint
+    NS_TEST_ASSERT_MSG_EQ(Checkpoint::Restore(path, {"RngRun=7"}), 0, "Status of the run 7");
+    restored = Read(filename);
+    NS_TEST_ASSERT_MSG_EQ(restored.size(), 4, "Values of the run 7");
+    NS_TEST_ASSERT_MSG_EQ_TOL(restored[1], m_values[1], 1e-15, "Value before the checkpoint");
+    NS_TEST_ASSERT_MSG_NE(restored[2], m_values[2], "Value of the run 7");
+
+    Checkpoint::Stop(path);
+    NS_TEST_ASSERT_MSG_EQ(access(path.c_str(), F_OK), -1, "Socket of the stopped checkpoint");
+}
+
+/**
+ * \ingroup checkpoint-tests
+ * Check that the state which a checkpoint can't hold is reported.
+ */
+class CheckpointUnsupportedTestCase : public TestCase
+{
+  public:
+    CheckpointUnsupportedTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+CheckpointUnsupportedTestCase::CheckpointUnsupportedTestCase()
+    : TestCase("Check the report of the unsupported state")
+{
+}
+
+void
+CheckpointUnsupportedTestCase::DoRun()
+{
+    bool binary = LogIsBinaryEnabled();
+    if (!binary)
+    {
+        NS_TEST_ASSERT_MSG_EQ(Checkpoint::GetUnsupported().empty(), true, "Supported process");
+        LogEnableBinary(CreateTempDirFilename("checkpoint-log.bin"));
+    }
+    std::vector<std::string> unsupported = Checkpoint::GetUnsupported();
+    NS_TEST_ASSERT_MSG_EQ(unsupported.size(), 1, "Binary log");
+    NS_TEST_ASSERT_MSG_NE(unsupported[0].find("binary log"), std::string::npos, "Report");
+    if (!binary)
+    {
+        LogDisableBinary();
+    }
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup checkpoint-tests
+ * Checkpoint test suite.
+ */
+class CheckpointTestSuite : public TestSuite
+{
+  public:
+    CheckpointTestSuite();
+};
+
+CheckpointTestSuite::CheckpointTestSuite()
+    : TestSuite("checkpoint")
+{
+#ifndef __WIN32__
+    AddTestCase(new CheckpointRestoreTestCase);
+    AddTestCase(new CheckpointUnsupportedTestCase);
+#endif
+}
+
+/**
+ * \ingroup checkpoint-tests
+ * Static variable for test initialization.
+ */
+static CheckpointTestSuite g_checkpointTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
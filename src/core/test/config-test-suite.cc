@@ -864,6 +864,123 @@ SearchAttributesOfParentObjectsTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(iv.Get(), 42, "Object Attribute \"X\" not settable in derived class");
 }
 
+/**
+ * \ingroup config-tests
+ * Test the resolution of parsed Config paths.
+ */
+class PathConfigTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    PathConfigTestCase();
+
+    /** Destructor. */
+    ~PathConfigTestCase() override
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+PathConfigTestCase::PathConfigTestCase()
+    : TestCase("Check the resolution of parsed Config paths")
+{
+}
+
+void
+PathConfigTestCase::DoRun()
+{
+    IntegerValue iv;
+
+    //
+    // Name a root object, to keep its paths apart from the root namespace
+    // objects of the other tests, and add four objects to its vector.
+    //
+    Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject>();
+    Names::Add("PathRoot", root);
+    std::vector<Ptr<ConfigTestObject>> objects;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objects.push_back(CreateObject<ConfigTestObject>());
+        root->AddNodeA(objects.back());
+    }
+
+    Config::Path path("/Names/PathRoot/NodesA/[2-3]|0/A");
+    NS_TEST_ASSERT_MSG_EQ(path.GetString(),
+                          "/Names/PathRoot/NodesA/[2-3]|0/A",
+                          "Path not kept as given");
+
+    //
+    // A parsed path sets the same attributes as the string path.
+    //
+    Config::Set(path, IntegerValue(-20));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        objects[i]->GetAttribute("A", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(),
+                              (i == 1 ? 10 : -20),
+                              "Object Attribute \"A\" of object " << i << " not as expected");
+    }
+
+    //
+    // The matches and their contexts are in the order of the indexes.
+    //
+    Config::Path objectsPath("/Names/PathRoot/NodesA/*");
+    Config::MatchContainer matches = Config::LookupMatches(objectsPath);
+    NS_TEST_ASSERT_MSG_EQ(matches.GetN(), 4, "Unexpected number of matches");
+    for (uint32_t i = 0; i < matches.GetN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(matches.Get(i), objects[i], "Unexpected match " << i);
+        NS_TEST_ASSERT_MSG_EQ(matches.GetMatchedPath(i),
+                              "/Names/PathRoot/NodesA/" + std::to_string(i) + "/",
+                              "Unexpected context of match " << i);
+    }
+
+    //
+    // A parsed path is resolved again on each use, so it finds the objects
+    // added since its last use.
+    //
+    objects.push_back(CreateObject<ConfigTestObject>());
+    root->AddNodeA(objects.back());
+    NS_TEST_ASSERT_MSG_EQ(Config::LookupMatches(objectsPath).GetN(),
+                          5,
+                          "Added object not found by the parsed path");
+    Config::Set(path, IntegerValue(-21));
+    objects[4]->GetAttribute("A", iv);
+    NS_TEST_ASSERT_MSG_EQ(iv.Get(), 10, "Object Attribute \"A\" of object 4 unexpectedly set");
+    objects[3]->GetAttribute("A", iv);
+    NS_TEST_ASSERT_MSG_EQ(iv.Get(), -21, "Object Attribute \"A\" of object 3 not set");
+
+    //
+    // Indexes beyond the end of the vector match nothing.
+    //
+    NS_TEST_ASSERT_MSG_EQ(Config::LookupMatches(Config::Path("/Names/PathRoot/NodesA/[3-9]"))
+                              .GetN(),
+                          2,
+                          "Unexpected number of matches of a range");
+    NS_TEST_ASSERT_MSG_EQ(Config::SetFailSafe(Config::Path("/Names/PathRoot/NodesA/7/A"),
+                                              IntegerValue(-22)),
+                          false,
+                          "Unexpectedly set an attribute beyond the end of the vector");
+
+    //
+    // Several attributes of the same objects are set with one resolution.
+    //
+    matches = Config::LookupMatches(Config::Path("/Names/PathRoot/NodesA/1|4"));
+    matches.Set("A", IntegerValue(-23));
+    matches.Set("B", IntegerValue(-24));
+    for (uint32_t i : {1, 4})
+    {
+        objects[i]->GetAttribute("A", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), -23, "Object Attribute \"A\" of object " << i);
+        objects[i]->GetAttribute("B", iv);
+        NS_TEST_ASSERT_MSG_EQ(iv.Get(), -24, "Object Attribute \"B\" of object " << i);
+    }
+
+    Names::Clear();
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -882,6 +999,7 @@ ConfigTestSuite::ConfigTestSuite()
     AddTestCase(new UnderRootNamespaceConfigTestCase);
     AddTestCase(new ObjectVectorConfigTestCase);
     AddTestCase(new SearchAttributesOfParentObjectsTestCase);
+    AddTestCase(new PathConfigTestCase);
 }
 
 /**
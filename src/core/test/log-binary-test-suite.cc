@@ -0,0 +1,284 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/nstime.h"
+#include "ns3/pair.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup log-binary-tests
+ * Binary log sink test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup log-binary-tests Binary log sink tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+NS_LOG_COMPONENT_DEFINE("LogBinaryTestSuite");
+
+/**
+ * \ingroup log-binary-tests
+ * A class with an output streamer for its pointers.
+ */
+class Streamed
+{
+    /**
+     * Output streamer for the pointers to Streamed.
+     *
+     * This is a hidden friend, so that it doesn't hide the other
+     * ns3::operator<< from the test cases.
+     *
+     * \param [in,out] os The output stream.
+     * \returns The output stream.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const Streamed* /* streamed */)
+    {
+        os << "Streamed";
+        return os;
+    }
+};
+
+/**
+ * \ingroup log-binary-tests
+ * A class with an output streamer which takes a non-const reference.
+ */
+class NonConstStreamed
+{
+    /**
+     * Output streamer for NonConstStreamed.
+     *
+     * \param [in,out] os The output stream.
+     * \returns The output stream.
+     */
+    friend std::ostream& operator<<(std::ostream& os, NonConstStreamed& /* streamed */)
+    {
+        os << "NonConstStreamed";
+        return os;
+    }
+};
+
+/**
+ * \ingroup log-binary-tests
+ * Check that the decoded binary log is the text log.
+ */
+class LogBinaryRenderingTestCase : public TestCase
+{
+  public:
+    LogBinaryRenderingTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Emit the log messages.
+     * \param [in] value A value to log.
+     */
+    void Emit(int value);
+
+    /** Run a simulation which emits the log messages. */
+    void Simulate();
+
+    Streamed m_streamed;         //!< An object with a custom pointer streamer.
+    NonConstStreamed m_nonConst; //!< An object with a non-const streamer.
+};
+
+LogBinaryRenderingTestCase::LogBinaryRenderingTestCase()
+    : TestCase("Check that the decoded binary log is the text log")
+{
+}
+
+void
+LogBinaryRenderingTestCase::Emit(int value)
+{
+    NS_LOG_FUNCTION(this << value << "literal" << std::string("string") << int8_t(-3)
+                         << uint8_t(200) << 'c' << 2.5 << true << std::vector<int>(2, 1)
+                         << Seconds(1) << &m_streamed);
+    NS_LOG_FUNCTION_NOARGS();
+    NS_LOG_DEBUG("value=" << value << " negative=" << -value << " unsigned=" << 42U
+                          << " double=" << 1.0 / 3 << " float=" << 0.1F << " bool=" << false
+                          << " char=" << 'x' << uint8_t('y') << " pointer=" << this
+                          << " null=" << static_cast<void*>(nullptr));
+    NS_LOG_INFO("hex=" << std::hex << value << " still hex=" << 255 << std::dec
+                       << " dec=" << 255);
+    NS_LOG_WARN("width=[" << std::setw(6) << value << "] [" << std::left << std::setw(4) << "ab"
+                          << "]" << std::right);
+    NS_LOG_ERROR("time=" << Seconds(1.5) << " precision=" << std::setprecision(3) << 3.14159
+                         << std::setprecision(6) << " streamed=" << &m_streamed
+                         << " pair=" << std::make_pair(1, 2) << " non-const=" << m_nonConst);
+    NS_LOG_LOGIC("uint64=" << std::numeric_limits<uint64_t>::max()
+                           << " int64=" << std::numeric_limits<int64_t>::min()
+                           << " string=" << std::string("s") << std::endl
+                           << "second line");
+}
+
+void
+LogBinaryRenderingTestCase::Simulate()
+{
+    Simulator::Schedule(Seconds(1), &LogBinaryRenderingTestCase::Emit, this, 5);
+    Simulator::ScheduleWithContext(7, Seconds(2), &LogBinaryRenderingTestCase::Emit, this, -9);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+LogBinaryRenderingTestCase::DoRun()
+{
+    LogComponentEnable("LogBinaryTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+
+    std::ostringstream text;
+    std::streambuf* clogBuffer = std::clog.rdbuf(text.rdbuf());
+    Simulate();
+    std::clog.rdbuf(clogBuffer);
+
+    std::string filename = CreateTempDirFilename("log-binary.nslog");
+    LogEnableBinary(filename);
+    NS_TEST_EXPECT_MSG_EQ(LogIsBinaryEnabled(), true, "The binary sink should be enabled");
+    Simulate();
+    LogDisableBinary();
+    NS_TEST_EXPECT_MSG_EQ(LogIsBinaryEnabled(), false, "The binary sink should be disabled");
+
+    std::ifstream is(filename, std::ios::binary);
+    std::ostringstream decoded;
+    LogDecodeBinary(is, decoded);
+    NS_TEST_EXPECT_MSG_EQ(decoded.str(), text.str(), "The decoded log differs from the text log");
+
+    LogComponentDisable("LogBinaryTestSuite", LogLevel(LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+}
+
+/**
+ * \ingroup log-binary-tests
+ * Check the records of several threads, which overflow their buffers,
+ * and a record larger than a buffer.
+ */
+class LogBinaryVolumeTestCase : public TestCase
+{
+  public:
+    LogBinaryVolumeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LogBinaryVolumeTestCase::LogBinaryVolumeTestCase()
+    : TestCase("Check the records of several threads and a large record")
+{
+}
+
+void
+LogBinaryVolumeTestCase::DoRun()
+{
+    const uint32_t threads = 4;
+    const uint32_t messages = 40000;
+    const std::size_t largeSize = 3 << 20;
+
+    LogComponentEnable("LogBinaryTestSuite", LOG_DEBUG);
+    std::string filename = CreateTempDirFilename("log-binary-volume.nslog");
+    LogEnableBinary(filename);
+
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([t]() {
+            for (uint32_t i = 0; i < messages; ++i)
+            {
+                NS_LOG_DEBUG("thread " << t << " message " << i
+                                       << " padding to fill the buffers faster");
+            }
+        });
+    }
+    NS_LOG_DEBUG(std::string(largeSize, 'x'));
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    LogDisableBinary();
+    LogComponentDisable("LogBinaryTestSuite", LOG_DEBUG);
+
+    std::ifstream is(filename, std::ios::binary);
+    std::stringstream decoded;
+    LogDecodeBinary(is, decoded);
+
+    std::vector<uint32_t> next(threads, 0);
+    uint32_t large = 0;
+    std::string line;
+    while (std::getline(decoded, line))
+    {
+        if (line.size() == largeSize)
+        {
+            large++;
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string word;
+        uint32_t t = threads;
+        uint32_t i = 0;
+        iss >> word >> t >> word >> i;
+        NS_TEST_ASSERT_MSG_LT(t, threads, "Unexpected line " << line);
+        NS_TEST_ASSERT_MSG_EQ(i, next[t], "The messages of thread " << t << " are out of order");
+        next[t]++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(large, 1, "The large record should be decoded once");
+    for (uint32_t t = 0; t < threads; ++t)
+    {
+        NS_TEST_EXPECT_MSG_EQ(next[t], messages, "Messages of thread " << t << " are missing");
+    }
+}
+
+/**
+ * \ingroup log-binary-tests
+ * Binary log sink test suite.
+ */
+class LogBinaryTestSuite : public TestSuite
+{
+  public:
+    LogBinaryTestSuite();
+};
+
+LogBinaryTestSuite::LogBinaryTestSuite()
+    : TestSuite("log-binary")
+{
+#ifdef NS3_LOG_ENABLE
+    AddTestCase(new LogBinaryRenderingTestCase);
+    AddTestCase(new LogBinaryVolumeTestCase);
+#endif
+}
+
+/**
+ * \ingroup log-binary-tests
+ * Static variable for test initialization.
+ */
+static LogBinaryTestSuite g_logBinaryTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/mpsc-queue.h"
+#include "ns3/test.h"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpsc-queue-tests
+ * MpscQueue test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup mpsc-queue-tests MpscQueue tests
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Check the MpscQueue from a single thread.
+ */
+class MpscQueueBasicTestCase : public TestCase
+{
+  public:
+    MpscQueueBasicTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+MpscQueueBasicTestCase::MpscQueueBasicTestCase()
+    : TestCase("Check the MpscQueue from a single thread")
+{
+}
+
+void
+MpscQueueBasicTestCase::DoRun()
+{
+    MpscQueue<uint32_t> queue(5);
+    NS_TEST_ASSERT_MSG_EQ(queue.GetCapacity(), 8, "Capacity not rounded up to a power of two");
+    NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), true, "New queue not empty");
+
+    uint32_t item = 0;
+    NS_TEST_ASSERT_MSG_EQ(queue.Pop(item), false, "Pop from an empty queue");
+
+    // Go around the circular buffer several times
+    uint32_t pushed = 0;
+    uint32_t popped = 0;
+    for (uint32_t lap = 0; lap < 5; ++lap)
+    {
+        while (queue.Push(pushed))
+        {
+            pushed++;
+        }
+        NS_TEST_ASSERT_MSG_EQ(pushed - popped, 8, "Queue full too early");
+        NS_TEST_ASSERT_MSG_EQ(queue.IsEmpty(), false, "Full queue empty");
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(queue.Pop(item), true, "Pop failed");
+            NS_TEST_ASSERT_MSG_EQ(item, popped, "Wrong item order");
+            popped++;
+        }
+    }
+    while (queue.Pop(item))
+    {
+        NS_TEST_ASSERT_MSG_EQ(item, popped, "Wrong item order");
+        popped++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(popped, pushed, "Items lost");
+    NS_TEST_EXPECT_MSG_EQ(queue.IsEmpty(), true, "Drained queue not empty");
+}
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Check the MpscQueue with concurrent producers.
+ *
+ * The producers retry while the queue is full; the consumer checks
+ * that no item is lost and that the items of each producer come out
+ * in order.
+ */
+class MpscQueueThreadedTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param producers The number of producer threads.
+     */
+    MpscQueueThreadedTestCase(uint32_t producers);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_producers; //!< The number of producer threads.
+};
+
+MpscQueueThreadedTestCase::MpscQueueThreadedTestCase(uint32_t producers)
+    : TestCase("Check the MpscQueue with " + std::to_string(producers) + " producer threads"),
+      m_producers(producers)
+{
+}
+
+void
+MpscQueueThreadedTestCase::DoRun()
+{
+    const uint32_t count = 100000;
+    // (producer, sequence number)
+    typedef std::pair<uint32_t, uint32_t> Item;
+    MpscQueue<Item> queue(64);
+
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < m_producers; ++p)
+    {
+        threads.emplace_back([&queue, p, count]() {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                while (!queue.Push(Item(p, i)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint32_t> next(m_producers, 0);
+    uint64_t received = 0;
+    bool ordered = true;
+    while (received < uint64_t(count) * m_producers)
+    {
+        Item item;
+        if (!queue.Pop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && item.second == next[item.first];
+        next[item.first] = item.second + 1;
+        received++;
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(ordered, true, "Items of a producer out of order");
+    NS_TEST_EXPECT_MSG_EQ(queue.IsEmpty(), true, "Items left in the queue");
+}
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief The MpscQueue Test Suite.
+ */
+class MpscQueueTestSuite : public TestSuite
+{
+  public:
+    MpscQueueTestSuite()
+        : TestSuite("mpsc-queue")
+    {
+        AddTestCase(new MpscQueueBasicTestCase(), TestCase::QUICK);
+        AddTestCase(new MpscQueueThreadedTestCase(1), TestCase::QUICK);
+        AddTestCase(new MpscQueueThreadedTestCase(4), TestCase::QUICK);
+    }
+};
+
+/** MpscQueueTestSuite instance variable. */
+static MpscQueueTestSuite g_mpscQueueTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -464,6 +464,82 @@ AggregateObjectTestCase::DoRun()
     NS_TEST_ASSERT_MSG_NE(baseA, nullptr, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookups cached in an aggregate.
+ */
+class AggregateLookupTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    AggregateLookupTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+AggregateLookupTestCase::AggregateLookupTestCase()
+    : TestCase("Check the lookups cached in an aggregate")
+{
+}
+
+void
+AggregateLookupTestCase::DoRun()
+{
+    Ptr<BaseA> baseA = CreateObject<BaseA>();
+    Ptr<DerivedB> derivedB = CreateObject<DerivedB>();
+    baseA->AggregateObject(derivedB);
+
+    //
+    // Repeated lookups, which are answered from the cache after the first
+    // one, must give the same answers, including for a parent TypeId.
+    //
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<BaseB>(),
+                              derivedB,
+                              "Cannot GetObject for the parent of DerivedB");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedB>(),
+                              derivedB,
+                              "Cannot GetObject for DerivedB");
+        NS_TEST_ASSERT_MSG_EQ(derivedB->GetObject<BaseA>(),
+                              baseA,
+                              "Cannot GetObject (through derivedB) for BaseA");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedA>(),
+                              nullptr,
+                              "Unexpectedly found a DerivedA");
+        NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<Object>(BaseB::GetTypeId()),
+                              derivedB,
+                              "Cannot GetObject by TypeId for BaseB");
+    }
+
+    //
+    // A new aggregation must drop the cached lookups, including the
+    // cached absence of DerivedA.
+    //
+    Ptr<DerivedA> derivedA = CreateObject<DerivedA>();
+    derivedB->AggregateObject(derivedA);
+    NS_TEST_ASSERT_MSG_EQ(baseA->GetObject<DerivedA>(),
+                          derivedA,
+                          "Cannot GetObject for DerivedA after its aggregation");
+    NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseB>(),
+                          derivedB,
+                          "Cannot GetObject (through derivedA) for BaseB");
+    NS_TEST_ASSERT_MSG_EQ(derivedB->GetObject<BaseB>(),
+                          derivedB,
+                          "Cannot GetObject (through derivedB) for BaseB");
+    NS_TEST_ASSERT_MSG_EQ(derivedA->GetObject<BaseA>(),
+                          baseA,
+                          "Cannot GetObject (through derivedA) for BaseA");
+
+    //
+    // An unaggregated Object only matches its own TypeId and parents.
+    //
+    Ptr<DerivedA> alone = CreateObject<DerivedA>();
+    NS_TEST_ASSERT_MSG_EQ(alone->GetObject<BaseA>(), alone, "Cannot GetObject for BaseA");
+    NS_TEST_ASSERT_MSG_EQ(alone->GetObject<BaseB>(), nullptr, "Unexpectedly found a BaseB");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -565,6 +641,7 @@ ObjectTestSuite::ObjectTestSuite()
 {
     AddTestCase(new CreateObjectTestCase);
     AddTestCase(new AggregateObjectTestCase);
+    AddTestCase(new AggregateLookupTestCase);
     AddTestCase(new ObjectFactoryTestCase);
 }
 
@@ -0,0 +1,173 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/parameter-sweep.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/test.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup parameter-sweep-tests
+ * ParameterSweep test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup parameter-sweep-tests ParameterSweep test suite
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup parameter-sweep-tests
+ * Check the parsing and the application of the variants.
+ */
+class ParameterSweepVariantTestCase : public TestCase
+{
+  public:
+    ParameterSweepVariantTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ParameterSweepVariantTestCase::ParameterSweepVariantTestCase()
+    : TestCase("Check the variants of a sweep")
+{
+}
+
+void
+ParameterSweepVariantTestCase::DoRun()
+{
+    using Overrides = std::vector<std::string>;
+    NS_TEST_ASSERT_MSG_EQ(ParameterSweep::ParseVariant("").empty(), true, "Blank line");
+    NS_TEST_ASSERT_MSG_EQ(ParameterSweep::ParseVariant("  # comment").empty(),
+                          true,
+                          "Comment line");
+    Overrides overrides =
+        ParameterSweep::ParseVariant("  ns3::UniformRandomVariable::Max=7\tRngRun=3 # seven");
+    NS_TEST_ASSERT_MSG_EQ((overrides ==
+                           Overrides{"ns3::UniformRandomVariable::Max=7", "RngRun=3"}),
+                          true,
+                          "Overrides of a variant");
+    NS_TEST_ASSERT_MSG_EQ((ParameterSweep::ParseVariant("/A/B=1=2") == Overrides{"/A/B=1=2"}),
+                          true,
+                          "Value with an equal sign");
+
+    uint64_t run = RngSeedManager::GetRun();
+    ParameterSweep::Apply(overrides);
+    NS_TEST_ASSERT_MSG_EQ(RngSeedManager::GetRun(), 3, "Global value of an override");
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    NS_TEST_ASSERT_MSG_EQ(rv->GetMax(), 7, "Default attribute value of an override");
+
+    Config::SetDefault("ns3::UniformRandomVariable::Max", DoubleValue(1));
+    RngSeedManager::SetRun(run);
+}
+
+/**
+ * \ingroup parameter-sweep-tests
+ * Check that RandomVariableStream::ReseedAll() restarts the random
+ * variable streams alive as if they were created with the new run number.
+ */
+class ParameterSweepReseedTestCase : public TestCase
+{
+  public:
+    ParameterSweepReseedTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ParameterSweepReseedTestCase::ParameterSweepReseedTestCase()
+    : TestCase("Check the restart of the random variable streams")
+{
+}
+
+void
+ParameterSweepReseedTestCase::DoRun()
+{
+    uint64_t run = RngSeedManager::GetRun();
+    RngSeedManager::SetRun(1);
+    Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(5);
+    Ptr<NormalRandomVariable> normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(6);
+    // The automatic streams keep their index
+    Ptr<UniformRandomVariable> automatic = CreateObject<UniformRandomVariable>();
+    Ptr<UniformRandomVariable> other = CreateObject<UniformRandomVariable>();
+    double first = automatic->GetValue();
+    uniform->GetValue();
+    // The polar method keeps the second value of the pair
+    normal->GetValue();
+
+    RngSeedManager::SetRun(2);
+    RandomVariableStream::ReseedAll();
+    Ptr<UniformRandomVariable> uniform2 = CreateObject<UniformRandomVariable>();
+    uniform2->SetStream(5);
+    Ptr<NormalRandomVariable> normal2 = CreateObject<NormalRandomVariable>();
+    normal2->SetStream(6);
+    for (int i = 0; i < 10; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(uniform->GetValue(), uniform2->GetValue(), "Uniform value " << i);
+        NS_TEST_ASSERT_MSG_EQ(normal->GetValue(), normal2->GetValue(), "Normal value " << i);
+    }
+
+    RngSeedManager::SetRun(1);
+    RandomVariableStream::ReseedAll();
+    NS_TEST_ASSERT_MSG_EQ(automatic->GetValue(), first, "Automatic stream of the run 1");
+    NS_TEST_ASSERT_MSG_NE(other->GetValue(), first, "Other automatic stream");
+
+    RngSeedManager::SetRun(run);
+    RandomVariableStream::ReseedAll();
+}
+
+/**
+ * \ingroup parameter-sweep-tests
+ * ParameterSweep test suite.
+ */
+class ParameterSweepTestSuite : public TestSuite
+{
+  public:
+    ParameterSweepTestSuite();
+};
+
+ParameterSweepTestSuite::ParameterSweepTestSuite()
+    : TestSuite("parameter-sweep")
+{
+    AddTestCase(new ParameterSweepVariantTestCase);
+    AddTestCase(new ParameterSweepReseedTestCase);
+}
+
+/**
+ * \ingroup parameter-sweep-tests
+ * Static variable for test initialization.
+ */
+static ParameterSweepTestSuite g_parameterSweepTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
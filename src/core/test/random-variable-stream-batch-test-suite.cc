@@ -0,0 +1,258 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-stream.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Tests of the batches of random values.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RngStream::RandU01(double*,std::size_t) returns the
+ * numbers of successive calls to RngStream::RandU01().
+ */
+class RngStreamBatchTestCase : public TestCase
+{
+  public:
+    RngStreamBatchTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+RngStreamBatchTestCase::RngStreamBatchTestCase()
+    : TestCase("Check the batches of RngStream")
+{
+}
+
+void
+RngStreamBatchTestCase::DoRun()
+{
+    struct Start
+    {
+        uint32_t seed;
+        uint64_t stream;
+        uint64_t substream;
+    };
+
+    const std::vector<Start> starts = {
+        {1, 0, 0},
+        {12345, 7, 3},
+        {4294944442U, (1ULL << 63) + 5, 11},
+    };
+    // Small batches, then batches split in blocks of several sizes
+    const std::vector<std::size_t> counts =
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 100, 127, 128, 1001, 4096, 65539};
+
+    for (const auto& start : starts)
+    {
+        RngStream scalar(start.seed, start.stream, start.substream);
+        RngStream batch(scalar);
+        for (auto count : counts)
+        {
+            std::vector<double> values(count);
+            batch.RandU01(values.data(), count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                NS_TEST_ASSERT_MSG_EQ(values[i],
+                                      scalar.RandU01(),
+                                      "Different random " << i << " in a batch of " << count
+                                                          << " of stream " << start.stream);
+            }
+            // The streams continue in step after the batch
+            NS_TEST_ASSERT_MSG_EQ(batch.RandU01(),
+                                  scalar.RandU01(),
+                                  "Different random after a batch of " << count);
+        }
+    }
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that RandomVariableStream::GetValues() and
+ * RandomVariableStream::GetIntegers() return the values of successive
+ * calls to GetValue() and GetInteger().
+ */
+class RandomVariableStreamBatchTestCase : public TestCase
+{
+  public:
+    RandomVariableStreamBatchTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the batches of a random variable.
+     * \param [in] scalar The random variable of the successive calls.
+     * \param [in] batch The random variable of the batches, with the same stream.
+     * \param [in] name The name of the random variable.
+     */
+    void Check(Ptr<RandomVariableStream> scalar,
+               Ptr<RandomVariableStream> batch,
+               const std::string& name);
+};
+
+RandomVariableStreamBatchTestCase::RandomVariableStreamBatchTestCase()
+    : TestCase("Check the batches of RandomVariableStream")
+{
+}
+
+void
+RandomVariableStreamBatchTestCase::Check(Ptr<RandomVariableStream> scalar,
+                                         Ptr<RandomVariableStream> batch,
+                                         const std::string& name)
+{
+    const std::vector<std::size_t> counts = {1, 3, 4, 5, 63, 64, 65, 1000};
+    for (auto count : counts)
+    {
+        std::vector<double> values(count);
+        batch->GetValues(values.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(values[i],
+                                  scalar->GetValue(),
+                                  name << ": different value " << i << " in a batch of " << count);
+        }
+
+        std::vector<uint32_t> integers(count);
+        batch->GetIntegers(integers.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(integers[i],
+                                  scalar->GetInteger(),
+                                  name << ": different integer " << i << " in a batch of "
+                                       << count);
+        }
+    }
+}
+
+void
+RandomVariableStreamBatchTestCase::DoRun()
+{
+    for (bool antithetic : {false, true})
+    {
+        std::string suffix = antithetic ? " (antithetic)" : "";
+        for (int64_t stream : {0, 1000})
+        {
+            std::vector<Ptr<UniformRandomVariable>> uniform;
+            std::vector<Ptr<ExponentialRandomVariable>> exponential;
+            std::vector<Ptr<ExponentialRandomVariable>> bounded;
+            std::vector<Ptr<NormalRandomVariable>> normal;
+            std::vector<Ptr<ExponentialRandomVariable>> exponentialZiggurat;
+            std::vector<Ptr<NormalRandomVariable>> normalZiggurat;
+            std::vector<Ptr<LogNormalRandomVariable>> logNormalZiggurat;
+            for (int i = 0; i < 2; ++i)
+            {
+                uniform.push_back(CreateObject<UniformRandomVariable>());
+                uniform.back()->SetAttribute("Min", DoubleValue(2));
+                uniform.back()->SetAttribute("Max", DoubleValue(100));
+                exponential.push_back(CreateObject<ExponentialRandomVariable>());
+                exponential.back()->SetAttribute("Mean", DoubleValue(10));
+                exponential.back()->SetAttribute("Bound", DoubleValue(0));
+                // Rejects about one value in three
+                bounded.push_back(CreateObject<ExponentialRandomVariable>());
+                bounded.back()->SetAttribute("Mean", DoubleValue(10));
+                bounded.back()->SetAttribute("Bound", DoubleValue(11));
+                // Draws in the base class
+                normal.push_back(CreateObject<NormalRandomVariable>());
+                // Rejects about one value in three, after the tails and
+                // wedges of the ziggurat
+                exponentialZiggurat.push_back(CreateObject<ExponentialRandomVariable>());
+                exponentialZiggurat.back()->SetAttribute("Bound", DoubleValue(1));
+                exponentialZiggurat.back()->SetAttribute(
+                    "Algorithm",
+                    EnumValue(ExponentialRandomVariable::ZIGGURAT));
+                normalZiggurat.push_back(CreateObject<NormalRandomVariable>());
+                normalZiggurat.back()->SetAttribute("Bound", DoubleValue(1));
+                normalZiggurat.back()->SetAttribute("Algorithm",
+                                                    EnumValue(NormalRandomVariable::ZIGGURAT));
+                logNormalZiggurat.push_back(CreateObject<LogNormalRandomVariable>());
+                logNormalZiggurat.back()->SetAttribute(
+                    "Algorithm",
+                    EnumValue(LogNormalRandomVariable::ZIGGURAT));
+            }
+            for (int i = 0; i < 2; ++i)
+            {
+                for (Ptr<RandomVariableStream> rv :
+                     {Ptr<RandomVariableStream>(uniform[i]),
+                      Ptr<RandomVariableStream>(exponential[i]),
+                      Ptr<RandomVariableStream>(bounded[i]),
+                      Ptr<RandomVariableStream>(normal[i]),
+                      Ptr<RandomVariableStream>(exponentialZiggurat[i]),
+                      Ptr<RandomVariableStream>(normalZiggurat[i]),
+                      Ptr<RandomVariableStream>(logNormalZiggurat[i])})
+                {
+                    rv->SetStream(stream);
+                    rv->SetAttribute("Antithetic", BooleanValue(antithetic));
+                }
+            }
+            Check(uniform[0], uniform[1], "Uniform" + suffix);
+            Check(exponential[0], exponential[1], "Exponential" + suffix);
+            Check(bounded[0], bounded[1], "Bounded exponential" + suffix);
+            Check(normal[0], normal[1], "Normal" + suffix);
+            Check(exponentialZiggurat[0],
+                  exponentialZiggurat[1],
+                  "Bounded exponential ziggurat" + suffix);
+            Check(normalZiggurat[0], normalZiggurat[1], "Bounded normal ziggurat" + suffix);
+            Check(logNormalZiggurat[0], logNormalZiggurat[1], "Log-normal ziggurat" + suffix);
+        }
+    }
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Batches of random values test suite.
+ */
+class RandomVariableStreamBatchTestSuite : public TestSuite
+{
+  public:
+    RandomVariableStreamBatchTestSuite();
+};
+
+RandomVariableStreamBatchTestSuite::RandomVariableStreamBatchTestSuite()
+    : TestSuite("random-variable-stream-batch")
+{
+    AddTestCase(new RngStreamBatchTestCase);
+    AddTestCase(new RandomVariableStreamBatchTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Static variable for test initialization.
+ */
+static RandomVariableStreamBatchTestSuite g_randomVariableStreamBatchTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
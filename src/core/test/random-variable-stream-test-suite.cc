@@ -22,19 +22,23 @@
 
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/enum.h"
 #include "ns3/integer.h"
 #include "ns3/log.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <algorithm>
 #include <cmath>
 #include <ctime>
 #include <fstream>
 #include <gsl/gsl_cdf.h>
 #include <gsl/gsl_histogram.h>
 #include <gsl/gsl_sf_zeta.h>
+#include <map>
 
 using namespace ns3;
 
@@ -180,6 +184,39 @@ class TestCaseBase : public TestCase
         bool m_anti;
     };
 
+    /**
+     * Factory class to create new instances of a random variable stream
+     * which draws its values with the ziggurat method.
+     *
+     * \tparam RNG The type of random variable generator to create.
+     */
+    template <typename RNG>
+    class ZigguratGenerator : public RngGeneratorBase
+    {
+      public:
+        /**
+         * Constructor.
+         * \param [in] anti Create antithetic streams if \c true.
+         */
+        ZigguratGenerator(bool anti = false)
+            : m_anti(anti)
+        {
+        }
+
+        // Inherited
+        Ptr<RandomVariableStream> Create() const override
+        {
+            auto rng = CreateObject<RNG>();
+            rng->SetAttribute("Antithetic", BooleanValue(m_anti));
+            rng->SetAttribute("Algorithm", EnumValue(RNG::ZIGGURAT));
+            return rng;
+        }
+
+      private:
+        /** Whether to create antithetic random variable streams. */
+        bool m_anti;
+    };
+
     /**
      * Compute the chi squared value of a sampled distribution
      * compared to the expected distribution.
@@ -2531,6 +2568,154 @@ EmpiricalAntitheticTestCase::DoRun()
                               "Wrong mean value.");
 }
 
+/**
+ * \ingroup rng-tests
+ * Test case for the guide table, the alias tables and the loading of the
+ * CDF of the empirical distribution random variable stream generator.
+ */
+class EmpiricalTablesTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    EmpiricalTablesTestCase();
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /**
+     * Fill the CDF of a random variable: a skewed distribution of many
+     * points, some of them with a zero probability, the others likely
+     * enough for a chi-squared test.
+     * \param [in] x The random variable.
+     * \param [out] points The points of the CDF.
+     */
+    void Fill(Ptr<EmpiricalRandomVariable> x, std::vector<std::pair<double, double>>& points) const;
+
+    /** The number of points of the CDF. */
+    static const uint32_t N_POINTS{1000};
+};
+
+EmpiricalTablesTestCase::EmpiricalTablesTestCase()
+    : TestCaseBase("Empirical Random Variable Stream Generator tables")
+{
+}
+
+void
+EmpiricalTablesTestCase::Fill(Ptr<EmpiricalRandomVariable> x,
+                              std::vector<std::pair<double, double>>& points) const
+{
+    points.clear();
+    for (uint32_t i = 1; i <= N_POINTS; ++i)
+    {
+        double fraction = static_cast<double>(i) / N_POINTS;
+        // Every tenth point repeats the CDF of the previous one
+        double cdf = (i % 10 == 0 && i < N_POINTS) ? points.back().second
+                                                   : (fraction + fraction * fraction) / 2;
+        points.emplace_back(i * 10.0, cdf);
+        x->CDF(i * 10.0, cdf);
+    }
+}
+
+void
+EmpiricalTablesTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    // The guide table finds the values of a search of the whole CDF
+    std::vector<std::pair<double, double>> points;
+    for (bool interpolate : {false, true})
+    {
+        Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable>();
+        x->SetInterpolate(interpolate);
+        x->SetStream(7);
+        Fill(x, points);
+        RngStream rng(RngSeedManager::GetSeed(), (1ULL << 63) + 7, RngSeedManager::GetRun());
+        auto less = [](double r, const std::pair<double, double>& point) {
+            return r < point.second;
+        };
+        for (uint32_t i = 0; i < N_MEASUREMENTS / 10; ++i)
+        {
+            double r = rng.RandU01();
+            double expected;
+            if (r <= points.front().second)
+            {
+                expected = points.front().first;
+            }
+            else
+            {
+                auto upper = std::upper_bound(points.begin(), points.end(), r, less);
+                auto lower = std::prev(upper);
+                expected = interpolate ? lower->first + (upper->first - lower->first) /
+                                                            (upper->second - lower->second) *
+                                                            (r - lower->second)
+                                       : upper->first;
+            }
+            NS_TEST_ASSERT_MSG_EQ(x->GetValue(),
+                                  expected,
+                                  "Wrong value " << i << ", interpolation " << interpolate);
+        }
+    }
+
+    // The alias tables have the probabilities of the points
+    Ptr<EmpiricalRandomVariable> x = CreateObject<EmpiricalRandomVariable>();
+    x->SetAttribute("Alias", BooleanValue(true));
+    Fill(x, points);
+    std::map<double, uint32_t> counts;
+    for (uint32_t i = 0; i < N_MEASUREMENTS; ++i)
+    {
+        counts[x->GetValue()]++;
+    }
+    double chiSquared = 0;
+    uint32_t bins = 0;
+    double prior = 0;
+    for (const auto& point : points)
+    {
+        double expected = (point.second - prior) * N_MEASUREMENTS;
+        prior = point.second;
+        if (expected == 0)
+        {
+            NS_TEST_ASSERT_MSG_EQ(counts.count(point.first),
+                                  0,
+                                  "Value " << point.first << " has a zero probability");
+            continue;
+        }
+        double difference = counts[point.first] - expected;
+        chiSquared += difference * difference / expected;
+        bins++;
+    }
+    NS_TEST_ASSERT_MSG_EQ(counts.size(), bins, "Unexpected values");
+    NS_TEST_ASSERT_MSG_LT(chiSquared,
+                          gsl_cdf_chisq_Qinv(0.01, bins - 1),
+                          "Chi-squared statistic out of range");
+
+    // A CDF loaded from a file is the CDF of its points
+    std::string filename = CreateTempDirFilename("empirical-cdf.txt");
+    {
+        std::ofstream os(filename);
+        os << "# value cdf" << std::endl;
+        os << std::endl;
+        os << "0.0   0.0" << std::endl;
+        os << "5.0   0.25  # the first quarter" << std::endl;
+        os << "\t10.0\t1.0" << std::endl;
+    }
+    Ptr<EmpiricalRandomVariable> loaded = CreateObject<EmpiricalRandomVariable>();
+    loaded->LoadCDF(filename);
+    loaded->SetStream(3);
+    Ptr<EmpiricalRandomVariable> direct = CreateObject<EmpiricalRandomVariable>();
+    direct->CDF(0.0, 0.0);
+    direct->CDF(5.0, 0.25);
+    direct->CDF(10.0, 1.0);
+    direct->SetStream(3);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(loaded->GetValue(),
+                              direct->GetValue(),
+                              "The loaded CDF differs at value " << i);
+    }
+}
+
 /**
  * \ingroup rng-tests
  * Test case for caching of Normal RV parameters (see issue #302)
@@ -2565,6 +2750,286 @@ NormalCachingTestCase::DoRun()
     NS_TEST_ASSERT_MSG_GT(v2, 0, "Incorrect value returned, expected > 0");
 }
 
+/**
+ * \ingroup rng-tests
+ * Test case for the ziggurat method of the normal distribution random
+ * variable stream generator.
+ */
+class NormalZigguratTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    NormalZigguratTestCase();
+
+    // Inherited
+    double ChiSquaredTest(Ptr<RandomVariableStream> rng) const override;
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /** Tolerance for testing rng values against expectation, in rms. */
+    static constexpr double TOLERANCE{5};
+};
+
+NormalZigguratTestCase::NormalZigguratTestCase()
+    : TestCaseBase("Ziggurat Normal Random Variable Stream Generator")
+{
+}
+
+double
+NormalZigguratTestCase::ChiSquaredTest(Ptr<RandomVariableStream> rng) const
+{
+    // The bins cover the tails, which the ziggurat draws apart
+    gsl_histogram* h = gsl_histogram_alloc(N_BINS);
+    auto range = UniformHistogramBins(h, -5., 5.);
+
+    std::vector<double> expected(N_BINS);
+
+    double sigma = 1.;
+
+    for (std::size_t i = 0; i < N_BINS; ++i)
+    {
+        expected[i] = gsl_cdf_gaussian_P(range[i + 1], sigma) - gsl_cdf_gaussian_P(range[i], sigma);
+        expected[i] *= N_MEASUREMENTS;
+    }
+
+    double chiSquared = ChiSquared(h, expected, rng);
+    gsl_histogram_free(h);
+    return chiSquared;
+}
+
+void
+NormalZigguratTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    double maxStatistic = gsl_cdf_chisq_Qinv(0.05, N_BINS);
+    for (bool anti : {false, true})
+    {
+        auto generator = ZigguratGenerator<NormalRandomVariable>(anti);
+        double sum = ChiSquaredsAverage(&generator, N_RUNS);
+        NS_TEST_ASSERT_MSG_LT(sum,
+                              maxStatistic,
+                              "Chi-squared statistic out of range, antithetic " << anti);
+    }
+
+    double mean = 5.0;
+    double variance = 2.0;
+
+    Ptr<NormalRandomVariable> x = CreateObject<NormalRandomVariable>();
+    x->SetAttribute("Mean", DoubleValue(mean));
+    x->SetAttribute("Variance", DoubleValue(variance));
+    x->SetAttribute("Algorithm", EnumValue(NormalRandomVariable::ZIGGURAT));
+
+    // The values beyond 3.44 standard deviations come from the tail of
+    // the ziggurat, the others from its layers.
+    double r = 3.442619855899;
+    double sum = 0;
+    double sumSquares = 0;
+    uint32_t tail = 0;
+    for (uint32_t i = 0; i < N_MEASUREMENTS; ++i)
+    {
+        double value = x->GetValue();
+        sum += value;
+        sumSquares += (value - mean) * (value - mean);
+        if (std::fabs(value - mean) > r * std::sqrt(variance))
+        {
+            tail++;
+        }
+    }
+    double valueMean = sum / N_MEASUREMENTS;
+    double valueVariance = sumSquares / N_MEASUREMENTS;
+    double expectedRms = mean / std::sqrt(variance * N_MEASUREMENTS);
+    NS_TEST_ASSERT_MSG_EQ_TOL(valueMean, mean, expectedRms * TOLERANCE, "Wrong mean value.");
+    // The variance of the sample variance is 2 sigma^4 / n
+    NS_TEST_ASSERT_MSG_EQ_TOL(valueVariance,
+                              variance,
+                              variance * std::sqrt(2. / N_MEASUREMENTS) * TOLERANCE,
+                              "Wrong variance.");
+    double expectedTail = 2 * gsl_cdf_gaussian_Q(r, 1.) * N_MEASUREMENTS;
+    NS_TEST_ASSERT_MSG_EQ_TOL(tail,
+                              expectedTail,
+                              std::sqrt(expectedTail) * TOLERANCE,
+                              "Wrong number of values in the tail.");
+}
+
+/**
+ * \ingroup rng-tests
+ * Test case for the ziggurat method of the exponential distribution
+ * random variable stream generator.
+ */
+class ExponentialZigguratTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    ExponentialZigguratTestCase();
+
+    // Inherited
+    double ChiSquaredTest(Ptr<RandomVariableStream> rng) const override;
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /** Tolerance for testing rng values against expectation, in rms. */
+    static constexpr double TOLERANCE{5};
+};
+
+ExponentialZigguratTestCase::ExponentialZigguratTestCase()
+    : TestCaseBase("Ziggurat Exponential Random Variable Stream Generator")
+{
+}
+
+double
+ExponentialZigguratTestCase::ChiSquaredTest(Ptr<RandomVariableStream> rng) const
+{
+    gsl_histogram* h = gsl_histogram_alloc(N_BINS);
+    auto range = UniformHistogramBins(h, 0, 10, false);
+
+    std::vector<double> expected(N_BINS);
+
+    double mu = 1.;
+
+    for (std::size_t i = 0; i < N_BINS; ++i)
+    {
+        expected[i] = gsl_cdf_exponential_P(range[i + 1], mu) - gsl_cdf_exponential_P(range[i], mu);
+        expected[i] *= N_MEASUREMENTS;
+    }
+
+    double chiSquared = ChiSquared(h, expected, rng);
+
+    gsl_histogram_free(h);
+    return chiSquared;
+}
+
+void
+ExponentialZigguratTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    double maxStatistic = gsl_cdf_chisq_Qinv(0.05, N_BINS);
+    for (bool anti : {false, true})
+    {
+        auto generator = ZigguratGenerator<ExponentialRandomVariable>(anti);
+        double sum = ChiSquaredsAverage(&generator, N_RUNS);
+        NS_TEST_ASSERT_MSG_LT(sum,
+                              maxStatistic,
+                              "Chi-squared statistic out of range, antithetic " << anti);
+    }
+
+    double mean = 3.14;
+
+    Ptr<ExponentialRandomVariable> x = CreateObject<ExponentialRandomVariable>();
+    x->SetAttribute("Mean", DoubleValue(mean));
+    x->SetAttribute("Algorithm", EnumValue(ExponentialRandomVariable::ZIGGURAT));
+
+    // The values beyond 7.70 means come from the tail of the ziggurat
+    double r = 7.697117470131487;
+    double sum = 0;
+    uint32_t tail = 0;
+    for (uint32_t i = 0; i < N_MEASUREMENTS; ++i)
+    {
+        double value = x->GetValue();
+        sum += value;
+        if (value > r * mean)
+        {
+            tail++;
+        }
+    }
+    double valueMean = sum / N_MEASUREMENTS;
+    double expectedRms = std::sqrt(mean / N_MEASUREMENTS);
+    NS_TEST_ASSERT_MSG_EQ_TOL(valueMean, mean, expectedRms * TOLERANCE, "Wrong mean value.");
+    double expectedTail = std::exp(-r) * N_MEASUREMENTS;
+    NS_TEST_ASSERT_MSG_EQ_TOL(tail,
+                              expectedTail,
+                              std::sqrt(expectedTail) * TOLERANCE,
+                              "Wrong number of values in the tail.");
+}
+
+/**
+ * \ingroup rng-tests
+ * Test case for the ziggurat method of the log-normal distribution
+ * random variable stream generator.
+ */
+class LogNormalZigguratTestCase : public TestCaseBase
+{
+  public:
+    // Constructor
+    LogNormalZigguratTestCase();
+
+    // Inherited
+    double ChiSquaredTest(Ptr<RandomVariableStream> rng) const override;
+
+  private:
+    // Inherited
+    void DoRun() override;
+
+    /**
+     * Tolerance for testing rng values against expectation,
+     * as a fraction of mean value.
+     */
+    static constexpr double TOLERANCE{3e-2};
+};
+
+LogNormalZigguratTestCase::LogNormalZigguratTestCase()
+    : TestCaseBase("Ziggurat Log-Normal Random Variable Stream Generator")
+{
+}
+
+double
+LogNormalZigguratTestCase::ChiSquaredTest(Ptr<RandomVariableStream> rng) const
+{
+    gsl_histogram* h = gsl_histogram_alloc(N_BINS);
+    auto range = UniformHistogramBins(h, 0, 10, false);
+
+    std::vector<double> expected(N_BINS);
+
+    double mu = 0.0;
+    double sigma = 1.0;
+
+    for (std::size_t i = 0; i < N_BINS; ++i)
+    {
+        expected[i] =
+            gsl_cdf_lognormal_P(range[i + 1], mu, sigma) - gsl_cdf_lognormal_P(range[i], mu, sigma);
+        expected[i] *= N_MEASUREMENTS;
+    }
+
+    double chiSquared = ChiSquared(h, expected, rng);
+
+    gsl_histogram_free(h);
+    return chiSquared;
+}
+
+void
+LogNormalZigguratTestCase::DoRun()
+{
+    NS_LOG_FUNCTION(this);
+    SetTestSuiteSeed();
+
+    auto generator = ZigguratGenerator<LogNormalRandomVariable>();
+    double sum = ChiSquaredsAverage(&generator, N_RUNS);
+    double maxStatistic = gsl_cdf_chisq_Qinv(0.05, N_BINS);
+    NS_TEST_ASSERT_MSG_LT(sum, maxStatistic, "Chi-squared statistic out of range");
+
+    double mu = 5.0;
+    double sigma = 2.0;
+
+    Ptr<LogNormalRandomVariable> x = CreateObject<LogNormalRandomVariable>();
+    x->SetAttribute("Mu", DoubleValue(mu));
+    x->SetAttribute("Sigma", DoubleValue(sigma));
+    x->SetAttribute("Algorithm", EnumValue(LogNormalRandomVariable::ZIGGURAT));
+
+    double valueMean = Average(x);
+    double expectedMean = std::exp(mu + sigma * sigma / 2.0);
+    NS_TEST_ASSERT_MSG_EQ_TOL(valueMean,
+                              expectedMean,
+                              expectedMean * TOLERANCE,
+                              "Wrong mean value.");
+}
+
 /**
  * \ingroup rng-tests
  * RandomVariableStream test suite, covering all random number variable
@@ -2615,8 +3080,12 @@ RandomVariableSuite::RandomVariableSuite()
     AddTestCase(new DeterministicTestCase);
     AddTestCase(new EmpiricalTestCase);
     AddTestCase(new EmpiricalAntitheticTestCase);
+    AddTestCase(new EmpiricalTablesTestCase);
     /// Issue #302:  NormalRandomVariable produces stale values
     AddTestCase(new NormalCachingTestCase);
+    AddTestCase(new NormalZigguratTestCase);
+    AddTestCase(new ExponentialZigguratTestCase);
+    AddTestCase(new LogNormalZigguratTestCase);
 }
 
 static RandomVariableSuite randomVariableSuite; //!< Static variable for test initialization
@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/rng-stream.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Tests of the random number generator engines.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup randomvariable-tests
+ * Check the Philox4x64 engine against the known answers of Random123.
+ */
+class PhiloxKnownAnswerTestCase : public TestCase
+{
+  public:
+    PhiloxKnownAnswerTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Convert random bits to a random in (0, 1), as the engine.
+     * \param [in] bits The random bits.
+     * \returns The random.
+     */
+    static double ToU01(uint64_t bits);
+};
+
+PhiloxKnownAnswerTestCase::PhiloxKnownAnswerTestCase()
+    : TestCase("Check the known answers of Philox4x64")
+{
+}
+
+double
+PhiloxKnownAnswerTestCase::ToU01(uint64_t bits)
+{
+    return (static_cast<double>(bits >> 12) + 0.5) / 4503599627370496.0;
+}
+
+void
+PhiloxKnownAnswerTestCase::DoRun()
+{
+    // philox4x64_10 of the counter 0 with the key 0
+    const uint64_t zeros[4] = {0x16554d9eca36314cULL,
+                               0xdb20fe9d672d0fdcULL,
+                               0xd7e772cee186176bULL,
+                               0x7e68b68aec7ba23bULL};
+    // The seed 0 is legal for this engine only
+    RngStream rng(0, 0, 0, RngStream::PHILOX4X64);
+    for (int i = 0; i < 4; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(rng.RandU01(), ToU01(zeros[i]), "Different random " << i);
+    }
+
+    // The next block starts at the next counter
+    RngStream again(0, 0, 0, RngStream::PHILOX4X64);
+    std::vector<double> values(4);
+    again.RandU01(values.data(), values.size());
+    for (int i = 0; i < 4; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(values[i], ToU01(zeros[i]), "Different random " << i << " in batch");
+    }
+    NS_TEST_ASSERT_MSG_EQ(again.RandU01(), rng.RandU01(), "Different random in the second block");
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Check the streams and substreams of the Philox4x64 engine.
+ */
+class PhiloxStreamTestCase : public TestCase
+{
+  public:
+    PhiloxStreamTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PhiloxStreamTestCase::PhiloxStreamTestCase()
+    : TestCase("Check the streams of Philox4x64")
+{
+}
+
+void
+PhiloxStreamTestCase::DoRun()
+{
+    const std::size_t count = 100003;
+
+    RngStream scalar(12345, (1ULL << 63) + 7, 3, RngStream::PHILOX4X64);
+    RngStream batch(scalar);
+    std::vector<double> values(count);
+    batch.RandU01(values.data(), count);
+    double sum = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double u = scalar.RandU01();
+        NS_TEST_ASSERT_MSG_EQ(values[i], u, "Different random " << i << " in a batch");
+        NS_TEST_ASSERT_MSG_GT(u, 0, "Random " << i << " out of (0, 1)");
+        NS_TEST_ASSERT_MSG_LT(u, 1, "Random " << i << " out of (0, 1)");
+        sum += u;
+    }
+    NS_TEST_EXPECT_MSG_EQ_TOL(sum / count, 0.5, 0.005, "Unexpected mean");
+
+    // Neighbouring streams, substreams and seeds differ
+    RngStream base(12345, 7, 3, RngStream::PHILOX4X64);
+    RngStream stream(12345, 8, 3, RngStream::PHILOX4X64);
+    RngStream substream(12345, 7, 4, RngStream::PHILOX4X64);
+    RngStream seed(12346, 7, 3, RngStream::PHILOX4X64);
+    RngStream mrg(12345, 7, 3, RngStream::MRG32K3A);
+    double first = base.RandU01();
+    NS_TEST_EXPECT_MSG_NE(stream.RandU01(), first, "Neighbouring streams should differ");
+    NS_TEST_EXPECT_MSG_NE(substream.RandU01(), first, "Neighbouring substreams should differ");
+    NS_TEST_EXPECT_MSG_NE(seed.RandU01(), first, "Neighbouring seeds should differ");
+    NS_TEST_EXPECT_MSG_NE(mrg.RandU01(), first, "The engines should differ");
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Check that the RngEngine global value selects the engine of the
+ * random variables.
+ */
+class RngEngineGlobalValueTestCase : public TestCase
+{
+  public:
+    RngEngineGlobalValueTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+RngEngineGlobalValueTestCase::RngEngineGlobalValueTestCase()
+    : TestCase("Check the selection of the engine")
+{
+}
+
+void
+RngEngineGlobalValueTestCase::DoRun()
+{
+    RngStream::Engine engine = RngSeedManager::GetEngine();
+    NS_TEST_EXPECT_MSG_EQ(engine, RngStream::MRG32K3A, "MRG32k3a should be the default engine");
+
+    for (auto selected : {RngStream::PHILOX4X64, RngStream::MRG32K3A})
+    {
+        RngSeedManager::SetEngine(selected);
+        NS_TEST_EXPECT_MSG_EQ(RngSeedManager::GetEngine(), selected, "Engine not set");
+
+        Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable>();
+        x->SetStream(42);
+        RngStream expected(RngSeedManager::GetSeed(),
+                           (1ULL << 63) + 42,
+                           RngSeedManager::GetRun(),
+                           selected);
+        for (int i = 0; i < 10; ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(x->GetValue(),
+                                  expected.RandU01(),
+                                  "Different random " << i << " of engine " << selected);
+        }
+    }
+
+    RngSeedManager::SetEngine(engine);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Random number generator engines test suite.
+ */
+class RngEngineTestSuite : public TestSuite
+{
+  public:
+    RngEngineTestSuite();
+};
+
+RngEngineTestSuite::RngEngineTestSuite()
+    : TestSuite("rng-engine")
+{
+    AddTestCase(new PhiloxKnownAnswerTestCase);
+    AddTestCase(new PhiloxStreamTestCase);
+    AddTestCase(new RngEngineGlobalValueTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Static variable for test initialization.
+ */
+static RngEngineTestSuite g_rngEngineTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
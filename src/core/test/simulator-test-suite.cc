@@ -17,12 +17,30 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "ns3/calendar-scheduler.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/event-impl.h"
+#include "ns3/event-profiler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator-stats.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -717,6 +735,576 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the order of the events of a Scheduler under a random
+ * mix of insertions and removals, against a reference ordered set.
+ *
+ * The delays include bursts of simultaneous events and long gaps, so
+ * that the schedulers which spread events over buckets are exercised
+ * across their reorganizations.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the event order under random operations with " +
+               schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+
+    std::set<Scheduler::EventKey> reference;
+    std::vector<Scheduler::EventKey> live;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    auto removeNext = [&]() {
+        Scheduler::Event ev = scheduler->RemoveNext();
+        NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid, reference.begin()->m_uid, "Wrong event order");
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(ev.key.m_ts, now, "Event in the past");
+        now = ev.key.m_ts;
+        reference.erase(reference.begin());
+    };
+
+    for (uint32_t i = 0; i < 50000; ++i)
+    {
+        double op = rng->GetValue();
+        if (op < 0.5 || reference.empty())
+        {
+            double shape = rng->GetValue();
+            uint64_t delay = 0;
+            if (shape < 0.3)
+            {
+                delay = 0;
+            }
+            else if (shape < 0.95)
+            {
+                delay = rng->GetInteger(0, 1000);
+            }
+            else
+            {
+                delay = rng->GetInteger(0, 1000000);
+            }
+            Scheduler::Event ev;
+            ev.impl = nullptr;
+            ev.key.m_ts = now + delay;
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            scheduler->Insert(ev);
+            reference.insert(ev.key);
+            live.push_back(ev.key);
+        }
+        else if (op < 0.85)
+        {
+            removeNext();
+        }
+        else
+        {
+            uint32_t index = rng->GetInteger(0, live.size() - 1);
+            Scheduler::EventKey key = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            if (reference.erase(key) == 1)
+            {
+                Scheduler::Event ev;
+                ev.impl = nullptr;
+                ev.key = key;
+                scheduler->Remove(ev);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), reference.empty(), "Wrong queue size");
+        if (!reference.empty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                                  reference.begin()->m_uid,
+                                  "Wrong next event");
+        }
+    }
+    while (!reference.empty())
+    {
+        removeNext();
+    }
+    NS_TEST_EXPECT_MSG_EQ(scheduler->IsEmpty(), true, "Scheduler not empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the accounting and the removal of the cancelled events.
+ *
+ * After the first events have run, three quarters of the remaining
+ * events are cancelled: the event queue must be compacted once half of
+ * it is made of cancelled events, and only the other events must run,
+ * in order.
+ */
+class CancelledEventsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     * \param threshold The compaction threshold.
+     */
+    CancelledEventsTestCase(ObjectFactory schedulerFactory, double threshold);
+    void DoRun() override;
+    void DoTeardown() override;
+
+  private:
+    /**
+     * Record an event.
+     * \param index The event index.
+     */
+    void Record(uint32_t index);
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    double m_threshold;               //!< Compaction threshold.
+    std::vector<uint32_t> m_run;      //!< The events run.
+};
+
+CancelledEventsTestCase::CancelledEventsTestCase(ObjectFactory schedulerFactory, double threshold)
+    : TestCase("Check the cancelled events with " + schedulerFactory.GetTypeId().GetName() +
+               " and a compaction threshold of " + std::to_string(threshold)),
+      m_schedulerFactory(schedulerFactory),
+      m_threshold(threshold)
+{
+}
+
+void
+CancelledEventsTestCase::Record(uint32_t index)
+{
+    m_run.push_back(index);
+}
+
+void
+CancelledEventsTestCase::DoTeardown()
+{
+    Config::Reset();
+}
+
+void
+CancelledEventsTestCase::DoRun()
+{
+    Config::SetDefault("ns3::DefaultSimulatorImpl::CompactionThreshold", DoubleValue(m_threshold));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::CompactionMinEvents", UintegerValue(10));
+    Simulator::SetScheduler(m_schedulerFactory);
+
+    // The events are scheduled out of order, at 0 to 999 us
+    const uint32_t total = 1000;
+    std::vector<EventId> events;
+    for (uint32_t i = 0; i < total; ++i)
+    {
+        uint32_t ts = (i * 7919) % total;
+        events.push_back(
+            Simulator::Schedule(MicroSeconds(ts), &CancelledEventsTestCase::Record, this, ts));
+    }
+    NS_TEST_ASSERT_MSG_EQ(Simulator::GetLiveEventCount(), total, "Wrong live event count");
+
+    // Run the first events, so that the scheduler is in a steady state
+    Simulator::Stop(MicroSeconds(250));
+    Simulator::Run();
+    const uint32_t first = m_run.size();
+    NS_TEST_ASSERT_MSG_EQ(Simulator::GetLiveEventCount(),
+                          total - first,
+                          "Wrong live event count");
+
+    // Cancel three quarters of the remaining events
+    uint64_t live = total - first;
+    uint64_t cancelled = 0;
+    bool compacted = false;
+    for (uint32_t i = 0; i < total; ++i)
+    {
+        if (events[i].IsExpired() || (i * 7919) % total % 4 == 0)
+        {
+            continue;
+        }
+        Simulator::Cancel(events[i]);
+        // Cancelling twice has no effect
+        Simulator::Cancel(events[i]);
+        live--;
+        cancelled++;
+        if (Simulator::GetCancelledEventCount() < cancelled)
+        {
+            // All the cancelled events were removed
+            compacted = true;
+            cancelled = 0;
+        }
+        NS_TEST_ASSERT_MSG_EQ(Simulator::GetCancelledEventCount(),
+                              cancelled,
+                              "Wrong cancelled event count");
+        NS_TEST_ASSERT_MSG_EQ(Simulator::GetLiveEventCount(), live, "Wrong live event count");
+    }
+    NS_TEST_EXPECT_MSG_EQ(compacted, (m_threshold < 1), "Wrong compaction");
+
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_run.size(), first + live, "Wrong number of events run");
+    for (uint32_t i = 1; i < m_run.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_GT(m_run[i], m_run[i - 1], "Events out of order");
+        if (i >= first)
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_run[i] % 4, 0, "Cancelled event run");
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetLiveEventCount(), 0, "Events left");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetCancelledEventCount(), 0, "Cancelled events left");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the recycling of the memory of the events.
+ *
+ * Events of several sizes are scheduled in waves, so that the events
+ * of a wave reuse the memory released by the previous one.  The bound
+ * arguments must survive the recycling.
+ */
+class EventPoolTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param enabled Whether the pool is enabled.
+     */
+    EventPoolTestCase(bool enabled);
+    void DoRun() override;
+
+  private:
+    /**
+     * Schedule an event whose closure holds \p N integers.
+     * \tparam N The number of integers.
+     * \param value The value of the integers.
+     */
+    template <std::size_t N>
+    void ScheduleWave(uint64_t value);
+
+    bool m_enabled;  //!< Whether the pool is enabled.
+    uint64_t m_sum;  //!< Sum of the values received.
+    uint64_t m_want; //!< Expected sum.
+};
+
+EventPoolTestCase::EventPoolTestCase(bool enabled)
+    : TestCase(std::string("Check the event memory pool ") + (enabled ? "enabled" : "disabled")),
+      m_enabled(enabled),
+      m_sum(0),
+      m_want(0)
+{
+}
+
+template <std::size_t N>
+void
+EventPoolTestCase::ScheduleWave(uint64_t value)
+{
+    std::array<uint64_t, N> data;
+    data.fill(value);
+    m_want += N * value;
+    Simulator::Schedule(NanoSeconds(value), [this, data]() {
+        m_sum += std::accumulate(data.begin(), data.end(), uint64_t(0));
+    });
+}
+
+void
+EventPoolTestCase::DoRun()
+{
+    EventImpl::SetPoolEnabled(m_enabled);
+    EventImpl::PoolStats before = EventImpl::GetPoolStats();
+    const uint32_t waves = 10;
+    const uint32_t events = 100;
+    for (uint32_t wave = 0; wave < waves; ++wave)
+    {
+        for (uint32_t i = 1; i <= events; ++i)
+        {
+            ScheduleWave<1>(i);
+            ScheduleWave<7>(i);
+            ScheduleWave<20>(i);
+        }
+        Simulator::Run();
+    }
+    Simulator::Destroy();
+    EventImpl::PoolStats after = EventImpl::GetPoolStats();
+    EventImpl::SetPoolEnabled(true);
+
+    NS_TEST_EXPECT_MSG_EQ(m_sum, m_want, "Corrupted event arguments");
+    uint64_t allocations = after.allocations - before.allocations;
+    uint64_t hits = after.hits - before.hits;
+#ifdef NS3_EVENT_POOL
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(allocations, waves * events * 3, "Events not counted");
+    if (m_enabled)
+    {
+        // All the waves after the first one reuse the memory of the events
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(hits, (waves - 1) * events * 3, "Pool not used");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(hits, 0, "Pool used while disabled");
+    }
+#else
+    NS_TEST_EXPECT_MSG_EQ(allocations + hits, 0, "Pool statistics without pool");
+#endif
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the EventProfiler.
+ *
+ * Fast and slow events are invoked in distinct contexts: the slow
+ * events must come first in the records, with exact counts, and only
+ * about one event in the sampling period must be timed.
+ */
+class EventProfilerTestCase : public TestCase
+{
+  public:
+    EventProfilerTestCase();
+    void DoRun() override;
+    void DoTeardown() override;
+
+  private:
+    /** A fast event. */
+    void Fast();
+    /** A slow event, which busy-waits for 50 us. */
+    void Slow();
+
+    uint32_t m_fast; //!< The number of fast events run.
+    uint32_t m_slow; //!< The number of slow events run.
+};
+
+EventProfilerTestCase::EventProfilerTestCase()
+    : TestCase("Check the event profiler"),
+      m_fast(0),
+      m_slow(0)
+{
+}
+
+void
+EventProfilerTestCase::Fast()
+{
+    m_fast++;
+}
+
+void
+EventProfilerTestCase::Slow()
+{
+    m_slow++;
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+void
+EventProfilerTestCase::DoTeardown()
+{
+    Config::Reset();
+}
+
+void
+EventProfilerTestCase::DoRun()
+{
+    // Every event timed
+    EventProfiler profiler(1);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        EventImpl* event = MakeEvent(&EventProfilerTestCase::Fast, this);
+        profiler.Invoke(event, 1);
+        event->Unref();
+    }
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        EventImpl* event = MakeEvent(&EventProfilerTestCase::Slow, this);
+        profiler.Invoke(event, 2);
+        event->Unref();
+    }
+    EventImpl* cancelled = MakeEvent(&EventProfilerTestCase::Slow, this);
+    cancelled->Cancel();
+    profiler.Invoke(cancelled, 2);
+    cancelled->Unref();
+
+    NS_TEST_EXPECT_MSG_EQ(m_fast, 100, "Fast events not run");
+    NS_TEST_EXPECT_MSG_EQ(m_slow, 10, "Slow events not run");
+    NS_TEST_EXPECT_MSG_EQ(profiler.GetEventCount(), 110, "Wrong event count");
+    std::vector<EventProfiler::Record> records = profiler.GetRecords();
+    NS_TEST_ASSERT_MSG_EQ(records.size(), 2, "Wrong number of records");
+    NS_TEST_EXPECT_MSG_EQ(records[0].context, 2, "Slow events not first");
+    NS_TEST_EXPECT_MSG_EQ(records[0].count, 10, "Wrong slow event count");
+    NS_TEST_EXPECT_MSG_EQ(records[0].samples, 10, "Wrong slow event samples");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(records[0].maximum, 50000, "Slow event too fast");
+    NS_TEST_EXPECT_MSG_EQ(records[0].estimate, records[0].sampled, "Wrong estimate");
+    NS_TEST_EXPECT_MSG_NE(records[0].type.find("EventProfilerTestCase"),
+                          std::string::npos,
+                          "Event type not named");
+    uint64_t histogram = 0;
+    for (uint64_t bucket : records[0].histogram)
+    {
+        histogram += bucket;
+    }
+    NS_TEST_EXPECT_MSG_EQ(histogram, 10, "Wrong histogram");
+    NS_TEST_EXPECT_MSG_EQ(records[1].context, 1, "Fast events not second");
+    NS_TEST_EXPECT_MSG_EQ(records[1].count, 100, "Wrong fast event count");
+
+    // One event in 16 timed, on average
+    EventProfiler sampler(16);
+    const uint32_t total = 16000;
+    for (uint32_t i = 0; i < total; ++i)
+    {
+        EventImpl* event = MakeEvent(&EventProfilerTestCase::Fast, this);
+        sampler.Invoke(event, i % 2);
+        event->Unref();
+    }
+    records = sampler.GetRecords();
+    NS_TEST_ASSERT_MSG_EQ(records.size(), 2, "Wrong number of records");
+    for (const auto& record : records)
+    {
+        // Both contexts are sampled, even though they alternate
+        NS_TEST_EXPECT_MSG_EQ(record.count, total / 2, "Wrong event count");
+        NS_TEST_EXPECT_MSG_GT(record.samples, total / 2 / 16 * 8 / 10, "Too few samples");
+        NS_TEST_EXPECT_MSG_LT(record.samples, total / 2 / 16 * 12 / 10, "Too many samples");
+    }
+
+    // Through the simulator
+    std::string file = CreateTempDirFilename("profile.json");
+    Config::SetDefault("ns3::DefaultSimulatorImpl::ProfilingPeriod", UintegerValue(1));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::ProfilingFile", StringValue(file));
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        Simulator::ScheduleWithContext(3, MicroSeconds(i), &EventProfilerTestCase::Slow, this);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::ifstream is(file);
+    NS_TEST_ASSERT_MSG_EQ(is.is_open(), true, "Profile not written");
+    std::ostringstream json;
+    json << is.rdbuf();
+    NS_TEST_EXPECT_MSG_NE(json.str().find("\"model_name\" : \"profile\""),
+                          std::string::npos,
+                          "Wrong model name");
+    NS_TEST_EXPECT_MSG_NE(json.str().find("\"context\" : 3, \"count\" : 10,"),
+                          std::string::npos,
+                          "Slow events not profiled");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the live counters of the SimulatorStats.
+ *
+ * Every event is sampled and updates the counters, which are read
+ * during and after the run.
+ */
+class SimulatorStatsTestCase : public TestCase
+{
+  public:
+    SimulatorStatsTestCase();
+    void DoRun() override;
+    void DoTeardown() override;
+
+  private:
+    /** An event, which reads the counters. */
+    void Event();
+    /**
+     * A gauge.
+     * \returns The number of events run.
+     */
+    uint64_t GetGauge();
+
+    std::string m_file; //!< The file of the counters.
+    uint64_t m_events;  //!< The number of events run.
+    bool m_running;     //!< Whether the counters were read while running.
+};
+
+SimulatorStatsTestCase::SimulatorStatsTestCase()
+    : TestCase("Check the live counters"),
+      m_events(0),
+      m_running(false)
+{
+}
+
+void
+SimulatorStatsTestCase::Event()
+{
+    m_events++;
+    SimulatorStats::Snapshot stats;
+    if (m_events == 10 && SimulatorStats::Read(m_file, stats))
+    {
+        m_running = stats.running && stats.events == Simulator::GetEventCount() &&
+                    stats.simTime == Simulator::Now();
+    }
+}
+
+uint64_t
+SimulatorStatsTestCase::GetGauge()
+{
+    return m_events;
+}
+
+void
+SimulatorStatsTestCase::DoTeardown()
+{
+    SimulatorStats::RemoveGauge("test");
+    Config::Reset();
+}
+
+void
+SimulatorStatsTestCase::DoRun()
+{
+    m_file = CreateTempDirFilename("stats");
+    SimulatorStats::AddGauge("test", MakeCallback(&SimulatorStatsTestCase::GetGauge, this));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::StatsFile", StringValue(m_file));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::StatsPeriod", UintegerValue(1));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::StatsInterval", TimeValue(Time(0)));
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(i), &SimulatorStatsTestCase::Event, this);
+        Simulator::Schedule(MicroSeconds(i), &Object::Initialize, rv);
+        Simulator::Schedule(MicroSeconds(i), &Object::Initialize, rv);
+    }
+    EventId cancelled = Simulator::Schedule(Seconds(1), &SimulatorStatsTestCase::Event, this);
+    Simulator::Cancel(cancelled);
+    Simulator::Stop(MicroSeconds(100));
+    Simulator::Run();
+
+    SimulatorStats::Snapshot stats;
+    NS_TEST_ASSERT_MSG_EQ(SimulatorStats::Read(m_file, stats), true, "Counters not exported");
+    NS_TEST_EXPECT_MSG_EQ(m_running, true, "Wrong counters while running");
+    NS_TEST_EXPECT_MSG_EQ(stats.running, false, "Run not finished");
+    NS_TEST_EXPECT_MSG_EQ(stats.events, 151, "Wrong event count");
+    NS_TEST_EXPECT_MSG_EQ(stats.scheduled, 1, "Wrong event queue size");
+    NS_TEST_EXPECT_MSG_EQ(stats.cancelled, 1, "Wrong cancelled event count");
+    NS_TEST_EXPECT_MSG_EQ(stats.simTime, MicroSeconds(100), "Wrong simulation time");
+    NS_TEST_EXPECT_MSG_GT(stats.rss, 0, "No resident memory");
+    std::map<std::string, uint64_t> counters(stats.counters.begin(), stats.counters.end());
+    NS_TEST_EXPECT_MSG_EQ(counters["events/Core"], 100, "Wrong event count of the module");
+    NS_TEST_EXPECT_MSG_EQ(counters["events/other"], 51, "Wrong event count without module");
+    NS_TEST_EXPECT_MSG_EQ(counters["test"], 50, "Wrong gauge");
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(SimulatorStats::Read(CreateTempDirFilename("none"), stats),
+                          false,
+                          "Counters read from a missing file");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -740,6 +1328,42 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+
+        for (TypeId tid : {MapScheduler::GetTypeId(),
+                           HeapScheduler::GetTypeId(),
+                           CalendarScheduler::GetTypeId(),
+                           PriorityQueueScheduler::GetTypeId(),
+                           LadderScheduler::GetTypeId()})
+        {
+            AddTestCase(new SchedulerOrderTestCase(ObjectFactory(tid.GetName())),
+                        TestCase::QUICK);
+        }
+        // Force the creation of many rungs
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        factory.Set("Threshold", UintegerValue(2));
+        factory.Set("MaxRungs", UintegerValue(4));
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+
+        for (TypeId tid : {ListScheduler::GetTypeId(),
+                           MapScheduler::GetTypeId(),
+                           HeapScheduler::GetTypeId(),
+                           CalendarScheduler::GetTypeId(),
+                           PriorityQueueScheduler::GetTypeId(),
+                           LadderScheduler::GetTypeId()})
+        {
+            AddTestCase(new CancelledEventsTestCase(ObjectFactory(tid.GetName()), 0.5),
+                        TestCase::QUICK);
+        }
+        AddTestCase(new CancelledEventsTestCase(factory, 0.5), TestCase::QUICK);
+        AddTestCase(new CancelledEventsTestCase(ObjectFactory("ns3::HeapScheduler"), 1),
+                    TestCase::QUICK);
+
+        AddTestCase(new EventPoolTestCase(true), TestCase::QUICK);
+        AddTestCase(new EventPoolTestCase(false), TestCase::QUICK);
+        AddTestCase(new EventProfilerTestCase(), TestCase::QUICK);
+        AddTestCase(new SimulatorStatsTestCase(), TestCase::QUICK);
     }
 };
 
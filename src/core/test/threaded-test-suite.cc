@@ -24,12 +24,15 @@
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
+#include <atomic>
 #include <chrono> // seconds, milliseconds
 #include <ctime>
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +281,124 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that no event injected from other threads is lost or
+ * reordered.
+ *
+ * The main thread is held in an event while the producers inject more
+ * events than the lock-free queue of DefaultSimulatorImpl can hold, so
+ * that both the queue and the overflow list are used.  The events of
+ * each producer must run in the order in which they were scheduled.
+ */
+class ThreadedInjectionOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param threads The number of producer threads.
+     * \param maxDrainBatch The maximum number of events moved per iteration.
+     */
+    ThreadedInjectionOrderTestCase(unsigned int threads, uint32_t maxDrainBatch);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** Hold the main thread until the producers are done. */
+    void Hold();
+    /**
+     * Record an injected event.
+     * \param producer The producer index.
+     * \param seq The sequence number of the event for this producer.
+     */
+    void Receive(unsigned int producer, uint32_t seq);
+
+    unsigned int m_threads;                   //!< The number of producer threads.
+    uint32_t m_maxDrainBatch;                 //!< The maximum drain batch.
+    std::atomic<unsigned int> m_done;         //!< The number of producers done.
+    std::vector<uint32_t> m_next;             //!< Next expected sequence number.
+    uint64_t m_received;                      //!< The number of events received.
+    bool m_ordered;                           //!< Whether the events were in order.
+    static constexpr uint32_t EVENTS = 10000; //!< Events per producer.
+};
+
+ThreadedInjectionOrderTestCase::ThreadedInjectionOrderTestCase(unsigned int threads,
+                                                               uint32_t maxDrainBatch)
+    : TestCase("Check the order of the events injected by " + std::to_string(threads) +
+               " threads, with at most " + std::to_string(maxDrainBatch) +
+               " events moved per iteration"),
+      m_threads(threads),
+      m_maxDrainBatch(maxDrainBatch),
+      m_done(0),
+      m_received(0),
+      m_ordered(true)
+{
+}
+
+void
+ThreadedInjectionOrderTestCase::Hold()
+{
+    while (m_done.load() < m_threads)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void
+ThreadedInjectionOrderTestCase::Receive(unsigned int producer, uint32_t seq)
+{
+    m_ordered = m_ordered && seq == m_next[producer];
+    m_next[producer] = seq + 1;
+    m_received++;
+}
+
+void
+ThreadedInjectionOrderTestCase::DoTeardown()
+{
+    Config::Reset();
+}
+
+void
+ThreadedInjectionOrderTestCase::DoRun()
+{
+    Config::SetDefault("ns3::DefaultSimulatorImpl::MinDrainBatch", UintegerValue(1));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::MaxDrainBatch", UintegerValue(m_maxDrainBatch));
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+
+    m_next.assign(m_threads, 0);
+    Simulator::Schedule(Seconds(0), &ThreadedInjectionOrderTestCase::Hold, this);
+
+    std::list<std::thread> threads;
+    for (unsigned int p = 0; p < m_threads; ++p)
+    {
+        threads.emplace_back([this, p]() {
+            for (uint32_t i = 0; i < EVENTS; ++i)
+            {
+                Simulator::ScheduleWithContext(p,
+                                               Seconds(0),
+                                               &ThreadedInjectionOrderTestCase::Receive,
+                                               this,
+                                               p,
+                                               i);
+            }
+            m_done++;
+        });
+    }
+
+    Simulator::Run();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, uint64_t(EVENTS) * m_threads, "Events lost");
+    NS_TEST_EXPECT_MSG_EQ(m_ordered, true, "Events of a thread out of order");
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -315,6 +436,10 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+
+        AddTestCase(new ThreadedInjectionOrderTestCase(1, 1024), TestCase::QUICK);
+        AddTestCase(new ThreadedInjectionOrderTestCase(4, 1024), TestCase::QUICK);
+        AddTestCase(new ThreadedInjectionOrderTestCase(4, 2), TestCase::QUICK);
     }
 };
 
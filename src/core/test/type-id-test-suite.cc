@@ -347,6 +347,93 @@ DeprecatedAttributeTestCase::DoRun()
               << (tinfo.supportLevel == TypeId::DEPRECATED ? "deprecated" : "error") << std::endl;
 }
 
+/**
+ * \ingroup typeid-tests
+ *
+ * Check the lookups of the Attributes and TraceSources by name of all
+ * the registered TypeIds against a scan of the TypeIds and their parents.
+ */
+class LookupByNameTestCase : public TestCase
+{
+  public:
+    LookupByNameTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+LookupByNameTestCase::LookupByNameTestCase()
+    : TestCase("Check the lookups of Attributes and TraceSources by name")
+{
+}
+
+void
+LookupByNameTestCase::DoRun()
+{
+    for (uint16_t i = 0; i < TypeId::GetRegisteredN(); ++i)
+    {
+        TypeId tid = TypeId::GetRegistered(i);
+        TypeId cur = tid;
+        while (true)
+        {
+            for (std::size_t j = 0; j < cur.GetAttributeN(); ++j)
+            {
+                struct TypeId::AttributeInformation expected = cur.GetAttribute(j);
+                if (expected.supportLevel != TypeId::SUPPORTED)
+                {
+                    continue;
+                }
+                struct TypeId::AttributeInformation info;
+                NS_TEST_ASSERT_MSG_EQ(tid.LookupAttributeByName(expected.name, &info),
+                                      true,
+                                      "Attribute " << expected.name << " of " << cur.GetName()
+                                                   << " not found in " << tid.GetName());
+                NS_TEST_ASSERT_MSG_EQ(info.checker,
+                                      expected.checker,
+                                      "Wrong attribute " << expected.name << " in "
+                                                         << tid.GetName());
+            }
+            for (std::size_t j = 0; j < cur.GetTraceSourceN(); ++j)
+            {
+                struct TypeId::TraceSourceInformation expected = cur.GetTraceSource(j);
+                if (expected.supportLevel != TypeId::SUPPORTED)
+                {
+                    continue;
+                }
+                NS_TEST_ASSERT_MSG_EQ(tid.LookupTraceSourceByName(expected.name),
+                                      expected.accessor,
+                                      "Wrong trace source " << expected.name << " in "
+                                                            << tid.GetName());
+            }
+            // The types of the collision test have no parent
+            TypeId parent = cur.GetParent();
+            if (parent == cur || parent.GetUid() == 0)
+            {
+                break;
+            }
+            cur = parent;
+        }
+
+        struct TypeId::AttributeInformation info;
+        NS_TEST_ASSERT_MSG_EQ(tid.LookupAttributeByName("NoSuchAttribute", &info),
+                              false,
+                              "Missing attribute found in " << tid.GetName());
+        NS_TEST_ASSERT_MSG_EQ(tid.LookupTraceSourceByName("NoSuchTrace"),
+                              nullptr,
+                              "Missing trace source found in " << tid.GetName());
+    }
+
+    // A child finds the attributes of its parent, but not the reverse
+    struct TypeId::AttributeInformation info;
+    NS_TEST_ASSERT_MSG_EQ(DeprecatedAttribute::GetTypeId().LookupAttributeByName("attribute",
+                                                                                  &info),
+                          true,
+                          "Attribute of the type not found");
+    NS_TEST_ASSERT_MSG_EQ(Object::GetTypeId().LookupAttributeByName("attribute", &info),
+                          false,
+                          "Attribute of a child found in its parent");
+}
+
 /**
  * \ingroup typeid-tests
  *
@@ -461,6 +548,7 @@ TypeIdTestSuite::TypeIdTestSuite()
     AddTestCase(new UniqueTypeIdTestCase, QUICK);
     AddTestCase(new CollisionTestCase, QUICK);
     AddTestCase(new DeprecatedAttributeTestCase, QUICK);
+    AddTestCase(new LookupByNameTestCase, QUICK);
 }
 
 /// Static variable for test initialization.
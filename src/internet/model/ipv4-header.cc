@@ -22,6 +22,7 @@
 #include "ns3/abort.h"
 #include "ns3/assert.h"
 #include "ns3/header.h"
+#include "ns3/internet-checksum.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -42,6 +43,7 @@ Ipv4Header::Ipv4Header()
       m_fragmentOffset(0),
       m_checksum(0),
       m_goodChecksum(true),
+      m_checksumValid(false),
       m_headerSize(5 * 4)
 {
 }
@@ -58,6 +60,7 @@ Ipv4Header::SetPayloadSize(uint16_t size)
 {
     NS_LOG_FUNCTION(this << size);
     m_payloadSize = size;
+    m_checksumValid = false;
 }
 
 uint16_t
@@ -79,6 +82,7 @@ Ipv4Header::SetIdentification(uint16_t identification)
 {
     NS_LOG_FUNCTION(this << identification);
     m_identification = identification;
+    m_checksumValid = false;
 }
 
 void
@@ -86,6 +90,7 @@ Ipv4Header::SetTos(uint8_t tos)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(tos));
     m_tos = tos;
+    m_checksumValid = false;
 }
 
 void
@@ -94,6 +99,7 @@ Ipv4Header::SetDscp(DscpType dscp)
     NS_LOG_FUNCTION(this << dscp);
     m_tos &= 0x3; // Clear out the DSCP part, retain 2 bits of ECN
     m_tos |= (dscp << 2);
+    m_checksumValid = false;
 }
 
 void
@@ -102,6 +108,7 @@ Ipv4Header::SetEcn(EcnType ecn)
     NS_LOG_FUNCTION(this << ecn);
     m_tos &= 0xFC; // Clear out the ECN part, retain 6 bits of DSCP
     m_tos |= ecn;
+    m_checksumValid = false;
 }
 
 Ipv4Header::DscpType
@@ -204,6 +211,7 @@ Ipv4Header::SetMoreFragments()
 {
     NS_LOG_FUNCTION(this);
     m_flags |= MORE_FRAGMENTS;
+    m_checksumValid = false;
 }
 
 void
@@ -211,6 +219,7 @@ Ipv4Header::SetLastFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags &= ~MORE_FRAGMENTS;
+    m_checksumValid = false;
 }
 
 bool
@@ -225,6 +234,7 @@ Ipv4Header::SetDontFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags |= DONT_FRAGMENT;
+    m_checksumValid = false;
 }
 
 void
@@ -232,6 +242,7 @@ Ipv4Header::SetMayFragment()
 {
     NS_LOG_FUNCTION(this);
     m_flags &= ~DONT_FRAGMENT;
+    m_checksumValid = false;
 }
 
 bool
@@ -248,6 +259,7 @@ Ipv4Header::SetFragmentOffset(uint16_t offsetBytes)
     // check if the user is trying to set an invalid offset
     NS_ABORT_MSG_IF((offsetBytes & 0x7), "offsetBytes must be multiple of 8 bytes");
     m_fragmentOffset = offsetBytes;
+    m_checksumValid = false;
 }
 
 uint16_t
@@ -267,6 +279,12 @@ void
 Ipv4Header::SetTtl(uint8_t ttl)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(ttl));
+    if (m_checksumValid)
+    {
+        // The TTL and the protocol are a 16-bit word of the header
+        m_checksum =
+            ChecksumUpdateU16(m_checksum, m_ttl | (m_protocol << 8), ttl | (m_protocol << 8));
+    }
     m_ttl = ttl;
 }
 
@@ -289,6 +307,7 @@ Ipv4Header::SetProtocol(uint8_t protocol)
 {
     NS_LOG_FUNCTION(this << static_cast<uint32_t>(protocol));
     m_protocol = protocol;
+    m_checksumValid = false;
 }
 
 void
@@ -296,6 +315,7 @@ Ipv4Header::SetSource(Ipv4Address source)
 {
     NS_LOG_FUNCTION(this << source);
     m_source = source;
+    m_checksumValid = false;
 }
 
 Ipv4Address
@@ -310,6 +330,7 @@ Ipv4Header::SetDestination(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
     m_destination = dst;
+    m_checksumValid = false;
 }
 
 Ipv4Address
@@ -414,11 +435,18 @@ Ipv4Header::Serialize(Buffer::Iterator start) const
     i.WriteU8(frag);
     i.WriteU8(m_ttl);
     i.WriteU8(m_protocol);
-    i.WriteHtonU16(0);
+    if (m_calcChecksum && m_checksumValid)
+    {
+        i.WriteU16(m_checksum);
+    }
+    else
+    {
+        i.WriteHtonU16(0);
+    }
     i.WriteHtonU32(m_source.Get());
     i.WriteHtonU32(m_destination.Get());
 
-    if (m_calcChecksum)
+    if (m_calcChecksum && !m_checksumValid)
     {
         i = start;
         uint16_t checksum = i.CalculateIpChecksum(20);
@@ -480,6 +508,9 @@ Ipv4Header::Deserialize(Buffer::Iterator start)
 
         m_goodChecksum = (checksum == 0);
     }
+    // The checksum is updated with the TTL, unless the options or the
+    // reserved flag are not serialized again
+    m_checksumValid = m_calcChecksum && m_goodChecksum && headerSize == 5 * 4 && !(flags & 0x80);
     return GetSerializedSize();
 }
 
@@ -262,6 +262,7 @@ class Ipv4Header : public Header
     Ipv4Address m_destination; //!< destination address
     uint16_t m_checksum;       //!< checksum
     bool m_goodChecksum;       //!< true if checksum is correct
+    bool m_checksumValid;      //!< true if checksum is that of the fields, as serialized
     uint16_t m_headerSize;     //!< IP header size
 };
 
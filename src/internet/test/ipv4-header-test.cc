@@ -47,6 +47,7 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <vector>
 #include <sys/types.h>
 
 using namespace ns3;
@@ -290,6 +291,84 @@ Ipv4HeaderTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 Header checksum update Test
+ *
+ * Check that the checksum of a received header, updated as its TTL is
+ * decremented, is the one computed over the whole header.
+ */
+class Ipv4HeaderChecksumUpdateTest : public TestCase
+{
+    /**
+     * \brief Serialize a header.
+     * \param header The header.
+     * \returns The bytes of the header.
+     */
+    std::vector<uint8_t> Serialize(const Ipv4Header& header);
+
+  public:
+    void DoRun() override;
+    Ipv4HeaderChecksumUpdateTest();
+};
+
+Ipv4HeaderChecksumUpdateTest::Ipv4HeaderChecksumUpdateTest()
+    : TestCase("IPv4 Header checksum update")
+{
+}
+
+std::vector<uint8_t>
+Ipv4HeaderChecksumUpdateTest::Serialize(const Ipv4Header& header)
+{
+    Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+    header.Serialize(buffer.Begin());
+    std::vector<uint8_t> bytes(buffer.GetSize());
+    buffer.CopyData(bytes.data(), bytes.size());
+    return bytes;
+}
+
+void
+Ipv4HeaderChecksumUpdateTest::DoRun()
+{
+    Ipv4Header sent;
+    sent.EnableChecksum();
+    sent.SetSource(Ipv4Address("10.1.2.3"));
+    sent.SetDestination(Ipv4Address("192.168.200.1"));
+    sent.SetProtocol(17);
+    sent.SetPayloadSize(1000);
+    sent.SetIdentification(0xbeef);
+    sent.SetTos(0xb8);
+    sent.SetDontFragment();
+
+    for (uint32_t ttl = 255; ttl > 1; ttl--)
+    {
+        sent.SetTtl(ttl);
+        Buffer buffer;
+        buffer.AddAtStart(sent.GetSerializedSize());
+        sent.Serialize(buffer.Begin());
+
+        Ipv4Header received;
+        received.EnableChecksum();
+        received.Deserialize(buffer.Begin());
+        NS_TEST_ASSERT_MSG_EQ(received.IsChecksumOk(), true, "Bad checksum at TTL " << ttl);
+        received.SetTtl(ttl - 1);
+        sent.SetTtl(ttl - 1);
+        NS_TEST_ASSERT_MSG_EQ((Serialize(received) == Serialize(sent)),
+                              true,
+                              "Bad updated checksum at TTL " << ttl);
+
+        // The checksum of a header changed otherwise is computed again
+        received.SetTos(0);
+        sent.SetTos(0);
+        NS_TEST_ASSERT_MSG_EQ((Serialize(received) == Serialize(sent)),
+                              true,
+                              "Bad checksum of a changed header at TTL " << ttl);
+        sent.SetTos(0xb8);
+    }
+}
+
 /**
  * \ingroup internet-test
  *
@@ -302,6 +381,7 @@ class Ipv4HeaderTestSuite : public TestSuite
         : TestSuite("ipv4-header", UNIT)
     {
         AddTestCase(new Ipv4HeaderTest, TestCase::QUICK);
+        AddTestCase(new Ipv4HeaderChecksumUpdateTest, TestCase::QUICK);
     }
 };
 
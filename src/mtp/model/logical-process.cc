@@ -0,0 +1,280 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::LogicalProcess.
+ */
+
+#include "logical-process.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator-impl.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions
+NS_LOG_COMPONENT_DEFINE("LogicalProcess");
+
+/** Timestamp used when there is no event, see SimulatorImpl::GetMaximumSimulationTime(). */
+static constexpr uint64_t MAXIMUM_TS = 0x7fffffffffffffffLL;
+
+LogicalProcess::LogicalProcess(SimulatorImpl* impl,
+                               uint32_t id,
+                               uint32_t count,
+                               uint32_t uid,
+                               uint64_t ts)
+    : m_impl(impl),
+      m_id(id),
+      m_events(nullptr),
+      m_parity(0),
+      m_minSentTs(MAXIMUM_TS),
+      m_uid(uid),
+      m_currentUid(EventId::UID::INVALID),
+      m_currentTs(ts),
+      m_currentContext(Simulator::NO_CONTEXT),
+      m_eventCount(0),
+      m_unscheduledEvents(0)
+{
+    NS_LOG_FUNCTION(this << impl << id << count << uid << ts);
+    m_outbox[0].resize(count);
+    m_outbox[1].resize(count);
+}
+
+LogicalProcess::~LogicalProcess()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    m_events = nullptr;
+}
+
+void
+LogicalProcess::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+
+    if (m_events)
+    {
+        while (!m_events->IsEmpty())
+        {
+            Scheduler::Event next = m_events->RemoveNext();
+            scheduler->Insert(next);
+        }
+    }
+    m_events = scheduler;
+}
+
+EventId
+LogicalProcess::Schedule(uint64_t ts, uint32_t context, EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+    return EventId(event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+LogicalProcess::Insert(const Scheduler::Event& ev)
+{
+    m_uid = std::max(m_uid, ev.key.m_uid + 1);
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
+void
+LogicalProcess::Remove(const Scheduler::Event& ev)
+{
+    m_events->Remove(ev);
+    m_unscheduledEvents--;
+}
+
+Scheduler::Event
+LogicalProcess::RemoveNext()
+{
+    m_unscheduledEvents--;
+    return m_events->RemoveNext();
+}
+
+void
+LogicalProcess::Send(uint32_t dst, uint64_t ts, uint32_t context, EventImpl* event)
+{
+    NS_ASSERT(dst != m_id && dst < m_outbox[m_parity].size());
+    m_outbox[m_parity][dst].push_back({ts, context, event});
+    m_minSentTs = std::min(m_minSentTs, ts);
+}
+
+void
+LogicalProcess::ReceiveMessages(const std::vector<LogicalProcess*>& lps, uint32_t parity)
+{
+    // The senders are done with the outboxes of the previous window;
+    // they are drained in the order of the sender ids, so that the uids
+    // (and thus the order of simultaneous events) do not depend on the
+    // thread scheduling.
+    uint32_t previous = parity ^ 1;
+    for (LogicalProcess* src : lps)
+    {
+        if (src == this)
+        {
+            continue;
+        }
+        Outbox& outbox = src->m_outbox[previous][m_id];
+        for (const Message& message : outbox)
+        {
+            Schedule(message.ts, message.context, message.event);
+        }
+        outbox.clear();
+    }
+    m_parity = parity;
+    m_minSentTs = MAXIMUM_TS;
+}
+
+void
+LogicalProcess::ProcessEvents(uint64_t grantedTs)
+{
+    while (!m_events->IsEmpty() && m_events->PeekNext().key.m_ts < grantedTs)
+    {
+        ProcessOneEvent();
+    }
+}
+
+void
+LogicalProcess::ProcessOneEvent()
+{
+    Scheduler::Event next = m_events->RemoveNext();
+
+    m_impl->PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= m_currentTs);
+    m_unscheduledEvents--;
+    m_eventCount++;
+
+    m_currentTs = next.key.m_ts;
+    m_currentContext = next.key.m_context;
+    m_currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+uint64_t
+LogicalProcess::NextTs() const
+{
+    if (m_events->IsEmpty())
+    {
+        return MAXIMUM_TS;
+    }
+    return m_events->PeekNext().key.m_ts;
+}
+
+uint64_t
+LogicalProcess::GetMinSentTs() const
+{
+    return m_minSentTs;
+}
+
+bool
+LogicalProcess::IsEmpty() const
+{
+    return m_events->IsEmpty();
+}
+
+uint32_t
+LogicalProcess::GetId() const
+{
+    return m_id;
+}
+
+uint64_t
+LogicalProcess::GetCurrentTs() const
+{
+    return m_currentTs;
+}
+
+void
+LogicalProcess::SetCurrentTs(uint64_t ts)
+{
+    m_currentTs = ts;
+}
+
+uint32_t
+LogicalProcess::GetCurrentUid() const
+{
+    return m_currentUid;
+}
+
+uint32_t
+LogicalProcess::GetContext() const
+{
+    return m_currentContext;
+}
+
+uint32_t
+LogicalProcess::GetUid() const
+{
+    return m_uid;
+}
+
+uint64_t
+LogicalProcess::GetEventCount() const
+{
+    return m_eventCount;
+}
+
+int
+LogicalProcess::GetUnscheduledEvents() const
+{
+    return m_unscheduledEvents;
+}
+
+void
+LogicalProcess::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& outboxes : m_outbox)
+    {
+        for (auto& outbox : outboxes)
+        {
+            for (const Message& message : outbox)
+            {
+                message.event->Unref();
+            }
+            outbox.clear();
+        }
+    }
+    if (m_events)
+    {
+        while (!m_events->IsEmpty())
+        {
+            Scheduler::Event next = m_events->RemoveNext();
+            next.impl->Unref();
+        }
+    }
+    m_unscheduledEvents = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,229 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::LogicalProcess.
+ */
+
+#ifndef NS3_LOGICAL_PROCESS_H
+#define NS3_LOGICAL_PROCESS_H
+
+#include "ns3/event-id.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class SimulatorImpl;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief A partition of the simulated nodes, with its own event list.
+ *
+ * Each LogicalProcess owns the events of the nodes (contexts) assigned
+ * to it and is executed by a single thread of the
+ * MultithreadedSimulatorImpl.  Events scheduled towards a node owned by
+ * another LogicalProcess are not inserted directly in the remote event
+ * list: they are stored in an outbox owned by the sender, and collected
+ * by the receiver at the start of the next time window.
+ *
+ * The outboxes are double-buffered: during a window the sender writes
+ * in the buffer selected by the parity of the window, while the
+ * receivers drain the buffer written during the previous window.
+ * No lock is thus needed to exchange events between threads.
+ */
+class LogicalProcess
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] impl The simulator implementation which owns this process.
+     * \param [in] id The index of this process; process 0 holds the
+     *             events which are not bound to a partitioned context.
+     * \param [in] count The total number of logical processes.
+     * \param [in] uid The first event uid to allocate.
+     * \param [in] ts The initial timestamp.
+     */
+    LogicalProcess(SimulatorImpl* impl, uint32_t id, uint32_t count, uint32_t uid, uint64_t ts);
+    /** Destructor. */
+    ~LogicalProcess();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    LogicalProcess(const LogicalProcess&) = delete;
+    LogicalProcess& operator=(const LogicalProcess&) = delete;
+
+    /**
+     * Set the scheduler used to hold the events of this process.
+     *
+     * \param [in] schedulerFactory The scheduler factory.
+     */
+    void SetScheduler(ObjectFactory schedulerFactory);
+
+    /**
+     * Insert a new event in the local event list.
+     *
+     * \param [in] ts The absolute timestamp of the event.
+     * \param [in] context The execution context of the event.
+     * \param [in] event The event implementation.
+     * \return The id of the new event.
+     */
+    EventId Schedule(uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Insert an event which already has a key, e.g. when events are
+     * moved between processes.
+     *
+     * \param [in] ev The event to insert.
+     */
+    void Insert(const Scheduler::Event& ev);
+    /**
+     * Remove an event from the local event list.
+     *
+     * \param [in] ev The event to remove.
+     */
+    void Remove(const Scheduler::Event& ev);
+    /**
+     * Remove the next event from the local event list, without invoking it.
+     *
+     * \return The removed event.
+     */
+    Scheduler::Event RemoveNext();
+
+    /**
+     * Post an event in the outbox towards another logical process.
+     *
+     * \param [in] dst The index of the destination process.
+     * \param [in] ts The absolute timestamp of the event.
+     * \param [in] context The execution context of the event.
+     * \param [in] event The event implementation.
+     */
+    void Send(uint32_t dst, uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Collect the events posted towards this process during the previous
+     * window, and start a new window for the events sent by this process.
+     *
+     * \param [in] lps All the logical processes, indexed by id.
+     * \param [in] parity The parity of the new window.
+     */
+    void ReceiveMessages(const std::vector<LogicalProcess*>& lps, uint32_t parity);
+
+    /**
+     * Process all the events with a timestamp strictly smaller than
+     * the granted time.
+     *
+     * \param [in] grantedTs The end of the current window.
+     */
+    void ProcessEvents(uint64_t grantedTs);
+    /** Process the next event. */
+    void ProcessOneEvent();
+
+    /**
+     * Get the timestamp of the next local event, or the maximum time
+     * if there is none.
+     *
+     * \return The timestamp of the next event.
+     */
+    uint64_t NextTs() const;
+    /**
+     * Get the smallest timestamp of the events sent by this process
+     * which have not yet been collected by their receiver.
+     *
+     * \return The smallest timestamp of the in-flight events.
+     */
+    uint64_t GetMinSentTs() const;
+    /** \return \c true if the local event list is empty. */
+    bool IsEmpty() const;
+
+    /** \return The index of this process. */
+    uint32_t GetId() const;
+    /** \return The timestamp of the current event. */
+    uint64_t GetCurrentTs() const;
+    /**
+     * Set the current timestamp.
+     *
+     * \param [in] ts The new timestamp.
+     */
+    void SetCurrentTs(uint64_t ts);
+    /** \return The uid of the current event. */
+    uint32_t GetCurrentUid() const;
+    /** \return The execution context of the current event. */
+    uint32_t GetContext() const;
+    /** \return The next uid this process would allocate. */
+    uint32_t GetUid() const;
+    /** \return The number of events processed by this process. */
+    uint64_t GetEventCount() const;
+    /** \return The number of events inserted but not yet processed. */
+    int GetUnscheduledEvents() const;
+
+    /** Release all the pending events, including the undelivered ones. */
+    void Clear();
+
+  private:
+    /** An event sent to another logical process. */
+    struct Message
+    {
+        /** Event timestamp. */
+        uint64_t ts;
+        /** The event context. */
+        uint32_t context;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+
+    /** Container type for the events sent to one logical process. */
+    typedef std::vector<Message> Outbox;
+
+    /** The simulator implementation which owns this process. */
+    SimulatorImpl* m_impl;
+    /** The index of this process. */
+    uint32_t m_id;
+    /** The event priority queue. */
+    Ptr<Scheduler> m_events;
+    /** The outboxes, indexed by window parity and destination. */
+    std::vector<Outbox> m_outbox[2];
+    /** The parity of the current window. */
+    uint32_t m_parity;
+    /** Smallest timestamp of the events in the outboxes of the current window. */
+    uint64_t m_minSentTs;
+
+    /** Next event unique id. */
+    uint32_t m_uid;
+    /** Unique id of the current event. */
+    uint32_t m_currentUid;
+    /** Timestamp of the current event. */
+    uint64_t m_currentTs;
+    /** Execution context of the current event. */
+    uint32_t m_currentContext;
+    /** The event count. */
+    uint64_t m_eventCount;
+    /**
+     * Number of events that have been inserted but not yet scheduled,
+     * not counting the events in transit; this is used for validation.
+     */
+    int m_unscheduledEvents;
+};
+
+} // namespace ns3
+
+#endif /* NS3_LOGICAL_PROCESS_H */
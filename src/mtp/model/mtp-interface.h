@@ -0,0 +1,58 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MtpInterface.
+ */
+
+#ifndef NS3_MTP_INTERFACE_H
+#define NS3_MTP_INTERFACE_H
+
+#include <cstdint>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Helper to enable the multithreaded simulator implementation.
+ *
+ * Enable() must be called before the simulator implementation is
+ * created, i.e., before anything is scheduled, typically at the
+ * beginning of main():
+ *
+ * \code
+ *   MtpInterface::Enable(4);
+ * \endcode
+ */
+class MtpInterface
+{
+  public:
+    /**
+     * Select MultithreadedSimulatorImpl as the simulator implementation.
+     *
+     * \param [in] threads The maximum number of threads; 0 selects the
+     *             number of hardware threads.
+     */
+    static void Enable(uint32_t threads = 0);
+};
+
+} // namespace ns3
+
+#endif /* NS3_MTP_INTERFACE_H */
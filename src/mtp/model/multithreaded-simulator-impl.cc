@@ -0,0 +1,758 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "logical-process.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+/**
+ * The LP executed by the calling thread, or \c nullptr if the
+ * thread is not executing a partition.
+ */
+static thread_local LogicalProcess* g_currentLp = nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of partitions, each executed by its own "
+                          "thread; 0 selects the number of hardware threads.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MinLookAhead",
+                          "The point-to-point channels with a smaller delay do not "
+                          "separate partitions, which avoids tiny time windows.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&MultithreadedSimulatorImpl::m_minLookAhead),
+                          MakeTimeChecker());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = false;
+    m_running = false;
+    m_window = 0;
+    m_windowDone = 0;
+    m_grantedTs = 0;
+    m_maxThreads = 0;
+    m_boundLookAhead = Time::Max();
+    m_lookAhead = Time::Max();
+    m_eventCount = 0;
+    m_lps.push_back(new LogicalProcess(this, 0, 1, EventId::UID::VALID, 0));
+    m_mainThreadId = std::this_thread::get_id();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+    for (LogicalProcess* lp : m_lps)
+    {
+        delete lp;
+    }
+    m_lps.clear();
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    ProcessEventsWithContext();
+
+    for (LogicalProcess* lp : m_lps)
+    {
+        lp->Clear();
+    }
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetChannelDelay(Ptr<Channel> channel)
+{
+    NS_LOG_FUNCTION(channel);
+
+    // Only the channels which connect devices in point-to-point mode are
+    // known to keep no medium state shared by the attached devices.
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> device = channel->GetDevice(i);
+        if (!device || !device->IsPointToPoint())
+        {
+            return Seconds(0);
+        }
+    }
+
+    TypeId::AttributeInformation info;
+    if (!channel->GetInstanceTypeId().LookupAttributeByName("Delay", &info) ||
+        info.checker->GetValueTypeName() != "ns3::TimeValue")
+    {
+        return Seconds(0);
+    }
+    TimeValue delay;
+    channel->GetAttribute("Delay", delay);
+    return delay.Get();
+}
+
+void
+MultithreadedSimulatorImpl::Partition()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t nNodes = NodeList::GetNNodes();
+
+    // Union-find over the nodes: the nodes which cannot be separated
+    // end up in the same set.
+    std::vector<uint32_t> parent(nNodes);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](uint32_t n) {
+        while (parent[n] != n)
+        {
+            parent[n] = parent[parent[n]];
+            n = parent[n];
+        }
+        return n;
+    };
+
+    /** A channel which can separate two partitions. */
+    struct Link
+    {
+        Time delay;                  //!< The channel delay.
+        std::vector<uint32_t> nodes; //!< The attached nodes.
+    };
+
+    std::vector<Link> links;
+    for (ChannelList::Iterator i = ChannelList::Begin(); i != ChannelList::End(); ++i)
+    {
+        Ptr<Channel> channel = *i;
+        std::vector<uint32_t> nodes;
+        for (std::size_t j = 0; j < channel->GetNDevices(); ++j)
+        {
+            Ptr<NetDevice> device = channel->GetDevice(j);
+            if (device && device->GetNode())
+            {
+                nodes.push_back(device->GetNode()->GetId());
+            }
+        }
+        if (nodes.size() < 2)
+        {
+            continue;
+        }
+
+        Time delay = GetChannelDelay(channel);
+        if (delay.IsStrictlyPositive() && delay >= m_minLookAhead)
+        {
+            links.push_back({delay, nodes});
+        }
+        else
+        {
+            NS_LOG_LOGIC("channel " << channel->GetId() << " keeps its nodes together");
+            for (uint32_t node : nodes)
+            {
+                parent[find(node)] = find(nodes.front());
+            }
+        }
+    }
+
+    // Balance the sets over the partitions, biggest sets first.
+    std::vector<uint32_t> setSize(nNodes, 0);
+    for (uint32_t n = 0; n < nNodes; ++n)
+    {
+        setSize[find(n)]++;
+    }
+    std::vector<uint32_t> roots;
+    for (uint32_t n = 0; n < nNodes; ++n)
+    {
+        if (setSize[n] > 0)
+        {
+            roots.push_back(n);
+        }
+    }
+    std::stable_sort(roots.begin(), roots.end(), [&setSize](uint32_t a, uint32_t b) {
+        return setSize[a] > setSize[b];
+    });
+
+    uint32_t maxThreads = m_maxThreads;
+    if (maxThreads == 0)
+    {
+        maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    uint32_t nPartitions = std::max<std::size_t>(1, std::min<std::size_t>(maxThreads, roots.size()));
+
+    std::vector<uint32_t> load(nPartitions, 0);
+    std::vector<uint32_t> partitionOfRoot(nNodes, 0);
+    for (uint32_t root : roots)
+    {
+        uint32_t lightest = std::min_element(load.begin(), load.end()) - load.begin();
+        partitionOfRoot[root] = lightest;
+        load[lightest] += setSize[root];
+    }
+
+    // LP 0 is the global LP, the partitions start at 1.
+    m_lpOfContext.assign(nNodes, 0);
+    for (uint32_t n = 0; n < nNodes; ++n)
+    {
+        m_lpOfContext[n] = partitionOfRoot[find(n)] + 1;
+    }
+
+    m_lookAhead = m_boundLookAhead;
+    if (nPartitions == 1)
+    {
+        m_lookAhead = Time::Max();
+    }
+    for (const Link& link : links)
+    {
+        uint32_t lp = m_lpOfContext[link.nodes.front()];
+        for (uint32_t node : link.nodes)
+        {
+            if (m_lpOfContext[node] != lp)
+            {
+                m_lookAhead = Min(m_lookAhead, link.delay);
+                break;
+            }
+        }
+    }
+    NS_LOG_INFO(nNodes << " nodes in " << nPartitions << " partitions, lookahead " << m_lookAhead);
+
+    // Move the pending events to the new LPs.
+    std::vector<LogicalProcess*> lps;
+    lps.swap(m_lps);
+    uint32_t uid = 0;
+    for (LogicalProcess* lp : lps)
+    {
+        uid = std::max(uid, lp->GetUid());
+        m_eventCount += lp->GetEventCount();
+    }
+    uint64_t ts = lps.front()->GetCurrentTs();
+    for (uint32_t i = 0; i <= nPartitions; ++i)
+    {
+        m_lps.push_back(new LogicalProcess(this, i, nPartitions + 1, uid, ts));
+        m_lps.back()->SetScheduler(m_schedulerFactory);
+    }
+    for (LogicalProcess* lp : lps)
+    {
+        while (!lp->IsEmpty())
+        {
+            Scheduler::Event ev = lp->RemoveNext();
+            GetLp(ev.key.m_context)->Insert(ev);
+        }
+        delete lp;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::BoundLookAhead(const Time lookAhead)
+{
+    if (lookAhead > Time(0))
+    {
+        NS_LOG_FUNCTION(this << lookAhead);
+        m_boundLookAhead = Min(m_boundLookAhead, lookAhead);
+    }
+    else
+    {
+        NS_LOG_WARN("attempted to set lookahead to a negative time: " << lookAhead);
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead() const
+{
+    return m_lookAhead;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount() const
+{
+    return m_lps.size() - 1;
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    m_schedulerFactory = schedulerFactory;
+    for (LogicalProcess* lp : m_lps)
+    {
+        lp->SetScheduler(schedulerFactory);
+    }
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetCurrentLp() const
+{
+    return g_currentLp != nullptr ? g_currentLp : m_lps.front();
+}
+
+LogicalProcess*
+MultithreadedSimulatorImpl::GetLp(uint32_t context) const
+{
+    if (context < m_lpOfContext.size())
+    {
+        return m_lps[m_lpOfContext[context]];
+    }
+    return m_lps.front();
+}
+
+void
+MultithreadedSimulatorImpl::ProcessEventsWithContext()
+{
+    EventsWithContext eventsWithContext;
+    EventsWithContext globalEvents;
+    {
+        std::unique_lock lock{m_eventsWithContextMutex};
+        m_eventsWithContext.swap(eventsWithContext);
+        m_globalEvents.swap(globalEvents);
+    }
+
+    // All the partitions are done with the events before the end of the
+    // last window, so this is the earliest time at which a foreign event
+    // can safely be inserted.
+    uint64_t now = std::max(m_lps.front()->GetCurrentTs(), m_grantedTs);
+    for (const EventWithContext& event : eventsWithContext)
+    {
+        GetLp(event.context)->Schedule(now + event.timestamp, event.context, event.event);
+    }
+    for (const EventWithContext& event : globalEvents)
+    {
+        m_lps.front()->Schedule(event.timestamp, event.context, event.event);
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    for (LogicalProcess* lp : m_lps)
+    {
+        if (!lp->IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::WorkerLoop(LogicalProcess* lp, uint64_t window)
+{
+    g_currentLp = lp;
+    while (true)
+    {
+        uint64_t next;
+        while ((next = m_window.load(std::memory_order_acquire)) == window)
+        {
+            std::this_thread::yield();
+        }
+        window = next;
+        if (!m_running.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        lp->ReceiveMessages(m_lps, window & 1);
+        lp->ProcessEvents(m_grantedTs);
+        m_windowDone.fetch_add(1, std::memory_order_release);
+    }
+    g_currentLp = nullptr;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow(uint64_t grantedTs)
+{
+    m_grantedTs = grantedTs;
+    uint64_t window = m_window.load(std::memory_order_relaxed) + 1;
+    m_window.store(window, std::memory_order_release);
+
+    // The main thread executes the first partition.
+    LogicalProcess* lp = m_lps[1];
+    g_currentLp = lp;
+    lp->ReceiveMessages(m_lps, window & 1);
+    lp->ProcessEvents(grantedTs);
+    g_currentLp = nullptr;
+
+    uint32_t workers = m_lps.size() - 2;
+    while (m_windowDone.load(std::memory_order_acquire) < workers)
+    {
+        std::this_thread::yield();
+    }
+    m_windowDone.store(0, std::memory_order_relaxed);
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    ProcessEventsWithContext();
+    Partition();
+    m_stop = false;
+    m_running = true;
+
+    std::vector<std::thread> threads;
+    uint64_t window = m_window.load();
+    for (std::size_t i = 2; i < m_lps.size(); ++i)
+    {
+        threads.emplace_back(&MultithreadedSimulatorImpl::WorkerLoop, this, m_lps[i], window);
+    }
+
+    const uint64_t maxTs = GetMaximumSimulationTime().GetTimeStep();
+    LogicalProcess* global = m_lps.front();
+    while (!m_stop)
+    {
+        ProcessEventsWithContext();
+
+        uint64_t globalTs = global->NextTs();
+        uint64_t partitionTs = maxTs;
+        for (std::size_t i = 1; i < m_lps.size(); ++i)
+        {
+            partitionTs = std::min({partitionTs, m_lps[i]->NextTs(), m_lps[i]->GetMinSentTs()});
+        }
+        if (globalTs == maxTs && partitionTs == maxTs)
+        {
+            break;
+        }
+
+        if (globalTs <= partitionTs)
+        {
+            // The partitions are paused: the events without context can
+            // access any node.
+            g_currentLp = global;
+            while (!m_stop && !global->IsEmpty() && global->NextTs() == globalTs)
+            {
+                global->ProcessOneEvent();
+            }
+            g_currentLp = nullptr;
+        }
+        else
+        {
+            uint64_t grantedTs = globalTs;
+            uint64_t lookAhead = m_lookAhead.GetTimeStep();
+            if (lookAhead < maxTs - partitionTs)
+            {
+                grantedTs = std::min(grantedTs, partitionTs + lookAhead);
+            }
+            ProcessWindow(grantedTs);
+        }
+    }
+
+    m_running.store(false, std::memory_order_release);
+    m_window.fetch_add(1, std::memory_order_release);
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Deliver the events still in transit, and move the global clock to
+    // the most advanced partition.
+    uint64_t parity = (m_window.load() + 1) & 1;
+    uint64_t ts = global->GetCurrentTs();
+    for (LogicalProcess* lp : m_lps)
+    {
+        lp->ReceiveMessages(m_lps, parity);
+        ts = std::max(ts, lp->GetCurrentTs());
+    }
+    global->SetCurrentTs(ts);
+    m_grantedTs = 0;
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    if (!m_stop && IsFinished())
+    {
+        for (LogicalProcess* lp : m_lps)
+        {
+            NS_ASSERT(lp->GetUnscheduledEvents() == 0);
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(g_currentLp != nullptr || m_mainThreadId == std::this_thread::get_id(),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    LogicalProcess* lp = GetCurrentLp();
+    uint64_t ts = lp->GetCurrentTs() + delay.GetTimeStep();
+    return lp->Schedule(ts, lp->GetContext(), event);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    LogicalProcess* src = g_currentLp;
+    if (src == nullptr)
+    {
+        if (m_mainThreadId != std::this_thread::get_id())
+        {
+            EventWithContext ev;
+            ev.context = context;
+            // Current time added in ProcessEventsWithContext()
+            ev.timestamp = delay.GetTimeStep();
+            ev.event = event;
+            std::unique_lock lock{m_eventsWithContextMutex};
+            m_eventsWithContext.push_back(ev);
+            return;
+        }
+        src = m_lps.front();
+    }
+
+    uint64_t ts = src->GetCurrentTs() + delay.GetTimeStep();
+    LogicalProcess* dst = GetLp(context);
+    if (dst == src || src->GetId() == 0)
+    {
+        // Either a local event, or the partitions are paused.
+        dst->Schedule(ts, context, event);
+        return;
+    }
+
+    NS_ABORT_MSG_IF(ts < m_grantedTs,
+                    "Event scheduled from context " << src->GetContext() << " to context "
+                                                    << context << " with a delay of " << delay
+                                                    << ", which is smaller than the lookahead "
+                                                    << m_lookAhead);
+    if (dst->GetId() == 0)
+    {
+        EventWithContext ev;
+        ev.context = context;
+        ev.timestamp = ts;
+        ev.event = event;
+        std::unique_lock lock{m_eventsWithContextMutex};
+        m_globalEvents.push_back(ev);
+        return;
+    }
+    src->Send(dst->GetId(), ts, context, event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false), GetCurrentLp()->GetCurrentTs(), 0xffffffff, 2);
+    std::unique_lock lock{m_destroyEventsMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrentLp()->GetCurrentTs());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetLp(id.GetContext())->GetCurrentTs());
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (DestroyEvents::iterator i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    GetLp(id.GetContext())->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{const_cast<std::mutex&>(m_destroyEventsMutex)};
+        for (DestroyEvents::const_iterator i = m_destroyEvents.begin(); i != m_destroyEvents.end();
+             i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    // The event is owned by the LP of its context, whose clock is the
+    // relevant one.
+    LogicalProcess* lp = GetLp(id.GetContext());
+    if (id.PeekEventImpl() == nullptr || id.GetTs() < lp->GetCurrentTs() ||
+        (id.GetTs() == lp->GetCurrentTs() && id.GetUid() <= lp->GetCurrentUid()) ||
+        id.PeekEventImpl()->IsCancelled())
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentLp()->GetContext();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = m_eventCount;
+    for (LogicalProcess* lp : m_lps)
+    {
+        count += lp->GetEventCount();
+    }
+    return count;
+}
+
+} // namespace ns3
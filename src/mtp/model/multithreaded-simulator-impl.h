@@ -0,0 +1,251 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file
+ * \ingroup mtp
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-impl.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+class Channel;
+class LogicalProcess;
+
+/**
+ * \ingroup simulator
+ * \ingroup mtp
+ *
+ * \brief Shared-memory parallel simulator implementation using lookahead
+ *
+ * The nodes of the simulation are partitioned into logical processes
+ * (LPs), each with its own event list, and the LPs are executed
+ * concurrently by a pool of threads.  The synchronization is the same
+ * conservative, globally synchronized time window algorithm as the one
+ * of DistributedSimulatorImpl, but the events crossing partitions are
+ * exchanged through in-process queues (see LogicalProcess) instead of
+ * MPI messages.
+ *
+ * The partitioning is computed when Run() is invoked:
+ *   - the execution context of an event is the id of the node it
+ *     belongs to; each node is assigned to exactly one LP;
+ *   - only point-to-point channels with a positive "Delay" attribute
+ *     can separate two LPs; the nodes attached to any other channel
+ *     (e.g., CSMA or spectrum channels, whose medium state is shared by
+ *     all the attached devices) are kept in the same LP;
+ *   - the connected components are balanced over MaxThreads LPs;
+ *   - the lookahead is the smallest delay of the channels which
+ *     connect two different LPs.
+ *
+ * The events without context (e.g., those scheduled from the main
+ * program before Run()) are executed by the main thread while the
+ * other threads are paused, so they can safely access any node.
+ *
+ * This implementation requires ns-3 to be built with NS3_MTP, which
+ * makes reference counts and packet internals thread-safe.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Default constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // virtual from SimulatorImpl
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * Add additional bound to lookahead constraints.
+     *
+     * The method may be invoked more than once, the minimum time will
+     * be used to constrain lookahead.
+     *
+     * \param [in] lookAhead The maximum lookahead; must be > 0.
+     */
+    void BoundLookAhead(const Time lookAhead);
+
+    /**
+     * Get the lookahead computed by the last partitioning.
+     *
+     * \return The size of the time windows.
+     */
+    Time GetLookAhead() const;
+
+    /**
+     * Get the number of LPs (and threads) used by the last partitioning.
+     *
+     * \return The number of partitions.
+     */
+    uint32_t GetPartitionCount() const;
+
+    /**
+     * Get the delay which bounds the lookahead when a channel separates
+     * two partitions.
+     *
+     * \param [in] channel The channel.
+     * \return The channel delay, or zero if the channel cannot separate
+     *         two partitions.
+     */
+    static Time GetChannelDelay(Ptr<Channel> channel);
+
+  private:
+    // Inherited from Object
+    void DoDispose() override;
+
+    /**
+     * Assign the nodes to the LPs, compute the lookahead and move the
+     * pending events to the LP which owns their context.
+     */
+    void Partition();
+    /**
+     * Get the LP of the calling thread.
+     *
+     * \return The LP executing the current event, or the global LP
+     *         if called outside of a partition.
+     */
+    LogicalProcess* GetCurrentLp() const;
+    /**
+     * Get the LP which owns a context.
+     *
+     * \param [in] context The execution context.
+     * \return The LP owning the context.
+     */
+    LogicalProcess* GetLp(uint32_t context) const;
+    /**
+     * Move the events injected by foreign threads and the events sent
+     * to the global LP into the event lists.
+     */
+    void ProcessEventsWithContext();
+    /**
+     * Execute a time window in all the partitions.
+     *
+     * \param [in] grantedTs The end of the window.
+     */
+    void ProcessWindow(uint64_t grantedTs);
+    /**
+     * Main loop of a worker thread.
+     *
+     * \param [in] lp The LP executed by the thread.
+     * \param [in] window The number of the last window executed.
+     */
+    void WorkerLoop(LogicalProcess* lp, uint64_t window);
+
+    /** Wrap an event with its execution context. */
+    struct EventWithContext
+    {
+        /** The event context. */
+        uint32_t context;
+        /** Event timestamp. */
+        uint64_t timestamp;
+        /** The event implementation. */
+        EventImpl* event;
+    };
+    /** Container type for the events from a different context. */
+    typedef std::list<EventWithContext> EventsWithContext;
+    /** Events injected by foreign threads; the timestamp is relative. */
+    EventsWithContext m_eventsWithContext;
+    /** Events sent by the partitions to the global LP; the timestamp is absolute. */
+    EventsWithContext m_globalEvents;
+    /** Mutex to control access to the two lists of events above. */
+    std::mutex m_eventsWithContextMutex;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex to control access to the list of destroy events. */
+    std::mutex m_destroyEventsMutex;
+
+    /** The scheduler factory used by all the LPs. */
+    ObjectFactory m_schedulerFactory;
+    /**
+     * All the LPs; LP 0 holds the events without context and is
+     * executed by the main thread between the time windows.
+     */
+    std::vector<LogicalProcess*> m_lps;
+    /** The LP index of each node, indexed by node id. */
+    std::vector<uint32_t> m_lpOfContext;
+
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Flag \c true while the worker threads must keep running. */
+    std::atomic<bool> m_running;
+    /** Number of the current time window. */
+    std::atomic<uint64_t> m_window;
+    /** Number of worker threads done with the current window. */
+    std::atomic<uint32_t> m_windowDone;
+    /** End of the current time window. */
+    uint64_t m_grantedTs;
+
+    /** Maximum number of threads. */
+    uint32_t m_maxThreads;
+    /** Smallest channel delay which can separate two partitions. */
+    Time m_minLookAhead;
+    /** User bound on the lookahead. */
+    Time m_boundLookAhead;
+    /** Lookahead computed by the partitioning. */
+    Time m_lookAhead;
+    /** Number of events processed by the LPs of previous partitionings. */
+    uint64_t m_eventCount;
+
+    /** Main execution thread. */
+    std::thread::id m_mainThreadId;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,375 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/mac48-address.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * Multithreaded simulator test suite.
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests Multithreaded simulator tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Packets circulating on a ring of nodes: the trace of the receptions
+ * of each node must not depend on the simulator implementation nor on
+ * the number of threads.
+ */
+class MtpRingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] threads The number of threads, 0 to use the default simulator.
+     * \param [in] pointToPoint Whether the devices are in point-to-point mode.
+     */
+    MtpRingTestCase(uint32_t threads, bool pointToPoint);
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** A packet reception. */
+    struct Reception
+    {
+        int64_t ts;   //!< The reception time.
+        uint64_t uid; //!< The packet uid.
+        uint32_t hop; //!< The hop count carried by the packet.
+    };
+
+    /**
+     * Run the ring.
+     *
+     * \return The receptions of each node.
+     */
+    std::vector<std::vector<Reception>> RunRing();
+
+    /**
+     * Receive a packet and forward it to the next node.
+     *
+     * \param [in] device The receiving device.
+     * \param [in] packet The packet.
+     * \param [in] protocol The protocol number.
+     * \param [in] from The sender address.
+     * \return \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    /**
+     * Send a packet on the outgoing device of a node.
+     *
+     * \param [in] node The node index.
+     * \param [in] packet The packet.
+     * \param [in] hop The hop count, carried as protocol number.
+     */
+    void Send(uint32_t node, Ptr<Packet> packet, uint16_t hop);
+
+    uint32_t m_threads;                               //!< The number of threads.
+    bool m_pointToPoint;                              //!< The devices mode.
+    std::vector<Ptr<SimpleNetDevice>> m_out;          //!< The outgoing device of each node.
+    std::vector<std::vector<Reception>> m_receptions; //!< The receptions of each node.
+};
+
+/// The number of nodes of the ring.
+static const uint32_t RING_SIZE = 8;
+
+MtpRingTestCase::MtpRingTestCase(uint32_t threads, bool pointToPoint)
+    : TestCase("Ring of " + std::to_string(RING_SIZE) + " nodes, " + std::to_string(threads) +
+               " threads" + (pointToPoint ? "" : ", shared channels")),
+      m_threads(threads),
+      m_pointToPoint(pointToPoint)
+{
+}
+
+void
+MtpRingTestCase::DoSetup()
+{
+    if (m_threads > 0)
+    {
+        Config::SetGlobal("SimulatorImplementationType",
+                          StringValue("ns3::MultithreadedSimulatorImpl"));
+        Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads",
+                           UintegerValue(m_threads));
+    }
+}
+
+void
+MtpRingTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::Reset();
+}
+
+bool
+MtpRingTestCase::Receive(Ptr<NetDevice> device,
+                         Ptr<const Packet> packet,
+                         uint16_t protocol,
+                         const Address& from)
+{
+    uint32_t node = device->GetNode()->GetId();
+    uint32_t hop = protocol;
+    m_receptions[node].push_back({Simulator::Now().GetTimeStep(), packet->GetUid(), hop});
+
+    // Every other hop, fork a new packet to exercise the uid allocation
+    // and the packet copies from several threads.
+    Ptr<Packet> next = (hop % 2 == 0) ? Create<Packet>(100 + hop) : packet->Copy();
+    Simulator::Schedule(MicroSeconds(hop % 3), &MtpRingTestCase::Send, this, node, next, hop + 1);
+    (void)from;
+    return true;
+}
+
+void
+MtpRingTestCase::Send(uint32_t node, Ptr<Packet> packet, uint16_t hop)
+{
+    m_out[node]->Send(packet, Mac48Address::GetBroadcast(), hop);
+}
+
+std::vector<std::vector<MtpRingTestCase::Reception>>
+MtpRingTestCase::RunRing()
+{
+    std::vector<Ptr<Node>> nodes;
+    std::vector<Ptr<SimpleNetDevice>> in;
+    m_out.clear();
+    m_receptions.assign(RING_SIZE, {});
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        nodes.push_back(CreateObject<Node>());
+        for (auto devices : {&in, &m_out})
+        {
+            Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+            device->SetAttribute("PointToPointMode", BooleanValue(m_pointToPoint));
+            device->SetAddress(Mac48Address::Allocate());
+            nodes[i]->AddDevice(device);
+            devices->push_back(device);
+        }
+        in[i]->SetReceiveCallback(MakeCallback(&MtpRingTestCase::Receive, this));
+    }
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        channel->SetAttribute("Delay", TimeValue(MicroSeconds(10 + i % 3)));
+        uint32_t next = (i + 1) % RING_SIZE;
+        m_out[i]->SetChannel(channel);
+        in[next]->SetChannel(channel);
+    }
+
+    for (uint32_t i = 0; i < RING_SIZE; i += 2)
+    {
+        Simulator::ScheduleWithContext(i,
+                                       MicroSeconds(i),
+                                       &MtpRingTestCase::Send,
+                                       this,
+                                       i,
+                                       Create<Packet>(100),
+                                       0);
+    }
+    Simulator::Stop(MilliSeconds(20));
+    Simulator::Run();
+
+    if (m_threads > 0)
+    {
+        auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+        NS_TEST_EXPECT_MSG_NE(impl, nullptr, "Wrong simulator implementation");
+        if (impl && m_pointToPoint)
+        {
+            NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(),
+                                  std::min(m_threads, RING_SIZE),
+                                  "Wrong number of partitions");
+            if (m_threads > 1)
+            {
+                NS_TEST_EXPECT_MSG_EQ(impl->GetLookAhead(),
+                                      MicroSeconds(10),
+                                      "Wrong lookahead");
+            }
+        }
+        else if (impl)
+        {
+            NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(), 1, "Shared channels were cut");
+        }
+    }
+    Simulator::Destroy();
+
+    return m_receptions;
+}
+
+void
+MtpRingTestCase::DoRun()
+{
+    std::vector<std::vector<Reception>> receptions = RunRing();
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        total += receptions[i].size();
+        for (std::size_t j = 1; j < receptions[i].size(); ++j)
+        {
+            NS_TEST_EXPECT_MSG_GT_OR_EQ(receptions[i][j].ts,
+                                        receptions[i][j - 1].ts,
+                                        "Receptions out of order at node " << i);
+        }
+    }
+    NS_TEST_ASSERT_MSG_GT(total, 1000, "Too few receptions");
+
+    if (m_threads == 0)
+    {
+        return;
+    }
+
+    // Compare with a serial run of the same scenario.  The order of the
+    // simultaneous receptions of a node depends on the event uids, which
+    // are allocated differently by the two implementations.
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    uint32_t threads = m_threads;
+    m_threads = 0;
+    std::vector<std::vector<Reception>> reference = RunRing();
+    m_threads = threads;
+
+    auto byTime = [](const Reception& a, const Reception& b) {
+        return a.ts < b.ts || (a.ts == b.ts && a.hop < b.hop);
+    };
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        std::sort(receptions[i].begin(), receptions[i].end(), byTime);
+        std::sort(reference[i].begin(), reference[i].end(), byTime);
+    }
+
+    for (uint32_t i = 0; i < RING_SIZE; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(receptions[i].size(),
+                              reference[i].size(),
+                              "Wrong number of receptions at node " << i);
+        for (std::size_t j = 0; j < receptions[i].size(); ++j)
+        {
+            NS_TEST_EXPECT_MSG_EQ(receptions[i][j].ts,
+                                  reference[i][j].ts,
+                                  "Wrong reception time at node " << i);
+            NS_TEST_EXPECT_MSG_EQ(receptions[i][j].hop,
+                                  reference[i][j].hop,
+                                  "Wrong reception at node " << i);
+        }
+    }
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * Lookahead violations are detected, and events without context run
+ * while all the partitions are paused.
+ */
+class MtpGlobalEventsTestCase : public TestCase
+{
+  public:
+    MtpGlobalEventsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record the time of an event.
+     *
+     * \param [in] index The event index.
+     */
+    void Record(uint32_t index);
+
+    std::vector<int64_t> m_times; //!< The event times.
+};
+
+MtpGlobalEventsTestCase::MtpGlobalEventsTestCase()
+    : TestCase("Events without context")
+{
+}
+
+void
+MtpGlobalEventsTestCase::Record(uint32_t index)
+{
+    m_times[index] = Simulator::Now().GetTimeStep();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetContext(),
+                          Simulator::NO_CONTEXT,
+                          "Global event with a context");
+    if (index + 1 < m_times.size())
+    {
+        Simulator::Schedule(MicroSeconds(3), &MtpGlobalEventsTestCase::Record, this, index + 1);
+    }
+}
+
+void
+MtpGlobalEventsTestCase::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    m_times.assign(10, -1);
+    Simulator::Schedule(MicroSeconds(1), &MtpGlobalEventsTestCase::Record, this, 0);
+    Simulator::Run();
+
+    for (uint32_t i = 0; i < m_times.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_times[i], MicroSeconds(1 + 3 * i).GetTimeStep(), "Wrong time");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(28), "Wrong final time");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::GetEventCount(), 10, "Wrong event count");
+    Simulator::Destroy();
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief The multithreaded simulator Test Suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite()
+        : TestSuite("mtp", UNIT)
+    {
+        AddTestCase(new MtpGlobalEventsTestCase(), TestCase::QUICK);
+        for (uint32_t threads : {1, 2, 3, 8})
+        {
+            AddTestCase(new MtpRingTestCase(threads, true), TestCase::QUICK);
+        }
+        AddTestCase(new MtpRingTestCase(4, false), TestCase::QUICK);
+    }
+};
+
+/// Static variable for test initialization.
+static MtpTestSuite g_mtpTestSuite;
@@ -19,11 +19,13 @@
 #include "buffer.h"
 
 #include "ns3/assert.h"
+#include "ns3/internet-checksum.h"
 #include "ns3/log.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                      \
     NS_LOG_LOGIC(y << "start=" << m_start << ", end=" << m_end                                     \
                    << ", zero start=" << m_zeroAreaStart << ", zero end=" << m_zeroAreaEnd         \
+                   << ", payload=" << m_payload << ", payload start=" << m_payloadStart          \
                    << ", count=" << m_data->m_count << ", size=" << m_data->m_size                 \
                    << ", dirty start=" << m_data->m_dirtyStart                                     \
                    << ", dirty end=" << m_data->m_dirtyEnd)
@@ -54,7 +56,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MTP
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -189,6 +195,55 @@ Buffer::Deallocate(struct Buffer::Data* data)
     delete[] buf;
 }
 
+void
+Buffer::ReleasePayload(struct Buffer::Payload* payload)
+{
+    NS_LOG_FUNCTION(payload);
+    if (payload != nullptr && --payload->m_count == 0)
+    {
+        uint8_t* buf = reinterpret_cast<uint8_t*>(payload);
+        delete[] buf;
+    }
+}
+
+void
+Buffer::SetPayload(struct Buffer::Payload* payload, uint32_t start)
+{
+    NS_LOG_FUNCTION(this << payload << start);
+    if (payload != m_payload)
+    {
+        if (payload != nullptr)
+        {
+            payload->m_count++;
+        }
+        ReleasePayload(m_payload);
+        m_payload = payload;
+    }
+    m_payloadStart = payload == nullptr ? 0 : start;
+}
+
+void
+Buffer::Unshare()
+{
+    NS_LOG_FUNCTION(this);
+    struct Buffer::Data* newData = Buffer::Create(GetInternalSize());
+    memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
+    if (--m_data->m_count == 0)
+    {
+        Buffer::Recycle(m_data);
+    }
+    m_data = newData;
+
+    int32_t delta = -m_start;
+    m_zeroAreaStart += delta;
+    m_zeroAreaEnd += delta;
+    m_end += delta;
+    m_start += delta;
+    m_data->m_dirtyStart = m_start;
+    m_data->m_dirtyEnd = m_end;
+    LOG_INTERNAL_STATE("unshare ");
+}
+
 Buffer::Buffer()
 {
     NS_LOG_FUNCTION(this);
@@ -210,6 +265,21 @@ Buffer::Buffer(uint32_t dataSize, bool initialize)
     }
 }
 
+Buffer::Buffer(const uint8_t* data, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << &data << size);
+    Initialize(size);
+    if (size > 0)
+    {
+        uint8_t* b = new uint8_t[size - 1 + sizeof(struct Buffer::Payload)];
+        struct Buffer::Payload* payload = reinterpret_cast<struct Buffer::Payload*>(b);
+        payload->m_count = 1;
+        payload->m_size = size;
+        memcpy(payload->m_data, data, size);
+        m_payload = payload;
+    }
+}
+
 bool
 Buffer::CheckInternalState() const
 {
@@ -229,8 +299,11 @@ Buffer::CheckInternalState() const
   bool internalSizeOk = m_end - (m_zeroAreaEnd - m_zeroAreaStart) <= m_data->m_size &&
     m_start <= m_data->m_size &&
     m_zeroAreaStart <= m_data->m_size;
+  bool payloadOk = m_payload == nullptr ||
+    (m_payload->m_count > 0 &&
+     m_payloadStart + m_zeroAreaEnd - m_zeroAreaStart <= m_payload->m_size);
 
-  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk;
+  bool ok = m_data->m_count > 0 && offsetsOk && dirtyOk && internalSizeOk && payloadOk;
   if (!ok)
     {
       LOG_INTERNAL_STATE ("check " << this <<
@@ -249,6 +322,8 @@ Buffer::Initialize(uint32_t zeroSize)
 {
     NS_LOG_FUNCTION(this << zeroSize);
     m_data = Buffer::Create(0);
+    m_payload = nullptr;
+    m_payloadStart = 0;
     m_start = std::min(m_data->m_size, g_recommendedStart);
     m_maxZeroAreaStart = m_start;
     m_zeroAreaStart = m_start;
@@ -266,14 +341,14 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
         m_data = o.m_data;
         m_data->m_count++;
     }
+    SetPayload(o.m_payload, o.m_payloadStart);
     g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
     m_maxZeroAreaStart = o.m_maxZeroAreaStart;
     m_zeroAreaStart = o.m_zeroAreaStart;
@@ -289,11 +364,11 @@ Buffer::~Buffer()
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
     g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
+    ReleasePayload(m_payload);
 }
 
 uint32_t
@@ -315,7 +390,13 @@ Buffer::AddAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    // the dirty area cannot be grown safely while another thread may own
+    // a reference to the same data.
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
     if (m_start >= start && !isDirty)
     {
         /* enough space in the buffer and not dirty.
@@ -333,8 +414,7 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         struct Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -361,7 +441,11 @@ Buffer::AddAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
+#ifdef NS3_MTP
+    bool isDirty = m_data->m_count > 1;
+#else
     bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
     if (GetInternalEnd() + end <= m_data->m_size && !isDirty)
     {
         /* enough space in buffer and not dirty
@@ -379,8 +463,7 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         struct Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -407,18 +490,27 @@ Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    bool noZeroArea = m_zeroAreaStart == m_zeroAreaEnd;
+    bool sameArea = m_payload == o.m_payload &&
+                    (m_payload == nullptr ||
+                     m_payloadStart + (m_zeroAreaEnd - m_zeroAreaStart) == o.m_payloadStart);
+    if ((m_end == m_zeroAreaEnd || noZeroArea) && (sameArea || noZeroArea) &&
+        o.m_start == o.m_zeroAreaStart && o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
         /**
          * This is an optimization which kicks in when
          * we attempt to aggregate two buffers which contain
-         * adjacent zero areas.
+         * adjacent zero areas, or adjacent parts of the same
+         * payload slice: only the real bytes are copied.
          */
-        if (m_zeroAreaStart == m_zeroAreaEnd)
+        if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+            Unshare();
+        }
+        if (noZeroArea)
         {
             m_zeroAreaStart = m_end;
+            SetPayload(o.m_payload, o.m_payloadStart);
         }
         uint32_t zeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
         m_zeroAreaEnd = m_end + zeroSize;
@@ -463,6 +555,7 @@ Buffer::RemoveAtStart(uint32_t start)
         m_start = m_zeroAreaStart;
         m_zeroAreaEnd -= delta;
         m_end -= delta;
+        m_payloadStart += delta;
     }
     else if (newStart <= m_end)
     {
@@ -484,6 +577,10 @@ Buffer::RemoveAtStart(uint32_t start)
         m_zeroAreaEnd = m_end;
         m_zeroAreaStart = m_end;
     }
+    if (m_zeroAreaStart == m_zeroAreaEnd)
+    {
+        SetPayload(nullptr, 0);
+    }
     m_maxZeroAreaStart = std::max(m_maxZeroAreaStart, m_zeroAreaStart);
     LOG_INTERNAL_STATE("rem start=" << start << ", ");
     NS_ASSERT(CheckInternalState());
@@ -520,6 +617,10 @@ Buffer::RemoveAtEnd(uint32_t end)
         m_zeroAreaEnd = m_start;
         m_zeroAreaStart = m_start;
     }
+    if (m_zeroAreaStart == m_zeroAreaEnd)
+    {
+        SetPayload(nullptr, 0);
+    }
     m_maxZeroAreaStart = std::max(m_maxZeroAreaStart, m_zeroAreaStart);
     LOG_INTERNAL_STATE("rem end=" << end << ", ");
     NS_ASSERT(CheckInternalState());
@@ -546,7 +647,14 @@ Buffer::CreateFullCopy() const
     {
         Buffer tmp;
         tmp.AddAtStart(m_zeroAreaEnd - m_zeroAreaStart);
-        tmp.Begin().WriteU8(0, m_zeroAreaEnd - m_zeroAreaStart);
+        if (m_payload != nullptr)
+        {
+            tmp.Begin().Write(m_payload->m_data + m_payloadStart, m_zeroAreaEnd - m_zeroAreaStart);
+        }
+        else
+        {
+            tmp.Begin().WriteU8(0, m_zeroAreaEnd - m_zeroAreaStart);
+        }
         uint32_t dataStart = m_zeroAreaStart - m_start;
         tmp.AddAtStart(dataStart);
         tmp.Begin().Write(m_data->m_data + m_start, dataStart);
@@ -566,6 +674,10 @@ uint32_t
 Buffer::GetSerializedSize() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_payload != nullptr)
+    {
+        return CreateFullCopy().GetSerializedSize();
+    }
     uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
     uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -582,6 +694,10 @@ uint32_t
 Buffer::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
     NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (m_payload != nullptr)
+    {
+        return CreateFullCopy().Serialize(buffer, maxSize);
+    }
     uint32_t* p = reinterpret_cast<uint32_t*>(buffer);
     uint32_t size = 0;
 
@@ -727,12 +843,19 @@ Buffer::CopyData(std::ostream* os, uint32_t size) const
         {
             size -= m_zeroAreaStart - m_start;
             tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
-            uint32_t left = tmpsize;
-            while (left > 0)
+            if (m_payload != nullptr)
+            {
+                os->write((const char*)(m_payload->m_data + m_payloadStart), tmpsize);
+            }
+            else
             {
-                uint32_t toWrite = std::min(left, g_zeroes.size);
-                os->write(g_zeroes.buffer, toWrite);
-                left -= toWrite;
+                uint32_t left = tmpsize;
+                while (left > 0)
+                {
+                    uint32_t toWrite = std::min(left, g_zeroes.size);
+                    os->write(g_zeroes.buffer, toWrite);
+                    left -= toWrite;
+                }
             }
             if (size > tmpsize)
             {
@@ -758,13 +881,21 @@ Buffer::CopyData(uint8_t* buffer, uint32_t size) const
         if (size > 0)
         {
             tmpsize = std::min(m_zeroAreaEnd - m_zeroAreaStart, size);
-            uint32_t left = tmpsize;
-            while (left > 0)
+            if (m_payload != nullptr)
             {
-                uint32_t toWrite = std::min(left, g_zeroes.size);
-                memcpy(buffer, g_zeroes.buffer, toWrite);
-                left -= toWrite;
-                buffer += toWrite;
+                memcpy(buffer, m_payload->m_data + m_payloadStart, tmpsize);
+                buffer += tmpsize;
+            }
+            else
+            {
+                uint32_t left = tmpsize;
+                while (left > 0)
+                {
+                    uint32_t toWrite = std::min(left, g_zeroes.size);
+                    memcpy(buffer, g_zeroes.buffer, toWrite);
+                    left -= toWrite;
+                    buffer += toWrite;
+                }
             }
             size -= tmpsize;
             if (size > 0)
@@ -838,27 +969,42 @@ Buffer::Iterator::Write(Iterator start, Iterator end)
     NS_ASSERT(m_data != start.m_data);
     uint32_t size = end.m_current - start.m_current;
     NS_ASSERT_MSG(CheckNoZero(m_current, m_current + size), GetWriteErrorMessage());
+    uint8_t* to;
+    if (m_current <= m_zeroStart)
+    {
+        to = &m_data[m_current];
+    }
+    else
+    {
+        to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
+    m_current += size;
     if (start.m_current <= start.m_zeroStart)
     {
         uint32_t toCopy = std::min(size, start.m_zeroStart - start.m_current);
-        memcpy(&m_data[m_current], &start.m_data[start.m_current], toCopy);
+        memcpy(to, &start.m_data[start.m_current], toCopy);
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     if (start.m_current <= start.m_zeroEnd)
     {
         uint32_t toCopy = std::min(size, start.m_zeroEnd - start.m_current);
-        memset(&m_data[m_current], 0, toCopy);
+        if (start.m_payload != nullptr)
+        {
+            memcpy(to, &start.m_payload[start.m_current - start.m_zeroStart], toCopy);
+        }
+        else
+        {
+            memset(to, 0, toCopy);
+        }
         start.m_current += toCopy;
-        m_current += toCopy;
+        to += toCopy;
         size -= toCopy;
     }
     uint32_t toCopy = std::min(size, start.m_dataEnd - start.m_current);
     uint8_t* from = &start.m_data[start.m_current - (start.m_zeroEnd - start.m_zeroStart)];
-    uint8_t* to = &m_data[m_current];
     memcpy(to, from, toCopy);
-    m_current += toCopy;
 }
 
 void
@@ -1148,17 +1294,43 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum(uint16_t size, uint32_t initialChecksum)
 {
     NS_LOG_FUNCTION(this << size << initialChecksum);
+    NS_ASSERT_MSG(m_current >= m_dataStart && m_current + size <= m_dataEnd,
+                  GetReadErrorMessage());
     /* see RFC 1071 to understand this code. */
     uint32_t sum = initialChecksum;
-
-    for (int j = 0; j < size / 2; j++)
-    {
-        sum += ReadU16();
-    }
-
-    if (size & 1)
+    uint32_t start = m_current;
+    uint32_t end = m_current + size;
+    // Sum the bytes before, in and after the virtual zero area in turn
+    while (m_current < end)
     {
-        sum += ReadU8();
+        const uint8_t* data;
+        uint32_t length;
+        if (m_current < m_zeroStart)
+        {
+            data = &m_data[m_current];
+            length = std::min(end, m_zeroStart) - m_current;
+        }
+        else if (m_current < m_zeroEnd)
+        {
+            data = m_payload == nullptr ? nullptr : &m_payload[m_current - m_zeroStart];
+            length = std::min(end, m_zeroEnd) - m_current;
+        }
+        else
+        {
+            data = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+            length = end - m_current;
+        }
+        if (data != nullptr)
+        {
+            uint16_t partial = ChecksumAdd(0, data, length);
+            // A part which starts at an odd offset is summed byte-swapped
+            if ((m_current - start) & 1)
+            {
+                partial = (partial << 8) | (partial >> 8);
+            }
+            sum += partial;
+        }
+        m_current += length;
     }
 
     while (sum >> 16)
@@ -25,7 +25,13 @@
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
+// The free list is shared by all the buffers of the process, so it is
+// only used when buffers cannot be handled by several threads.
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -89,6 +95,17 @@ namespace ns3
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * The virtual area may also hold the bytes of a payload slice instead
+ * of zeroes: a Buffer created from a payload (see Buffer(const uint8_t*,
+ * uint32_t)) references an immutable, reference-counted copy of its
+ * bytes, which is shared by all the copies and fragments of the buffer.
+ * Adding or removing headers and trailers only copies the real bytes
+ * around the slice, a fragment of the buffer references a sub-slice, and
+ * appending a buffer which continues the same slice extends it.  Like
+ * the zero area, the slice cannot be written to: it is copied into real
+ * bytes only by CreateFullCopy(), PeekData(), Serialize(), and when
+ * appending a buffer which does not continue it.
  */
 class Buffer
 {
@@ -483,6 +500,11 @@ class Buffer
          * to this pointer.
          */
         uint8_t* m_data;
+        /**
+         * a pointer to the byte of the payload slice at m_zeroStart, or
+         * nullptr if the virtual area holds zeroes.
+         */
+        const uint8_t* m_payload;
     };
 
     /**
@@ -581,7 +603,8 @@ class Buffer
      * This buffer's contents are serialized into the raw
      * character buffer parameter. Note: The zero length
      * data is not copied entirely. Only the length of
-     * zero byte data is serialized.
+     * zero byte data is serialized. A payload slice is
+     * serialized as real bytes.
      */
     uint32_t Serialize(uint8_t* buffer, uint32_t maxSize) const;
 
@@ -642,6 +665,16 @@ class Buffer
      * \param initialize initialize the buffer with zeroes.
      */
     Buffer(uint32_t dataSize, bool initialize);
+    /**
+     * \brief Constructor
+     *
+     * The buffer holds a payload slice with a copy of the input bytes,
+     * which is shared by the copies and the fragments of the buffer.
+     *
+     * \param data the bytes of the payload.
+     * \param size the size of the payload.
+     */
+    Buffer(const uint8_t* data, uint32_t size);
     ~Buffer();
 
   private:
@@ -665,7 +698,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -687,6 +724,31 @@ class Buffer
         uint8_t m_data[1];
     };
 
+    /**
+     * The immutable bytes of a payload slice, variable-sized like Data.
+     * The buffers which hold the slice, or a part of it, share it.
+     */
+    struct Payload
+    {
+        /**
+         * The reference count of an instance of this data structure.
+         * Each buffer which references an instance holds a count.
+         */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
+        uint32_t m_count;
+#endif
+        /**
+         * the size of the m_data field below.
+         */
+        uint32_t m_size;
+        /**
+         * The payload bytes, _at least_ one.
+         */
+        uint8_t m_data[1];
+    };
+
     /**
      * \brief Create a full copy of the buffer, including
      * all the internal structures.
@@ -750,8 +812,34 @@ class Buffer
      * \param data the buffer data storage
      */
     static void Deallocate(struct Buffer::Data* data);
+    /**
+     * \brief Release a reference to a payload slice
+     * \param payload the payload, or nullptr
+     */
+    static void ReleasePayload(struct Buffer::Payload* payload);
+    /**
+     * \brief Reference a payload slice in the virtual area
+     * \param payload the payload, or nullptr for zeroes
+     * \param start the offset of the slice in the payload
+     */
+    void SetPayload(struct Buffer::Payload* payload, uint32_t start);
+    /**
+     * \brief Copy the real bytes into unshared buffer data storage,
+     * leaving the virtual area as it is
+     */
+    void Unshare();
 
     struct Data* m_data; //!< the buffer data storage
+    /**
+     * the payload slice held in the virtual area, or nullptr if
+     * the virtual area holds zeroes
+     */
+    struct Payload* m_payload;
+    /**
+     * offset from the start of m_payload->m_data to the byte at
+     * m_zeroAreaStart
+     */
+    uint32_t m_payloadStart;
 
     /**
      * keep track of the maximum value of m_zeroAreaStart across
@@ -769,7 +857,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static thread_local uint32_t g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -823,7 +915,8 @@ Buffer::Iterator::Iterator()
       m_dataStart(0),
       m_dataEnd(0),
       m_current(0),
-      m_data(nullptr)
+      m_data(nullptr),
+      m_payload(nullptr)
 {
 }
 
@@ -847,6 +940,9 @@ Buffer::Iterator::Construct(const Buffer* buffer)
     m_dataStart = buffer->m_start;
     m_dataEnd = buffer->m_end;
     m_data = buffer->m_data->m_data;
+    m_payload = buffer->m_payload == nullptr
+                    ? nullptr
+                    : buffer->m_payload->m_data + buffer->m_payloadStart;
 }
 
 void
@@ -1014,7 +1110,7 @@ Buffer::Iterator::PeekU8()
     }
     else if (m_current < m_zeroEnd)
     {
-        return 0;
+        return m_payload == nullptr ? 0 : m_payload[m_current - m_zeroStart];
     }
     else
     {
@@ -1054,6 +1150,8 @@ Buffer::Iterator::Read(Buffer::Iterator start, uint32_t size)
 
 Buffer::Buffer(const Buffer& o)
     : m_data(o.m_data),
+      m_payload(o.m_payload),
+      m_payloadStart(o.m_payloadStart),
       m_maxZeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaStart(o.m_zeroAreaStart),
       m_zeroAreaEnd(o.m_zeroAreaEnd),
@@ -1061,6 +1159,10 @@ Buffer::Buffer(const Buffer& o)
       m_end(o.m_end)
 {
     m_data->m_count++;
+    if (m_payload != nullptr)
+    {
+        m_payload->m_count++;
+    }
     NS_ASSERT(CheckInternalState());
 }
 
@@ -24,7 +24,14 @@
 #include <limits>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+// Without the packet pool, the free list is shared by all the threads, so
+// it is only used when tags cannot be handled by several threads.
+#if !defined(NS3_MTP) || defined(NS3_PACKET_POOL)
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
@@ -43,7 +50,11 @@ NS_LOG_COMPONENT_DEFINE("ByteTagList");
 struct ByteTagListData
 {
     uint32_t size;   //!< size of the data
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; //!< use counter (for smart deallocation)
+#else
     uint32_t count;  //!< use counter (for smart deallocation)
+#endif
     uint32_t dirty;  //!< number of bytes actually in use
     uint8_t data[4]; //!< data
 };
@@ -56,13 +67,28 @@ struct ByteTagListData
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData*>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData*>
 {
   public:
     ~ByteTagListDataFreeList();
-} g_freeList; //!< Container for struct ByteTagListData
+};
 
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#ifdef NS3_MTP
+static thread_local ByteTagListDataFreeList g_freeList; //!< Container for struct ByteTagListData
+static thread_local uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+#else
+static ByteTagListDataFreeList g_freeList; //!< Container for struct ByteTagListData
+static uint32_t g_maxSize = 0;             //!< maximum data size (used for allocation)
+#endif
+#ifdef NS3_PACKET_POOL
+#ifdef NS3_MTP
+static thread_local uint64_t g_poolHits = 0;   //!< data allocated from the free list
+static thread_local uint64_t g_poolMisses = 0; //!< data allocated from the heap
+#else
+static uint64_t g_poolHits = 0;   //!< data allocated from the free list
+static uint64_t g_poolMisses = 0; //!< data allocated from the heap
+#endif
+#endif /* NS3_PACKET_POOL */
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList()
 {
@@ -169,6 +195,10 @@ ByteTagList::ByteTagList(const ByteTagList& o)
     {
         m_data->count++;
     }
+    else
+    {
+        std::memcpy(m_inline, o.m_inline, m_used);
+    }
 }
 
 ByteTagList&
@@ -189,6 +219,10 @@ ByteTagList::operator=(const ByteTagList& o)
     {
         m_data->count++;
     }
+    else
+    {
+        std::memcpy(m_inline, o.m_inline, m_used);
+    }
     return *this;
 }
 
@@ -208,17 +242,26 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
     NS_ASSERT(m_used <= spaceNeeded);
     if (m_data == nullptr)
     {
-        m_data = Allocate(spaceNeeded);
-        m_used = 0;
+        if (spaceNeeded > INLINE_SIZE)
+        {
+            // The tags outgrow the list itself
+            m_data = Allocate(spaceNeeded);
+            std::memcpy(&m_data->data, m_inline, m_used);
+        }
     }
+#ifdef NS3_MTP
+    else if (m_data->size < spaceNeeded || m_data->count != 1)
+#else
     else if (m_data->size < spaceNeeded || (m_data->count != 1 && m_data->dirty != m_used))
+#endif
     {
         struct ByteTagListData* newData = Allocate(spaceNeeded);
         std::memcpy(&newData->data, &m_data->data, m_used);
         Deallocate(m_data);
         m_data = newData;
     }
-    TagBuffer tag = TagBuffer(&m_data->data[m_used], &m_data->data[spaceNeeded]);
+    uint8_t* data = m_data == nullptr ? m_inline : m_data->data;
+    TagBuffer tag = TagBuffer(&data[m_used], &data[spaceNeeded]);
     tag.WriteU32(tid.GetUid());
     tag.WriteU32(bufferSize);
     tag.WriteU32(start - m_adjustment);
@@ -232,7 +275,10 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
         m_maxEnd = end - m_adjustment;
     }
     m_used = spaceNeeded;
-    m_data->dirty = m_used;
+    if (m_data != nullptr)
+    {
+        m_data->dirty = m_used;
+    }
     return tag;
 }
 
@@ -276,7 +322,9 @@ ByteTagList::Begin(int32_t offsetStart, int32_t offsetEnd) const
     NS_LOG_FUNCTION(this << offsetStart << offsetEnd);
     if (m_data == nullptr)
     {
-        return Iterator(nullptr, nullptr, offsetStart, offsetEnd, 0);
+        // The iterator does not write to the tags
+        auto data = const_cast<uint8_t*>(m_inline);
+        return Iterator(data, &data[m_used], offsetStart, offsetEnd, m_adjustment);
     }
     else
     {
@@ -364,11 +412,17 @@ ByteTagList::Allocate(uint32_t size)
         {
             data->count = 1;
             data->dirty = 0;
+#ifdef NS3_PACKET_POOL
+            g_poolHits++;
+#endif
             return data;
         }
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
     }
+#ifdef NS3_PACKET_POOL
+    g_poolMisses++;
+#endif
     uint8_t* buffer = new uint8_t[std::max(size, g_maxSize) + sizeof(struct ByteTagListData) - 4];
     struct ByteTagListData* data = (struct ByteTagListData*)buffer;
     data->count = 1;
@@ -386,8 +440,7 @@ ByteTagList::Deallocate(struct ByteTagListData* data)
         return;
     }
     g_maxSize = std::max(g_maxSize, data->size);
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
@@ -419,12 +472,11 @@ void
 ByteTagList::Deallocate(struct ByteTagListData* data)
 {
     NS_LOG_FUNCTION(this << data);
-    if (data == 0)
+    if (data == nullptr)
     {
         return;
     }
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
@@ -433,6 +485,18 @@ ByteTagList::Deallocate(struct ByteTagListData* data)
 
 #endif /* USE_FREE_LIST */
 
+void
+ByteTagList::GetPoolStats(uint64_t& hits, uint64_t& misses)
+{
+#ifdef NS3_PACKET_POOL
+    hits = g_poolHits;
+    misses = g_poolMisses;
+#else
+    hits = 0;
+    misses = 0;
+#endif
+}
+
 uint32_t
 ByteTagList::GetSerializedSize() const
 {
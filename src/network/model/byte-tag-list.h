@@ -51,6 +51,11 @@ struct ByteTagListData;
  *     is shared and, thus, reference-counted. This data structure is unshared
  *     as-needed to emulate COW semantics.
  *
+ *   - Most packets carry a few small tags, so the byte buffer starts in an
+ *     area of INLINE_SIZE bytes of the ByteTagList itself, which is copied
+ *     with the list rather than shared, and needs no allocation.  The tags
+ *     are moved to a struct ByteTagListData when they outgrow this area.
+ *
  *   - Each tag tags a unique set of bytes identified by the pair of offsets
  *     (start,end). These offsets are relative to the start of the packet
  *     Whenever the origin of the offset changes, the Packet adjusts all
@@ -65,6 +70,9 @@ struct ByteTagListData;
 class ByteTagList
 {
   public:
+    /** The size of the byte buffer of the tags stored in the list itself. */
+    static constexpr uint32_t INLINE_SIZE = 48;
+
     /**
      * \brief An iterator for iterating through a byte tag list
      *
@@ -262,6 +270,18 @@ class ByteTagList
      */
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
+    /**
+     * Get the usage statistics of the free list of the tag data.
+     *
+     * When ns-3 is built with \c NS3_MTP, each thread has its own free
+     * list, and the statistics are those of the calling thread.  They are
+     * zero if ns-3 is built without the \c NS3_PACKET_POOL option.
+     *
+     * \param [out] hits The number of data allocated from the free list.
+     * \param [out] misses The number of data allocated from the heap.
+     */
+    static void GetPoolStats(uint64_t& hits, uint64_t& misses);
+
   private:
     /**
      * \brief Returns an iterator pointing to the very first tag in this list.
@@ -288,6 +308,7 @@ class ByteTagList
     int32_t m_adjustment;           //!< adjustment to byte tag offsets
     uint32_t m_used;                //!< the number of used bytes in the buffer
     struct ByteTagListData* m_data; //!< the ByteTagListData structure
+    uint8_t m_inline[INLINE_SIZE];  //!< the buffer of the tags when m_data is null
 };
 
 void
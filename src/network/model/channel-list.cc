@@ -145,6 +145,11 @@ ChannelListPriv::Delete()
 {
     NS_LOG_FUNCTION_NOARGS();
     Config::UnregisterRootNamespaceObject(Get());
+    if (Simulator::IsBulkTeardown())
+    {
+        // The channels are left to the end of the process, without disposal
+        (*DoGet())->Ref();
+    }
     (*DoGet()) = nullptr;
 }
 
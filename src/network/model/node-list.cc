@@ -148,6 +148,11 @@ NodeListPriv::Delete()
 {
     NS_LOG_FUNCTION_NOARGS();
     Config::UnregisterRootNamespaceObject(Get());
+    if (Simulator::IsBulkTeardown())
+    {
+        // The nodes are left to the end of the process, without disposal
+        (*DoGet())->Ref();
+    }
     (*DoGet()) = nullptr;
 }
 
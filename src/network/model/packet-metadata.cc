@@ -25,6 +25,7 @@
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include <list>
 #include <utility>
@@ -37,9 +38,22 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
+bool PacketMetadata::m_lazy = false;
+uint32_t PacketMetadata::m_samplingPeriod = 1;
+Callback<uint64_t> PacketMetadata::m_flowKey;
+#ifdef NS3_MTP
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+std::atomic<uint16_t> PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+thread_local PacketMetadata::LogFreeList PacketMetadata::m_logFreeList;
+thread_local bool PacketMetadata::m_logFreeListDone = false;
+#else
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+PacketMetadata::LogFreeList PacketMetadata::m_logFreeList;
+bool PacketMetadata::m_logFreeListDone = false;
+#endif
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -65,12 +79,210 @@ PacketMetadata::Enable()
     m_enable = true;
 }
 
+PacketMetadata::LogFreeList::~LogFreeList()
+{
+    NS_LOG_FUNCTION(this);
+    for (iterator i = begin(); i != end(); i++)
+    {
+        delete *i;
+    }
+    PacketMetadata::m_logFreeListDone = true;
+}
+
 void
 PacketMetadata::EnableChecking()
 {
     NS_LOG_FUNCTION_NOARGS();
     Enable();
     m_enableChecking = true;
+    m_lazy = false;
+}
+
+void
+PacketMetadata::EnableLazy(bool lazy)
+{
+    NS_LOG_FUNCTION(lazy);
+    Enable();
+    m_lazy = lazy && !m_enableChecking;
+}
+
+void
+PacketMetadata::EnableSampling(uint32_t period, Callback<uint64_t> flowKey)
+{
+    NS_LOG_FUNCTION(period);
+    NS_ASSERT_MSG(period > 0, "The sampling period must be positive");
+    Enable();
+    m_samplingPeriod = period;
+    m_flowKey = flowKey;
+}
+
+bool
+PacketMetadata::IsFlowSampled()
+{
+    uint64_t key = m_flowKey.IsNull() ? Simulator::GetContext() : m_flowKey();
+    // splitmix64 finalizer, so that consecutive node ids are not sampled in step
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111eb;
+    key ^= key >> 31;
+    return key % m_samplingPeriod == 0;
+}
+
+bool
+PacketMetadata::IsRecording() const
+{
+    if (!m_enable)
+    {
+        m_metadataSkipped = true;
+        return false;
+    }
+    return m_sampled;
+}
+
+struct PacketMetadata::Log*
+PacketMetadata::CreateLog()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    struct PacketMetadata::Log* log;
+    if (m_logFreeList.empty())
+    {
+        log = new struct PacketMetadata::Log();
+    }
+    else
+    {
+        log = m_logFreeList.back();
+        m_logFreeList.pop_back();
+    }
+    log->m_count = 1;
+    log->m_dirtyEnd = 0;
+    return log;
+}
+
+void
+PacketMetadata::RecycleLog(struct PacketMetadata::Log* log)
+{
+    NS_LOG_FUNCTION(log);
+    NS_ASSERT(log->m_count == 0);
+    // may recycle the logs of the appended metadata
+    log->m_appended.clear();
+    if (m_logFreeListDone || m_logFreeList.size() > 1000)
+    {
+        delete log;
+    }
+    else
+    {
+        m_logFreeList.push_back(log);
+    }
+}
+
+void
+PacketMetadata::ReserveLog()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_log == nullptr)
+    {
+        m_log = CreateLog();
+        return;
+    }
+#ifdef NS3_MTP
+    // a copy of this metadata may be extended concurrently by another
+    // thread, so the dirty area is never shared.
+    if (m_log->m_count == 1)
+#else
+    if (m_log->m_count == 1 || m_log->m_dirtyEnd == m_logUsed)
+#endif
+    {
+        return;
+    }
+    struct PacketMetadata::Log* log = CreateLog();
+    for (uint16_t i = 0; i < m_logUsed; i++)
+    {
+        const Operation& operation = m_log->m_operations[i];
+        log->m_operations[i] = operation;
+        if (operation.type == ADD_AT_END)
+        {
+            NS_ASSERT(operation.uid == log->m_appended.size());
+            log->m_appended.push_back(m_log->m_appended[operation.uid]);
+        }
+    }
+    if (--m_log->m_count == 0)
+    {
+        RecycleLog(m_log);
+    }
+    m_log = log;
+}
+
+bool
+PacketMetadata::Defer(const Operation& operation)
+{
+    NS_LOG_FUNCTION(this << static_cast<uint32_t>(operation.type));
+    if (!m_lazy)
+    {
+        if (m_log != nullptr)
+        {
+            Materialize();
+        }
+        return false;
+    }
+    if (m_logUsed == LOG_SIZE)
+    {
+        Materialize();
+    }
+    ReserveLog();
+    m_log->m_operations[m_logUsed] = operation;
+    m_logUsed++;
+    m_log->m_dirtyEnd = m_logUsed;
+    return true;
+}
+
+void
+PacketMetadata::Materialize()
+{
+    NS_LOG_FUNCTION(this);
+    struct PacketMetadata::Log* log = m_log;
+    uint16_t used = m_logUsed;
+    m_log = nullptr;
+    m_logUsed = 0;
+    if (log == nullptr)
+    {
+        return;
+    }
+    for (uint16_t i = 0; i < used; i++)
+    {
+        const Operation& operation = log->m_operations[i];
+        switch (operation.type)
+        {
+        case ADD_HEADER:
+            ApplyAddHeader(operation.uid, operation.size, operation.chunkUid);
+            break;
+        case REMOVE_HEADER:
+            ApplyRemoveHeader(operation.uid, operation.size);
+            break;
+        case ADD_TRAILER:
+            ApplyAddTrailer(operation.uid, operation.size, operation.chunkUid);
+            break;
+        case REMOVE_TRAILER:
+            ApplyRemoveTrailer(operation.uid, operation.size);
+            break;
+        case ADD_AT_END: {
+            PacketMetadata o = log->m_appended[operation.uid];
+            o.Materialize();
+            ApplyAddAtEnd(o);
+            break;
+        }
+        case REMOVE_AT_START:
+            ApplyRemoveAtStart(operation.size);
+            break;
+        case REMOVE_AT_END:
+            ApplyRemoveAtEnd(operation.size);
+            break;
+        }
+    }
+    if (--log->m_count == 0)
+    {
+        RecycleLog(log);
+    }
 }
 
 void
@@ -80,8 +292,7 @@ PacketMetadata::ReserveCopy(uint32_t size)
     struct PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
     memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
@@ -104,8 +315,7 @@ PacketMetadata::Reserve(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     NS_ASSERT(m_data != nullptr);
-    if (m_data->m_size >= m_used + size &&
-        (m_head == 0xffff || m_data->m_count == 1 || m_data->m_dirtyEnd == m_used))
+    if (m_data->m_size >= m_used + size && IsAppendSafe())
     {
         /* enough room, not dirty. */
     }
@@ -116,6 +326,35 @@ PacketMetadata::Reserve(uint32_t size)
     }
 }
 
+bool
+PacketMetadata::IsAppendSafe() const
+{
+#ifdef NS3_MTP
+    // a copy of this metadata may be extended concurrently by another
+    // thread, so the dirty area is never shared.
+    return m_data->m_count == 1;
+#else
+    if (m_data->m_count == 1)
+    {
+        return true;
+    }
+    if (m_data->m_dirtyEnd != m_used)
+    {
+        return false;
+    }
+    if (m_head == 0xffff)
+    {
+        return true;
+    }
+    // the records linked to the new one must not be linked to others in
+    // the lists of the other instances, such as the records which this
+    // one removed from the end of its list without reclaiming them.
+    const uint8_t* tail = &m_data->m_data[m_tail];
+    const uint8_t* head = &m_data->m_data[m_head];
+    return (tail[0] & tail[1]) == 0xff && (head[2] & head[3]) == 0xff;
+#endif
+}
+
 bool
 PacketMetadata::IsSharedPointerOk(uint16_t pointer) const
 {
@@ -384,8 +623,7 @@ PacketMetadata::AddSmall(const struct PacketMetadata::SmallItem* item)
     uint32_t typeUidSize = GetUleb128Size(item->typeUid);
     uint32_t sizeSize = GetUleb128Size(item->size);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2;
-    if (m_used + n > m_data->m_size ||
-        (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+    if (m_used + n > m_data->m_size || !IsAppendSafe())
     {
         ReserveCopy(n);
     }
@@ -421,8 +659,7 @@ PacketMetadata::AddBig(uint32_t next,
     uint32_t fragEndSize = GetUleb128Size(extraItem->fragmentEnd);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
-    if (m_used + n > m_data->m_size ||
-        (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
+    if (m_used + n > m_data->m_size || !IsAppendSafe())
     {
         ReserveCopy(n);
     }
@@ -659,19 +896,27 @@ void
 PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
 {
     NS_LOG_FUNCTION(this << uid << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
+    uint16_t chunkUid = m_chunkUid++;
+    if (!Defer({ADD_HEADER, chunkUid, uid, size}))
+    {
+        ApplyAddHeader(uid, size, chunkUid);
+    }
+}
 
+void
+PacketMetadata::ApplyAddHeader(uint32_t uid, uint32_t size, uint16_t chunkUid)
+{
+    NS_LOG_FUNCTION(this << uid << size << chunkUid);
     struct PacketMetadata::SmallItem item;
     item.next = m_head;
     item.prev = 0xffff;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = chunkUid;
     uint16_t written = AddSmall(&item);
     UpdateHead(written);
 }
@@ -681,11 +926,16 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
 {
     uint32_t uid = header.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &header << size);
-    if (!m_enable)
+    if (IsRecording() && !Defer({REMOVE_HEADER, 0, uid, size}))
     {
-        m_metadataSkipped = true;
-        return;
+        ApplyRemoveHeader(uid, size);
     }
+}
+
+void
+PacketMetadata::ApplyRemoveHeader(uint32_t uid, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << uid << size);
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_head, &item, &extraItem);
@@ -726,18 +976,27 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
+    uint16_t chunkUid = m_chunkUid++;
+    if (!Defer({ADD_TRAILER, chunkUid, uid, size}))
+    {
+        ApplyAddTrailer(uid, size, chunkUid);
+    }
+}
+
+void
+PacketMetadata::ApplyAddTrailer(uint32_t uid, uint32_t size, uint16_t chunkUid)
+{
+    NS_LOG_FUNCTION(this << uid << size << chunkUid);
     struct PacketMetadata::SmallItem item;
     item.next = 0xffff;
     item.prev = m_tail;
     item.typeUid = uid;
     item.size = size;
-    item.chunkUid = m_chunkUid;
-    m_chunkUid++;
+    item.chunkUid = chunkUid;
     uint16_t written = AddSmall(&item);
     UpdateTail(written);
     NS_ASSERT(IsStateOk());
@@ -748,11 +1007,16 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (IsRecording() && !Defer({REMOVE_TRAILER, 0, uid, size}))
     {
-        m_metadataSkipped = true;
-        return;
+        ApplyRemoveTrailer(uid, size);
     }
+}
+
+void
+PacketMetadata::ApplyRemoveTrailer(uint32_t uid, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << uid << size);
     struct PacketMetadata::SmallItem item;
     struct PacketMetadata::ExtraItem extraItem;
     uint32_t read = ReadItems(m_tail, &item, &extraItem);
@@ -792,11 +1056,48 @@ void
 PacketMetadata::AddAtEnd(const PacketMetadata& o)
 {
     NS_LOG_FUNCTION(this << &o);
-    if (!m_enable)
+    if (!IsRecording())
     {
-        m_metadataSkipped = true;
         return;
     }
+    // whether there are items left, which o does not replace, is only
+    // known once the pending operations are applied.
+    Materialize();
+    if (m_tail == 0xffff)
+    {
+        *this = o;
+        return;
+    }
+    if (!o.m_sampled)
+    {
+        // the items would not describe the bytes of o
+        m_head = 0xffff;
+        m_tail = 0xffff;
+        m_sampled = false;
+        return;
+    }
+    if (m_lazy || o.m_log != nullptr)
+    {
+        // copied first, as o may be this metadata
+        PacketMetadata appended = o;
+        if (Defer({ADD_AT_END, 0, 0, 0}))
+        {
+            m_log->m_appended.push_back(appended);
+            return;
+        }
+        // recorded lazily before the metadata stopped being lazy
+        appended.Materialize();
+        ApplyAddAtEnd(appended);
+        return;
+    }
+    ApplyAddAtEnd(o);
+}
+
+void
+PacketMetadata::ApplyAddAtEnd(const PacketMetadata& o)
+{
+    NS_LOG_FUNCTION(this << &o);
+    NS_ASSERT(o.m_log == nullptr);
     if (m_tail == 0xffff)
     {
         // We have no items so 'AddAtEnd' is
@@ -879,11 +1180,16 @@ void
 PacketMetadata::RemoveAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
-    if (!m_enable)
+    if (IsRecording() && !Defer({REMOVE_AT_START, 0, 0, start}))
     {
-        m_metadataSkipped = true;
-        return;
+        ApplyRemoveAtStart(start);
     }
+}
+
+void
+PacketMetadata::ApplyRemoveAtStart(uint32_t start)
+{
+    NS_LOG_FUNCTION(this << start);
     NS_ASSERT(m_data != nullptr);
     uint32_t leftToRemove = start;
     uint16_t current = m_head;
@@ -911,6 +1217,7 @@ PacketMetadata::RemoveAtStart(uint32_t start)
         {
             // fragment the list item.
             PacketMetadata fragment(m_packetUid, 0);
+            fragment.m_sampled = m_sampled;
             extraItem.fragmentStart += leftToRemove;
             leftToRemove = 0;
             uint16_t written = fragment.AddBig(0xffff, fragment.m_tail, &item, &extraItem);
@@ -940,11 +1247,16 @@ void
 PacketMetadata::RemoveAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (IsRecording() && !Defer({REMOVE_AT_END, 0, 0, end}))
     {
-        m_metadataSkipped = true;
-        return;
+        ApplyRemoveAtEnd(end);
     }
+}
+
+void
+PacketMetadata::ApplyRemoveAtEnd(uint32_t end)
+{
+    NS_LOG_FUNCTION(this << end);
     NS_ASSERT(m_data != nullptr);
 
     uint32_t leftToRemove = end;
@@ -973,6 +1285,7 @@ PacketMetadata::RemoveAtEnd(uint32_t end)
         {
             // fragment the list item.
             PacketMetadata fragment(m_packetUid, 0);
+            fragment.m_sampled = m_sampled;
             NS_ASSERT(extraItem.fragmentEnd > leftToRemove);
             extraItem.fragmentEnd -= leftToRemove;
             leftToRemove = 0;
@@ -1037,13 +1350,14 @@ PacketMetadata::BeginItem(Buffer buffer) const
 }
 
 PacketMetadata::ItemIterator::ItemIterator(const PacketMetadata* metadata, Buffer buffer)
-    : m_metadata(metadata),
+    : m_metadata(*metadata),
       m_buffer(buffer),
-      m_current(metadata->m_head),
       m_offset(0),
       m_hasReadTail(false)
 {
     NS_LOG_FUNCTION(this << metadata << &buffer);
+    m_metadata.Materialize();
+    m_current = m_metadata.m_head;
 }
 
 bool
@@ -1068,8 +1382,8 @@ PacketMetadata::ItemIterator::Next()
     struct PacketMetadata::Item item;
     struct PacketMetadata::SmallItem smallItem;
     struct PacketMetadata::ExtraItem extraItem;
-    m_metadata->ReadItems(m_current, &smallItem, &extraItem);
-    if (m_current == m_metadata->m_tail)
+    m_metadata.ReadItems(m_current, &smallItem, &extraItem);
+    if (m_current == m_metadata.m_tail)
     {
         m_hasReadTail = true;
     }
@@ -1123,6 +1437,12 @@ uint32_t
 PacketMetadata::GetSerializedSize() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_log != nullptr)
+    {
+        PacketMetadata materialized = *this;
+        materialized.Materialize();
+        return materialized.GetSerializedSize();
+    }
     uint32_t totalSize = 0;
 
     // add 8 bytes for the packet uid
@@ -1168,6 +1488,12 @@ uint32_t
 PacketMetadata::Serialize(uint8_t* buffer, uint32_t maxSize) const
 {
     NS_LOG_FUNCTION(this << &buffer << maxSize);
+    if (m_log != nullptr)
+    {
+        PacketMetadata materialized = *this;
+        materialized.Materialize();
+        return materialized.Serialize(buffer, maxSize);
+    }
     uint8_t* start = buffer;
 
     buffer = AddToRawU64(m_packetUid, start, buffer, maxSize);
@@ -1327,6 +1653,11 @@ PacketMetadata::Deserialize(const uint8_t* buffer, uint32_t size)
         uint32_t tmp = AddBig(0xffff, m_tail, &item, &extraItem);
         UpdateTail(tmp);
     }
+    if (m_samplingPeriod != 1)
+    {
+        // the packets of the flows not sampled are serialized without items
+        m_sampled = m_head != 0xffff;
+    }
     NS_ASSERT(desSize == 0);
     return (desSize != 0) ? 0 : 1;
 }
@@ -29,6 +29,10 @@
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -76,6 +80,18 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * When the metadata is recorded lazily, see EnableLazy(), the
+ * operations performed on the packet are not applied to the linked
+ * list: each PacketMetadata appends them to a log of fixed-size
+ * records, shared between its copies as the data buffer is, and the
+ * linked list is only built from the log when the items are read, by
+ * BeginItem() or the serialization, or when the log is full. The
+ * packets which are never printed thus never pay for the linked list.
+ *
+ * The metadata can also be recorded for a sample of the flows only,
+ * see EnableSampling(): the other packets record no items, as if the
+ * metadata was not enabled.
  */
 class PacketMetadata
 {
@@ -130,36 +146,7 @@ class PacketMetadata
         Buffer::Iterator current;
     };
 
-    /**
-     * \brief Iterator class for metadata items.
-     */
-    class ItemIterator
-    {
-      public:
-        /**
-         * \brief Constructor
-         * \param metadata a pointer to the metadata
-         * \param buffer the buffer the metadata refers to
-         */
-        ItemIterator(const PacketMetadata* metadata, Buffer buffer);
-        /**
-         * \brief Checks if there is another metadata item
-         * \returns true if there is another item
-         */
-        bool HasNext() const;
-        /**
-         * \brief Retrieve the next metadata item
-         * \returns the next metadata item
-         */
-        Item Next();
-
-      private:
-        const PacketMetadata* m_metadata; //!< pointer to the metadata
-        Buffer m_buffer;                  //!< buffer the metadata refers to
-        uint16_t m_current;               //!< current position
-        uint32_t m_offset;                //!< offset
-        bool m_hasReadTail;               //!< true if the metadata tail has been read
-    };
+    class ItemIterator;
 
     /**
      * \brief Enable the packet metadata
@@ -167,8 +154,35 @@ class PacketMetadata
     static void Enable();
     /**
      * \brief Enable the packet metadata checking
+     *
+     * The checked metadata is never recorded lazily.
      */
     static void EnableChecking();
+    /**
+     * \brief Enable the packet metadata, recorded lazily or not
+     *
+     * The operations on the packets recorded lazily are only applied
+     * to their items when these are read.
+     *
+     * \param lazy whether to record the metadata lazily
+     */
+    static void EnableLazy(bool lazy = true);
+    /**
+     * \brief Enable the packet metadata for a sample of the flows
+     *
+     * The flow of a packet is given by \p flowKey when the packet is
+     * created, by default the context of the simulation, which is the id
+     * of the node which creates it. The metadata of one flow in \p period
+     * on average, picked by a hash of the flow key, is recorded; the
+     * other packets have no items, and a packet which appends one of
+     * them loses its own items.
+     *
+     * \param period the average number of flows per recorded flow;
+     *        1 records the metadata of every packet
+     * \param flowKey the callback which returns the flow of a new packet
+     */
+    static void EnableSampling(uint32_t period,
+                               Callback<uint64_t> flowKey = MakeNullCallback<uint64_t>());
 
     /**
      * \brief Constructor
@@ -426,7 +440,11 @@ class PacketMetadata
     struct Data
     {
         /** number of references to this struct Data instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /** size (in bytes) of m_data buffer below */
         uint16_t m_size;
         /** max of the m_used field over all objects which reference this struct Data instance */
@@ -518,7 +536,70 @@ class PacketMetadata
         ~DataFreeList();
     };
 
+    /**
+     * The maximum number of operations in the log of a lazy metadata,
+     * beyond which they are applied to its items.
+     */
+    static constexpr uint16_t LOG_SIZE = 32;
+
+    /**
+     * \brief The type of an operation recorded by a lazy metadata
+     */
+    enum OperationType : uint8_t
+    {
+        ADD_HEADER,      //!< AddHeader()
+        REMOVE_HEADER,   //!< RemoveHeader()
+        ADD_TRAILER,     //!< AddTrailer()
+        REMOVE_TRAILER,  //!< RemoveTrailer()
+        ADD_AT_END,      //!< AddAtEnd()
+        REMOVE_AT_START, //!< RemoveAtStart()
+        REMOVE_AT_END    //!< RemoveAtEnd()
+    };
+
+    /**
+     * \brief An operation recorded by a lazy metadata
+     */
+    struct Operation
+    {
+        OperationType type; //!< the operation
+        uint16_t chunkUid;  //!< the chunk uid of an added header or trailer
+        /** the type uid of a header or trailer, or the index of the
+            metadata appended in Log::m_appended. */
+        uint32_t uid;
+        /** the size of a header or trailer, or the number of bytes removed. */
+        uint32_t size;
+    };
+
+    /**
+     * \brief The log of the operations of a lazy metadata
+     */
+    struct Log
+    {
+        /** number of references to this struct Log instance. */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
+        uint32_t m_count;
+#endif
+        /** max of the m_logUsed field over all objects which reference this struct Log instance */
+        uint16_t m_dirtyEnd;
+        /** the operations */
+        Operation m_operations[LOG_SIZE];
+        /** the metadata appended by the ADD_AT_END operations */
+        std::vector<PacketMetadata> m_appended;
+    };
+
+    /**
+     * \brief Class to hold the unused logs
+     */
+    class LogFreeList : public std::vector<struct Log*>
+    {
+      public:
+        ~LogFreeList();
+    };
+
     friend DataFreeList::~DataFreeList();
+    friend LogFreeList::~LogFreeList();
     /// Friend class
     friend class ItemIterator;
 
@@ -634,6 +715,75 @@ class PacketMetadata
      * \param size header serialized size
      */
     void DoAddHeader(uint32_t uid, uint32_t size);
+    /**
+     * \brief Check if the operations on the packet are recorded
+     * \returns true if the metadata is enabled and the packet sampled
+     */
+    bool IsRecording() const;
+    /**
+     * \brief Log an operation if the metadata is lazy
+     *
+     * The operations pending in the log are applied first if the
+     * metadata is not lazy any more.
+     *
+     * \param operation the operation
+     * \returns true if the operation was logged, false if it must be applied
+     */
+    bool Defer(const Operation& operation);
+    /**
+     * \brief Apply the operations pending in the log
+     */
+    void Materialize();
+    /**
+     * \brief Make the log writable at m_logUsed, copying it if needed
+     */
+    void ReserveLog();
+    /**
+     * \brief Add an header to the items
+     * \param uid header's uid to add
+     * \param size header serialized size
+     * \param chunkUid the chunk uid of the header
+     */
+    void ApplyAddHeader(uint32_t uid, uint32_t size, uint16_t chunkUid);
+    /**
+     * \brief Remove an header from the items
+     * \param uid header's uid to remove
+     * \param size header serialized size
+     */
+    void ApplyRemoveHeader(uint32_t uid, uint32_t size);
+    /**
+     * \brief Add a trailer to the items
+     * \param uid trailer's uid to add
+     * \param size trailer serialized size
+     * \param chunkUid the chunk uid of the trailer
+     */
+    void ApplyAddTrailer(uint32_t uid, uint32_t size, uint16_t chunkUid);
+    /**
+     * \brief Remove a trailer from the items
+     * \param uid trailer's uid to remove
+     * \param size trailer serialized size
+     */
+    void ApplyRemoveTrailer(uint32_t uid, uint32_t size);
+    /**
+     * \brief Add the items of a metadata without pending operations
+     * \param o the metadata to add
+     */
+    void ApplyAddAtEnd(const PacketMetadata& o);
+    /**
+     * \brief Remove a chunk of the items at their start
+     * \param start the size of metadata to remove
+     */
+    void ApplyRemoveAtStart(uint32_t start);
+    /**
+     * \brief Remove a chunk of the items at their end
+     * \param end the size of metadata to remove
+     */
+    void ApplyRemoveAtEnd(uint32_t end);
+    /**
+     * \brief Check if a new packet is in a sampled flow
+     * \returns true if the metadata of the packet must be recorded
+     */
+    static bool IsFlowSampled();
     /**
      * \brief Check if the metadata state is ok
      * \returns true if the internal state is ok
@@ -651,6 +801,12 @@ class PacketMetadata
      * \returns true if the position is valid
      */
     bool IsSharedPointerOk(uint16_t pointer) const;
+    /**
+     * \brief Check if new records can be written in place at the end
+     * of the shared data, without affecting other PacketMetadata instances
+     * \returns true if the data can be written in place
+     */
+    bool IsAppendSafe() const;
 
     /**
      * \brief Recycle the buffer memory
@@ -674,10 +830,31 @@ class PacketMetadata
      * \param data the buffer data storage
      */
     static void Deallocate(struct PacketMetadata::Data* data);
+    /**
+     * \brief Create a log
+     * \returns a log with a single reference and no operations
+     */
+    static struct PacketMetadata::Log* CreateLog();
+    /**
+     * \brief Recycle a log which is not referenced any more
+     * \param log the log
+     */
+    static void RecycleLog(struct PacketMetadata::Log* log);
 
-    static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+#ifdef NS3_MTP
+    static thread_local DataFreeList m_freeList;   //!< the metadata data storage
+    static thread_local LogFreeList m_logFreeList; //!< the unused logs
+    static thread_local bool m_logFreeListDone;    //!< m_logFreeList was destroyed
+#else
+    static DataFreeList m_freeList;   //!< the metadata data storage
+    static LogFreeList m_logFreeList; //!< the unused logs
+    static bool m_logFreeListDone;    //!< m_logFreeList was destroyed
+#endif
+    static bool m_enable;                 //!< Enable the packet metadata
+    static bool m_enableChecking;         //!< Enable the packet metadata checking
+    static bool m_lazy;                   //!< Record the packet metadata lazily
+    static uint32_t m_samplingPeriod;     //!< The average number of flows per sampled flow
+    static Callback<uint64_t> m_flowKey; //!< The flow of a new packet
 
     /**
      * Set to true when adding metadata to a packet is skipped because
@@ -686,8 +863,13 @@ class PacketMetadata
      */
     static bool m_metadataSkipped;
 
+#ifdef NS3_MTP
+    static thread_local uint32_t m_maxSize; //!< maximum metadata size
+    static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
+#else
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
     struct Data* m_data; //!< Metadata storage
     /*
@@ -698,7 +880,44 @@ class PacketMetadata
     uint16_t m_head;      //!< list head
     uint16_t m_tail;      //!< list tail
     uint16_t m_used;      //!< used portion
+    uint16_t m_logUsed;   //!< number of operations of m_log pending
     uint64_t m_packetUid; //!< packet Uid
+    struct Log* m_log;    //!< operations pending, or nullptr
+    bool m_sampled;       //!< the metadata of the packet is recorded
+};
+
+/**
+ * \brief Iterator class for metadata items.
+ *
+ * The iterator holds a copy of the metadata, with its pending
+ * operations applied.
+ */
+class PacketMetadata::ItemIterator
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param metadata a pointer to the metadata
+     * \param buffer the buffer the metadata refers to
+     */
+    ItemIterator(const PacketMetadata* metadata, Buffer buffer);
+    /**
+     * \brief Checks if there is another metadata item
+     * \returns true if there is another item
+     */
+    bool HasNext() const;
+    /**
+     * \brief Retrieve the next metadata item
+     * \returns the next metadata item
+     */
+    Item Next();
+
+  private:
+    PacketMetadata m_metadata; //!< the metadata, without pending operations
+    Buffer m_buffer;           //!< buffer the metadata refers to
+    uint16_t m_current;        //!< current position
+    uint32_t m_offset;         //!< offset
+    bool m_hasReadTail;        //!< true if the metadata tail has been read
 };
 
 } // namespace ns3
@@ -711,7 +930,10 @@ PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
-      m_packetUid(uid)
+      m_logUsed(0),
+      m_packetUid(uid),
+      m_log(nullptr),
+      m_sampled(m_samplingPeriod == 1 || IsFlowSampled())
 {
     memset(m_data->m_data, 0xff, 4);
     if (size > 0)
@@ -725,11 +947,18 @@ PacketMetadata::PacketMetadata(const PacketMetadata& o)
       m_head(o.m_head),
       m_tail(o.m_tail),
       m_used(o.m_used),
-      m_packetUid(o.m_packetUid)
+      m_logUsed(o.m_logUsed),
+      m_packetUid(o.m_packetUid),
+      m_log(o.m_log),
+      m_sampled(o.m_sampled)
 {
     NS_ASSERT(m_data != nullptr);
     NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
     m_data->m_count++;
+    if (m_log != nullptr)
+    {
+        m_log->m_count++;
+    }
 }
 
 PacketMetadata&
@@ -739,8 +968,7 @@ PacketMetadata::operator=(const PacketMetadata& o)
     {
         // not self assignment
         NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             PacketMetadata::Recycle(m_data);
         }
@@ -748,21 +976,38 @@ PacketMetadata::operator=(const PacketMetadata& o)
         NS_ASSERT(m_data != nullptr);
         m_data->m_count++;
     }
+    if (m_log != o.m_log)
+    {
+        if (m_log != nullptr && --m_log->m_count == 0)
+        {
+            PacketMetadata::RecycleLog(m_log);
+        }
+        m_log = o.m_log;
+        if (m_log != nullptr)
+        {
+            m_log->m_count++;
+        }
+    }
     m_head = o.m_head;
     m_tail = o.m_tail;
     m_used = o.m_used;
+    m_logUsed = o.m_logUsed;
     m_packetUid = o.m_packetUid;
+    m_sampled = o.m_sampled;
     return *this;
 }
 
 PacketMetadata::~PacketMetadata()
 {
     NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (--m_data->m_count == 0)
     {
         PacketMetadata::Recycle(m_data);
     }
+    if (m_log != nullptr && --m_log->m_count == 0)
+    {
+        PacketMetadata::RecycleLog(m_log);
+    }
 }
 
 } // namespace ns3
@@ -37,6 +37,178 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+#ifdef NS3_PACKET_POOL
+namespace
+{
+
+/** Granularity of the size classes of the TagData pool, in bytes. */
+constexpr std::size_t POOL_GRANULARITY = 16;
+/** Number of size classes; larger TagData blocks are not pooled. */
+constexpr std::size_t POOL_CLASSES = 8;
+/** Maximum number of free blocks kept per size class. */
+constexpr uint32_t POOL_MAX_FREE = 4096;
+
+/** A free block of the pool. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block of the same size class.
+};
+
+/**
+ * \ingroup packet
+ * The pool of the TagData blocks.
+ *
+ * The pool is trivially destructible, so that tags released during the
+ * destruction of static objects can still safely reach it; the free
+ * blocks are released by TagDataPoolDestructor.
+ */
+struct TagDataPool
+{
+    FreeBlock* freeList[POOL_CLASSES]; //!< Free blocks, per size class.
+    uint32_t length[POOL_CLASSES];     //!< Number of free blocks, per size class.
+    bool registered;                   //!< Whether the destructor is registered.
+    bool destroyed;                    //!< Whether the free blocks were released.
+    uint64_t hits;                     //!< Blocks allocated from a free list.
+    uint64_t misses;                   //!< Blocks allocated from the heap.
+};
+
+/** Release the free blocks of the pool at exit. */
+struct TagDataPoolDestructor
+{
+    ~TagDataPoolDestructor();
+};
+
+#ifdef NS3_MTP
+thread_local TagDataPool g_tagDataPool;                     //!< The pool of the thread
+thread_local TagDataPoolDestructor g_tagDataPoolDestructor; //!< Its destructor
+#else
+TagDataPool g_tagDataPool;                     //!< The pool
+TagDataPoolDestructor g_tagDataPoolDestructor; //!< Its destructor
+#endif
+
+TagDataPoolDestructor::~TagDataPoolDestructor()
+{
+    for (std::size_t i = 0; i < POOL_CLASSES; ++i)
+    {
+        while (g_tagDataPool.freeList[i] != nullptr)
+        {
+            FreeBlock* block = g_tagDataPool.freeList[i];
+            g_tagDataPool.freeList[i] = block->next;
+            std::free(block);
+        }
+        g_tagDataPool.length[i] = 0;
+    }
+    g_tagDataPool.destroyed = true;
+}
+
+/**
+ * Get the size class of a TagData block.
+ * \param [in] size The size of the block.
+ * \returns The size class; POOL_CLASSES if the block is not pooled.
+ */
+inline std::size_t
+GetSizeClass(std::size_t size)
+{
+    std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+    return sizeClass < POOL_CLASSES ? sizeClass : POOL_CLASSES;
+}
+
+} // unnamed namespace
+#endif /* NS3_PACKET_POOL */
+
+namespace
+{
+
+/**
+ * \ingroup packet
+ * Get the serialized size of a tag of a PacketTagList.
+ * \param [in] dataSize The size of the tag data.
+ * \returns The size of the tag, with its size and the hash of its TypeId.
+ */
+inline uint32_t
+GetTagSerializedSize(uint32_t dataSize)
+{
+    // TypeId hash and tag data; ensure sizes are multiples of 4 bytes
+    uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
+    uint32_t tagWordSize = (dataSize + 3) & (~3);
+    return 4 + hashSize + tagWordSize;
+}
+
+/**
+ * \ingroup packet
+ * Serialize a tag of a PacketTagList.
+ * \param [in] tid The type of the tag.
+ * \param [in] data The tag data.
+ * \param [in] dataSize The size of the tag data.
+ * \param [in,out] p The position in the byte buffer.
+ * \param [in,out] size The number of bytes written to the byte buffer.
+ * \param [in] maxSize The size of the byte buffer.
+ * \returns \c false if the byte buffer is too small.
+ */
+bool
+SerializeTag(TypeId tid,
+             const uint8_t* data,
+             uint32_t dataSize,
+             uint32_t*& p,
+             uint32_t& size,
+             uint32_t maxSize)
+{
+    if (size + 4 <= maxSize)
+    {
+        *p++ = dataSize;
+        size += 4;
+    }
+    else
+    {
+        return false;
+    }
+
+    NS_LOG_INFO("Serializing tag id " << tid);
+
+    // ensure size is multiple of 4 bytes for 4 byte boundaries
+    uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
+    if (size + hashSize <= maxSize)
+    {
+        TypeId::hash_t hash = tid.GetHash();
+        memcpy(p, &hash, sizeof(TypeId::hash_t));
+        p += hashSize / 4;
+        size += hashSize;
+    }
+    else
+    {
+        return false;
+    }
+
+    // ensure size is multiple of 4 bytes for 4 byte boundaries
+    uint32_t tagWordSize = (dataSize + 3) & (~3);
+    if (size + tagWordSize <= maxSize)
+    {
+        memcpy(p, data, dataSize);
+        size += tagWordSize;
+        p += tagWordSize / 4;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+std::size_t
+PacketTagList::FindInline(TypeId tid) const
+{
+    // All the slots are compared, so that the slot is selected without
+    // a branch on the types
+    std::size_t slot = INLINE_TAGS;
+    for (std::size_t i = INLINE_TAGS; i-- > 0;)
+    {
+        slot = m_inline.tid[i] == tid ? i : slot;
+    }
+    return slot;
+}
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -44,14 +216,82 @@ PacketTagList::CreateTagData(size_t dataSize)
                   "Requested TagData size " << dataSize << " exceeds maximum "
                                             << std::numeric_limits<decltype(TagData::size)>::max());
 
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
-    // The matching frees are in RemoveAll and RemoveWriter
+    std::size_t size = sizeof(TagData) + dataSize - 1;
+    void* p = nullptr;
+#ifdef NS3_PACKET_POOL
+    TagDataPool& pool = g_tagDataPool;
+    std::size_t sizeClass = GetSizeClass(size);
+    if (sizeClass < POOL_CLASSES && pool.freeList[sizeClass] != nullptr)
+    {
+        FreeBlock* block = pool.freeList[sizeClass];
+        pool.freeList[sizeClass] = block->next;
+        pool.length[sizeClass]--;
+        pool.hits++;
+        p = block;
+    }
+    else
+    {
+        if (!pool.registered)
+        {
+            // The destructor of a thread_local object is only registered
+            // when the object is first used by the thread.
+            (void)&g_tagDataPoolDestructor;
+            pool.registered = true;
+        }
+        pool.misses++;
+        if (sizeClass < POOL_CLASSES)
+        {
+            // The whole size class is allocated so that the block can be
+            // reused by any tag of the class.
+            size = (sizeClass + 1) * POOL_GRANULARITY;
+        }
+        p = std::malloc(size);
+    }
+#else
+    p = std::malloc(size);
+#endif
+    // The matching releases are in FreeTagData
 
     TagData* tag = new (p) TagData;
     tag->size = dataSize;
     return tag;
 }
 
+void
+PacketTagList::FreeTagData(TagData* tag)
+{
+#ifdef NS3_PACKET_POOL
+    TagDataPool& pool = g_tagDataPool;
+    std::size_t sizeClass = GetSizeClass(sizeof(TagData) + tag->size - 1);
+    tag->~TagData();
+    if (sizeClass == POOL_CLASSES || !pool.registered || pool.destroyed ||
+        pool.length[sizeClass] >= POOL_MAX_FREE)
+    {
+        std::free(tag);
+        return;
+    }
+    auto block = reinterpret_cast<FreeBlock*>(tag);
+    block->next = pool.freeList[sizeClass];
+    pool.freeList[sizeClass] = block;
+    pool.length[sizeClass]++;
+#else
+    tag->~TagData();
+    std::free(tag);
+#endif
+}
+
+void
+PacketTagList::GetPoolStats(uint64_t& hits, uint64_t& misses)
+{
+#ifdef NS3_PACKET_POOL
+    hits = g_tagDataPool.hits;
+    misses = g_tagDataPool.misses;
+#else
+    hits = 0;
+    misses = 0;
+#endif
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -175,6 +415,14 @@ PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 bool
 PacketTagList::Remove(Tag& tag)
 {
+    std::size_t slot = FindInline(tag.GetInstanceTypeId());
+    if (slot < INLINE_TAGS)
+    {
+        uint8_t* data = m_inline.data[slot];
+        tag.Deserialize(TagBuffer(data, data + m_inline.size[slot]));
+        m_inline.tid[slot] = TypeId();
+        return true;
+    }
     return COWTraverse(tag, &PacketTagList::RemoveWriter);
 }
 
@@ -195,8 +443,7 @@ PacketTagList::RemoveWriter(Tag& tag,
     if (preMerge)
     {
         // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
+        FreeTagData(cur);
     }
     else
     {
@@ -215,6 +462,21 @@ PacketTagList::RemoveWriter(Tag& tag,
 bool
 PacketTagList::Replace(Tag& tag)
 {
+    std::size_t slot = FindInline(tag.GetInstanceTypeId());
+    if (slot < INLINE_TAGS)
+    {
+        uint32_t size = tag.GetSerializedSize();
+        if (size > INLINE_TAG_SIZE)
+        {
+            m_inline.tid[slot] = TypeId();
+            Add(tag);
+            return true;
+        }
+        uint8_t* data = m_inline.data[slot];
+        m_inline.size[slot] = size;
+        tag.Serialize(TagBuffer(data, data + size));
+        return true;
+    }
     bool found = COWTraverse(tag, &PacketTagList::ReplaceWriter);
     if (!found)
     {
@@ -261,21 +523,36 @@ PacketTagList::ReplaceWriter(Tag& tag,
 void
 PacketTagList::Add(const Tag& tag) const
 {
-    NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
     // ensure this id was not yet added
+    NS_ASSERT_MSG(FindInline(tid) == INLINE_TAGS, "Error: cannot add the same kind of tag twice.");
     for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        NS_ASSERT_MSG(cur->tid != tag.GetInstanceTypeId(),
-                      "Error: cannot add the same kind of tag twice.");
+        NS_ASSERT_MSG(cur->tid != tid, "Error: cannot add the same kind of tag twice.");
+    }
+    auto self = const_cast<PacketTagList*>(this);
+    uint32_t size = tag.GetSerializedSize();
+    if (size <= INLINE_TAG_SIZE)
+    {
+        std::size_t slot = FindInline(TypeId());
+        if (slot < INLINE_TAGS)
+        {
+            uint8_t* data = self->m_inline.data[slot];
+            self->m_inline.tid[slot] = tid;
+            self->m_inline.size[slot] = size;
+            tag.Serialize(TagBuffer(data, data + size));
+            return;
+        }
     }
-    struct TagData* head = CreateTagData(tag.GetSerializedSize());
+    struct TagData* head = CreateTagData(size);
     head->count = 1;
     head->next = nullptr;
-    head->tid = tag.GetInstanceTypeId();
+    head->tid = tid;
     head->next = m_next;
     tag.Serialize(TagBuffer(head->data, head->data + head->size));
 
-    const_cast<PacketTagList*>(this)->m_next = head;
+    self->m_next = head;
 }
 
 bool
@@ -283,6 +560,13 @@ PacketTagList::Peek(Tag& tag) const
 {
     NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
     TypeId tid = tag.GetInstanceTypeId();
+    std::size_t slot = FindInline(tid);
+    if (slot < INLINE_TAGS)
+    {
+        auto data = const_cast<uint8_t*>(m_inline.data[slot]);
+        tag.Deserialize(TagBuffer(data, data + m_inline.size[slot]));
+        return true;
+    }
     for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
         if (cur->tid == tid)
@@ -311,17 +595,16 @@ PacketTagList::GetSerializedSize() const
 
     size = 4; // numberOfTags
 
+    for (std::size_t slot = 0; slot < INLINE_TAGS; ++slot)
+    {
+        if (m_inline.tid[slot] != TypeId())
+        {
+            size += GetTagSerializedSize(m_inline.size[slot]);
+        }
+    }
     for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        size += 4; // TagData -> size
-
-        // TypeId hash; ensure size is multiple of 4 bytes
-        uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
-        size += hashSize;
-
-        // TagData -> data; ensure size is multiple of 4 bytes
-        uint32_t tagWordSize = (cur->size + 3) & (~3);
-        size += tagWordSize;
+        size += GetTagSerializedSize(cur->size);
     }
 
     return size;
@@ -348,47 +631,29 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
         return 0;
     }
 
-    for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (std::size_t slot = 0; slot < INLINE_TAGS; ++slot)
     {
-        if (size + 4 <= maxSize)
-        {
-            *p++ = cur->size;
-            size += 4;
-        }
-        else
+        if (m_inline.tid[slot] == TypeId())
         {
-            return 0;
+            continue;
         }
-
-        NS_LOG_INFO("Serializing tag id " << cur->tid);
-
-        // ensure size is multiple of 4 bytes for 4 byte boundaries
-        uint32_t hashSize = (sizeof(TypeId::hash_t) + 3) & (~3);
-        if (size + hashSize <= maxSize)
-        {
-            TypeId::hash_t tid = cur->tid.GetHash();
-            memcpy(p, &tid, sizeof(TypeId::hash_t));
-            p += hashSize / 4;
-            size += hashSize;
-        }
-        else
+        if (!SerializeTag(m_inline.tid[slot],
+                          m_inline.data[slot],
+                          m_inline.size[slot],
+                          p,
+                          size,
+                          maxSize))
         {
             return 0;
         }
-
-        // ensure size is multiple of 4 bytes for 4 byte boundaries
-        uint32_t tagWordSize = (cur->size + 3) & (~3);
-        if (size + tagWordSize <= maxSize)
-        {
-            memcpy(p, cur->data, cur->size);
-            size += tagWordSize;
-            p += tagWordSize / 4;
-        }
-        else
+        (*numberOfTags)++;
+    }
+    for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    {
+        if (!SerializeTag(cur->tid, cur->data, cur->size, p, size, maxSize))
         {
             return 0;
         }
-
         (*numberOfTags)++;
     }
 
@@ -427,30 +692,39 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
         NS_LOG_INFO("Deserializing tag of type " << tid);
 
-        struct TagData* newTag = CreateTagData(tagSize);
-        newTag->count = 1;
-        newTag->next = nullptr;
-        newTag->tid = tid;
-
         NS_ASSERT(sizeCheck >= tagSize);
-        memcpy(newTag->data, p, tagSize);
-
-        // ensure 4 byte boundary
-        uint32_t tagWordSize = (tagSize + 3) & (~3);
-        p += tagWordSize / 4;
-        sizeCheck -= tagWordSize;
-
-        // Set link list pointers.
-        if (i == 0)
+        std::size_t slot = tagSize <= INLINE_TAG_SIZE ? FindInline(TypeId()) : INLINE_TAGS;
+        if (slot < INLINE_TAGS)
         {
-            m_next = newTag;
+            m_inline.tid[slot] = tid;
+            m_inline.size[slot] = tagSize;
+            memcpy(m_inline.data[slot], p, tagSize);
         }
         else
         {
-            prevTag->next = newTag;
+            struct TagData* newTag = CreateTagData(tagSize);
+            newTag->count = 1;
+            newTag->next = nullptr;
+            newTag->tid = tid;
+            memcpy(newTag->data, p, tagSize);
+
+            // Set link list pointers.
+            if (prevTag == nullptr)
+            {
+                m_next = newTag;
+            }
+            else
+            {
+                prevTag->next = newTag;
+            }
+
+            prevTag = newTag;
         }
 
-        prevTag = newTag;
+        // ensure 4 byte boundary
+        uint32_t tagWordSize = (tagSize + 3) & (~3);
+        p += tagWordSize / 4;
+        sizeCheck -= tagWordSize;
     }
 
     NS_ASSERT(sizeCheck == 0);
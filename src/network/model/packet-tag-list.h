@@ -29,6 +29,10 @@
 #include <ostream>
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -120,10 +124,26 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Inline tags </b>
+ *
+ *   - Most packets carry a few small tags, so the first #INLINE_TAGS tags
+ *     of at most #INLINE_TAG_SIZE bytes are stored in the PacketTagList
+ *     itself rather than in TagData.  They are copied with the list, so
+ *     they need no allocation and no copy-on-write.  The other tags are
+ *     stored in the tree of TagData.
+ *
+ *   - The types of the inline tags are kept together, and are all compared
+ *     to the type looked up, so that the scan has no data-dependent branch.
  */
 class PacketTagList
 {
   public:
+    /** The maximum number of tags stored in the list itself. */
+    static constexpr std::size_t INLINE_TAGS = 3;
+    /** The maximum serialized size of the tags stored in the list itself. */
+    static constexpr std::size_t INLINE_TAG_SIZE = 16;
+
     /**
      * Tree node for sharing serialized tags.
      *
@@ -142,7 +162,11 @@ class PacketTagList
     struct TagData
     {
         struct TagData* next; //!< Pointer to next in list
+#ifdef NS3_MTP
+        std::atomic<uint32_t> count; //!< Number of incoming links
+#else
         uint32_t count;       //!< Number of incoming links
+#endif
         TypeId tid;           //!< Type of the tag serialized into #data
         uint32_t size;        //!< Size of the \c data buffer
         uint8_t data[1];      //!< Serialization buffer
@@ -157,7 +181,7 @@ class PacketTagList
      *
      * \param [in] o The PacketTagList to copy.
      *
-     * This makes a light-weight copy by #RemoveAll, then
+     * This makes a light-weight copy by copying the inline tags, then
      * pointing to the same \ref TagData as \pname{o}.
      */
     inline PacketTagList(const PacketTagList& o);
@@ -167,8 +191,8 @@ class PacketTagList
      * \param [in] o The PacketTagList to copy.
      * \returns the copied object
      *
-     * This makes a light-weight copy by #RemoveAll, then
-     * pointing to the same \ref TagData as \pname{o}.
+     * This makes a light-weight copy by #RemoveAll, then copying the
+     * inline tags and pointing to the same \ref TagData as \pname{o}.
      */
     inline PacketTagList& operator=(const PacketTagList& o);
     /**
@@ -215,7 +239,8 @@ class PacketTagList
      */
     inline void RemoveAll();
     /**
-     * \returns pointer to head of tag list
+     * \returns pointer to head of the list of the tags which are not
+     *          stored in the list itself
      */
     const struct PacketTagList::TagData* Head() const;
     /**
@@ -243,7 +268,38 @@ class PacketTagList
      */
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
+    /**
+     * Get the usage statistics of the pool of TagData blocks.
+     *
+     * When ns-3 is built with \c NS3_MTP, each thread has its own pool,
+     * and the statistics are those of the calling thread.  They are zero
+     * if ns-3 is built without the \c NS3_PACKET_POOL option.
+     *
+     * \param [out] hits The number of blocks allocated from a free list.
+     * \param [out] misses The number of blocks allocated from the heap.
+     */
+    static void GetPoolStats(uint64_t& hits, uint64_t& misses);
+
   private:
+    /// Friend class
+    friend class PacketTagIterator;
+
+    /** The tags stored in the list itself. */
+    struct InlineTags
+    {
+        TypeId tid[INLINE_TAGS];                    //!< Types, TypeId() for a free slot
+        uint8_t size[INLINE_TAGS];                  //!< Serialized sizes
+        uint8_t data[INLINE_TAGS][INLINE_TAG_SIZE]; //!< Serialized tags
+    };
+
+    /**
+     * Find a tag stored in the list itself.
+     *
+     * \param [in] tid The type of the tag; TypeId() finds a free slot.
+     * \returns The slot of the tag, or #INLINE_TAGS if none is found.
+     */
+    std::size_t FindInline(TypeId tid) const;
+
     /**
      * Allocate and construct a TagData struct, sizing the data area
      * large enough to serialize dataSize bytes from a Tag.
@@ -252,6 +308,12 @@ class PacketTagList
      * \returns The newly constructed TagData object.
      */
     static TagData* CreateTagData(size_t dataSize);
+    /**
+     * Destroy a TagData struct and release its memory.
+     *
+     * \param [in] tag The TagData object.
+     */
+    static void FreeTagData(TagData* tag);
 
     /**
      * Typedef of method function pointer for copy-on-write operations
@@ -301,6 +363,7 @@ class PacketTagList
      */
     bool ReplaceWriter(Tag& tag, bool preMerge, struct TagData* cur, struct TagData** prevNext);
 
+    InlineTags m_inline; //!< The tags stored in the list itself
     /**
      * Pointer to first \ref TagData on the list
      */
@@ -317,12 +380,14 @@ namespace ns3
 {
 
 PacketTagList::PacketTagList()
-    : m_next()
+    : m_inline(),
+      m_next()
 {
 }
 
 PacketTagList::PacketTagList(const PacketTagList& o)
-    : m_next(o.m_next)
+    : m_inline(o.m_inline),
+      m_next(o.m_next)
 {
     if (m_next != nullptr)
     {
@@ -334,16 +399,20 @@ PacketTagList&
 PacketTagList::operator=(const PacketTagList& o)
 {
     // self assignment
-    if (m_next == o.m_next)
+    if (this == &o)
     {
         return *this;
     }
-    RemoveAll();
-    m_next = o.m_next;
-    if (m_next != nullptr)
+    if (m_next != o.m_next)
     {
-        m_next->count++;
+        RemoveAll();
+        m_next = o.m_next;
+        if (m_next != nullptr)
+        {
+            m_next->count++;
+        }
     }
+    m_inline = o.m_inline;
     return *this;
 }
 
@@ -355,25 +424,26 @@ PacketTagList::~PacketTagList()
 void
 PacketTagList::RemoveAll()
 {
+    for (std::size_t slot = 0; slot < INLINE_TAGS; ++slot)
+    {
+        m_inline.tid[slot] = TypeId();
+    }
     struct TagData* prev = nullptr;
     for (struct TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        cur->count--;
-        if (cur->count > 0)
+        if (--cur->count > 0)
         {
             break;
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            FreeTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        FreeTagData(prev);
     }
     m_next = nullptr;
 }
@@ -20,6 +20,7 @@
 
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/simulator-stats.h"
 #include "ns3/simulator.h"
 
 #include <cstdarg>
@@ -30,7 +31,117 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Packet::m_globalUid = 0;
+std::atomic<uint64_t> Packet::m_liveCount = 0;
+#else
 uint32_t Packet::m_globalUid = 0;
+uint64_t Packet::m_liveCount = 0;
+#endif
+
+namespace
+{
+
+/**
+ * \ingroup packet
+ * Get the number of blocks allocated from the packet pools.
+ * \returns the hits of the pools of packets and tags
+ */
+uint64_t
+GetPoolHits()
+{
+    return Packet::GetPoolStats().hits + Packet::GetTagPoolStats().hits;
+}
+
+/**
+ * \ingroup packet
+ * Get the number of blocks allocated from the heap by the packet pools.
+ * \returns the misses of the pools of packets and tags
+ */
+uint64_t
+GetPoolMisses()
+{
+    return Packet::GetPoolStats().misses + Packet::GetTagPoolStats().misses;
+}
+
+/**
+ * \ingroup packet
+ * Export the number of packets alive and the usage of the packet pools
+ * as gauges of the SimulatorStats.
+ */
+struct PacketStatsGauge
+{
+    PacketStatsGauge()
+    {
+        SimulatorStats::AddGauge("packets", MakeCallback(&Packet::GetLiveCount));
+        SimulatorStats::AddGauge("packet-pool/hits", MakeCallback(&GetPoolHits));
+        SimulatorStats::AddGauge("packet-pool/misses", MakeCallback(&GetPoolMisses));
+    }
+} g_packetStatsGauge; //!< The registration of the gauges
+
+#ifdef NS3_PACKET_POOL
+/** Maximum number of free blocks kept by the packet pool. */
+constexpr uint32_t POOL_MAX_FREE = 4096;
+
+/** A free block of the packet pool. */
+struct FreeBlock
+{
+    FreeBlock* next; //!< Next free block.
+};
+
+/**
+ * \ingroup packet
+ * The pool of the Packet instances.
+ *
+ * The pool is trivially destructible, so that packets released during
+ * the destruction of static objects can still safely reach it; the
+ * free blocks are released by PacketPoolDestructor.
+ */
+struct PacketPool
+{
+    FreeBlock* freeList;     //!< Free blocks.
+    uint32_t length;         //!< Number of free blocks.
+    bool registered;         //!< Whether the destructor is registered.
+    bool destroyed;          //!< Whether the free blocks were released.
+    Packet::PoolStats stats; //!< Usage statistics.
+};
+
+/** Release the free blocks of the pool at exit. */
+struct PacketPoolDestructor
+{
+    ~PacketPoolDestructor();
+};
+
+#ifdef NS3_MTP
+thread_local PacketPool g_packetPool;                     //!< The pool of the thread
+thread_local PacketPoolDestructor g_packetPoolDestructor; //!< Its destructor
+#else
+PacketPool g_packetPool;                     //!< The pool
+PacketPoolDestructor g_packetPoolDestructor; //!< Its destructor
+#endif
+
+PacketPoolDestructor::~PacketPoolDestructor()
+{
+    while (g_packetPool.freeList != nullptr)
+    {
+        FreeBlock* block = g_packetPool.freeList;
+        g_packetPool.freeList = block->next;
+        ::operator delete(block);
+    }
+    g_packetPool.length = 0;
+    g_packetPool.destroyed = true;
+}
+#endif /* NS3_PACKET_POOL */
+
+/**
+ * \ingroup packet
+ * The size from which the bytes of a packet created from a buffer are
+ * held in a payload slice, which the headers, trailers and fragments of
+ * the packet do not copy.
+ */
+constexpr uint32_t PAYLOAD_SLICE_MIN_SIZE = 512;
+
+} // unnamed namespace
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -89,42 +200,64 @@ ByteTagIterator::ByteTagIterator(ByteTagList::Iterator i)
 {
 }
 
-PacketTagIterator::PacketTagIterator(const struct PacketTagList::TagData* head)
-    : m_current(head)
+PacketTagIterator::PacketTagIterator(const PacketTagList& list)
+    : m_list(list),
+      m_slot(0),
+      m_current(m_list.Head())
+{
+    SkipFreeSlots();
+}
+
+void
+PacketTagIterator::SkipFreeSlots()
 {
+    while (m_slot < PacketTagList::INLINE_TAGS && m_list.m_inline.tid[m_slot] == TypeId())
+    {
+        m_slot++;
+    }
 }
 
 bool
 PacketTagIterator::HasNext() const
 {
-    return m_current != nullptr;
+    return m_slot < PacketTagList::INLINE_TAGS || m_current != nullptr;
 }
 
 PacketTagIterator::Item
 PacketTagIterator::Next()
 {
     NS_ASSERT(HasNext());
+    if (m_slot < PacketTagList::INLINE_TAGS)
+    {
+        std::size_t slot = m_slot++;
+        SkipFreeSlots();
+        return PacketTagIterator::Item(m_list.m_inline.tid[slot],
+                                       m_list.m_inline.data[slot],
+                                       m_list.m_inline.size[slot]);
+    }
     const struct PacketTagList::TagData* prev = m_current;
     m_current = m_current->next;
-    return PacketTagIterator::Item(prev);
+    return PacketTagIterator::Item(prev->tid, prev->data, prev->size);
 }
 
-PacketTagIterator::Item::Item(const struct PacketTagList::TagData* data)
-    : m_data(data)
+PacketTagIterator::Item::Item(TypeId tid, const uint8_t* data, uint32_t size)
+    : m_tid(tid),
+      m_data(data),
+      m_size(size)
 {
 }
 
 TypeId
 PacketTagIterator::Item::GetTypeId() const
 {
-    return m_data->tid;
+    return m_tid;
 }
 
 void
 PacketTagIterator::Item::GetTag(Tag& tag) const
 {
-    NS_ASSERT(tag.GetInstanceTypeId() == m_data->tid);
-    tag.Deserialize(TagBuffer((uint8_t*)m_data->data, (uint8_t*)m_data->data + m_data->size));
+    NS_ASSERT(tag.GetInstanceTypeId() == m_tid);
+    tag.Deserialize(TagBuffer((uint8_t*)m_data, (uint8_t*)m_data + m_size));
 }
 
 Ptr<Packet>
@@ -146,10 +279,10 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    m_liveCount++;
 }
 
 Packet::Packet(const Packet& o)
@@ -158,9 +291,15 @@ Packet::Packet(const Packet& o)
       m_packetTagList(o.m_packetTagList),
       m_metadata(o.m_metadata)
 {
+    m_liveCount++;
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
 }
 
+Packet::~Packet()
+{
+    m_liveCount--;
+}
+
 Packet&
 Packet::operator=(const Packet& o)
 {
@@ -186,10 +325,10 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    m_liveCount++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -199,6 +338,7 @@ Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
       m_metadata(0, 0),
       m_nixVector(nullptr)
 {
+    m_liveCount++;
     NS_ASSERT(magic);
     Deserialize(buffer, size);
 }
@@ -213,10 +353,15 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
+    m_liveCount++;
+    if (size >= PAYLOAD_SLICE_MIN_SIZE)
+    {
+        m_buffer = Buffer(buffer, size);
+        return;
+    }
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -232,6 +377,7 @@ Packet::Packet(const Buffer& buffer,
       m_metadata(metadata),
       m_nixVector(nullptr)
 {
+    m_liveCount++;
 }
 
 Ptr<Packet>
@@ -606,6 +752,90 @@ Packet::EnableChecking()
     PacketMetadata::EnableChecking();
 }
 
+void
+Packet::EnableLazyPrinting()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    PacketMetadata::EnableLazy();
+}
+
+void
+Packet::EnableSampledPrinting(uint32_t period, Callback<uint64_t> flowKey)
+{
+    NS_LOG_FUNCTION(period);
+    PacketMetadata::EnableSampling(period, flowKey);
+}
+
+uint64_t
+Packet::GetLiveCount()
+{
+    return m_liveCount;
+}
+
+Packet::PoolStats
+Packet::GetPoolStats()
+{
+#ifdef NS3_PACKET_POOL
+    return g_packetPool.stats;
+#else
+    return PoolStats{0, 0};
+#endif
+}
+
+Packet::PoolStats
+Packet::GetTagPoolStats()
+{
+    PoolStats stats{0, 0};
+    PacketTagList::GetPoolStats(stats.hits, stats.misses);
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    ByteTagList::GetPoolStats(hits, misses);
+    stats.hits += hits;
+    stats.misses += misses;
+    return stats;
+}
+
+#ifdef NS3_PACKET_POOL
+void*
+Packet::operator new(std::size_t size)
+{
+    NS_ASSERT(size == sizeof(Packet));
+    PacketPool& pool = g_packetPool;
+    FreeBlock* block = pool.freeList;
+    if (block != nullptr)
+    {
+        pool.freeList = block->next;
+        pool.length--;
+        pool.stats.hits++;
+        return block;
+    }
+    if (!pool.registered)
+    {
+        // The destructor of a thread_local object is only registered
+        // when the object is first used by the thread.
+        (void)&g_packetPoolDestructor;
+        pool.registered = true;
+    }
+    pool.stats.misses++;
+    return ::operator new(size);
+}
+
+void
+Packet::operator delete(void* ptr)
+{
+    PacketPool& pool = g_packetPool;
+    if (!pool.registered || pool.destroyed || pool.length >= POOL_MAX_FREE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = pool.freeList;
+    pool.freeList = block;
+    pool.length++;
+}
+#endif /* NS3_PACKET_POOL */
+
 uint32_t
 Packet::GetSerializedSize() const
 {
@@ -1038,7 +1268,7 @@ Packet::PrintPacketTags(std::ostream& os) const
 PacketTagIterator
 Packet::GetPacketTagIterator() const
 {
-    return PacketTagIterator(m_packetTagList.Head());
+    return PacketTagIterator(m_packetTagList);
 }
 
 std::ostream&
@@ -35,6 +35,10 @@
 
 #include <stdint.h>
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -130,7 +134,8 @@ class ByteTagIterator
  * \ingroup packet
  * \brief Iterator over the set of packet tags in a packet
  *
- * This is a java-style iterator.
+ * This is a java-style iterator.  It holds a copy of the list of packet
+ * tags, so the items remain valid as long as the iterator.
  */
 class PacketTagIterator
 {
@@ -160,10 +165,14 @@ class PacketTagIterator
         friend class PacketTagIterator;
         /**
          * Constructor
-         * \param data the data to copy.
+         * \param tid the type of the tag.
+         * \param data the serialized tag.
+         * \param size the size of the serialized tag.
          */
-        Item(const struct PacketTagList::TagData* data);
-        const struct PacketTagList::TagData* m_data; //!< the tag data
+        Item(TypeId tid, const uint8_t* data, uint32_t size);
+        TypeId m_tid;          //!< the type of the tag
+        const uint8_t* m_data; //!< the serialized tag
+        uint32_t m_size;       //!< the size of the serialized tag
     };
 
     /**
@@ -180,11 +189,17 @@ class PacketTagIterator
     friend class Packet;
     /**
      * Constructor
-     * \param head head of the items
+     * \param list the list of the items
      */
-    PacketTagIterator(const struct PacketTagList::TagData* head);
+    PacketTagIterator(const PacketTagList& list);
+    /**
+     * Skip the free slots of the inline tags of the list.
+     */
+    void SkipFreeSlots();
+    PacketTagList m_list; //!< the list of the items
+    std::size_t m_slot;   //!< actual position over the inline tags of the list
     const struct PacketTagList::TagData*
-        m_current; //!< actual position over the set of tags in a packet
+        m_current; //!< actual position over the other tags of the list
 };
 
 /**
@@ -235,6 +250,11 @@ class PacketTagIterator
  *
  * The performance aspects copy-on-write semantics of the
  * Packet API are discussed in \ref packetperf
+ *
+ * When ns-3 is built with the \c NS3_PACKET_POOL option (the default),
+ * the memory of the Packet instances and of the storage of their tags is
+ * recycled: the blocks released are kept in free lists, one set per
+ * thread, and reused by the next packets and tags.
  */
 class Packet : public SimpleRefCount<Packet>
 {
@@ -255,6 +275,8 @@ class Packet : public SimpleRefCount<Packet>
      * \return the copied object
      */
     Packet& operator=(const Packet& o);
+    /** Destructor */
+    ~Packet();
     /**
      * \brief Create a packet with a zero-filled payload.
      *
@@ -285,7 +307,10 @@ class Packet : public SimpleRefCount<Packet>
      * of this buffer.
      *
      * The input data is copied: the input
-     * buffer is untouched.
+     * buffer is untouched. A large payload is copied once
+     * into a payload slice, shared by the copies and the
+     * fragments of the packet, so that adding or removing
+     * headers does not copy it again.
      *
      * \param buffer the data to store in the packet.
      * \param size the size of the input buffer.
@@ -537,6 +562,86 @@ class Packet : public SimpleRefCount<Packet>
      * errors will be detected and will abort the program.
      */
     static void EnableChecking();
+    /**
+     * \brief Enable printing packets metadata, recorded lazily.
+     *
+     * The headers and trailers added to and removed from a packet are
+     * logged, and only applied to its metadata when the packet is
+     * printed or serialized, so that the packets which are never printed
+     * cost less than with EnablePrinting. This method must be invoked
+     * before any packet is created, as EnablePrinting.
+     */
+    static void EnableLazyPrinting();
+    /**
+     * \brief Enable printing the packets of a sample of the flows.
+     *
+     * Only the packets of one flow in \p period on average keep the
+     * metadata needed by the Print methods; the others are printed as
+     * if EnablePrinting was not invoked. The flow of a packet is given
+     * by \p flowKey when the packet is created, by default the id of the
+     * node which creates it. This method must be invoked before any
+     * packet is created, as EnablePrinting.
+     *
+     * \param [in] period The average number of flows per flow printed.
+     * \param [in] flowKey The callback which returns the flow of a new packet.
+     */
+    static void EnableSampledPrinting(uint32_t period,
+                                      Callback<uint64_t> flowKey = MakeNullCallback<uint64_t>());
+
+    /**
+     * \brief Get the number of packets alive in the process.
+     *
+     * The count is also exported as the \c packets gauge of the
+     * SimulatorStats.
+     *
+     * \returns the number of packets alive
+     */
+    static uint64_t GetLiveCount();
+
+    /** Usage statistics of a packet memory pool. */
+    struct PoolStats
+    {
+        uint64_t hits;   //!< Number of blocks allocated from a free list.
+        uint64_t misses; //!< Number of blocks allocated from the heap.
+    };
+
+    /**
+     * \brief Get the usage statistics of the pool of Packet instances.
+     *
+     * When ns-3 is built with \c NS3_MTP, each thread has its own pool,
+     * and the statistics are those of the calling thread. The hits and
+     * misses of all the packet pools are also exported as the
+     * \c packet-pool/hits and \c packet-pool/misses gauges of the
+     * SimulatorStats.
+     *
+     * \returns the statistics; all zero if ns-3 is built without the
+     * \c NS3_PACKET_POOL option.
+     */
+    static PoolStats GetPoolStats();
+
+    /**
+     * \brief Get the usage statistics of the pools of the storage of the
+     * packet tags and of the byte tags.
+     *
+     * \returns the statistics, as GetPoolStats()
+     */
+    static PoolStats GetTagPoolStats();
+
+#ifdef NS3_PACKET_POOL
+    /**
+     * \brief Allocate the memory of a packet, from the pool if possible.
+     *
+     * \param size the size of a packet
+     * \returns the memory block
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Release the memory of a packet to the pool.
+     *
+     * \param ptr the memory block
+     */
+    static void operator delete(void* ptr);
+#endif /* NS3_PACKET_POOL */
 
     /**
      * \brief Returns number of bytes required for packet
@@ -796,7 +901,13 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+    static std::atomic<uint64_t> m_liveCount; //!< Number of packets alive
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+    static uint64_t m_liveCount; //!< Number of packets alive
+#endif
 };
 
 /**
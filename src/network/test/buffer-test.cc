@@ -395,6 +395,146 @@ BufferTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer payload slice unit tests.
+ */
+class BufferPayloadTest : public TestCase
+{
+  private:
+    /**
+     * Checks the buffer content against a part of the payload, between
+     * a header and a trailer of bytes of a given value.
+     * \param b The buffer to check
+     * \param header The size of the header
+     * \param start The offset of the part of the payload
+     * \param size The size of the part of the payload
+     * \param trailer The size of the trailer
+     */
+    void EnsurePayload(const Buffer& b,
+                       uint32_t header,
+                       uint32_t start,
+                       uint32_t size,
+                       uint32_t trailer);
+
+    std::vector<uint8_t> m_payload; //!< The payload bytes
+
+  public:
+    void DoRun() override;
+    BufferPayloadTest();
+};
+
+BufferPayloadTest::BufferPayloadTest()
+    : TestCase("Buffer payload slices")
+{
+}
+
+void
+BufferPayloadTest::EnsurePayload(const Buffer& b,
+                                 uint32_t header,
+                                 uint32_t start,
+                                 uint32_t size,
+                                 uint32_t trailer)
+{
+    NS_TEST_ASSERT_MSG_EQ(b.GetSize(), header + size + trailer, "Bad buffer size");
+    std::vector<uint8_t> expected(header, 0xaa);
+    expected.insert(expected.end(),
+                    m_payload.begin() + start,
+                    m_payload.begin() + start + size);
+    expected.insert(expected.end(), trailer, 0xbb);
+
+    Buffer::Iterator i = b.Begin();
+    for (uint32_t j = 0; j < expected.size(); j++)
+    {
+        NS_TEST_ASSERT_MSG_EQ((uint16_t)i.ReadU8(), (uint16_t)expected[j], "Bad byte " << j);
+    }
+    std::vector<uint8_t> copy(expected.size());
+    NS_TEST_ASSERT_MSG_EQ(b.CopyData(copy.data(), copy.size()), copy.size(), "Bad copy size");
+    NS_TEST_ASSERT_MSG_EQ((copy == expected), true, "Bad copied bytes");
+}
+
+void
+BufferPayloadTest::DoRun()
+{
+    m_payload.resize(1000);
+    for (uint32_t j = 0; j < m_payload.size(); j++)
+    {
+        m_payload[j] = (j * 7) & 0xff;
+    }
+    Buffer buffer(m_payload.data(), m_payload.size());
+    EnsurePayload(buffer, 0, 0, 1000, 0);
+
+    // headers and trailers around the payload, in a shared buffer
+    Buffer shared = buffer;
+    buffer.AddAtStart(4);
+    buffer.Begin().WriteU8(0xaa, 4);
+    buffer.AddAtEnd(2);
+    Buffer::Iterator i = buffer.End();
+    i.Prev(2);
+    i.WriteU8(0xbb, 2);
+    EnsurePayload(buffer, 4, 0, 1000, 2);
+    EnsurePayload(shared, 0, 0, 1000, 0);
+    i = buffer.Begin();
+    i.Next(3);
+    NS_TEST_ASSERT_MSG_EQ(i.ReadNtohU16(), 0xaa00, "Bad read across the payload start");
+    i = buffer.End();
+    i.Prev(3);
+    NS_TEST_ASSERT_MSG_EQ(i.ReadNtohU16(), ((m_payload[999] << 8) | 0xbb), "Bad read at the end");
+
+    // fragments and headers added to them
+    Buffer fragment = buffer.CreateFragment(104, 300);
+    EnsurePayload(fragment, 0, 100, 300, 0);
+    fragment.AddAtStart(8);
+    fragment.Begin().WriteU8(0xaa, 8);
+    EnsurePayload(fragment, 8, 100, 300, 0);
+    fragment.RemoveAtStart(10);
+    EnsurePayload(fragment, 0, 102, 298, 0);
+    EnsurePayload(buffer, 4, 0, 1000, 2);
+
+    // reassembly of fragments, in and out of order
+    Buffer first = buffer.CreateFragment(0, 404);
+    Buffer second = buffer.CreateFragment(404, 300);
+    Buffer third = buffer.CreateFragment(704, 302);
+    Buffer whole = first;
+    whole.AddAtEnd(second);
+    whole.AddAtEnd(third);
+    EnsurePayload(whole, 4, 0, 1000, 2);
+    Buffer mixed = second;
+    mixed.AddAtEnd(first);
+    EnsurePayload(first, 4, 0, 400, 0);
+    NS_TEST_ASSERT_MSG_EQ(mixed.GetSize(), 704, "Bad size of the mixed fragments");
+    i = mixed.Begin();
+    for (uint32_t k = 0; k < 300; k++)
+    {
+        NS_TEST_ASSERT_MSG_EQ((uint16_t)i.ReadU8(), (uint16_t)m_payload[400 + k], "Bad byte");
+    }
+    i.Next(4);
+    for (uint32_t k = 0; k < 400; k++)
+    {
+        NS_TEST_ASSERT_MSG_EQ((uint16_t)i.ReadU8(), (uint16_t)m_payload[k], "Bad byte");
+    }
+
+    // copies into real bytes
+    Buffer other;
+    other.AddAtStart(buffer.GetSize());
+    other.Begin().Write(buffer.Begin(), buffer.End());
+    EnsurePayload(other, 4, 0, 1000, 2);
+    const uint8_t* data = fragment.PeekData();
+    NS_TEST_ASSERT_MSG_EQ((uint16_t)data[0], (uint16_t)m_payload[102], "Bad peeked byte");
+    std::vector<uint8_t> serialized(buffer.GetSerializedSize());
+    NS_TEST_ASSERT_MSG_EQ(buffer.Serialize(serialized.data(), serialized.size()),
+                          1,
+                          "Serialization failed");
+    Buffer deserialized(0, false);
+    // The size includes the size field which precedes the buffer in a packet
+    NS_TEST_ASSERT_MSG_EQ(deserialized.Deserialize(serialized.data(), serialized.size() + 4),
+                          1,
+                          "Deserialization failed");
+    EnsurePayload(deserialized, 4, 0, 1000, 2);
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -411,6 +551,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", UNIT)
 {
     AddTestCase(new BufferTest, TestCase::QUICK);
+    AddTestCase(new BufferPayloadTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
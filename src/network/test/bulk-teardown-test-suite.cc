@@ -0,0 +1,153 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/node.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * An object aggregated to a node, which writes to a trace stream and
+ * records its disposal.
+ */
+class BulkTeardownTracer : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return The object TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid =
+            TypeId("BulkTeardownTracer").SetParent<Object>().SetGroupName("Network");
+        return tid;
+    }
+
+    /**
+     * Constructor.
+     * \param [in] stream The trace stream.
+     */
+    BulkTeardownTracer(Ptr<OutputStreamWrapper> stream)
+        : m_stream(stream)
+    {
+    }
+
+    /** Write a line to the trace stream, which is not flushed. */
+    void Trace()
+    {
+        *m_stream->GetStream() << "traced at " << Simulator::Now().GetSeconds() << "\n";
+    }
+
+    /** Whether an object of this type was disposed. */
+    static bool m_disposed;
+
+  private:
+    void DoDispose() override
+    {
+        m_disposed = true;
+        m_stream = nullptr;
+        Object::DoDispose();
+    }
+
+    Ptr<OutputStreamWrapper> m_stream; //!< The trace stream.
+};
+
+bool BulkTeardownTracer::m_disposed = false;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that a bulk teardown leaves the nodes and the pending events
+ * alive, and flushes the trace streams which they hold.
+ */
+class BulkTeardownTestCase : public TestCase
+{
+  public:
+    BulkTeardownTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+};
+
+BulkTeardownTestCase::BulkTeardownTestCase()
+    : TestCase("Check the bulk teardown of Simulator::Destroy()")
+{
+}
+
+void
+BulkTeardownTestCase::DoTeardown()
+{
+    Config::SetGlobal("BulkTeardown", BooleanValue(false));
+}
+
+void
+BulkTeardownTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("bulk-teardown.tr");
+    Config::SetGlobal("BulkTeardown", BooleanValue(true));
+    NS_TEST_ASSERT_MSG_EQ(Simulator::IsBulkTeardown(), true, "Bulk teardown not enabled");
+
+    {
+        Ptr<Node> node = CreateObject<Node>();
+        Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper>(filename, std::ios::out);
+        Ptr<BulkTeardownTracer> tracer = CreateObject<BulkTeardownTracer>(stream);
+        node->AggregateObject(tracer);
+        Simulator::Schedule(Seconds(1), &BulkTeardownTracer::Trace, tracer);
+        // Never run, but holds the tracer
+        Simulator::Schedule(Seconds(10), &BulkTeardownTracer::Trace, tracer);
+        Simulator::Stop(Seconds(2));
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(BulkTeardownTracer::m_disposed, false, "Node disposed");
+    std::ifstream is(filename);
+    std::ostringstream trace;
+    trace << is.rdbuf();
+    NS_TEST_EXPECT_MSG_EQ(trace.str(), "traced at 1\n", "Trace stream not flushed");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Bulk teardown test suite.
+ */
+class BulkTeardownTestSuite : public TestSuite
+{
+  public:
+    BulkTeardownTestSuite();
+};
+
+BulkTeardownTestSuite::BulkTeardownTestSuite()
+    : TestSuite("bulk-teardown", UNIT)
+{
+    AddTestCase(new BulkTeardownTestCase, TestCase::QUICK);
+}
+
+static BulkTeardownTestSuite g_bulkTeardownTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,276 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/buffer.h"
+#include "ns3/internet-checksum.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+/**
+ * \ingroup network-test
+ * Draw bytes from a xorshift generator.
+ * \param [in,out] state The state of the generator.
+ * \param [in] size The number of bytes.
+ * \returns The bytes.
+ */
+std::vector<uint8_t>
+RandomBytes(uint32_t& state, uint32_t size)
+{
+    std::vector<uint8_t> bytes(size);
+    for (auto& byte : bytes)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = state >> 24;
+    }
+    return bytes;
+}
+
+} // unnamed namespace
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the vectorized kernels against the scalar one.
+ */
+class ChecksumKernelTestCase : public TestCase
+{
+  public:
+    ChecksumKernelTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ChecksumKernelTestCase::ChecksumKernelTestCase()
+    : TestCase("Check the checksum kernels against the scalar one")
+{
+}
+
+void
+ChecksumKernelTestCase::DoRun()
+{
+    uint32_t state = 0x12345678;
+    std::vector<uint8_t> data = RandomBytes(state, 1100);
+    for (auto kernel : {CHECKSUM_WORDS, CHECKSUM_SSE2, CHECKSUM_AVX2})
+    {
+        if (!IsChecksumKernelSupported(kernel))
+        {
+            continue;
+        }
+        // All the lengths and alignments of the blocks and of the rest
+        for (uint32_t offset = 0; offset < 64; offset++)
+        {
+            for (uint32_t length = 0; length <= 1024; length += (length < 200 ? 1 : 37))
+            {
+                uint32_t sum = offset * 0x01010101;
+                NS_TEST_ASSERT_MSG_EQ(ChecksumAdd(kernel, sum, &data[offset], length),
+                                      ChecksumAdd(CHECKSUM_SCALAR, sum, &data[offset], length),
+                                      "Bad sum of kernel " << kernel << " at offset " << offset
+                                                           << " of length " << length);
+            }
+        }
+        // Many large words, and no data at all
+        std::vector<uint8_t> ones(70001, 0xff);
+        NS_TEST_ASSERT_MSG_EQ(ChecksumAdd(kernel, 0xffffffff, ones.data(), ones.size()),
+                              ChecksumAdd(CHECKSUM_SCALAR, 0xffffffff, ones.data(), ones.size()),
+                              "Bad sum of kernel " << kernel << " of large words");
+        std::vector<uint8_t> zeroes(100, 0);
+        NS_TEST_ASSERT_MSG_EQ(ChecksumAdd(kernel, 0, zeroes.data(), zeroes.size()),
+                              0,
+                              "Bad sum of kernel " << kernel << " of zeroes");
+    }
+    NS_TEST_ASSERT_MSG_EQ(ChecksumAdd(0, &data[1], 1000),
+                          ChecksumAdd(CHECKSUM_SCALAR, 0, &data[1], 1000),
+                          "Bad sum of the default kernel");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check Buffer::Iterator::CalculateIpChecksum() against the sum of the
+ * words read one at a time, across the virtual zero area and payload
+ * slices.
+ */
+class BufferChecksumTestCase : public TestCase
+{
+  public:
+    BufferChecksumTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check the checksums of the parts of a buffer.
+     * \param [in] buffer The buffer.
+     * \param [in] name The name of the buffer.
+     */
+    void CheckChecksums(const Buffer& buffer, const std::string& name);
+};
+
+BufferChecksumTestCase::BufferChecksumTestCase()
+    : TestCase("Check the checksums of buffers")
+{
+}
+
+void
+BufferChecksumTestCase::CheckChecksums(const Buffer& buffer, const std::string& name)
+{
+    for (uint32_t start = 0; start < buffer.GetSize(); start += 7)
+    {
+        for (uint32_t size = 0; start + size <= buffer.GetSize() && size < 0x10000; size += 13)
+        {
+            Buffer::Iterator i = buffer.Begin();
+            i.Next(start);
+            uint32_t sum = 0x1234;
+            for (uint32_t j = 0; j < size / 2; j++)
+            {
+                sum += i.ReadU16();
+            }
+            if (size & 1)
+            {
+                sum += i.ReadU8();
+            }
+            while (sum >> 16)
+            {
+                sum = (sum & 0xffff) + (sum >> 16);
+            }
+            uint16_t expected = ~sum;
+
+            i = buffer.Begin();
+            i.Next(start);
+            NS_TEST_ASSERT_MSG_EQ(i.CalculateIpChecksum(size, 0x1234),
+                                  expected,
+                                  "Bad checksum of " << name << " at " << start << " of size "
+                                                     << size);
+            NS_TEST_ASSERT_MSG_EQ(i.GetRemainingSize(),
+                                  buffer.GetSize() - start - size,
+                                  "Bad position after the checksum of " << name);
+        }
+    }
+}
+
+void
+BufferChecksumTestCase::DoRun()
+{
+    uint32_t state = 0x9abcdef0;
+    std::vector<uint8_t> bytes = RandomBytes(state, 601);
+
+    // Headers around a virtual zero area of odd size
+    Buffer zero(301);
+    zero.AddAtStart(11);
+    zero.Begin().Write(bytes.data(), 11);
+    zero.AddAtEnd(9);
+    Buffer::Iterator i = zero.End();
+    i.Prev(9);
+    i.Write(bytes.data() + 11, 9);
+    CheckChecksums(zero, "a zero area");
+
+    // Headers around a payload slice
+    Buffer payload(bytes.data(), bytes.size());
+    payload.AddAtStart(3);
+    payload.Begin().WriteU8(0xaa, 3);
+    payload.AddAtEnd(5);
+    i = payload.End();
+    i.Prev(5);
+    i.WriteU8(0xbb, 5);
+    CheckChecksums(payload, "a payload slice");
+    CheckChecksums(payload.CreateFragment(1, 400), "a fragment of a payload slice");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check the incremental updates of the checksums against their full
+ * computation.
+ */
+class ChecksumUpdateTestCase : public TestCase
+{
+  public:
+    ChecksumUpdateTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ChecksumUpdateTestCase::ChecksumUpdateTestCase()
+    : TestCase("Check the incremental updates of the checksums")
+{
+}
+
+void
+ChecksumUpdateTestCase::DoRun()
+{
+    uint32_t state = 0x0badcafe;
+    for (uint32_t round = 0; round < 1000; round++)
+    {
+        std::vector<uint8_t> data = RandomBytes(state, 20);
+        std::vector<uint8_t> change = RandomBytes(state, 4);
+        uint32_t word = (change[0] % 9) * 2;
+        uint16_t checksum = ~ChecksumAdd(CHECKSUM_SCALAR, 0, data.data(), data.size());
+
+        uint16_t oldValue = data[word] | (data[word + 1] << 8);
+        uint16_t newValue = round % 2 ? change[2] | (change[3] << 8) : oldValue - 0x100;
+        data[word] = newValue & 0xff;
+        data[word + 1] = newValue >> 8;
+        uint16_t updated = ChecksumUpdateU16(checksum, oldValue, newValue);
+        checksum = ~ChecksumAdd(CHECKSUM_SCALAR, 0, data.data(), data.size());
+        NS_TEST_ASSERT_MSG_EQ(updated, checksum, "Bad update of a word in round " << round);
+
+        uint32_t oldValues = 0;
+        uint32_t newValues = change[0] | (change[1] << 8) | (change[2] << 16) | (change[3] << 24);
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            oldValues |= data[word + j] << (8 * j);
+            data[word + j] = newValues >> (8 * j);
+        }
+        updated = ChecksumUpdateU32(checksum, oldValues, newValues);
+        checksum = ~ChecksumAdd(CHECKSUM_SCALAR, 0, data.data(), data.size());
+        NS_TEST_ASSERT_MSG_EQ(updated, checksum, "Bad update of two words in round " << round);
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Internet checksum test suite.
+ */
+class InternetChecksumTestSuite : public TestSuite
+{
+  public:
+    InternetChecksumTestSuite();
+};
+
+InternetChecksumTestSuite::InternetChecksumTestSuite()
+    : TestSuite("internet-checksum", UNIT)
+{
+    AddTestCase(new ChecksumKernelTestCase, TestCase::QUICK);
+    AddTestCase(new BufferChecksumTestCase, TestCase::QUICK);
+    AddTestCase(new ChecksumUpdateTestCase, TestCase::QUICK);
+}
+
+static InternetChecksumTestSuite
+    g_internetChecksumTestSuite; //!< Static variable for test initialization
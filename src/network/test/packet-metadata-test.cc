@@ -25,6 +25,7 @@
 #include <cstdarg>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -326,7 +327,11 @@ HistoryTrailer<N>::Deserialize(Buffer::Iterator start)
 class PacketMetadataTest : public TestCase
 {
   public:
-    PacketMetadataTest();
+    /**
+     * Constructor
+     * \param lazy Whether to record the metadata lazily
+     */
+    PacketMetadataTest(bool lazy);
     ~PacketMetadataTest() override;
     /**
      * Checks the packet header and trailer history
@@ -336,6 +341,7 @@ class PacketMetadataTest : public TestCase
      */
     void CheckHistory(Ptr<Packet> p, uint32_t n, ...);
     void DoRun() override;
+    void DoTeardown() override;
 
   private:
     /**
@@ -344,10 +350,13 @@ class PacketMetadataTest : public TestCase
      * \return The packet with the header added.
      */
     Ptr<Packet> DoAddHeader(Ptr<Packet> p);
+
+    bool m_lazy; //!< Whether to record the metadata lazily
 };
 
-PacketMetadataTest::PacketMetadataTest()
-    : TestCase("Packet metadata")
+PacketMetadataTest::PacketMetadataTest(bool lazy)
+    : TestCase(lazy ? "Packet metadata, recorded lazily" : "Packet metadata"),
+      m_lazy(lazy)
 {
 }
 
@@ -476,10 +485,16 @@ PacketMetadataTest::DoAddHeader(Ptr<Packet> p)
     return p;
 }
 
+void
+PacketMetadataTest::DoTeardown()
+{
+    PacketMetadata::EnableLazy(false);
+}
+
 void
 PacketMetadataTest::DoRun()
 {
-    PacketMetadata::Enable();
+    PacketMetadata::EnableLazy(m_lazy);
 
     Ptr<Packet> p = Create<Packet>(0);
     Ptr<Packet> p1 = Create<Packet>(0);
@@ -879,6 +894,121 @@ PacketMetadataTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(msg,
                           std::string("hello world"),
                           "Could not find original data in received packet");
+
+    // More operations than a lazy metadata logs
+    p = Create<Packet>(10);
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        ADD_HEADER(p, 2);
+        ADD_TRAILER(p, 3);
+        REM_HEADER(p, 2);
+        REM_TRAILER(p, 3);
+    }
+    ADD_HEADER(p, 2);
+    CHECK_HISTORY(p, 2, 2, 10);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that the metadata of a sample of the flows only is recorded.
+ */
+class PacketMetadataSamplingTest : public TestCase
+{
+  public:
+    PacketMetadataSamplingTest();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Count the metadata items of a packet
+     * \param p The packet
+     * \return The number of items
+     */
+    static uint32_t CountItems(Ptr<const Packet> p);
+};
+
+PacketMetadataSamplingTest::PacketMetadataSamplingTest()
+    : TestCase("Packet metadata of a sample of the flows")
+{
+}
+
+uint32_t
+PacketMetadataSamplingTest::CountItems(Ptr<const Packet> p)
+{
+    uint32_t n = 0;
+    PacketMetadata::ItemIterator i = p->BeginItem();
+    while (i.HasNext())
+    {
+        i.Next();
+        n++;
+    }
+    return n;
+}
+
+void
+PacketMetadataSamplingTest::DoTeardown()
+{
+    PacketMetadata::EnableSampling(1);
+}
+
+void
+PacketMetadataSamplingTest::DoRun()
+{
+    uint64_t flow = 0;
+    PacketMetadata::EnableSampling(4, Callback<uint64_t>([&flow]() { return flow; }));
+
+    uint64_t sampled = 0;
+    uint64_t unsampled = 0;
+    bool foundSampled = false;
+    bool foundUnsampled = false;
+    for (flow = 0; flow < 100 && !(foundSampled && foundUnsampled); flow++)
+    {
+        Ptr<Packet> p = Create<Packet>(10);
+        NS_TEST_ASSERT_MSG_EQ(CountItems(p), CountItems(Create<Packet>(10)), "Unstable sampling");
+        if (CountItems(p) == 1 && !foundSampled)
+        {
+            sampled = flow;
+            foundSampled = true;
+        }
+        else if (CountItems(p) == 0 && !foundUnsampled)
+        {
+            unsampled = flow;
+            foundUnsampled = true;
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(foundSampled && foundUnsampled, true, "No flow sampled or all sampled");
+
+    flow = sampled;
+    Ptr<Packet> p = Create<Packet>(10);
+    ADD_HEADER(p, 2);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p), 2, "Items of a sampled flow not recorded");
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p->CreateFragment(1, 5)), 2, "Fragment not sampled");
+
+    flow = unsampled;
+    Ptr<Packet> o = Create<Packet>(10);
+    ADD_HEADER(o, 2);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(o), 0, "Items of a flow not sampled recorded");
+    NS_TEST_EXPECT_MSG_EQ(o->ToString(), "", "Packet not sampled printed");
+
+    // The packets of the other flows are not sampled where they are received
+    flow = sampled;
+    uint32_t size = o->GetSerializedSize();
+    std::vector<uint8_t> buffer(size);
+    o->Serialize(buffer.data(), size);
+    Ptr<Packet> received = Create<Packet>(buffer.data(), size, true);
+    ADD_HEADER(received, 3);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(received), 0, "Items of a flow not sampled recorded");
+
+    // Nor are the packets which aggregate them
+    o->AddAtEnd(p);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(o), 0, "Items of a flow not sampled recorded");
+    p->AddAtEnd(o);
+    ADD_HEADER(p, 3);
+    NS_TEST_EXPECT_MSG_EQ(CountItems(p), 0, "Items of a flow not sampled recorded");
 }
 
 /**
@@ -896,7 +1026,9 @@ class PacketMetadataTestSuite : public TestSuite
 PacketMetadataTestSuite::PacketMetadataTestSuite()
     : TestSuite("packet-metadata", UNIT)
 {
-    AddTestCase(new PacketMetadataTest, TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(false), TestCase::QUICK);
+    AddTestCase(new PacketMetadataTest(true), TestCase::QUICK);
+    AddTestCase(new PacketMetadataSamplingTest, TestCase::QUICK);
 }
 
 static PacketMetadataTestSuite g_packetMetadataTest; //!< Static variable for test initialization
@@ -1260,6 +1260,197 @@ PacketTagListTest::DoRun()
 } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Unit tests of the tags stored in the tag lists themselves.
+ */
+class PacketInlineTagsTest : public TestCase
+{
+  public:
+    PacketInlineTagsTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * Check the data of a packet tag.
+     * \param p The packet.
+     * \param tag The tag, whose type is looked up.
+     * \param expected The expected data, or -1 if the tag is expected missing.
+     * \param msg The message.
+     */
+    void CheckTag(Ptr<const Packet> p, ATestTagBase&& tag, int expected, const char* msg);
+};
+
+PacketInlineTagsTest::PacketInlineTagsTest()
+    : TestCase("Packet inline tags")
+{
+}
+
+void
+PacketInlineTagsTest::CheckTag(Ptr<const Packet> p,
+                               ATestTagBase&& tag,
+                               int expected,
+                               const char* msg)
+{
+    bool found = p->PeekPacketTag(tag);
+    NS_TEST_EXPECT_MSG_EQ(found, (expected >= 0), msg << ": " << tag.GetInstanceTypeId());
+    if (found)
+    {
+        NS_TEST_EXPECT_MSG_EQ(tag.GetData(), expected, msg << ": " << tag.GetInstanceTypeId());
+        NS_TEST_EXPECT_MSG_EQ(tag.m_error, false, msg << ": " << tag.GetInstanceTypeId());
+    }
+}
+
+void
+PacketInlineTagsTest::DoRun()
+{
+    static_assert(PacketTagList::INLINE_TAGS == 3, "The test fills the inline tags");
+
+    // Three inline tags, then a tag too large and a tag beyond the inline tags
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddPacketTag(ATestTag<1>(1));
+    p->AddPacketTag(ATestTag<2>(2));
+    p->AddPacketTag(ATestTag<20>(20));
+    p->AddPacketTag(ATestTag<3>(3));
+    p->AddPacketTag(ATestTag<4>(4));
+
+    Ptr<Packet> copy = p->Copy();
+    ATestTag<2> removed;
+    NS_TEST_EXPECT_MSG_EQ(copy->RemovePacketTag(removed), true, "Inline tag not removed");
+    NS_TEST_EXPECT_MSG_EQ(removed.GetData(), 2, "Inline tag removed with the wrong data");
+    copy->AddPacketTag(ATestTag<5>(5));
+    ATestTag<1> replaced1(11);
+    copy->ReplacePacketTag(replaced1);
+    ATestTag<3> replaced3(13);
+    copy->ReplacePacketTag(replaced3);
+
+    CheckTag(p, ATestTag<1>(), 1, "original");
+    CheckTag(p, ATestTag<2>(), 2, "original");
+    CheckTag(p, ATestTag<3>(), 3, "original");
+    CheckTag(p, ATestTag<4>(), 4, "original");
+    CheckTag(p, ATestTag<5>(), -1, "original");
+    CheckTag(p, ATestTag<20>(), 20, "original");
+    CheckTag(copy, ATestTag<1>(), 11, "copy");
+    CheckTag(copy, ATestTag<2>(), -1, "copy");
+    CheckTag(copy, ATestTag<3>(), 13, "copy");
+    CheckTag(copy, ATestTag<4>(), 4, "copy");
+    CheckTag(copy, ATestTag<5>(), 5, "copy");
+    CheckTag(copy, ATestTag<20>(), 20, "copy");
+
+    // The iterator visits the inline tags and the other tags
+    uint32_t count = 0;
+    uint32_t sum = 0;
+    PacketTagIterator i = p->GetPacketTagIterator();
+    while (i.HasNext())
+    {
+        PacketTagIterator::Item item = i.Next();
+        ATestTag<1> tag;
+        if (item.GetTypeId() == tag.GetInstanceTypeId())
+        {
+            item.GetTag(tag);
+            NS_TEST_EXPECT_MSG_EQ(tag.GetData(), 1, "Wrong data of an iterated tag");
+        }
+        count++;
+        sum += item.GetTypeId().GetUid();
+    }
+    uint32_t expected = ATestTag<1>::GetTypeId().GetUid() + ATestTag<2>::GetTypeId().GetUid() +
+                        ATestTag<3>::GetTypeId().GetUid() + ATestTag<4>::GetTypeId().GetUid() +
+                        ATestTag<20>::GetTypeId().GetUid();
+    NS_TEST_EXPECT_MSG_EQ(count, 5, "Wrong number of iterated tags");
+    NS_TEST_EXPECT_MSG_EQ(sum, expected, "Wrong types of iterated tags");
+
+    uint32_t serializedSize = copy->GetSerializedSize();
+    std::vector<uint8_t> buffer(serializedSize);
+    NS_TEST_ASSERT_MSG_EQ(copy->Serialize(buffer.data(), serializedSize), 1, "Not serialized");
+    Ptr<Packet> deserialized = Create<Packet>(buffer.data(), serializedSize, true);
+    CheckTag(deserialized, ATestTag<1>(), 11, "deserialized");
+    CheckTag(deserialized, ATestTag<2>(), -1, "deserialized");
+    CheckTag(deserialized, ATestTag<3>(), 13, "deserialized");
+    CheckTag(deserialized, ATestTag<4>(), 4, "deserialized");
+    CheckTag(deserialized, ATestTag<5>(), 5, "deserialized");
+    CheckTag(deserialized, ATestTag<20>(), 20, "deserialized");
+
+    // Byte tags outgrowing the inline buffer of a copy
+    Ptr<Packet> b = Create<Packet>(100);
+    b->AddByteTag(ATestTag<1>(1), 0, 49);
+    Ptr<Packet> bcopy = b->Copy();
+    bcopy->AddByteTag(ATestTag<2>(2), 50, 99);
+    bcopy->AddByteTag(ATestTag<30>(30));
+    ATestTag<1> b1;
+    ATestTag<2> b2;
+    ATestTag<30> b30;
+    NS_TEST_EXPECT_MSG_EQ(b->FindFirstMatchingByteTag(b1), true, "Inline byte tag lost");
+    NS_TEST_EXPECT_MSG_EQ(b->FindFirstMatchingByteTag(b2), false, "Byte tag added to original");
+    NS_TEST_EXPECT_MSG_EQ(bcopy->FindFirstMatchingByteTag(b1), true, "Byte tag not copied");
+    NS_TEST_EXPECT_MSG_EQ(bcopy->FindFirstMatchingByteTag(b2), true, "Byte tag lost");
+    NS_TEST_EXPECT_MSG_EQ(bcopy->FindFirstMatchingByteTag(b30), true, "Byte tag lost");
+    NS_TEST_EXPECT_MSG_EQ(b30.GetData(), 30, "Byte tag data corrupted");
+    Ptr<Packet> fragment = bcopy->CreateFragment(50, 50);
+    NS_TEST_EXPECT_MSG_EQ(fragment->FindFirstMatchingByteTag(b1), false, "Byte tag not trimmed");
+    NS_TEST_EXPECT_MSG_EQ(fragment->FindFirstMatchingByteTag(b2), true, "Byte tag lost");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Packet memory pool unit tests.
+ */
+class PacketPoolTest : public TestCase
+{
+  public:
+    PacketPoolTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketPoolTest::PacketPoolTest()
+    : TestCase("Packet memory pool")
+{
+}
+
+void
+PacketPoolTest::DoRun()
+{
+    Packet::PoolStats packets = Packet::GetPoolStats();
+    Packet::PoolStats tags = Packet::GetTagPoolStats();
+    // The tags are too large to be stored in the tag lists themselves
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(10);
+        p->AddPacketTag(ATestTag<20>(i));
+        p->AddByteTag(ATestTag<40>(i));
+        Ptr<Packet> copy = p->Copy();
+        ATestTag<20> tag;
+        NS_TEST_ASSERT_MSG_EQ(copy->PeekPacketTag(tag), true, "Packet tag lost");
+        NS_TEST_ASSERT_MSG_EQ(tag.GetData(), static_cast<int>(i), "Packet tag corrupted");
+    }
+    Packet::PoolStats packetsAfter = Packet::GetPoolStats();
+    Packet::PoolStats tagsAfter = Packet::GetTagPoolStats();
+
+#ifdef NS3_PACKET_POOL
+    // Each packet and its copy, and the packet tag
+    NS_TEST_EXPECT_MSG_EQ(packetsAfter.hits + packetsAfter.misses,
+                          packets.hits + packets.misses + 4,
+                          "Packets not accounted for");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(packetsAfter.hits, packets.hits + 2, "Packets not recycled");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(tagsAfter.hits + tagsAfter.misses,
+                                tags.hits + tags.misses + 2,
+                                "Tags not accounted for");
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(tagsAfter.hits, tags.hits + 1, "Tags not recycled");
+#else
+    NS_TEST_EXPECT_MSG_EQ(packetsAfter.hits + packetsAfter.misses,
+                          packets.hits + packets.misses,
+                          "Packet pool disabled");
+    NS_TEST_EXPECT_MSG_EQ(tagsAfter.hits + tagsAfter.misses,
+                          tags.hits + tags.misses,
+                          "Packet pool disabled");
+#endif
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1277,6 +1468,8 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::QUICK);
+    AddTestCase(new PacketInlineTagsTest, TestCase::QUICK);
+    AddTestCase(new PacketPoolTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
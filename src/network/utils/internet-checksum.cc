@@ -0,0 +1,268 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "internet-checksum.h"
+
+#include "ns3/assert.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+/** The AVX2 kernel is built, and selected at run time. */
+#define CHECKSUM_HAVE_AVX2
+#endif
+
+/**
+ * \file
+ * \ingroup packet
+ * The one's complement sum of the Internet checksum, implementation.
+ */
+
+namespace ns3
+{
+
+namespace
+{
+
+/*
+ * The kernels sum the 32-bit words of the data in 64-bit integers: as
+ * 2^16 is 1 modulo 2^16 - 1, the sum of the 32-bit words folds to the
+ * sum of the 16-bit words.  Each kernel sums the blocks it can, then
+ * hands over the rest to the next, narrower one.
+ */
+
+/**
+ * \ingroup packet
+ * Fold a sum to 16 bits.
+ * \param [in] sum The sum.
+ * \returns The folded sum.
+ */
+uint16_t
+Fold(uint64_t sum)
+{
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return sum;
+}
+
+/**
+ * \ingroup packet
+ * Sum the remaining bytes one 16-bit word at a time.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \param [in] i The index of the first byte to sum.
+ * \returns The sum.
+ */
+uint64_t
+SumScalar(const uint8_t* data, uint32_t length, uint32_t i)
+{
+    uint64_t sum = 0;
+    for (; i + 1 < length; i += 2)
+    {
+        sum += data[i] | (data[i + 1] << 8);
+    }
+    if (i < length)
+    {
+        sum += data[i];
+    }
+    return sum;
+}
+
+/**
+ * \ingroup packet
+ * Sum the remaining bytes eight bytes at a time, then the rest.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \param [in] i The index of the first byte to sum.
+ * \returns The sum.
+ */
+uint64_t
+SumWords(const uint8_t* data, uint32_t length, uint32_t i)
+{
+    uint64_t sum = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        sum += (word & 0xffffffff) + (word >> 32);
+    }
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // The words were read with their first byte in their high-order bits
+    uint16_t folded = Fold(sum);
+    sum = static_cast<uint16_t>((folded << 8) | (folded >> 8));
+#endif
+    return sum + SumScalar(data, length, i);
+}
+
+#if defined(__SSE2__)
+/**
+ * \ingroup packet
+ * Sum the remaining bytes sixteen bytes at a time with SSE2, then the rest.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \param [in] i The index of the first byte to sum.
+ * \returns The sum.
+ */
+uint64_t
+SumSse2(const uint8_t* data, uint32_t length, uint32_t i)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i low = zero;
+    __m128i high = zero;
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        low = _mm_add_epi64(low, _mm_unpacklo_epi32(block, zero));
+        high = _mm_add_epi64(high, _mm_unpackhi_epi32(block, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(low, high));
+    return lanes[0] + lanes[1] + SumWords(data, length, i);
+}
+#endif
+
+#ifdef CHECKSUM_HAVE_AVX2
+/**
+ * \ingroup packet
+ * Sum the remaining bytes sixty-four bytes at a time with AVX2, then the
+ * rest.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \param [in] i The index of the first byte to sum.
+ * \returns The sum.
+ */
+__attribute__((target("avx2"))) uint64_t
+SumAvx2(const uint8_t* data, uint32_t length, uint32_t i)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum0 = zero;
+    __m256i sum1 = zero;
+    for (; i + 64 <= length; i += 64)
+    {
+        __m256i block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        sum0 = _mm256_add_epi64(sum0, _mm256_unpacklo_epi32(block0, zero));
+        sum1 = _mm256_add_epi64(sum1, _mm256_unpackhi_epi32(block0, zero));
+        sum0 = _mm256_add_epi64(sum0, _mm256_unpacklo_epi32(block1, zero));
+        sum1 = _mm256_add_epi64(sum1, _mm256_unpackhi_epi32(block1, zero));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(sum0, sum1));
+    uint64_t sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#if defined(__SSE2__)
+    return sum + SumSse2(data, length, i);
+#else
+    return sum + SumWords(data, length, i);
+#endif
+}
+#endif
+
+/**
+ * \ingroup packet
+ * Get the fastest kernel supported by the processor.
+ * \returns The kernel.
+ */
+ChecksumKernel
+GetBestKernel()
+{
+    static const ChecksumKernel kernel =
+        IsChecksumKernelSupported(CHECKSUM_AVX2)
+            ? CHECKSUM_AVX2
+            : (IsChecksumKernelSupported(CHECKSUM_SSE2) ? CHECKSUM_SSE2 : CHECKSUM_WORDS);
+    return kernel;
+}
+
+} // unnamed namespace
+
+bool
+IsChecksumKernelSupported(ChecksumKernel kernel)
+{
+    switch (kernel)
+    {
+    case CHECKSUM_SCALAR:
+    case CHECKSUM_WORDS:
+        return true;
+    case CHECKSUM_SSE2:
+#if defined(__SSE2__)
+        return true;
+#else
+        return false;
+#endif
+    case CHECKSUM_AVX2:
+#ifdef CHECKSUM_HAVE_AVX2
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+uint16_t
+ChecksumAdd(uint32_t sum, const uint8_t* data, uint32_t length)
+{
+    return ChecksumAdd(GetBestKernel(), sum, data, length);
+}
+
+uint16_t
+ChecksumAdd(ChecksumKernel kernel, uint32_t sum, const uint8_t* data, uint32_t length)
+{
+    NS_ASSERT_MSG(IsChecksumKernelSupported(kernel), "Unsupported checksum kernel " << kernel);
+    switch (kernel)
+    {
+#ifdef CHECKSUM_HAVE_AVX2
+    case CHECKSUM_AVX2:
+        return Fold(sum + SumAvx2(data, length, 0));
+#endif
+#if defined(__SSE2__)
+    case CHECKSUM_SSE2:
+        return Fold(sum + SumSse2(data, length, 0));
+#endif
+    case CHECKSUM_WORDS:
+        return Fold(sum + SumWords(data, length, 0));
+    default:
+        return Fold(sum + SumScalar(data, length, 0));
+    }
+}
+
+uint16_t
+ChecksumUpdateU16(uint16_t checksum, uint16_t oldValue, uint16_t newValue)
+{
+    // HC' = ~(~HC + ~m + m')
+    uint32_t sum = static_cast<uint16_t>(~checksum);
+    sum += static_cast<uint16_t>(~oldValue);
+    sum += newValue;
+    return ~Fold(sum);
+}
+
+uint16_t
+ChecksumUpdateU32(uint16_t checksum, uint32_t oldValue, uint32_t newValue)
+{
+    uint32_t sum = static_cast<uint16_t>(~checksum);
+    sum += static_cast<uint16_t>(~oldValue);
+    sum += static_cast<uint16_t>(~(oldValue >> 16));
+    sum += newValue & 0xffff;
+    sum += newValue >> 16;
+    return ~Fold(sum);
+}
+
+} // namespace ns3
@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef INTERNET_CHECKSUM_H
+#define INTERNET_CHECKSUM_H
+
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup packet
+ * The one's complement sum of the Internet checksum.
+ *
+ * The sums are those of RFC 1071, over 16-bit words which hold their
+ * first byte in their low-order bits, as read by
+ * Buffer::Iterator::ReadU16(): the checksum computed over such words is
+ * written back with Buffer::Iterator::WriteU16().  An odd final byte is
+ * padded with a zero byte.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ * The implementations of ChecksumAdd().
+ */
+enum ChecksumKernel
+{
+    CHECKSUM_SCALAR, //!< One 16-bit word at a time.
+    CHECKSUM_WORDS,  //!< Eight bytes at a time, in a 64-bit integer.
+    CHECKSUM_SSE2,   //!< Sixteen bytes at a time, with SSE2.
+    CHECKSUM_AVX2,   //!< Sixty-four bytes at a time, with AVX2.
+};
+
+/**
+ * \ingroup packet
+ * Add bytes to a one's complement sum.
+ *
+ * The fastest kernel supported by the processor is used.
+ *
+ * \param [in] sum The sum of the previous bytes, of which the first byte
+ *             of \p data follows an even number.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \returns The sum, folded to 16 bits.
+ */
+uint16_t ChecksumAdd(uint32_t sum, const uint8_t* data, uint32_t length);
+
+/**
+ * \ingroup packet
+ * Add bytes to a one's complement sum, with a given kernel.
+ *
+ * \param [in] kernel The kernel, which must be supported.
+ * \param [in] sum The sum of the previous bytes.
+ * \param [in] data The bytes.
+ * \param [in] length The number of bytes.
+ * \returns The sum, folded to 16 bits.
+ */
+uint16_t ChecksumAdd(ChecksumKernel kernel, uint32_t sum, const uint8_t* data, uint32_t length);
+
+/**
+ * \ingroup packet
+ * \param [in] kernel A kernel.
+ * \returns \c true if the processor supports the kernel.
+ */
+bool IsChecksumKernelSupported(ChecksumKernel kernel);
+
+/**
+ * \ingroup packet
+ * Update a checksum for the change of a 16-bit word of the data, as in
+ * RFC 1624, equation 3.
+ *
+ * The words are in the byte order of the checksum.  The result is the
+ * checksum computed over the whole changed data, unless that data is all
+ * zero: the update then gives 0x0000 rather than the equivalent 0xffff.
+ *
+ * \param [in] checksum The checksum of the data.
+ * \param [in] oldValue The previous value of the word.
+ * \param [in] newValue The new value of the word.
+ * \returns The checksum of the changed data.
+ */
+uint16_t ChecksumUpdateU16(uint16_t checksum, uint16_t oldValue, uint16_t newValue);
+
+/**
+ * \ingroup packet
+ * Update a checksum for the change of two consecutive 16-bit words of
+ * the data, such as an IPv4 address.
+ *
+ * \param [in] checksum The checksum of the data.
+ * \param [in] oldValue The previous value of the words, the first one in
+ *             the low-order bits.
+ * \param [in] newValue The new value of the words.
+ * \returns The checksum of the changed data.
+ */
+uint16_t ChecksumUpdateU32(uint16_t checksum, uint32_t oldValue, uint32_t newValue);
+
+} // namespace ns3
+
+#endif /* INTERNET_CHECKSUM_H */
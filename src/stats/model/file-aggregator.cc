@@ -20,6 +20,7 @@
 #include "file-aggregator.h"
 
 #include "ns3/abort.h"
+#include "ns3/fatal-impl.h"
 #include "ns3/log.h"
 
 #include <fstream>
@@ -75,11 +76,13 @@ FileAggregator::FileAggregator(const std::string& outputFileName, FileType fileT
     }
 
     m_file.open(m_outputFileName);
+    FatalImpl::RegisterStream(&m_file);
 }
 
 FileAggregator::~FileAggregator()
 {
     NS_LOG_FUNCTION(this);
+    FatalImpl::UnregisterStream(&m_file);
     m_file.close();
 }
 
@@ -21,6 +21,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include <fstream>
 #include <iostream>
@@ -50,14 +51,37 @@ GnuplotAggregator::GnuplotAggregator(const std::string& outputFileNameWithoutExt
       m_yLegend("Y Values"),
       m_titleSet(false),
       m_xAndYLegendsSet(false),
-      m_gnuplot(m_graphicsFileName)
+      m_gnuplot(m_graphicsFileName),
+      m_written(false)
 {
     NS_LOG_FUNCTION(this);
+    if (Simulator::IsBulkTeardown())
+    {
+        // This aggregator may be left alive by the bulk teardown
+        m_writeEvent = Simulator::ScheduleDestroy(&GnuplotAggregator::Write, this);
+    }
 }
 
 GnuplotAggregator::~GnuplotAggregator()
 {
     NS_LOG_FUNCTION(this);
+    if (m_writeEvent.PeekEventImpl() != nullptr)
+    {
+        Simulator::Remove(m_writeEvent);
+    }
+    Write();
+}
+
+void
+GnuplotAggregator::Write()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_written)
+    {
+        return;
+    }
+    m_written = true;
+
     if (!m_titleSet)
     {
         NS_LOG_WARN("Warning: The plot title was not set for the gnuplot aggregator");
@@ -24,6 +24,7 @@
 #define GNUPLOT_AGGREGATOR_H
 
 #include "ns3/data-collection-object.h"
+#include "ns3/event-id.h"
 #include "ns3/gnuplot.h"
 
 #include <map>
@@ -64,6 +65,9 @@ class GnuplotAggregator : public DataCollectionObject
      * outputFileNameWithoutExtension + ".plt", and a shell script to
      * generate the gnuplot named outputFileNameWithoutExtension +
      * ".sh".
+     *
+     * The files are written when the aggregator is destroyed, or at
+     * Simulator::Destroy() with a bulk teardown.
      */
     GnuplotAggregator(const std::string& outputFileNameWithoutExtension);
 
@@ -255,6 +259,9 @@ class GnuplotAggregator : public DataCollectionObject
     void SetKeyLocation(KeyLocation keyLocation);
 
   private:
+    /// Write the gnuplot files, if not already written.
+    void Write();
+
     /// The output file name without any extension.
     std::string m_outputFileNameWithoutExtension;
 
@@ -289,6 +296,12 @@ class GnuplotAggregator : public DataCollectionObject
     /// Maps context strings to 2D datasets.
     std::map<std::string, Gnuplot2dDataset> m_2dDatasetMap;
 
+    /// Set equal to true after writing the gnuplot files.
+    bool m_written;
+
+    /// The destroy event which writes the files in a bulk teardown.
+    EventId m_writeEvent;
+
 }; // class GnuplotAggregator
 
 } // namespace ns3
@@ -223,6 +223,18 @@ VisualSimulatorImpl::GetEventCount() const
     return m_simulator->GetEventCount();
 }
 
+uint64_t
+VisualSimulatorImpl::GetLiveEventCount() const
+{
+    return m_simulator->GetLiveEventCount();
+}
+
+uint64_t
+VisualSimulatorImpl::GetCancelledEventCount() const
+{
+    return m_simulator->GetCancelledEventCount();
+}
+
 void
 VisualSimulatorImpl::RunRealSimulator()
 {
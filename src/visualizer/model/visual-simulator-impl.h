@@ -72,6 +72,8 @@ class VisualSimulatorImpl : public SimulatorImpl
     uint32_t GetSystemId() const override;
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
+    uint64_t GetLiveEventCount() const override;
+    uint64_t GetCancelledEventCount() const override;
 
     /// calls Run() in the wrapped simulator
     void RunRealSimulator();
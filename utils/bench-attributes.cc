@@ -0,0 +1,227 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+namespace
+{
+
+/**
+ * Find an attribute by name by scanning a TypeId and its parents, as
+ * TypeId::LookupAttributeByName() did before the attributes were indexed.
+ *
+ * \param [in] tid The TypeId.
+ * \param [in] name The name of the attribute.
+ * \param [out] info The attribute.
+ * \returns \c true if the attribute is found.
+ */
+bool
+ScanAttributes(TypeId tid, const std::string& name, TypeId::AttributeInformation* info)
+{
+    TypeId cur = tid;
+    while (true)
+    {
+        for (std::size_t i = 0; i < cur.GetAttributeN(); i++)
+        {
+            TypeId::AttributeInformation tmp = cur.GetAttribute(i);
+            if (tmp.name == name)
+            {
+                *info = tmp;
+                return true;
+            }
+        }
+        if (cur.GetParent() == cur)
+        {
+            return false;
+        }
+        cur = cur.GetParent();
+    }
+}
+
+/**
+ * Find a trace source by name by scanning a TypeId and its parents, as
+ * TypeId::LookupTraceSourceByName() did before the trace sources were
+ * indexed.
+ *
+ * \param [in] tid The TypeId.
+ * \param [in] name The name of the trace source.
+ * \returns The accessor of the trace source, if it is found.
+ */
+Ptr<const TraceSourceAccessor>
+ScanTraceSources(TypeId tid, const std::string& name)
+{
+    TypeId cur = tid;
+    while (true)
+    {
+        for (std::size_t i = 0; i < cur.GetTraceSourceN(); i++)
+        {
+            TypeId::TraceSourceInformation tmp = cur.GetTraceSource(i);
+            if (tmp.name == name)
+            {
+                return tmp.accessor;
+            }
+        }
+        if (cur.GetParent() == cur)
+        {
+            return nullptr;
+        }
+        cur = cur.GetParent();
+    }
+}
+
+/**
+ * Trace sink of the packets.
+ *
+ * \param [in] packet The packet.
+ */
+void
+PacketSink(Ptr<const Packet> packet)
+{
+}
+
+/**
+ * Measure the cost of an operation.
+ *
+ * \param [in] iterations The number of times to run the operation.
+ * \param [in] op The operation, called with the iteration number.
+ * \returns The time per operation, in ns.
+ */
+template <typename F>
+double
+Measure(uint64_t iterations, F op)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        op(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Log the cost of an operation, and of its previous implementation.
+ *
+ * \param [in] name The name of the operation.
+ * \param [in] current The time per operation, in ns.
+ * \param [in] scan The time per operation of the previous implementation,
+ *             in ns, or 0 if there is none.
+ */
+void
+Report(const std::string& name, double current, double scan = 0)
+{
+    if (scan == 0)
+    {
+        LOG("  " << std::left << std::setw(36) << name << std::right << std::setw(12)
+                 << current);
+        return;
+    }
+    LOG("  " << std::left << std::setw(36) << name << std::right << std::setw(12) << current
+             << std::setw(12) << scan << std::setw(10) << scan / current);
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t iterations = 1000000;
+    uint32_t devices = 1000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the lookups of the attributes and trace sources by name.\n"
+              "\n"
+              "The attributes and trace sources of point-to-point devices are looked\n"
+              "up by name, set by name with ObjectBase::SetAttribute() and connected\n"
+              "by name.  The lookups, which are indexed by TypeId and name, are\n"
+              "compared with a scan of the TypeId and its parents, as the lookups did\n"
+              "before.");
+    cmd.AddValue("iterations", "number of operations of each kind", iterations);
+    cmd.AddValue("devices", "number of devices", devices);
+    cmd.Parse(argc, argv);
+
+    std::vector<Ptr<PointToPointNetDevice>> objects;
+    for (uint32_t i = 0; i < devices; ++i)
+    {
+        objects.push_back(CreateObject<PointToPointNetDevice>());
+    }
+    TypeId tid = PointToPointNetDevice::GetTypeId();
+    // Early and late entries of the lists of the device
+    const std::vector<std::string> attributes = {"Mtu", "InterframeGap", "TxQueue", "DataRate"};
+    const std::vector<std::string> sources = {"MacTx", "PromiscSniffer", "PhyRxDrop"};
+
+    LOG(std::fixed << std::setprecision(2));
+    LOG(cmd.GetName() << ": Benchmark the lookups by name");
+    LOG("  Devices:                            " << devices);
+    LOG("  Iterations:                         " << iterations);
+    LOG("  " << std::left << std::setw(36) << "Time per operation (ns)" << std::right
+             << std::setw(12) << "Index" << std::setw(12) << "Scan" << std::setw(10)
+             << "Ratio");
+
+    uint64_t found = 0;
+    TypeId::AttributeInformation info;
+    double index = Measure(iterations, [&](uint64_t i) {
+        found += tid.LookupAttributeByName(attributes[i % attributes.size()], &info);
+    });
+    double scan = Measure(iterations, [&](uint64_t i) {
+        found += ScanAttributes(tid, attributes[i % attributes.size()], &info);
+    });
+    Report("LookupAttributeByName", index, scan);
+    index = Measure(iterations, [&](uint64_t i) {
+        found += (tid.LookupTraceSourceByName(sources[i % sources.size()]) != nullptr);
+    });
+    scan = Measure(iterations, [&](uint64_t i) {
+        found += (ScanTraceSources(tid, sources[i % sources.size()]) != nullptr);
+    });
+    Report("LookupTraceSourceByName", index, scan);
+    Report("TypeId::LookupByName", Measure(iterations, [&](uint64_t i) {
+               found += (TypeId::LookupByName("ns3::PointToPointNetDevice") == tid);
+           }));
+
+    UintegerValue mtu(1500);
+    Report("SetAttribute(\"Mtu\")", Measure(iterations, [&](uint64_t i) {
+               objects[i % devices]->SetAttribute("Mtu", mtu);
+           }));
+    TimeValue gap(NanoSeconds(96));
+    Report("SetAttribute(\"InterframeGap\")", Measure(iterations, [&](uint64_t i) {
+               objects[i % devices]->SetAttribute("InterframeGap", gap);
+           }));
+    Callback<void, Ptr<const Packet>> sink = MakeCallback(&PacketSink);
+    Report("TraceConnect/Disconnect(\"MacTx\")", Measure(iterations, [&](uint64_t i) {
+               Ptr<PointToPointNetDevice> device = objects[i % devices];
+               device->TraceConnectWithoutContext("MacTx", sink);
+               device->TraceDisconnectWithoutContext("MacTx", sink);
+           }));
+
+    // Keep the lookups alive
+    LOG("  Found:                              " << found);
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,281 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+namespace
+{
+
+/**
+ * The Callback implementation of ns-3.38, which wraps the target in a
+ * std::function and keeps each component in its own allocation, as
+ * the reference for the benchmark.
+ */
+namespace legacy
+{
+
+/** Base class of the components. */
+class ComponentBase
+{
+  public:
+    virtual ~ComponentBase() = default;
+    /**
+     * \param [in] other The other component.
+     * \returns \c true if the components are equal.
+     */
+    virtual bool IsEqual(std::shared_ptr<const ComponentBase> other) const = 0;
+};
+
+/**
+ * A component of a callback.
+ * \tparam T The type of the component.
+ */
+template <typename T>
+class Component : public ComponentBase
+{
+  public:
+    /** \param [in] t The component. */
+    Component(const T& t)
+        : m_comp(t)
+    {
+    }
+
+    bool IsEqual(std::shared_ptr<const ComponentBase> other) const override
+    {
+        auto p = std::dynamic_pointer_cast<const Component<T>>(other);
+        return p != nullptr && !(p->m_comp != m_comp);
+    }
+
+  private:
+    T m_comp; //!< The component.
+};
+
+/**
+ * The implementation of a callback.
+ * \tparam R The return type.
+ * \tparam UArgs The argument types.
+ */
+template <typename R, typename... UArgs>
+class Impl : public SimpleRefCount<Impl<R, UArgs...>>
+{
+  public:
+    /**
+     * \param [in] func The function.
+     * \param [in] components The components.
+     */
+    Impl(std::function<R(UArgs...)> func,
+         const std::vector<std::shared_ptr<ComponentBase>>& components)
+        : m_func(func),
+          m_components(components)
+    {
+    }
+
+    /**
+     * \param [in] uargs The arguments.
+     * \returns The return value.
+     */
+    R operator()(UArgs... uargs) const
+    {
+        return m_func(uargs...);
+    }
+
+  private:
+    std::function<R(UArgs...)> m_func;                        //!< The function.
+    std::vector<std::shared_ptr<ComponentBase>> m_components; //!< The components.
+};
+
+/**
+ * A callback.
+ * \tparam R The return type.
+ * \tparam UArgs The argument types.
+ */
+template <typename R, typename... UArgs>
+class Callback
+{
+  public:
+    /**
+     * \param [in] func The function.
+     * \param [in] bargs The bound arguments.
+     */
+    template <typename T, typename... BArgs>
+    Callback(T func, BArgs... bargs)
+    {
+        std::function<R(BArgs..., UArgs...)> f(func);
+        std::vector<std::shared_ptr<ComponentBase>> components(
+            {std::make_shared<Component<T>>(func), std::make_shared<Component<BArgs>>(bargs)...});
+        m_impl = Create<Impl<R, UArgs...>>(
+            [f, bargs...](auto&&... uargs) -> R {
+                return f(bargs..., std::forward<decltype(uargs)>(uargs)...);
+            },
+            components);
+    }
+
+    /**
+     * \param [in] uargs The arguments.
+     * \returns The return value.
+     */
+    R operator()(UArgs... uargs) const
+    {
+        return (*m_impl)(uargs...);
+    }
+
+  private:
+    Ptr<Impl<R, UArgs...>> m_impl; //!< The implementation.
+};
+
+} // namespace legacy
+
+/** The target of the callbacks. */
+class Target : public SimpleRefCount<Target>
+{
+  public:
+    /**
+     * Accumulate a value.
+     * \param [in] x The value.
+     */
+    void Receive(uint32_t x)
+    {
+        m_sum += x;
+    }
+
+    /**
+     * Accumulate three values, two of which are bound.
+     * \param [in] a The first value.
+     * \param [in] b The second value.
+     * \param [in] x The third value.
+     */
+    void ReceiveBound(uint32_t a, uint32_t b, uint32_t x)
+    {
+        m_sum += a + b + x;
+    }
+
+    uint64_t m_sum{0}; //!< The sum of the values.
+};
+
+/**
+ * Measure the cost of an operation.
+ *
+ * \param [in] iterations The number of times to run the operation.
+ * \param [in] op The operation, which takes the iteration index.
+ * \returns The time per operation, in ns.
+ */
+template <typename F>
+double
+Measure(uint64_t iterations, F op)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        op(static_cast<uint32_t>(i));
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Log the costs of an operation.
+ *
+ * \param [in] name The operation.
+ * \param [in] current The cost with Callback, in ns.
+ * \param [in] previous The cost with the previous implementation, in ns.
+ */
+void
+Report(const std::string& name, double current, double previous)
+{
+    LOG("  " << std::left << std::setw(30) << name << std::right << std::setw(12) << current
+             << std::setw(12) << previous << std::setw(10) << previous / current);
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t iterations = 10000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the creation, copy and invocation of callbacks.\n"
+              "\n"
+              "Callbacks to a member function of an object held by a Ptr, with\n"
+              "and without two bound arguments, are compared with the previous\n"
+              "implementation, which wrapped the target in a std::function.");
+    cmd.AddValue("iterations", "number of times each operation is run", iterations);
+    cmd.Parse(argc, argv);
+
+    Ptr<Target> target = Create<Target>();
+
+    LOG(std::fixed << std::setprecision(2));
+    LOG(cmd.GetName() << ": Benchmark the creation, copy and invocation of callbacks");
+    LOG("  Iterations:                   " << iterations);
+    LOG("  " << std::left << std::setw(30) << "Time per operation (ns)" << std::right
+             << std::setw(12) << "Callback" << std::setw(12) << "Previous" << std::setw(10)
+             << "Ratio");
+
+    Report(
+        "Create",
+        Measure(iterations,
+                [&target](uint32_t) { MakeCallback(&Target::Receive, target); }),
+        Measure(iterations, [&target](uint32_t) {
+            legacy::Callback<void, uint32_t>(&Target::Receive, target);
+        }));
+    Report("Create, two bound arguments",
+           Measure(iterations,
+                   [&target](uint32_t i) {
+                       MakeCallback(&Target::ReceiveBound, target, i, i);
+                   }),
+           Measure(iterations, [&target](uint32_t i) {
+               legacy::Callback<void, uint32_t>(&Target::ReceiveBound, target, i, i);
+           }));
+
+    auto cb = MakeCallback(&Target::Receive, target);
+    legacy::Callback<void, uint32_t> legacyCb(&Target::Receive, target);
+    Report("Copy",
+           Measure(iterations,
+                   [&cb](uint32_t) {
+                       Callback<void, uint32_t> copy = cb;
+                       copy.IsNull();
+                   }),
+           Measure(iterations, [&legacyCb](uint32_t) {
+               legacy::Callback<void, uint32_t> copy = legacyCb;
+               (void)copy;
+           }));
+    Report("Invoke",
+           Measure(iterations, [&cb](uint32_t i) { cb(i); }),
+           Measure(iterations, [&legacyCb](uint32_t i) { legacyCb(i); }));
+
+    auto boundCb = MakeCallback(&Target::ReceiveBound, target, 1, 2);
+    legacy::Callback<void, uint32_t> legacyBoundCb(&Target::ReceiveBound, target, 1, 2);
+    Report("Invoke, two bound arguments",
+           Measure(iterations, [&boundCb](uint32_t i) { boundCb(i); }),
+           Measure(iterations, [&legacyBoundCb](uint32_t i) { legacyBoundCb(i); }));
+
+    // Keep the sum alive
+    LOG("  Checksum:                     " << target->m_sum);
+
+    return 0;
+}
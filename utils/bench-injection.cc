@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+/**
+ * Benchmark of the injection of events from other threads.
+ *
+ * Producer threads call Simulator::ScheduleWithContext() as fast as
+ * they can, as the reader threads of the emulation devices do, while
+ * the main thread runs a chain of local events.
+ */
+class InjectionBench
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in] threads The number of producer threads.
+     * \param [in] events The number of events injected by each producer.
+     */
+    InjectionBench(uint32_t threads, uint64_t events);
+
+    /** Run the benchmark and log the results. */
+    void Run();
+
+  private:
+    /**
+     * Producer thread body.
+     *
+     * \param [in] index The index of the producer.
+     */
+    void Produce(uint32_t index);
+    /** An injected event. */
+    void Injected();
+    /** A local event of the main thread, which reschedules itself. */
+    void Local();
+
+    uint32_t m_threads;                   //!< The number of producer threads.
+    uint64_t m_events;                    //!< Events injected per producer.
+    std::atomic<bool> m_start;            //!< Start signal for the producers.
+    std::atomic<uint32_t> m_done;         //!< The number of producers done.
+    std::vector<double> m_produceSeconds; //!< Injection time of each producer.
+    uint64_t m_injected;                  //!< The number of injected events run.
+    uint64_t m_local;                     //!< The number of local events run.
+};
+
+InjectionBench::InjectionBench(uint32_t threads, uint64_t events)
+    : m_threads(threads),
+      m_events(events),
+      m_start(false),
+      m_done(0),
+      m_produceSeconds(threads, 0),
+      m_injected(0),
+      m_local(0)
+{
+}
+
+void
+InjectionBench::Produce(uint32_t index)
+{
+    while (!m_start.load())
+    {
+        std::this_thread::yield();
+    }
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < m_events; ++i)
+    {
+        Simulator::ScheduleWithContext(index, NanoSeconds(1), &InjectionBench::Injected, this);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    m_produceSeconds[index] = elapsed.count();
+    m_done++;
+}
+
+void
+InjectionBench::Injected()
+{
+    m_injected++;
+}
+
+void
+InjectionBench::Local()
+{
+    m_local++;
+    if (m_done.load() == m_threads && m_injected == m_events * m_threads)
+    {
+        Simulator::Stop();
+        return;
+    }
+    Simulator::Schedule(NanoSeconds(10), &InjectionBench::Local, this);
+}
+
+void
+InjectionBench::Run()
+{
+    Simulator::Schedule(Seconds(0), &InjectionBench::Local, this);
+
+    std::vector<std::thread> producers;
+    for (uint32_t i = 0; i < m_threads; ++i)
+    {
+        producers.emplace_back(&InjectionBench::Produce, this, i);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    m_start = true;
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    Simulator::Destroy();
+
+    double produce = 0;
+    for (double seconds : m_produceSeconds)
+    {
+        produce += seconds;
+    }
+    uint64_t total = m_events * m_threads;
+    LOG("  Wall clock time (s):          " << elapsed.count());
+    LOG("  Injected events run:          " << m_injected << " / " << total);
+    LOG("  Local events run:             " << m_local);
+    LOG("  Injection rate (ev/s):        " << total / elapsed.count());
+    LOG("  Producer cost (s/ev):         " << produce / total);
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t threads = 4;
+    uint64_t events = 1000000;
+    uint32_t minBatch = 16;
+    uint32_t maxBatch = 1024;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the injection of events from other threads.\n"
+              "\n"
+              "Producer threads schedule events with Simulator::ScheduleWithContext()\n"
+              "while the main thread runs the simulation, which measures the\n"
+              "contention between the producers and the simulator.");
+    cmd.AddValue("threads", "number of producer threads", threads);
+    cmd.AddValue("events", "number of events injected by each producer", events);
+    cmd.AddValue("min", "minimum number of injected events moved per iteration", minBatch);
+    cmd.AddValue("max", "maximum number of injected events moved per iteration", maxBatch);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::DefaultSimulatorImpl::MinDrainBatch", UintegerValue(minBatch));
+    Config::SetDefault("ns3::DefaultSimulatorImpl::MaxDrainBatch", UintegerValue(maxBatch));
+
+    LOG(std::setprecision(6));
+    LOG(cmd.GetName() << ": Benchmark the injection of events from other threads");
+    LOG("  Producer threads:             " << threads);
+    LOG("  Events per producer:          " << events);
+    LOG("  Events moved per iteration:   " << minBatch << " to " << maxBatch);
+
+    InjectionBench(threads, events).Run();
+
+    return 0;
+}
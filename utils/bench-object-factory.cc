@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+namespace
+{
+
+/**
+ * Measure the cost of an operation.
+ *
+ * \param [in] iterations The number of times to run the operation.
+ * \param [in] op The operation.
+ * \returns The time per operation, in ns.
+ */
+template <typename F>
+double
+Measure(uint64_t iterations, F op)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        op();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Log the cost of an operation.
+ *
+ * \param [in] name The name of the operation.
+ * \param [in] ns The time per operation, in ns.
+ */
+void
+Report(const std::string& name, double ns)
+{
+    LOG("  " << std::left << std::setw(36) << name << std::right << std::setw(12) << ns);
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t objects = 1000000;
+    uint32_t links = 50000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the construction of objects with their attributes.\n"
+              "\n"
+              "The objects are created with CreateObject() and ObjectFactory::Create(),\n"
+              "with and without attribute values, and point-to-point links are\n"
+              "installed between new nodes by PointToPointHelper, as the helpers\n"
+              "build a topology.");
+    cmd.AddValue("objects", "number of objects of each type", objects);
+    cmd.AddValue("links", "number of point-to-point links", links);
+    cmd.Parse(argc, argv);
+
+    LOG(std::fixed << std::setprecision(2));
+    LOG(cmd.GetName() << ": Benchmark the construction of objects");
+    LOG("  Objects:                            " << objects);
+    LOG("  Links:                              " << links);
+    LOG("  " << std::left << std::setw(36) << "Time per construction (ns)");
+
+    Report("CreateObject<PointToPointNetDevice>", Measure(objects, []() {
+               CreateObject<PointToPointNetDevice>();
+           }));
+    ObjectFactory device("ns3::PointToPointNetDevice",
+                         "DataRate",
+                         StringValue("5Mbps"),
+                         "Mtu",
+                         UintegerValue(1500));
+    Report("Factory PointToPointNetDevice", Measure(objects, [&device]() {
+               device.Create();
+           }));
+    ObjectFactory queue("ns3::DropTailQueue<Packet>", "MaxSize", StringValue("100p"));
+    Report("Factory DropTailQueue<Packet>", Measure(objects, [&queue]() { queue.Create(); }));
+
+    NodeContainer nodes;
+    Report("CreateObject<Node>", Measure(2 * links, [&nodes]() {
+               nodes.Add(CreateObject<Node>());
+           }));
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("5Mbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+    uint32_t link = 0;
+    Report("PointToPointHelper::Install", Measure(links, [&nodes, &p2p, &link]() {
+               p2p.Install(nodes.Get(2 * link), nodes.Get(2 * link + 1));
+               link++;
+           }));
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -21,6 +21,7 @@
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
 
+#include "ns3/buffer.h"
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
@@ -32,6 +33,7 @@
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -350,6 +352,139 @@ benchByteTags(uint32_t n)
     }
 }
 
+static void
+benchPacketTags(uint32_t n)
+{
+    BenchHeader<8> udp;
+    BenchTag<4> flowId;
+    BenchTag<8> timestamp;
+    BenchTag<1> priority;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddPacketTag(flowId);
+        p->AddPacketTag(timestamp);
+        p->AddPacketTag(priority);
+        p->AddHeader(udp);
+        Ptr<Packet> o = p->Copy();
+        o->PeekPacketTag(flowId);
+        o->RemovePacketTag(priority);
+        o->ReplacePacketTag(timestamp);
+        p->RemovePacketTag(timestamp);
+        p->PeekPacketTag(priority);
+    }
+}
+
+static void
+benchSmallByteTags(uint32_t n)
+{
+    BenchHeader<8> udp;
+    BenchTag<4> flowId;
+    BenchTag<8> timestamp;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddByteTag(flowId);
+        p->AddByteTag(timestamp);
+        p->AddHeader(udp);
+        Ptr<Packet> o = p->Copy();
+        o->FindFirstMatchingByteTag(timestamp);
+        Ptr<Packet> f = o->CreateFragment(0, 500);
+        f->FindFirstMatchingByteTag(flowId);
+        f->AddAtEnd(o->CreateFragment(500, 508));
+    }
+}
+
+/// The size of the large payloads
+static const uint32_t LARGE_PAYLOAD_SIZE = 65000;
+
+/**
+ * Get the content of the large payloads.
+ * \returns the payload bytes
+ */
+static const std::vector<uint8_t>&
+GetLargePayload()
+{
+    static std::vector<uint8_t> payload(LARGE_PAYLOAD_SIZE, 0x5a);
+    return payload;
+}
+
+static void
+benchLargePayload(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    BenchHeader<14> ethernet;
+    const std::vector<uint8_t>& payload = GetLargePayload();
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(payload.data(), payload.size());
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        // A copy kept by a queue or a trace while the original goes on
+        Ptr<Packet> o = p->Copy();
+        p->AddHeader(ethernet);
+        p->RemoveHeader(ethernet);
+        p->RemoveHeader(ipv4);
+        o->RemoveHeader(ipv4);
+        o->AddHeader(ipv4);
+    }
+}
+
+static void
+benchLargeFragment(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    const uint32_t mtu = 1500;
+    const std::vector<uint8_t>& payload = GetLargePayload();
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(payload.data(), payload.size());
+        p->AddHeader(udp);
+
+        Ptr<Packet> whole;
+        for (uint32_t offset = 0; offset < p->GetSize(); offset += mtu)
+        {
+            Ptr<Packet> fragment =
+                p->CreateFragment(offset, std::min(mtu, p->GetSize() - offset));
+            fragment->AddHeader(ipv4);
+            fragment->RemoveHeader(ipv4);
+            if (whole)
+            {
+                whole->AddAtEnd(fragment);
+            }
+            else
+            {
+                whole = fragment;
+            }
+        }
+        whole->RemoveHeader(udp);
+    }
+}
+
+/// The combined checksums, kept so that they are computed
+static uint16_t g_checksum = 0;
+
+static void
+benchChecksum(uint32_t n)
+{
+    const std::vector<uint8_t>& payload = GetLargePayload();
+    // The IPv4 and UDP headers and the payload of a full-size frame
+    Buffer buffer(payload.data(), 1472);
+    buffer.AddAtStart(28);
+    buffer.Begin().WriteU8(28, 28);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        g_checksum ^= buffer.Begin().CalculateIpChecksum(buffer.GetSize(), i);
+    }
+}
+
 static uint64_t
 runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
 {
@@ -382,6 +517,7 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool lazyPrinting = false;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -390,8 +526,18 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("lazy-printing", "enable packet printing, recorded lazily", lazyPrinting);
     cmd.Parse(argc, argv);
 
+    if (lazyPrinting)
+    {
+        Packet::EnableLazyPrinting();
+    }
+    else if (enablePrinting)
+    {
+        Packet::EnablePrinting();
+    }
+
     if (n == 0)
     {
         std::cerr << "Error-- number of packets must be specified "
@@ -407,6 +553,20 @@ main(int argc, char* argv[])
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchPacketTags, n, minIterations, "Add, copy, peek and remove small packet tags");
+    runBench(&benchSmallByteTags, n, minIterations, "Add, copy, fragment and find small byte tags");
+    runBench(&benchLargePayload,
+             n,
+             minIterations,
+             "Copy packet, add and remove headers, 64 KB payload");
+    runBench(&benchLargeFragment, n, minIterations, "Fragmentation and reassembly, 64 KB payload");
+    runBench(&benchChecksum, n, minIterations, "Checksum of 1500-byte packets");
+
+    Packet::PoolStats packets = Packet::GetPoolStats();
+    Packet::PoolStats tags = Packet::GetTagPoolStats();
+    std::cout << "Packet pool: " << packets.hits << " hits, " << packets.misses << " misses"
+              << std::endl;
+    std::cout << "Tag pools: " << tags.hits << " hits, " << tags.misses << " misses" << std::endl;
 
     return 0;
 }
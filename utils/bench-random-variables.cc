@@ -0,0 +1,168 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/** Log to std::cout */
+#define LOG(x) std::cout << x << std::endl
+
+namespace
+{
+
+/**
+ * Measure the cost of the values of a random variable.
+ *
+ * \param [in] rv The random variable.
+ * \param [in] count The number of values.
+ * \param [in] batch The number of values of each call to GetValues(),
+ *             or 0 for GetValue().
+ * \param [in,out] sum The sum of the values, to keep them alive.
+ * \returns The time per value, in ns.
+ */
+double
+Measure(Ptr<RandomVariableStream> rv, uint64_t count, uint32_t batch, double& sum)
+{
+    std::vector<double> values(batch);
+    auto begin = std::chrono::steady_clock::now();
+    if (batch == 0)
+    {
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            sum += rv->GetValue();
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0; i < count; i += batch)
+        {
+            rv->GetValues(values.data(), batch);
+            sum += values[0];
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count() / count;
+}
+
+/**
+ * Measure and log the cost of the values of a random variable.
+ *
+ * \param [in] name The name of the random variable.
+ * \param [in] rv The random variable.
+ * \param [in] count The number of values.
+ * \param [in] batch The number of values of each call to GetValues().
+ * \param [in,out] sum The sum of the values, to keep them alive.
+ */
+void
+Report(const std::string& name,
+       Ptr<RandomVariableStream> rv,
+       uint64_t count,
+       uint32_t batch,
+       double& sum)
+{
+    double scalar = Measure(rv, count, 0, sum);
+    double batched = Measure(rv, count, batch, sum);
+    LOG("  " << std::left << std::setw(36) << name << std::right << std::setw(12) << scalar
+             << std::setw(12) << batched);
+}
+
+} // unnamed namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint64_t count = 10000000;
+    uint32_t batch = 1024;
+    std::string engine = "MRG32k3a";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the random variables.\n"
+              "\n"
+              "The exponential, normal and log-normal random variables are measured\n"
+              "with each of their algorithms, and the empirical random variable with\n"
+              "small and large CDFs in each mode, one value at a time with GetValue(),\n"
+              "and in batches with GetValues().");
+    cmd.AddValue("count", "number of values of each random variable", count);
+    cmd.AddValue("batch", "number of values of each batch", batch);
+    cmd.AddValue("engine", "random number generator engine, MRG32k3a or Philox4x64", engine);
+    cmd.Parse(argc, argv);
+
+    Config::SetGlobal("RngEngine", StringValue(engine));
+
+    LOG(std::fixed << std::setprecision(2));
+    LOG(cmd.GetName() << ": Benchmark the random variables");
+    LOG("  Engine:                             " << engine);
+    LOG("  Values:                             " << count);
+    LOG("  Batch:                              " << batch);
+    LOG("  " << std::left << std::setw(36) << "Time per value (ns)" << std::right
+             << std::setw(12) << "GetValue" << std::setw(12) << "GetValues");
+
+    double sum = 0;
+    Report("Uniform", CreateObject<UniformRandomVariable>(), count, batch, sum);
+    for (auto algorithm :
+         {ExponentialRandomVariable::INVERSION, ExponentialRandomVariable::ZIGGURAT})
+    {
+        auto rv = CreateObject<ExponentialRandomVariable>();
+        rv->SetAttribute("Algorithm", EnumValue(algorithm));
+        std::string name = (algorithm == ExponentialRandomVariable::INVERSION) ? "inversion"
+                                                                               : "ziggurat";
+        Report("Exponential (" + name + ")", rv, count, batch, sum);
+    }
+    for (auto algorithm : {NormalRandomVariable::POLAR, NormalRandomVariable::ZIGGURAT})
+    {
+        auto rv = CreateObject<NormalRandomVariable>();
+        rv->SetAttribute("Algorithm", EnumValue(algorithm));
+        std::string name = (algorithm == NormalRandomVariable::POLAR) ? "polar" : "ziggurat";
+        Report("Normal (" + name + ")", rv, count, batch, sum);
+    }
+    for (auto algorithm : {LogNormalRandomVariable::POLAR, LogNormalRandomVariable::ZIGGURAT})
+    {
+        auto rv = CreateObject<LogNormalRandomVariable>();
+        rv->SetAttribute("Algorithm", EnumValue(algorithm));
+        std::string name = (algorithm == LogNormalRandomVariable::POLAR) ? "polar" : "ziggurat";
+        Report("Log-normal (" + name + ")", rv, count, batch, sum);
+    }
+
+    for (uint32_t points : {10, 100000})
+    {
+        for (std::string mode : {"sampling", "interpolation", "alias"})
+        {
+            auto rv = CreateObject<EmpiricalRandomVariable>();
+            rv->SetAttribute("Interpolate", BooleanValue(mode == "interpolation"));
+            rv->SetAttribute("Alias", BooleanValue(mode == "alias"));
+            // A skewed distribution, as of flow sizes
+            for (uint32_t i = 1; i <= points; ++i)
+            {
+                double fraction = static_cast<double>(i) / points;
+                rv->CDF(i, (i == points) ? 1.0 : 1 - std::pow(1 - fraction, 3));
+            }
+            std::string name = "Empirical " + std::to_string(points) + " (" + mode + ")";
+            Report(name, rv, count, batch, sum);
+        }
+    }
+
+    // Keep the values alive
+    LOG("  Sum:                                " << sum);
+    return 0;
+}
@@ -241,6 +241,7 @@ class BenchSuite
 
     std::string m_scheduler;       /**< Descriptive string for the scheduler. */
     std::vector<Result> m_results; /**< Store for the run results. */
+    EventImpl::PoolStats m_pool;   /**< Event memory pool usage during the runs. */
 
 }; // BenchSuite
 
@@ -296,6 +297,8 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     auto prime = bench.Run();
     Result::Bench(prime).Log("prime");
 
+    m_pool = EventImpl::GetPoolStats();
+
     // Perform the actual runs
     for (uint64_t i = 0; i < runs; i++)
     {
@@ -304,6 +307,10 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
         m_results.back().Log(i);
     }
 
+    auto pool = EventImpl::GetPoolStats();
+    m_pool.allocations = pool.allocations - m_pool.allocations;
+    m_pool.hits = pool.hits - m_pool.hits;
+
     Simulator::Destroy();
 
 } // BenchSuite::Run
@@ -331,6 +338,12 @@ BenchSuite::Header() const
 void
 BenchSuite::Log() const
 {
+    if (m_pool.allocations > 0)
+    {
+        LOG("Event pool hit rate: " << 100.0 * m_pool.hits / m_pool.allocations << "% of "
+                                    << m_pool.allocations << " events");
+    }
+
     if (m_results.size() < 2)
     {
         LOG("");
@@ -390,21 +403,58 @@ BenchSuite::Log() const
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
- *  If the \p filename parameter is empty a default exponential time
- *  distribution will be used, with mean delay of 100 ns.
+ *  If the \p filename parameter is empty the \p dist distribution
+ *  will be used:
+ *    - `exp`: exponential, with mean delay of 100 ns (the default);
+ *    - `uniform`: uniform in [0, 200] ns, the "rectangle" hold model;
+ *    - `camel`: half of the delays in [0, 20] ns and half in
+ *      [180, 200] ns, the "camel" hold model;
+ *    - `bursty`: 90% of the delays below 1 ns, i.e., bursts of
+ *      simultaneous events, and the rest spread up to 10 us.
  *
  *  If the \p filename is `-` standard input will be used.
  *
  *  \param [in] filename The delay interval source file name.
+ *  \param [in] dist The name of the delay distribution.
  *  \returns The RandomVariableStream.
  */
 Ptr<RandomVariableStream>
-GetRandomStream(std::string filename)
+GetRandomStream(std::string filename, std::string dist)
 {
     Ptr<RandomVariableStream> stream = nullptr;
 
-    if (filename.empty())
+    if (filename.empty() && dist == "uniform")
     {
+        LOG("  Event time distribution:      uniform hold model");
+        auto urv = CreateObject<UniformRandomVariable>();
+        urv->SetAttribute("Min", DoubleValue(0));
+        urv->SetAttribute("Max", DoubleValue(200));
+        stream = urv;
+    }
+    else if (filename.empty() && dist == "camel")
+    {
+        LOG("  Event time distribution:      camel hold model");
+        auto erv = CreateObject<EmpiricalRandomVariable>();
+        erv->SetInterpolate(true);
+        erv->CDF(0, 0);
+        erv->CDF(20, 0.5);
+        erv->CDF(180, 0.5);
+        erv->CDF(200, 1.0);
+        stream = erv;
+    }
+    else if (filename.empty() && dist == "bursty")
+    {
+        LOG("  Event time distribution:      bursty");
+        auto erv = CreateObject<EmpiricalRandomVariable>();
+        erv->SetInterpolate(true);
+        erv->CDF(0, 0);
+        erv->CDF(1, 0.9);
+        erv->CDF(10000, 1.0);
+        stream = erv;
+    }
+    else if (filename.empty())
+    {
+        NS_ABORT_MSG_UNLESS(dist == "exp", "Unknown event time distribution " << dist);
         LOG("  Event time distribution:      default exponential");
         auto erv = CreateObject<ExponentialRandomVariable>();
         erv->SetAttribute("Mean", DoubleValue(100));
@@ -457,6 +507,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -465,23 +516,31 @@ main(int argc, char* argv[])
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string dist = "exp";
     bool calRev = false;
+    bool pool = true;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark the simulator scheduler.\n"
               "\n"
               "Event intervals are taken from one of:\n"
               "  an exponential distribution, with mean 100 ns,\n"
+              "  a hold model or bursty distribution, given by --dist,\n"
               "  an ascii file, given by the --file=\"<filename>\" argument,\n"
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
               "to be ascii, giving the relative event times in ns.\n"
               "\n"
-              "If no scheduler is specified the MapScheduler will be run.");
+              "If no scheduler is specified the MapScheduler will be run.\n"
+              "\n"
+              "The simulation phase measures the end-to-end cost of scheduling\n"
+              "and invoking events; --pool=false disables the recycling of the\n"
+              "memory of the events, for comparison.");
     cmd.AddValue("all", "use all schedulers", allSched);
     cmd.AddValue("cal", "use CalendarSheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListSheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
@@ -490,6 +549,8 @@ main(int argc, char* argv[])
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("dist", "event time distribution: exp, uniform, camel or bursty", dist);
+    cmd.AddValue("pool", "recycle the memory of the events", pool);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
 
@@ -501,19 +562,25 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+#ifdef NS3_EVENT_POOL
+    LOG("  Event memory pool:            " << (pool ? "enabled" : "disabled"));
+#else
+    LOG("  Event memory pool:            not built");
+#endif
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    EventImpl::SetPoolEnabled(pool);
+    auto eventStream = GetRandomStream(filename, dist);
 
     ObjectFactory factory("ns3::MapScheduler");
     if (schedCal)
@@ -532,6 +599,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::HeapScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");
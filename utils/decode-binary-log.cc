@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Render a binary log file as text.\n"
+              "\n"
+              "The binary log files are written when the NS_LOG_BINARY environment\n"
+              "variable names the file, or after LogEnableBinary(), instead of the\n"
+              "text on std::clog.  The text is the same as std::clog would show.");
+    cmd.AddNonOption("input", "the binary log file", input);
+    cmd.AddValue("output", "the text file, instead of std::cout", output);
+    cmd.Parse(argc, argv);
+
+    if (input.empty())
+    {
+        std::cerr << "No binary log file" << std::endl;
+        cmd.PrintHelp(std::cerr);
+        return 1;
+    }
+    std::ifstream is(input, std::ios::binary);
+    if (!is.is_open())
+    {
+        std::cerr << "Can't open " << input << std::endl;
+        return 1;
+    }
+
+    if (output.empty())
+    {
+        LogDecodeBinary(is, std::cout);
+    }
+    else
+    {
+        std::ofstream os(output);
+        if (!os.is_open())
+        {
+            std::cerr << "Can't open " << output << std::endl;
+            return 1;
+        }
+        LogDecodeBinary(is, os);
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#ifndef __WIN32__
+#include <csignal>
+#endif
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string path;
+    double interval = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Print the live counters of a simulation.\n"
+              "\n"
+              "The counters are exported by the simulations run with\n"
+              "--ns3::DefaultSimulatorImpl::StatsFile=<path>, one name and value\n"
+              "separated by a tab per line.  The events/<module> counters are\n"
+              "estimated from a sample of the events.");
+    cmd.AddNonOption("path", "the path of the file of the counters", path);
+    cmd.AddValue("interval",
+                 "print the counters again every interval seconds, until the end of the run",
+                 interval);
+    cmd.Parse(argc, argv);
+
+    if (path.empty())
+    {
+        std::cerr << "No file of counters" << std::endl;
+        cmd.PrintHelp(std::cerr);
+        return 1;
+    }
+
+    while (true)
+    {
+        SimulatorStats::Snapshot stats;
+        if (!SimulatorStats::Read(path, stats))
+        {
+            std::cerr << "Can't read the counters of " << path << std::endl;
+            return 1;
+        }
+        double cancelled = stats.scheduled > 0 ? double(stats.cancelled) / stats.scheduled : 0;
+        std::cout << "pid\t" << stats.pid << "\n"
+                  << "running\t" << (stats.running ? "yes" : "no") << "\n"
+                  << "time\t" << stats.simTime.As(Time::S) << "\n"
+                  << "elapsed\t" << stats.elapsed << "\n"
+                  << "events\t" << stats.events << "\n"
+                  << "events/s\t" << stats.eventRate << "\n"
+                  << "scheduled\t" << stats.scheduled << "\n"
+                  << "cancelled\t" << stats.cancelled << "\n"
+                  << "cancelled ratio\t" << cancelled << "\n"
+                  << "rss\t" << stats.rss << "\n";
+        for (const auto& [name, value] : stats.counters)
+        {
+            std::cout << name << "\t" << value << "\n";
+        }
+        std::cout << std::endl;
+        if (interval <= 0 || !stats.running)
+        {
+            return 0;
+        }
+#ifndef __WIN32__
+        if (kill(stats.pid, 0) != 0 && errno == ESRCH)
+        {
+            std::cerr << "The process " << stats.pid << " ended during the run" << std::endl;
+            return 1;
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+}
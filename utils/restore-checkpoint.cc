@@ -0,0 +1,60 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string path;
+    bool stop = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Continue a simulation from a checkpoint, or stop the checkpoint.\n"
+              "\n"
+              "The checkpoints are saved by the scripts run with --checkpoint=<path>,\n"
+              "or which call Checkpoint::Save().  The simulation continues with the\n"
+              "standard input, output and error and the working directory of this\n"
+              "program, after the name=value overrides which follow the path, such as\n"
+              "RngRun=2, and this program exits with its status.");
+    cmd.AddNonOption("path", "the path of the socket of the checkpoint", path);
+    cmd.AddValue("stop", "stop the checkpoint process", stop);
+    cmd.Parse(argc, argv);
+
+    if (path.empty())
+    {
+        std::cerr << "No checkpoint" << std::endl;
+        cmd.PrintHelp(std::cerr);
+        return 1;
+    }
+    if (stop)
+    {
+        Checkpoint::Stop(path);
+        return 0;
+    }
+    std::vector<std::string> overrides;
+    for (std::size_t i = 0; i < cmd.GetNExtraNonOptions(); ++i)
+    {
+        overrides.push_back(cmd.GetExtraNonOption(i));
+    }
+    return Checkpoint::Restore(path, overrides);
+}